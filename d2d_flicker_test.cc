@@ -1,11 +1,13 @@
 #include <cassert>
 #include <cstdio>
 #include <cstdarg>
+#include <cstdint>
 #include <cstdlib>
 #include <algorithm>
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <string>
 #include <vector>
 
 #ifndef UNICODE
@@ -18,10 +20,24 @@
 
 #define NTDDI_VERSION NTDDI_WIN7
 
+#ifndef D2D_SUPPORT__
+#define D2D_SUPPORT__
+#endif
+
 #include <d2d1.h>
 #include <d2d1helper.h>
 #include <Windows.h>
 
+//
+// Built by d2d_flicker_test.vcxproj, which compiles this file with the
+// geometry_path_test sources (all but main.cc).
+#include "geometry_path_test/d2d_render_target.h"
+#include "geometry_path_test/intrusive_ptr.h"
+#include "geometry_path_test/demo_scenes.h"
+#include "geometry_path_test/input_recording.h"
+#include "geometry_path_test/latency_tracker.h"
+#include "geometry_path_test/trace.h"
+
 #ifndef WIDEN_STR
 #define WIDEN_STR(str) L#str
 #endif
@@ -74,72 +90,32 @@ OutputFormattedDebugString(
   } while (0)
 #endif
 
-struct COM_Deleter {
-  void operator()(IUnknown* ptr) {
-    if (ptr)
-      ptr->Release();
-  }
-};
-
-inline
-bool
-PointInRectangle(
-  const D2D1_POINT_2F& pt,
-  const D2D1_RECT_F& rect
+DemoKey
+ToDemoKey(
+  UINT code
   )
 {
-  return pt.x >= rect.left && pt.x <= rect.right &&
-    pt.y >= rect.top && pt.y <= rect.bottom;
-}
-
-class MovingRectangle {
-public :
-  MovingRectangle() {}
+  switch (code) {
+  case VK_LEFT :
+    return DemoKey_Left;
 
-  ~MovingRectangle() {}
+  case VK_RIGHT :
+    return DemoKey_Right;
 
-  void SetVelocity(const D2D1_POINT_2F& v) {
-    velocity_ = v;
-  }
+  case VK_ESCAPE :
+    return DemoKey_Escape;
 
-  void SetPosition(const D2D1_POINT_2F& pos) {
-    pos_ = pos;
-  }
-
-  void SetGeometry(const D2D1_SIZE_F& geometry) {
-    geometry_ = geometry;
-  }
-
-  void SetBrush(ID2D1SolidColorBrush* brush) {
-    brush_ = brush;
-  }
-
-  void Draw(ID2D1RenderTarget* target) {
-    assert(brush_);
-    target->FillRectangle(D2D1::RectF(pos_.x - geometry_.width / 2, 
-                                      pos_.y - geometry_.height / 2,
-                                      pos_.x + geometry_.width / 2,
-                                      pos_.y + geometry_.height / 2),
-                          brush_);
-  }
-
-  void Move(float direction) {
-    D2D1_POINT_2F new_pos(D2D1::Point2F(
-      pos_.x + direction * (velocity_.x + geometry_.width / 2), pos_.y));
-    if (PointInRectangle(new_pos, D2D1::RectF(0.0f, 0.0f, 1280, 1024)))
-      pos_.x += velocity_.x * direction;
+  default :
+    return DemoKey_Other;
   }
-  
-private :
-  D2D1_POINT_2F           pos_;
-  D2D1_POINT_2F           velocity_;
-  D2D1_SIZE_F             geometry_;
-  ID2D1SolidColorBrush*   brush_;
-};
+}
 
 class Direct2DWindow {
 public :
-  Direct2DWindow() : app_window_(nullptr) {}
+  Direct2DWindow()
+    : app_window_(nullptr), last_frame_counter_(0), recording_time_ns_(0), frame_id_(0) {
+    ::QueryPerformanceFrequency(&counter_frequency_);
+  }
 
   ~Direct2DWindow() {}
 
@@ -149,6 +125,22 @@ public :
 
   bool Create(int width, int height);
 
+  //
+  // Records the keys and frame times of the session, written to path when
+  // the window is destroyed. headless_main --replay plays them back.
+  void RecordInputTo(const std::string& path) {
+    record_path_ = path;
+    recorder_.clear();
+  }
+
+  //
+  // Writes the input to photon latency of every key press to path (CSV)
+  // when the window is destroyed. The percentiles always go to the
+  // debugger output.
+  void ExportLatencyTo(const std::string& path) {
+    latency_path_ = path;
+  }
+
 private :
   static const wchar_t* const C_WindowClassName;
   static Direct2DWindow*      mainwindow_;
@@ -165,46 +157,63 @@ private :
   bool CreateDeviceDependentResources();
 
   void DiscardResources() {
-    brush_cache_.clear();
+    target_.reset();
     rendertarget_.reset();
-    bitmaptarget_.reset();
   }
 
   void Handle_KeyDown(UINT code) {
-    switch (code) {
-    case VK_LEFT :
-      block_.Move(0.5f);
-      break;
-
-    case VK_RIGHT :
-      block_.Move(-0.5f);
-      break;
-
-    case VK_ESCAPE :
-      if (::MessageBoxW(app_window_, L"Quit app ?", L"", 
-                        MB_ICONQUESTION | MB_YESNO) == IDYES)
-                        ::DestroyWindow(app_window_);
-      break;
-
-    default :
-      break;
-    }
+    const DemoKey key = ToDemoKey(code);
+    if (!record_path_.empty())
+      recorder_.key_down(RecordingTime(), key);
+
+    scene_.HandleKeyDown(key, latency_.input_event(NowNs()));
+    if (key == DemoKey_Escape &&
+        ::MessageBoxW(app_window_, L"Quit app ?", L"",
+                      MB_ICONQUESTION | MB_YESNO) == IDYES)
+      ::DestroyWindow(app_window_);
   }
 
-  enum Brushes {
-    Brush_Black,
-    Brush_White,
-    Brush_Orange
-  };
+  void Handle_KeyUp(UINT code) {
+    const DemoKey key = ToDemoKey(code);
+    if (!record_path_.empty())
+      recorder_.key_up(RecordingTime(), key);
+
+    scene_.HandleKeyUp(key, latency_.input_event(NowNs()));
+  }
+
+  //
+  // Nanoseconds since the previous frame (0 for the first one).
+  uint64_t ElapsedSinceLastFrame();
+
+  //
+  // The recording clock : the sum of the frame times handed to the scene,
+  // plus the time since the last frame.
+  uint64_t RecordingTime() const;
+
+  uint64_t NowNs() const {
+    LARGE_INTEGER now;
+    ::QueryPerformanceCounter(&now);
+    return static_cast<uint64_t>(
+      static_cast<double>(now.QuadPart) * 1.0e9 / counter_frequency_.QuadPart);
+  }
+
+  void ReportLatency() const;
 
   HWND                                        app_window_;
   int                                         width_;
   int                                         height_;
-  std::shared_ptr<ID2D1Factory>               factory_;
-  std::shared_ptr<ID2D1HwndRenderTarget>      rendertarget_;
-  std::shared_ptr<ID2D1BitmapRenderTarget>    bitmaptarget_;
-  std::vector<std::shared_ptr<ID2D1SolidColorBrush>> brush_cache_;
-  MovingRectangle                             block_;
+  gfx::intrusive_ptr<ID2D1Factory>            factory_;
+  gfx::intrusive_ptr<ID2D1HwndRenderTarget>   rendertarget_;
+  std::shared_ptr<gfx::d2d_render_target>     target_;
+  BlockScene                                  scene_;
+  LARGE_INTEGER                               counter_frequency_;
+  LONGLONG                                    last_frame_counter_;
+  std::string                                 record_path_;
+  gfx::input_recorder                         recorder_;
+  uint64_t                                    recording_time_ns_;
+  gfx::latency_tracker                        latency_;
+  std::string                                 latency_path_;
+  uint64_t                                    frame_id_;
 };
 
 const wchar_t* const Direct2DWindow::C_WindowClassName = L"Direct2DWindowClass@@##";
@@ -248,6 +257,7 @@ Direct2DWindow::PumpMessagesUntilQuit() {
       if (msg_info.message == WM_QUIT)
         break;
 
+      GFX_TRACE_ZONE("message");
       ::TranslateMessage(&msg_info);
       ::DispatchMessageW(&msg_info);
     }
@@ -333,6 +343,11 @@ Direct2DWindow::WindowProcedureHandler(
     break;
 
   case WM_DESTROY :
+    if (!record_path_.empty() && !recorder_.save(record_path_)) {
+      OutputFormattedDebugString(__WFILE__, __LINE__,
+                                 L"Failed to save the input recording");
+    }
+    ReportLatency();
     ::PostQuitMessage(0);
     return 0L;
     break;
@@ -342,6 +357,11 @@ Direct2DWindow::WindowProcedureHandler(
     return 0L;
     break;
 
+  case WM_KEYUP :
+    Handle_KeyUp(wparam);
+    return 0L;
+    break;
+
   default :
     break;
   }
@@ -349,14 +369,87 @@ Direct2DWindow::WindowProcedureHandler(
   return ::DefWindowProcW(app_window_, msg, wparam, lparam);
 }
 
+uint64_t
+Direct2DWindow::ElapsedSinceLastFrame() {
+  LARGE_INTEGER now;
+  ::QueryPerformanceCounter(&now);
+
+  if (!last_frame_counter_) {
+    last_frame_counter_ = now.QuadPart;
+    return 0;
+  }
+
+  const LONGLONG ticks = now.QuadPart - last_frame_counter_;
+  last_frame_counter_ = now.QuadPart;
+  return static_cast<uint64_t>(
+    static_cast<double>(ticks) * 1.0e9 / counter_frequency_.QuadPart);
+}
+
+uint64_t
+Direct2DWindow::RecordingTime() const {
+  if (!last_frame_counter_)
+    return recording_time_ns_;
+
+  LARGE_INTEGER now;
+  ::QueryPerformanceCounter(&now);
+  return recording_time_ns_ + static_cast<uint64_t>(
+    static_cast<double>(now.QuadPart - last_frame_counter_) * 1.0e9 /
+    counter_frequency_.QuadPart);
+}
+
 void
 Direct2DWindow::RenderFrame() {
-  CreateDeviceDependentResources();
-  rendertarget_->BeginDraw();
-  rendertarget_->Clear(D2D1::ColorF(D2D1::ColorF::White));
-  block_.Draw(rendertarget_.get());
-  if (rendertarget_->EndDraw() == D2DERR_RECREATE_TARGET) {
+  GFX_TRACE_ZONE("frame");
+  const uint64_t elapsed_ns = ElapsedSinceLastFrame();
+  recording_time_ns_ += elapsed_ns;
+  if (!record_path_.empty())
+    recorder_.frame(recording_time_ns_);
+
+  {
+    GFX_TRACE_ZONE("update");
+    scene_.Update(elapsed_ns);
+  }
+
+  if (!CreateDeviceDependentResources())
+    return;
+
+  //
+  // EndDraw() presents (and waits for the vertical blank) : the keys the
+  // frame reflects are on screen when it returns.
+  const uint64_t frame_id = ++frame_id_;
+  latency_.frame_started(frame_id, scene_.GetAppliedInput());
+  {
+    GFX_TRACE_ZONE("draw");
+    target_->begin_draw();
+    scene_.Draw(target_.get());
+  }
+
+  gfx::end_draw_result result;
+  {
+    GFX_TRACE_ZONE("end draw");
+    result = target_->end_draw();
+  }
+  if (result == gfx::end_draw_recreate_target) {
     DiscardResources();
+    return;
+  }
+  latency_.frame_completed(frame_id, NowNs());
+}
+
+void
+Direct2DWindow::ReportLatency() const {
+  const gfx::latency_summary latency = latency_.summary();
+  OutputFormattedDebugString(
+    __WFILE__, __LINE__,
+    L"Input to photon : %llu inputs, mean %.2f ms, p50 %.2f ms, p90 %.2f ms, "
+    L"p99 %.2f ms, max %.2f ms, %.2f frames on average (%llu max)\n",
+    latency.count_, latency.mean_ns_ * 1.0e-6, latency.p50_ns_ * 1.0e-6,
+    latency.p90_ns_ * 1.0e-6, latency.p99_ns_ * 1.0e-6, latency.max_ns_ * 1.0e-6,
+    latency.mean_frames_, latency.max_frames_);
+
+  if (!latency_path_.empty() && !latency_.export_csv(latency_path_)) {
+    OutputFormattedDebugString(__WFILE__, __LINE__,
+                               L"Failed to write the latency report");
   }
 }
 
@@ -364,22 +457,19 @@ bool
 Direct2DWindow::CreateDeviceIndependentResources() {
   assert(!factory_);
 
-  ID2D1Factory* tmp;
   HRESULT ret_code;
   TRACE_D2DCALL(&ret_code,
-                ::D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, &tmp));
-  if (FAILED(ret_code))
-    return false;
-
-  factory_.reset(tmp, COM_Deleter());
-  return true;
+                ::D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED,
+                                    factory_.reset_and_get_address()));
+  return SUCCEEDED(ret_code);
 }
 
 bool
 Direct2DWindow::CreateDeviceDependentResources() {
   if (rendertarget_.get())
     return true;
-        
+
+  GFX_TRACE_ZONE("create resources");
   D2D1_RENDER_TARGET_PROPERTIES rtarget_props;
   rtarget_props.type = D2D1_RENDER_TARGET_TYPE_HARDWARE;
   rtarget_props.pixelFormat = ::D2D1::PixelFormat(
@@ -394,51 +484,55 @@ Direct2DWindow::CreateDeviceDependentResources() {
   hwnd_rprops.presentOptions = D2D1_PRESENT_OPTIONS_NONE;
 
   HRESULT ret_code;
-  ID2D1HwndRenderTarget* ptarget;
-  TRACE_D2DCALL(&ret_code, factory_->CreateHwndRenderTarget(rtarget_props, 
-                                                            hwnd_rprops,
-                                                            &ptarget));
+  TRACE_D2DCALL(&ret_code, factory_->CreateHwndRenderTarget(
+                  rtarget_props, hwnd_rprops,
+                  rendertarget_.reset_and_get_address()));
   if (FAILED(ret_code))
     return false;
 
-  rendertarget_.reset(ptarget, COM_Deleter());
-
-  D2D1_COLOR_F colors[] = {
-    D2D1::ColorF(D2D1::ColorF::Black),
-    D2D1::ColorF(D2D1::ColorF::White),
-    D2D1::ColorF(D2D1::ColorF::Orange)
-  };
-
-  std::transform(
-    std::begin(colors),
-    std::end(colors),
-    std::back_inserter(brush_cache_),
-    [ptarget](const D2D1_COLOR_F& colour) -> std::shared_ptr<ID2D1SolidColorBrush> {
-      ID2D1SolidColorBrush* brush = nullptr;
-      HRESULT ret_code;
-      TRACE_D2DCALL(&ret_code, ptarget->CreateSolidColorBrush(colour, &brush));
-      return std::shared_ptr<ID2D1SolidColorBrush>(brush, COM_Deleter());
-  });
-
-  block_.SetBrush(brush_cache_[Direct2DWindow::Brush_Orange].get());
-  block_.SetPosition(D2D1::Point2F(width_ / 2, height_ / 2));
-  block_.SetGeometry(D2D1::SizeF(200.0f, 200.0f));
-  block_.SetVelocity(D2D1::Point2F(10.0f, 0.0f));
+  target_.reset(new gfx::d2d_render_target(rendertarget_.get()));
+  scene_.Initialize(width_, height_);
   return true;
 }
 
 }
 
+//
+// d2d_flicker_test [--record=FILE] [--latency=FILE] [--trace=FILE]
 int 
 WINAPI 
 wWinMain(
   HINSTANCE instance,
   HINSTANCE,
-  LPWSTR,
+  LPWSTR command_line,
   int
   )
 {
   Direct2DWindow app_window;
+
+  const wchar_t C_RecordOption[] = L"--record=";
+  const wchar_t C_LatencyOption[] = L"--latency=";
+  const wchar_t C_TraceOption[] = L"--trace=";
+  int arg_count = 0;
+  LPWSTR* args = command_line && *command_line ?
+    ::CommandLineToArgvW(command_line, &arg_count) : nullptr;
+  for (int i = 0; i < arg_count; ++i) {
+    //
+    // Plain ASCII paths only.
+    const std::wstring arg(args[i]);
+    const std::string narrow(arg.begin(), arg.end());
+    if (!arg.compare(0, _countof(C_RecordOption) - 1, C_RecordOption))
+      app_window.RecordInputTo(narrow.substr(_countof(C_RecordOption) - 1));
+    else if (!arg.compare(0, _countof(C_LatencyOption) - 1, C_LatencyOption))
+      app_window.ExportLatencyTo(narrow.substr(_countof(C_LatencyOption) - 1));
+    else if (!arg.compare(0, _countof(C_TraceOption) - 1, C_TraceOption))
+      gfx::trace_write_at_exit(narrow.substr(_countof(C_TraceOption) - 1));
+  }
+  if (args)
+    ::LocalFree(args);
+
+  GFX_TRACE_THREAD_NAME("ui");
+
   if (Direct2DWindow::RegisterWindowClass(instance) && 
       app_window.Create(1280, 1024))
       Direct2DWindow::PumpMessagesUntilQuit();
@@ -0,0 +1,341 @@
+/*
+ * animation.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "animation.h"
+
+#include <cmath>
+
+namespace {
+
+/*
+ * The segment [times[i], times[i + 1]) holding t, n >= 2 keys. Tries the
+ * segment found last time, the next one and the first one before
+ * searching.
+ */
+inline
+uint32_t
+find_segment(
+    const float* times,
+    uint32_t n,
+    float t,
+    uint32_t* cursor,
+    gfx::animation_statistics* stats
+    )
+{
+    uint32_t segment = std::min(*cursor, n - 2);
+
+    if (times[segment] <= t && t < times[segment + 1]) {
+        ++stats->cursor_hits_;
+    } else if (segment + 2 < n && times[segment + 1] <= t && t < times[segment + 2]) {
+        ++segment;
+        ++stats->cursor_hits_;
+    } else if (t < times[1]) {
+        //
+        // Looping tracks wrap around to the first segment.
+        segment = 0;
+        ++stats->cursor_hits_;
+    } else {
+        const float* next = std::upper_bound(times, times + n, t);
+        const ptrdiff_t index = (next - times) - 1;
+        segment = static_cast<uint32_t>(
+            std::min<ptrdiff_t>(std::max<ptrdiff_t>(index, 0), n - 2));
+    }
+
+    *cursor = segment;
+    return segment;
+}
+
+inline
+float
+catmull_rom(
+    float p0,
+    float p1,
+    float p2,
+    float p3,
+    float u
+    )
+{
+    const float u2 = u * u;
+    const float u3 = u2 * u;
+    return 0.5f * (2.0f * p1 + (p2 - p0) * u +
+                   (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * u2 +
+                   (3.0f * (p1 - p2) + p3 - p0) * u3);
+}
+
+} // anonymous namespace
+
+float
+gfx::apply_easing(
+    easing_function easing,
+    float t
+    )
+{
+    switch (easing) {
+    case easing_in_quad :
+        return t * t;
+
+    case easing_out_quad :
+        return t * (2.0f - t);
+
+    case easing_in_out_quad :
+        return t < 0.5f ? 2.0f * t * t : -1.0f + (4.0f - 2.0f * t) * t;
+
+    case easing_in_out_cubic :
+        if (t < 0.5f)
+            return 4.0f * t * t * t;
+        t = 2.0f * t - 2.0f;
+        return 0.5f * t * t * t + 1.0f;
+
+    case easing_smoothstep :
+        return t * t * (3.0f - 2.0f * t);
+
+    default :
+        break;
+    }
+
+    return t;
+}
+
+void
+gfx::transform_animation_set::track_set::set_track(
+    uint32_t object,
+    const float* times,
+    const float* values0,
+    const float* values1,
+    size_t count,
+    const track_options& options
+    )
+{
+    assert(times && values0 && count);
+    assert(components_ == 1 || values1);
+
+    if (object_track_.size() <= object)
+        object_track_.resize(object + 1, static_cast<uint32_t>(C_NoTrack));
+
+    //
+    // Replacing a track : its keys go, the keys of the tracks after it
+    // move down.
+    const uint32_t existing = object_track_[object];
+    if (existing != C_NoTrack) {
+        const uint32_t first = first_key_[existing];
+        const uint32_t removed = key_count_[existing];
+
+        key_times_.erase(key_times_.begin() + first, key_times_.begin() + first + removed);
+        for (size_t c = 0; c < components_; ++c) {
+            key_values_[c].erase(key_values_[c].begin() + first,
+                                 key_values_[c].begin() + first + removed);
+        }
+
+        for (size_t track = 0; track < first_key_.size(); ++track) {
+            if (first_key_[track] > first)
+                first_key_[track] -= removed;
+        }
+
+        first_key_[existing] = static_cast<uint32_t>(key_times_.size());
+        key_count_[existing] = static_cast<uint32_t>(count);
+        cursor_[existing] = 0;
+        options_[existing] = options;
+    } else {
+        object_track_[object] = static_cast<uint32_t>(object_.size());
+        object_.push_back(object);
+        first_key_.push_back(static_cast<uint32_t>(key_times_.size()));
+        key_count_.push_back(static_cast<uint32_t>(count));
+        cursor_.push_back(0);
+        options_.push_back(options);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        assert(!i || times[i] >= times[i - 1]);
+        key_times_.push_back(times[i]);
+        key_values_[0].push_back(values0[i]);
+        if (components_ > 1)
+            key_values_[1].push_back(values1[i]);
+    }
+}
+
+void
+gfx::transform_animation_set::track_set::evaluate(
+    float time,
+    float* output0,
+    float* output1,
+    animation_statistics* stats
+    )
+{
+    float* outputs[] = { output0, output1 };
+
+    for (size_t track = 0; track < object_.size(); ++track) {
+        const uint32_t object = object_[track];
+        const uint32_t first = first_key_[track];
+        const uint32_t n = key_count_[track];
+        const track_options& options = options_[track];
+        const float* times = &key_times_[first];
+
+        ++stats->track_lookups_;
+
+        //
+        // Before the first or after the last key (not looping) : the value
+        // of that key.
+        const float start = times[0];
+        const float end = times[n - 1];
+        float t = time;
+        uint32_t hold_key = n;
+
+        if (n == 1 || !(end > start)) {
+            hold_key = 0;
+        } else if (options.loop_) {
+            t = std::fmod(t - start, end - start);
+            t = (t < 0.0f ? t + (end - start) : t) + start;
+        } else if (t <= start) {
+            hold_key = 0;
+        } else if (t >= end) {
+            hold_key = n - 1;
+        }
+
+        if (hold_key != n) {
+            ++stats->cursor_hits_;
+            for (size_t c = 0; c < components_; ++c)
+                outputs[c][object] = key_values_[c][first + hold_key];
+            continue;
+        }
+
+        const uint32_t segment = find_segment(times, n, t, &cursor_[track], stats);
+        const float u = apply_easing(
+            options.easing_, (t - times[segment]) / (times[segment + 1] - times[segment]));
+
+        if (options.interpolation_ == interpolation_linear) {
+            for (size_t c = 0; c < components_; ++c) {
+                const float* values = &key_values_[c][first];
+                outputs[c][object] = values[segment] + (values[segment + 1] - values[segment]) * u;
+            }
+            continue;
+        }
+
+        //
+        // The outer keys of the cubic : clamped, or taken from the other
+        // end for a looping track (whose last key repeats the first).
+        uint32_t before = segment ? segment - 1 : 0;
+        uint32_t after = std::min(segment + 2, n - 1);
+        if (options.loop_ && n > 2) {
+            if (!segment)
+                before = n - 2;
+            if (segment + 2 >= n)
+                after = 1;
+        }
+
+        for (size_t c = 0; c < components_; ++c) {
+            const float* values = &key_values_[c][first];
+            outputs[c][object] = catmull_rom(
+                values[before], values[segment], values[segment + 1], values[after], u);
+        }
+    }
+}
+
+size_t
+gfx::transform_animation_set::add_object() {
+    tx_.push_back(0.0f);
+    ty_.push_back(0.0f);
+    angle_.push_back(0.0f);
+    sx_.push_back(1.0f);
+    sy_.push_back(1.0f);
+    return tx_.size() - 1;
+}
+
+void
+gfx::transform_animation_set::set_translation_track(
+    size_t object,
+    const float* times,
+    const vector2* values,
+    size_t count,
+    const track_options& options
+    )
+{
+    assert(object < object_count());
+
+    std::vector<float> x(count);
+    std::vector<float> y(count);
+    for (size_t i = 0; i < count; ++i) {
+        x[i] = values[i].x_;
+        y[i] = values[i].y_;
+    }
+
+    translation_tracks_.set_track(
+        static_cast<uint32_t>(object), times, &x[0], &y[0], count, options);
+}
+
+void
+gfx::transform_animation_set::set_rotation_track(
+    size_t object,
+    const float* times,
+    const float* degrees,
+    size_t count,
+    const track_options& options
+    )
+{
+    assert(object < object_count());
+    rotation_tracks_.set_track(
+        static_cast<uint32_t>(object), times, degrees, nullptr, count, options);
+}
+
+void
+gfx::transform_animation_set::set_scale_track(
+    size_t object,
+    const float* times,
+    const vector2* values,
+    size_t count,
+    const track_options& options
+    )
+{
+    assert(object < object_count());
+
+    std::vector<float> x(count);
+    std::vector<float> y(count);
+    for (size_t i = 0; i < count; ++i) {
+        x[i] = values[i].x_;
+        y[i] = values[i].y_;
+    }
+
+    scale_tracks_.set_track(
+        static_cast<uint32_t>(object), times, &x[0], &y[0], count, options);
+}
+
+void
+gfx::transform_animation_set::evaluate(
+    float time,
+    matrix3X3* transforms
+    )
+{
+    assert(transforms);
+
+    const size_t n = object_count();
+    if (!n)
+        return;
+
+    ++stats_.evaluations_;
+
+    translation_tracks_.evaluate(time, &tx_[0], &ty_[0], &stats_);
+    rotation_tracks_.evaluate(time, &angle_[0], nullptr, &stats_);
+    scale_tracks_.evaluate(time, &sx_[0], &sy_[0], &stats_);
+
+    //
+    // translation * rotation * scale, written out.
+    for (size_t i = 0; i < n; ++i) {
+        const float radians = deg2rads(angle_[i]);
+        const float sin_theta = std::sin(radians);
+        const float cos_theta = std::cos(radians);
+
+        matrix3X3& m = transforms[i];
+        m.a11_ = cos_theta * sx_[i];
+        m.a12_ = -sin_theta * sy_[i];
+        m.a13_ = tx_[i];
+        m.a21_ = sin_theta * sx_[i];
+        m.a22_ = cos_theta * sy_[i];
+        m.a23_ = ty_[i];
+        m.a31_ = 0.0f;
+        m.a32_ = 0.0f;
+        m.a33_ = 1.0f;
+    }
+}
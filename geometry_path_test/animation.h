@@ -0,0 +1,187 @@
+/*
+ * animation.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_ANIMATION_H_
+#define GFX_ANIMATION_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "matrix3x3.h"
+#include "vector2.h"
+
+namespace gfx {
+
+enum interpolation_mode {
+    interpolation_linear,
+    //
+    // Catmull-Rom through the keys : passes through every key, with a
+    // continuous first derivative.
+    interpolation_cubic
+};
+
+/*
+ * Applied to the fraction of the time elapsed between two keys, before
+ * interpolating.
+ */
+enum easing_function {
+    easing_none,
+    easing_in_quad,
+    easing_out_quad,
+    easing_in_out_quad,
+    easing_in_out_cubic,
+    easing_smoothstep
+};
+
+float
+apply_easing(
+    easing_function easing,
+    float t
+    );
+
+struct track_options {
+    interpolation_mode  interpolation_;
+    easing_function     easing_;
+    //
+    // Looping tracks repeat over [first key time, last key time], the
+    // others hold their first and last values outside of it.
+    bool                loop_;
+
+    track_options(
+        interpolation_mode interpolation = interpolation_linear,
+        easing_function easing = easing_none,
+        bool loop = true
+        )
+        : interpolation_(interpolation), easing_(easing), loop_(loop) {}
+};
+
+struct animation_statistics {
+    uint64_t    evaluations_;
+    uint64_t    track_lookups_;
+    //
+    // Lookups answered without searching the keys (same, next or first
+    // segment, or a time outside the keys), the others needed a binary
+    // search.
+    uint64_t    cursor_hits_;
+
+    animation_statistics() {
+        reset();
+    }
+
+    void reset() {
+        evaluations_ = track_lookups_ = cursor_hits_ = 0;
+    }
+};
+
+/*
+ * Keyframed transforms for many objects. Each object can have a
+ * translation, a rotation (degrees) and a scale track, its transform is
+ * translation * rotation * scale, the same as composing
+ * matrix3X3::translation, rotation and scale.
+ *
+ * Tracks of the same kind are kept together, their keys in flat arrays,
+ * and evaluate() runs over each kind as a batch into per component
+ * arrays, then builds all the matrices in one pass. Every track remembers
+ * the segment used last time, so evaluating at increasing times finds
+ * the keys in constant time.
+ */
+class transform_animation_set {
+public :
+    transform_animation_set()
+        : translation_tracks_(2), rotation_tracks_(1), scale_tracks_(2) {}
+
+    /*
+     * Adds an object with no tracks (identity transform), returns its
+     * index.
+     */
+    size_t add_object();
+
+    size_t object_count() const {
+        return tx_.size();
+    }
+
+    /*
+     * Times must be increasing. Replaces the object's track of the same
+     * kind, if any. A looping cubic track should end on the value it
+     * starts with, the keys before the first and after the last are taken
+     * from the other end.
+     */
+    void set_translation_track(
+        size_t object, const float* times, const vector2* values, size_t count,
+        const track_options& options = track_options());
+
+    void set_rotation_track(
+        size_t object, const float* times, const float* degrees, size_t count,
+        const track_options& options = track_options());
+
+    void set_scale_track(
+        size_t object, const float* times, const vector2* values, size_t count,
+        const track_options& options = track_options());
+
+    /*
+     * Writes the transforms of all objects at the given time to
+     * transforms (object_count() elements).
+     */
+    void evaluate(float time, matrix3X3* transforms);
+
+    const animation_statistics& statistics() const {
+        return stats_;
+    }
+
+    void reset_statistics() {
+        stats_.reset();
+    }
+
+private :
+    /*
+     * The tracks of one kind, each with one or two components per key.
+     */
+    struct track_set {
+        size_t                      components_;
+        std::vector<float>          key_times_;
+        std::vector<float>          key_values_[2];
+        //
+        // Per track.
+        std::vector<uint32_t>       object_;
+        std::vector<uint32_t>       first_key_;
+        std::vector<uint32_t>       key_count_;
+        std::vector<uint32_t>       cursor_;
+        std::vector<track_options>  options_;
+        //
+        // Per object, the index of its track or C_NoTrack.
+        std::vector<uint32_t>       object_track_;
+
+        static const uint32_t C_NoTrack = 0xFFFFFFFF;
+
+        explicit track_set(size_t components) : components_(components) {}
+
+        void set_track(
+            uint32_t object, const float* times, const float* values0,
+            const float* values1, size_t count, const track_options& options);
+
+        void evaluate(
+            float time, float* output0, float* output1, animation_statistics* stats);
+    };
+
+    //
+    // Evaluated components, per object. Objects without a track of some
+    // kind keep the identity value for it.
+    std::vector<float>      tx_;
+    std::vector<float>      ty_;
+    std::vector<float>      angle_;
+    std::vector<float>      sx_;
+    std::vector<float>      sy_;
+
+    track_set               translation_tracks_;
+    track_set               rotation_tracks_;
+    track_set               scale_tracks_;
+    animation_statistics    stats_;
+};
+
+} // ns gfx
+
+#endif /* GFX_ANIMATION_H_ */
@@ -0,0 +1,319 @@
+/*
+ * bezier.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "bezier.h"
+
+#include <cmath>
+
+#include "pixel_ops.h"
+
+#if defined(GFX_HAVE_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+static_assert(sizeof(gfx::vector2) == 2 * sizeof(float),
+              "the batch kernels store vector2 as float pairs");
+
+const int C_ForwardDifferenceRestart = 64;
+
+inline
+gfx::vector2
+lerp(
+    const gfx::vector2& a,
+    const gfx::vector2& b,
+    float t
+    )
+{
+    return a + (b - a) * t;
+}
+
+/*
+ * Power basis coefficients, B(t) = a t^3 + b t^2 + c t + d, in double for
+ * the forward differences.
+ */
+struct power_basis {
+    double ax, ay, bx, by, cx, cy, dx, dy;
+
+    explicit power_basis(const gfx::cubic_bezier& curve) {
+        const double x0 = curve.p0_.x_, x1 = curve.p1_.x_, x2 = curve.p2_.x_, x3 = curve.p3_.x_;
+        const double y0 = curve.p0_.y_, y1 = curve.p1_.y_, y2 = curve.p2_.y_, y3 = curve.p3_.y_;
+        ax = x3 - x0 + 3.0 * (x1 - x2);
+        ay = y3 - y0 + 3.0 * (y1 - y2);
+        bx = 3.0 * (x0 - 2.0 * x1 + x2);
+        by = 3.0 * (y0 - 2.0 * y1 + y2);
+        cx = 3.0 * (x1 - x0);
+        cy = 3.0 * (y1 - y0);
+        dx = x0;
+        dy = y0;
+    }
+};
+
+#if defined(GFX_HAVE_SSE2)
+
+//
+// Stores 4 x and 4 y as 4 vector2.
+inline
+void
+store_points(
+    __m128 x,
+    __m128 y,
+    gfx::vector2* out
+    )
+{
+    float* dst = &out->x_;
+    _mm_storeu_ps(dst, _mm_unpacklo_ps(x, y));
+    _mm_storeu_ps(dst + 4, _mm_unpackhi_ps(x, y));
+}
+
+#endif
+
+} // anonymous namespace
+
+gfx::vector2
+gfx::cubic_bezier::tangent_at(
+    float t
+    ) const
+{
+    vector2 direction(derivative_at(t));
+    if (is_zero(direction.sum_components_squared())) {
+        //
+        // Degenerate at an end : the derivative's direction is the limit
+        // towards the next (or previous) distinct control point.
+        direction = t < 0.5f ? p2_ - p0_ : p3_ - p1_;
+        if (is_zero(direction.sum_components_squared()))
+            direction = p3_ - p0_;
+    }
+
+    return direction.normalize();
+}
+
+gfx::vector2
+gfx::de_casteljau(
+    const cubic_bezier& curve,
+    float t
+    )
+{
+    const vector2 a(lerp(curve.p0_, curve.p1_, t));
+    const vector2 b(lerp(curve.p1_, curve.p2_, t));
+    const vector2 c(lerp(curve.p2_, curve.p3_, t));
+    const vector2 ab(lerp(a, b, t));
+    const vector2 bc(lerp(b, c, t));
+    return lerp(ab, bc, t);
+}
+
+void
+gfx::evaluate_cubic(
+    const cubic_bezier& curve,
+    const float* t,
+    size_t count,
+    vector2* out
+    )
+{
+    assert(t && out);
+    size_t i = 0;
+
+#if defined(GFX_HAVE_SSE2)
+    const __m128 x0 = _mm_set1_ps(curve.p0_.x_), y0 = _mm_set1_ps(curve.p0_.y_);
+    const __m128 x1 = _mm_set1_ps(curve.p1_.x_), y1 = _mm_set1_ps(curve.p1_.y_);
+    const __m128 x2 = _mm_set1_ps(curve.p2_.x_), y2 = _mm_set1_ps(curve.p2_.y_);
+    const __m128 x3 = _mm_set1_ps(curve.p3_.x_), y3 = _mm_set1_ps(curve.p3_.y_);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 three = _mm_set1_ps(3.0f);
+
+    for (; i + 4 <= count; i += 4) {
+        const __m128 tt = _mm_loadu_ps(t + i);
+        const __m128 mt = _mm_sub_ps(one, tt);
+        const __m128 mt2 = _mm_mul_ps(mt, mt);
+        const __m128 t2 = _mm_mul_ps(tt, tt);
+
+        //
+        // Same products, in the same order, as point_at().
+        const __m128 b0 = _mm_mul_ps(mt2, mt);
+        const __m128 b1 = _mm_mul_ps(_mm_mul_ps(three, mt2), tt);
+        const __m128 b2 = _mm_mul_ps(_mm_mul_ps(three, mt), t2);
+        const __m128 b3 = _mm_mul_ps(t2, tt);
+
+        const __m128 x = _mm_add_ps(
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(b0, x0), _mm_mul_ps(b1, x1)), _mm_mul_ps(b2, x2)),
+            _mm_mul_ps(b3, x3));
+        const __m128 y = _mm_add_ps(
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(b0, y0), _mm_mul_ps(b1, y1)), _mm_mul_ps(b2, y2)),
+            _mm_mul_ps(b3, y3));
+        store_points(x, y, out + i);
+    }
+#endif
+
+    for (; i < count; ++i)
+        out[i] = curve.point_at(t[i]);
+}
+
+void
+gfx::evaluate_cubic_derivative(
+    const cubic_bezier& curve,
+    const float* t,
+    size_t count,
+    vector2* out
+    )
+{
+    assert(t && out);
+    size_t i = 0;
+
+#if defined(GFX_HAVE_SSE2)
+    //
+    // 3 (1 - t)^2 (p1 - p0) + 6 (1 - t) t (p2 - p1) + 3 t^2 (p3 - p2)
+    const vector2 d0(curve.p1_ - curve.p0_);
+    const vector2 d1(curve.p2_ - curve.p1_);
+    const vector2 d2(curve.p3_ - curve.p2_);
+    const __m128 x0 = _mm_set1_ps(d0.x_), y0 = _mm_set1_ps(d0.y_);
+    const __m128 x1 = _mm_set1_ps(d1.x_), y1 = _mm_set1_ps(d1.y_);
+    const __m128 x2 = _mm_set1_ps(d2.x_), y2 = _mm_set1_ps(d2.y_);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 three = _mm_set1_ps(3.0f);
+    const __m128 six = _mm_set1_ps(6.0f);
+
+    for (; i + 4 <= count; i += 4) {
+        const __m128 tt = _mm_loadu_ps(t + i);
+        const __m128 mt = _mm_sub_ps(one, tt);
+        const __m128 b0 = _mm_mul_ps(three, _mm_mul_ps(mt, mt));
+        const __m128 b1 = _mm_mul_ps(_mm_mul_ps(six, mt), tt);
+        const __m128 b2 = _mm_mul_ps(three, _mm_mul_ps(tt, tt));
+
+        const __m128 x = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(b0, x0), _mm_mul_ps(b1, x1)), _mm_mul_ps(b2, x2));
+        const __m128 y = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(b0, y0), _mm_mul_ps(b1, y1)), _mm_mul_ps(b2, y2));
+        store_points(x, y, out + i);
+    }
+#endif
+
+    for (; i < count; ++i)
+        out[i] = curve.derivative_at(t[i]);
+}
+
+void
+gfx::evaluate_cubics(
+    const cubic_bezier* curves,
+    size_t count,
+    float t,
+    vector2* out
+    )
+{
+    assert(curves && out);
+
+    const float mt = 1.0f - t;
+    const float b0 = mt * mt * mt;
+    const float b1 = 3.0f * mt * mt * t;
+    const float b2 = 3.0f * mt * t * t;
+    const float b3 = t * t * t;
+
+#if defined(GFX_HAVE_SSE2)
+    //
+    // A curve is 8 floats : (p0 p1) * (b0 b0 b1 b1) + (p2 p3) * (b2 b2 b3 b3)
+    // leaves the two halves of the sum to add.
+    const __m128 w01 = _mm_setr_ps(b0, b0, b1, b1);
+    const __m128 w23 = _mm_setr_ps(b2, b2, b3, b3);
+
+    for (size_t i = 0; i < count; ++i) {
+        const float* src = &curves[i].p0_.x_;
+        const __m128 sum = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(src), w01),
+                                      _mm_mul_ps(_mm_loadu_ps(src + 4), w23));
+        _mm_storel_pi(reinterpret_cast<__m64*>(&out[i].x_),
+                      _mm_add_ps(sum, _mm_movehl_ps(sum, sum)));
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        const cubic_bezier& c = curves[i];
+        out[i] = vector2(b0 * c.p0_.x_ + b1 * c.p1_.x_ + b2 * c.p2_.x_ + b3 * c.p3_.x_,
+                         b0 * c.p0_.y_ + b1 * c.p1_.y_ + b2 * c.p2_.y_ + b3 * c.p3_.y_);
+    }
+#endif
+}
+
+int
+gfx::cubic_uniform_step_count(
+    const cubic_bezier& curve,
+    float tolerance
+    )
+{
+    assert(tolerance > 0.0f);
+
+    const float dd = std::max(
+        (curve.p0_ - 2.0f * curve.p1_ + curve.p2_).magnitude(),
+        (curve.p1_ - 2.0f * curve.p2_ + curve.p3_).magnitude());
+    const float n = std::sqrt(0.75f * dd / tolerance);
+    return std::max(1, std::min(static_cast<int>(std::ceil(n)), 1 << 16));
+}
+
+void
+gfx::forward_difference_cubic(
+    const cubic_bezier& curve,
+    int steps,
+    vector2* out
+    )
+{
+    assert(steps > 0 && out);
+
+    const power_basis pb(curve);
+    const double h = 1.0 / steps;
+    const double h2 = h * h;
+    const double h3 = h2 * h;
+
+    //
+    // Third differences are constant.
+    const double dddx = 6.0 * pb.ax * h3;
+    const double dddy = 6.0 * pb.ay * h3;
+
+    double fx = 0.0, fy = 0.0, dfx = 0.0, dfy = 0.0, ddfx = 0.0, ddfy = 0.0;
+
+    for (int i = 0; i <= steps; ++i) {
+        if (i % C_ForwardDifferenceRestart == 0) {
+            //
+            // Value, first and second difference at t, from the polynomial.
+            const double t = i * h;
+            fx = ((pb.ax * t + pb.bx) * t + pb.cx) * t + pb.dx;
+            fy = ((pb.ay * t + pb.by) * t + pb.cy) * t + pb.dy;
+            dfx = pb.ax * (3.0 * t * t * h + 3.0 * t * h2 + h3) + pb.bx * (2.0 * t * h + h2) + pb.cx * h;
+            dfy = pb.ay * (3.0 * t * t * h + 3.0 * t * h2 + h3) + pb.by * (2.0 * t * h + h2) + pb.cy * h;
+            ddfx = 6.0 * pb.ax * h2 * (t + h) + 2.0 * pb.bx * h2;
+            ddfy = 6.0 * pb.ay * h2 * (t + h) + 2.0 * pb.by * h2;
+        }
+
+        out[i] = vector2(static_cast<float>(fx), static_cast<float>(fy));
+
+        fx += dfx;
+        fy += dfy;
+        dfx += ddfx;
+        dfy += ddfy;
+        ddfx += dddx;
+        ddfy += dddy;
+    }
+
+    //
+    // The end point exactly.
+    out[steps] = curve.p3_;
+}
+
+void
+gfx::flatten_cubic_uniform(
+    const cubic_bezier& curve,
+    float tolerance,
+    std::vector<vector2>* points
+    )
+{
+    assert(points);
+
+    const int steps = cubic_uniform_step_count(curve, tolerance);
+    const size_t first = points->size();
+    points->resize(first + steps + 1);
+    forward_difference_cubic(curve, steps, &(*points)[first]);
+
+    //
+    // Drop the start point, the previous segment ended there.
+    points->erase(points->begin() + first);
+}
@@ -0,0 +1,137 @@
+/*
+ * bezier.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_BEZIER_H_
+#define GFX_BEZIER_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "vector2.h"
+
+namespace gfx {
+
+/*
+ * Cubic Bezier curve, p0_ and p3_ are the end points.
+ */
+struct cubic_bezier {
+    vector2 p0_;
+    vector2 p1_;
+    vector2 p2_;
+    vector2 p3_;
+
+    cubic_bezier() {}
+
+    cubic_bezier(const vector2& p0, const vector2& p1, const vector2& p2, const vector2& p3)
+        : p0_(p0), p1_(p1), p2_(p2), p3_(p3) {}
+
+    /*
+     * Power basis evaluation, the fast path.
+     */
+    vector2 point_at(float t) const {
+        const float mt = 1.0f - t;
+        return (mt * mt * mt) * p0_ + (3.0f * mt * mt * t) * p1_ +
+            (3.0f * mt * t * t) * p2_ + (t * t * t) * p3_;
+    }
+
+    /*
+     * First derivative (the velocity along the curve).
+     */
+    vector2 derivative_at(float t) const {
+        const float mt = 1.0f - t;
+        return (3.0f * mt * mt) * (p1_ - p0_) + (6.0f * mt * t) * (p2_ - p1_) +
+            (3.0f * t * t) * (p3_ - p2_);
+    }
+
+    /*
+     * Unit tangent. Where the derivative vanishes (a control point on an
+     * end point), the direction to the next distinct control point.
+     */
+    vector2 tangent_at(float t) const;
+};
+
+/*
+ * Repeated linear interpolation : slower, numerically the most stable,
+ * the reference the other evaluations are checked against.
+ */
+vector2
+de_casteljau(
+    const cubic_bezier& curve,
+    float t
+    );
+
+/*
+ * Evaluates one curve at count parameter values : out[i] = point at t[i].
+ */
+void
+evaluate_cubic(
+    const cubic_bezier& curve,
+    const float* t,
+    size_t count,
+    vector2* out
+    );
+
+/*
+ * Same, for the derivative.
+ */
+void
+evaluate_cubic_derivative(
+    const cubic_bezier& curve,
+    const float* t,
+    size_t count,
+    vector2* out
+    );
+
+/*
+ * Evaluates count curves at the same parameter : out[i] = point of
+ * curves[i] at t.
+ */
+void
+evaluate_cubics(
+    const cubic_bezier* curves,
+    size_t count,
+    float t,
+    vector2* out
+    );
+
+/*
+ * Number of uniform steps in t keeping the polyline through the points
+ * within tolerance of the curve (Wang's formula).
+ */
+int
+cubic_uniform_step_count(
+    const cubic_bezier& curve,
+    float tolerance
+    );
+
+/*
+ * Points at t = i / steps, i = 0 .. steps (steps + 1 points), by forward
+ * differencing : three additions per point. The differences are
+ * accumulated in double and restarted from an exact evaluation every 64
+ * steps, so the error stays at float rounding whatever the step count.
+ */
+void
+forward_difference_cubic(
+    const cubic_bezier& curve,
+    int steps,
+    vector2* out
+    );
+
+/*
+ * Appends the points of the polyline approximating the curve within
+ * tolerance, without the start point (as when flattening a path).
+ */
+void
+flatten_cubic_uniform(
+    const cubic_bezier& curve,
+    float tolerance,
+    std::vector<vector2>* points
+    );
+
+} // ns gfx
+
+#endif /* GFX_BEZIER_H_ */
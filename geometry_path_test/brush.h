@@ -0,0 +1,61 @@
+/*
+ * brush.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_BRUSH_H_
+#define GFX_BRUSH_H_
+
+#include "color.h"
+
+namespace gfx {
+
+enum brush_type {
+    brush_type_solid_color,
+    brush_type_linear_gradient,
+    brush_type_radial_gradient
+};
+
+/*
+ * Brushes are plain, device independent objects. Each render_target
+ * implementation maps them to whatever its device needs.
+ */
+class brush {
+public :
+    virtual ~brush() {}
+
+    brush_type type() const {
+        return type_;
+    }
+
+protected :
+    explicit brush(brush_type type) : type_(type) {}
+
+private :
+    brush_type  type_;
+};
+
+class solid_color_brush : public brush {
+public :
+    solid_color_brush() : brush(brush_type_solid_color), color_(0.0f, 0.0f, 0.0f, 1.0f) {}
+
+    explicit solid_color_brush(const color& clr)
+        : brush(brush_type_solid_color), color_(clr) {}
+
+    void set_color(const color& clr) {
+        color_ = clr;
+    }
+
+    const color& get_color() const {
+        return color_;
+    }
+
+private :
+    color   color_;
+};
+
+} // ns gfx
+
+#endif /* GFX_BRUSH_H_ */
@@ -0,0 +1,535 @@
+/*
+ * collision.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "collision.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+
+const size_t C_MaxInsertionSortBodies = 64;
+
+inline
+float
+cross(
+    const gfx::vector2& lhs,
+    const gfx::vector2& rhs
+    )
+{
+    return lhs.x_ * rhs.y_ - lhs.y_ * rhs.x_;
+}
+
+float
+signed_area(
+    const gfx::vector2* points,
+    size_t count
+    )
+{
+    float area = 0.0f;
+    for (size_t i = 0, j = count - 1; i < count; j = i++)
+        area += cross(points[j], points[i]);
+    return area * 0.5f;
+}
+
+//
+// True if pt is strictly inside the triangle (a, b, c), orientation
+// given by sign.
+bool
+point_in_triangle(
+    const gfx::vector2& pt,
+    const gfx::vector2& a,
+    const gfx::vector2& b,
+    const gfx::vector2& c,
+    float sign
+    )
+{
+    return cross(b - a, pt - a) * sign > 0.0f &&
+        cross(c - b, pt - b) * sign > 0.0f &&
+        cross(a - c, pt - c) * sign > 0.0f;
+}
+
+/*
+ * Ear clipping, O(n^2), fine for the few hundred points of a flattened
+ * shape. Degenerate (collinear) vertices are dropped as they come up.
+ */
+void
+triangulate(
+    const gfx::vector2* points,
+    size_t count,
+    gfx::collision_shape* shape
+    )
+{
+    if (count < 3)
+        return;
+
+    const float area = signed_area(points, count);
+    if (gfx::is_zero(area))
+        return;
+    const float sign = area > 0.0f ? 1.0f : -1.0f;
+
+    std::vector<uint32_t> polygon(count);
+    for (size_t i = 0; i < count; ++i)
+        polygon[i] = static_cast<uint32_t>(i);
+
+    while (polygon.size() > 3) {
+        const size_t n = polygon.size();
+        size_t ear = n;
+        size_t flattest = 0;
+        float flattest_cross = FLT_MAX;
+
+        for (size_t i = 0; i < n && ear == n; ++i) {
+            const gfx::vector2& a = points[polygon[(i + n - 1) % n]];
+            const gfx::vector2& b = points[polygon[i]];
+            const gfx::vector2& c = points[polygon[(i + 1) % n]];
+            const float turn = cross(b - a, c - b) * sign;
+
+            if (std::fabs(turn) < flattest_cross) {
+                flattest_cross = std::fabs(turn);
+                flattest = i;
+            }
+
+            if (turn <= gfx::EPSILON)
+                continue;
+
+            bool contains_vertex = false;
+            for (size_t j = 0; j < n && !contains_vertex; ++j) {
+                if (j == i || j == (i + n - 1) % n || j == (i + 1) % n)
+                    continue;
+                contains_vertex = point_in_triangle(points[polygon[j]], a, b, c, sign);
+            }
+
+            if (!contains_vertex)
+                ear = i;
+        }
+
+        if (ear == n) {
+            //
+            // No ear : self intersecting or degenerate input, drop the
+            // flattest vertex and carry on.
+            polygon.erase(polygon.begin() + flattest);
+            continue;
+        }
+
+        const gfx::vector2 triangle[] = {
+            points[polygon[(ear + n - 1) % n]], points[polygon[ear]], points[polygon[(ear + 1) % n]]
+        };
+        shape->add_piece(triangle, 3);
+        polygon.erase(polygon.begin() + ear);
+    }
+
+    const gfx::vector2 triangle[] = {
+        points[polygon[0]], points[polygon[1]], points[polygon[2]]
+    };
+    if (!gfx::is_zero(signed_area(triangle, 3)))
+        shape->add_piece(triangle, 3);
+}
+
+inline
+void
+project(
+    const gfx::vector2* points,
+    size_t count,
+    const gfx::vector2& axis,
+    float* min_proj,
+    float* max_proj
+    )
+{
+    float lo = FLT_MAX;
+    float hi = -FLT_MAX;
+    for (size_t i = 0; i < count; ++i) {
+        const float d = points[i].x_ * axis.x_ + points[i].y_ * axis.y_;
+        lo = std::min(lo, d);
+        hi = std::max(hi, d);
+    }
+    *min_proj = lo;
+    *max_proj = hi;
+}
+
+/*
+ * Separating axis test for two convex polygons. On overlap returns the
+ * axis of least penetration (unit length, not yet oriented) and the
+ * penetration depth along it.
+ */
+bool
+separating_axis_test(
+    const gfx::vector2* a,
+    size_t count_a,
+    const gfx::vector2* b,
+    size_t count_b,
+    gfx::vector2* axis,
+    float* depth
+    )
+{
+    float best_depth = FLT_MAX;
+    gfx::vector2 best_axis(1.0f, 0.0f);
+
+    for (int polygon = 0; polygon < 2; ++polygon) {
+        const gfx::vector2* points = polygon ? b : a;
+        const size_t count = polygon ? count_b : count_a;
+
+        for (size_t i = 0, j = count - 1; i < count; j = i++) {
+            const gfx::vector2 edge(points[i] - points[j]);
+            const float length = std::sqrt(edge.x_ * edge.x_ + edge.y_ * edge.y_);
+            if (gfx::is_zero(length))
+                continue;
+
+            const gfx::vector2 normal(-edge.y_ / length, edge.x_ / length);
+            float min_a, max_a, min_b, max_b;
+            project(a, count_a, normal, &min_a, &max_a);
+            project(b, count_b, normal, &min_b, &max_b);
+
+            const float overlap = std::min(max_a, max_b) - std::max(min_a, min_b);
+            if (overlap <= 0.0f)
+                return false;
+
+            if (overlap < best_depth) {
+                best_depth = overlap;
+                best_axis = normal;
+            }
+        }
+    }
+
+    *axis = best_axis;
+    *depth = best_depth;
+    return true;
+}
+
+gfx::vector2
+centroid(
+    const gfx::vector2* points,
+    size_t count
+    )
+{
+    gfx::vector2 sum(0.0f, 0.0f);
+    for (size_t i = 0; i < count; ++i)
+        sum += points[i];
+    return sum / static_cast<float>(count);
+}
+
+} // anonymous namespace
+
+void
+gfx::collision_shape::clear() {
+    points_.clear();
+    piece_ends_.clear();
+    bounds_ = rectangle(0.0f, 0.0f, 0.0f, 0.0f);
+}
+
+void
+gfx::collision_shape::add_piece(
+    const vector2* points,
+    size_t count
+    )
+{
+    assert(points && count >= 3);
+
+    if (points_.empty())
+        bounds_ = rectangle(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+    for (size_t i = 0; i < count; ++i) {
+        points_.push_back(points[i]);
+        bounds_.add_point(points[i]);
+    }
+    piece_ends_.push_back(static_cast<uint32_t>(points_.size()));
+}
+
+void
+gfx::collision_shape::set_box(
+    float half_width,
+    float half_height
+    )
+{
+    clear();
+    const vector2 corners[] = {
+        vector2(-half_width, -half_height), vector2(half_width, -half_height),
+        vector2(half_width, half_height), vector2(-half_width, half_height)
+    };
+    add_piece(corners, 4);
+}
+
+bool
+gfx::collision_shape::set_geometry(
+    const path_geometry& geometry,
+    float tolerance
+    )
+{
+    clear();
+
+    flattened_path flattened;
+    geometry.flatten(matrix3X3::identity, tolerance, &flattened);
+
+    for (size_t figure = 0; figure < flattened.figure_count(); ++figure) {
+        const size_t first = flattened.figure_begin(figure);
+        const size_t last = flattened.figure_ends_[figure];
+
+        //
+        // Closed figures may repeat the first point at the end.
+        size_t count = last - first;
+        if (count > 1 && flattened.points_[first] == flattened.points_[last - 1])
+            --count;
+        triangulate(&flattened.points_[first], count, this);
+    }
+
+    return !piece_ends_.empty();
+}
+
+uint32_t
+gfx::collision_world::add_body(
+    const collision_shape* shape,
+    const matrix3X3& xform
+    )
+{
+    assert(shape);
+
+    const uint32_t index = static_cast<uint32_t>(bodies_.size());
+    bodies_.push_back(body(shape, xform));
+
+    min_x_.push_back(0.0f);
+    min_y_.push_back(0.0f);
+    max_x_.push_back(0.0f);
+    max_y_.push_back(0.0f);
+    update_bounds(index);
+
+    //
+    // Appended at the end of the sweep order, the next sort moves it in
+    // place.
+    sweep_order_.push_back(index);
+    ++unsorted_bodies_;
+    return index;
+}
+
+void
+gfx::collision_world::set_transform(
+    uint32_t index,
+    const matrix3X3& xform
+    )
+{
+    assert(index < bodies_.size());
+    bodies_[index].transform_ = xform;
+    bodies_[index].world_points_valid_ = false;
+    update_bounds(index);
+}
+
+void
+gfx::collision_world::update_bounds(
+    uint32_t index
+    )
+{
+    //
+    // The transformed corners of the local bounds, conservative and cheap.
+    const body& b = bodies_[index];
+    const rectangle& local = b.shape_->bounds_;
+    const vector2 corners[] = {
+        b.transform_ * vector2(local.left_, local.top_),
+        b.transform_ * vector2(local.right_, local.top_),
+        b.transform_ * vector2(local.right_, local.bottom_),
+        b.transform_ * vector2(local.left_, local.bottom_)
+    };
+
+    rectangle world(corners[0].x_, corners[0].y_, corners[0].x_, corners[0].y_);
+    for (int i = 1; i < 4; ++i)
+        world.add_point(corners[i]);
+
+    min_x_[index] = world.left_;
+    min_y_[index] = world.top_;
+    max_x_[index] = world.right_;
+    max_y_[index] = world.bottom_;
+}
+
+void
+gfx::collision_world::sort_sweep_order() {
+    //
+    // Bodies added since the last update are at the end, in no particular
+    // order : a full sort for those (the insertion sort would be quadratic).
+    if (unsorted_bodies_ > C_MaxInsertionSortBodies) {
+        const std::vector<float>& min_x = min_x_;
+        std::sort(sweep_order_.begin(), sweep_order_.end(),
+                  [&min_x](uint32_t lhs, uint32_t rhs) { return min_x[lhs] < min_x[rhs]; });
+        unsorted_bodies_ = 0;
+        return;
+    }
+
+    unsorted_bodies_ = 0;
+
+    //
+    // Insertion sort on min x : linear when the order barely changed since
+    // the last update.
+    for (size_t i = 1; i < sweep_order_.size(); ++i) {
+        const uint32_t index = sweep_order_[i];
+        const float key = min_x_[index];
+
+        size_t j = i;
+        while (j > 0 && min_x_[sweep_order_[j - 1]] > key) {
+            sweep_order_[j] = sweep_order_[j - 1];
+            --j;
+        }
+
+        sweep_order_[j] = index;
+        stats_.sort_swaps_ += i - j;
+    }
+}
+
+void
+gfx::collision_world::gather_sweep_bounds() {
+    const size_t count = sweep_order_.size();
+    sweep_min_x_.resize(count);
+    sweep_min_y_.resize(count);
+    sweep_max_x_.resize(count);
+    sweep_max_y_.resize(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t index = sweep_order_[i];
+        sweep_min_x_[i] = min_x_[index];
+        sweep_min_y_[i] = min_y_[index];
+        sweep_max_x_[i] = max_x_[index];
+        sweep_max_y_[i] = max_y_[index];
+    }
+}
+
+void
+gfx::collision_world::update_world_points(
+    uint32_t index
+    )
+{
+    body& b = bodies_[index];
+    if (b.world_points_valid_)
+        return;
+
+    const collision_shape& shape = *b.shape_;
+    b.world_points_.resize(shape.points_.size());
+    for (size_t i = 0; i < shape.points_.size(); ++i)
+        b.world_points_[i] = b.transform_ * shape.points_[i];
+
+    b.world_piece_bounds_.resize(shape.piece_count());
+    for (size_t piece = 0; piece < shape.piece_count(); ++piece) {
+        const vector2* points = &b.world_points_[shape.piece_begin(piece)];
+        const size_t count = shape.piece_ends_[piece] - shape.piece_begin(piece);
+
+        rectangle bounds(points[0].x_, points[0].y_, points[0].x_, points[0].y_);
+        for (size_t i = 1; i < count; ++i)
+            bounds.add_point(points[i]);
+        b.world_piece_bounds_[piece] = bounds;
+    }
+
+    b.world_points_valid_ = true;
+}
+
+bool
+gfx::collision_world::narrowphase(
+    uint32_t first,
+    uint32_t second,
+    contact_pair* contact
+    )
+{
+    update_world_points(first);
+    update_world_points(second);
+
+    const body& a = bodies_[first];
+    const body& b = bodies_[second];
+    const rectangle bounds_a(world_bounds(first));
+    const rectangle bounds_b(world_bounds(second));
+
+    //
+    // The deepest overlap among all the piece pairs.
+    bool overlap = false;
+    float best_depth = -1.0f;
+    vector2 best_axis;
+    const vector2* best_a = nullptr;
+    const vector2* best_b = nullptr;
+    size_t best_count_a = 0;
+    size_t best_count_b = 0;
+
+    for (size_t pa = 0; pa < a.shape_->piece_count(); ++pa) {
+        const rectangle& piece_bounds_a = a.world_piece_bounds_[pa];
+        if (!rectangles_intersect(piece_bounds_a, bounds_b))
+            continue;
+
+        const vector2* points_a = &a.world_points_[a.shape_->piece_begin(pa)];
+        const size_t count_a = a.shape_->piece_ends_[pa] - a.shape_->piece_begin(pa);
+
+        for (size_t pb = 0; pb < b.shape_->piece_count(); ++pb) {
+            const rectangle& piece_bounds_b = b.world_piece_bounds_[pb];
+            if (!rectangles_intersect(piece_bounds_a, piece_bounds_b) ||
+                !rectangles_intersect(piece_bounds_b, bounds_a))
+                continue;
+
+            const vector2* points_b = &b.world_points_[b.shape_->piece_begin(pb)];
+            const size_t count_b = b.shape_->piece_ends_[pb] - b.shape_->piece_begin(pb);
+
+            ++stats_.piece_tests_;
+            vector2 axis;
+            float depth;
+            if (separating_axis_test(points_a, count_a, points_b, count_b, &axis, &depth) &&
+                depth > best_depth) {
+                overlap = true;
+                best_depth = depth;
+                best_axis = axis;
+                best_a = points_a;
+                best_b = points_b;
+                best_count_a = count_a;
+                best_count_b = count_b;
+            }
+        }
+    }
+
+    if (!overlap)
+        return false;
+
+    //
+    // Orient the normal from the first piece towards the second.
+    const vector2 direction(centroid(best_b, best_count_b) - centroid(best_a, best_count_a));
+    if (dot_product(direction, best_axis) < 0.0f)
+        best_axis = -best_axis;
+
+    contact->first_ = first;
+    contact->second_ = second;
+    contact->normal_ = best_axis;
+    contact->depth_ = best_depth;
+    return true;
+}
+
+void
+gfx::collision_world::update(
+    std::vector<contact_pair>* contacts
+    )
+{
+    assert(contacts);
+    contacts->clear();
+    ++stats_.updates_;
+
+    sort_sweep_order();
+    gather_sweep_bounds();
+
+    const size_t count = sweep_order_.size();
+    for (size_t i = 0; i < count; ++i) {
+        const float max_x = sweep_max_x_[i];
+        const float min_y = sweep_min_y_[i];
+        const float max_y = sweep_max_y_[i];
+
+        //
+        // Every body starting before this one ends overlaps it on x.
+        // The y test is evaluated without short circuit : it fails for most
+        // of the candidates, in no predictable pattern.
+        for (size_t j = i + 1; j < count && sweep_min_x_[j] <= max_x; ++j) {
+            const bool overlap_y = (sweep_min_y_[j] <= max_y) & (sweep_max_y_[j] >= min_y);
+            if (!overlap_y)
+                continue;
+
+            ++stats_.broadphase_pairs_;
+
+            const uint32_t first = sweep_order_[i];
+            const uint32_t second = sweep_order_[j];
+            contact_pair contact;
+            if (narrowphase(std::min(first, second), std::max(first, second), &contact)) {
+                contacts->push_back(contact);
+                ++stats_.contacts_;
+            }
+        }
+    }
+}
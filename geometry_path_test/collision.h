@@ -0,0 +1,183 @@
+/*
+ * collision.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_COLLISION_H_
+#define GFX_COLLISION_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "matrix3x3.h"
+#include "path_geometry.h"
+#include "rectangle.h"
+#include "vector2.h"
+
+namespace gfx {
+
+/*
+ * A shape as a set of convex pieces, in its own (local) space. Pieces are
+ * runs of points in points_, piece_ends_ holds one past the last point of
+ * each piece.
+ */
+class collision_shape {
+public :
+    std::vector<vector2>    points_;
+    std::vector<uint32_t>   piece_ends_;
+    rectangle               bounds_;
+
+    collision_shape() : bounds_(0.0f, 0.0f, 0.0f, 0.0f) {}
+
+    size_t piece_count() const {
+        return piece_ends_.size();
+    }
+
+    uint32_t piece_begin(size_t piece) const {
+        return piece ? piece_ends_[piece - 1] : 0;
+    }
+
+    void clear();
+
+    /*
+     * Adds a convex polygon as a piece.
+     */
+    void add_piece(const vector2* points, size_t count);
+
+    /*
+     * Axis aligned box centred on the origin.
+     */
+    void set_box(float half_width, float half_height);
+
+    /*
+     * Flattens the geometry and splits every figure into triangles (ear
+     * clipping), each triangle becoming a convex piece. Figures are taken
+     * as simple polygons; holes are not subtracted.
+     */
+    bool set_geometry(const path_geometry& geometry, float tolerance);
+};
+
+/*
+ * Two bodies whose shapes overlap. The normal points from first_ to
+ * second_; moving second_ by normal_ * depth_ separates them.
+ */
+struct contact_pair {
+    uint32_t    first_;
+    uint32_t    second_;
+    vector2     normal_;
+    float       depth_;
+};
+
+struct collision_statistics {
+    uint64_t    updates_;
+    //
+    // Swaps done by the incremental sort of the sweep axis, low when the
+    // bodies move little between updates.
+    uint64_t    sort_swaps_;
+    //
+    // Pairs whose world bounds overlap.
+    uint64_t    broadphase_pairs_;
+    //
+    // Convex piece pairs tested with the separating axis test.
+    uint64_t    piece_tests_;
+    uint64_t    contacts_;
+
+    collision_statistics() {
+        reset();
+    }
+
+    void reset() {
+        updates_ = sort_swaps_ = broadphase_pairs_ = piece_tests_ = contacts_ = 0;
+    }
+};
+
+/*
+ * Bodies are a shape and a transform. update() finds the overlapping
+ * pairs in two phases :
+ *  - broadphase : sweep and prune along x over the world bounds. The
+ *    sweep order is kept from one update to the next and fixed with an
+ *    insertion sort, which is close to linear for coherent motion.
+ *  - narrowphase : separating axis test between the convex pieces of the
+ *    two shapes, in world space.
+ *
+ * Shapes are referenced, they must outlive the bodies using them.
+ */
+class collision_world {
+public :
+    collision_world() : unsorted_bodies_(0) {}
+
+    uint32_t add_body(const collision_shape* shape, const matrix3X3& xform);
+
+    void set_transform(uint32_t body, const matrix3X3& xform);
+
+    size_t body_count() const {
+        return bodies_.size();
+    }
+
+    rectangle world_bounds(uint32_t body) const {
+        return rectangle(min_x_[body], min_y_[body], max_x_[body], max_y_[body]);
+    }
+
+    /*
+     * Replaces contacts with the pairs overlapping at the current
+     * transforms, each pair reported once, first_ < second_.
+     */
+    void update(std::vector<contact_pair>* contacts);
+
+    const collision_statistics& statistics() const {
+        return stats_;
+    }
+
+    void reset_statistics() {
+        stats_.reset();
+    }
+
+private :
+    struct body {
+        body(const collision_shape* shape, const matrix3X3& xform)
+            : shape_(shape), transform_(xform), world_points_valid_(false) {}
+
+        const collision_shape*  shape_;
+        matrix3X3               transform_;
+        //
+        // World space points and piece bounds of the shape, computed when
+        // the body first shows up in a broadphase pair after it moved.
+        std::vector<vector2>    world_points_;
+        std::vector<rectangle>  world_piece_bounds_;
+        bool                    world_points_valid_;
+    };
+
+    void update_bounds(uint32_t index);
+
+    void sort_sweep_order();
+
+    void gather_sweep_bounds();
+
+    void update_world_points(uint32_t index);
+
+    bool narrowphase(uint32_t first, uint32_t second, contact_pair* contact);
+
+    std::vector<body>       bodies_;
+    //
+    // World bounds, one array per side, indexed by body.
+    std::vector<float>      min_x_;
+    std::vector<float>      min_y_;
+    std::vector<float>      max_x_;
+    std::vector<float>      max_y_;
+    std::vector<uint32_t>   sweep_order_;
+    size_t                  unsorted_bodies_;
+    //
+    // The bounds again, in sweep order : the sweep walks them front to
+    // back instead of jumping around the per body arrays.
+    std::vector<float>      sweep_min_x_;
+    std::vector<float>      sweep_min_y_;
+    std::vector<float>      sweep_max_x_;
+    std::vector<float>      sweep_max_y_;
+    collision_statistics    stats_;
+};
+
+} // ns gfx
+
+#endif /* GFX_COLLISION_H_ */
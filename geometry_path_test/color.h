@@ -0,0 +1,93 @@
+/*
+ * color.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_COLOR_H_
+#define GFX_COLOR_H_
+
+#include <cstdint>
+
+#if defined(D2D_SUPPORT__)
+#include <d2d1.h>
+#endif
+
+#include "gfx_misc.h"
+
+namespace gfx {
+
+/*
+ * Straight (not premultiplied) RGBA colour, components in [0, 1].
+ */
+class color {
+public :
+    float r_;
+    float g_;
+    float b_;
+    float a_;
+
+    color() {}
+
+    color(float r, float g, float b, float a = 1.0f)
+        : r_(r), g_(g), b_(b), a_(a) {}
+
+    /*
+     * From a 0xRRGGBB value, same as the D2D1::ColorF(UINT32, FLOAT)
+     * constructor, so the D2D1::ColorF::Enum values can be used.
+     */
+    explicit color(uint32_t rgb, float a = 1.0f)
+        : r_(static_cast<float>((rgb >> 16) & 0xFF) / 255.0f),
+          g_(static_cast<float>((rgb >> 8) & 0xFF) / 255.0f),
+          b_(static_cast<float>(rgb & 0xFF) / 255.0f),
+          a_(a) {}
+
+#if defined(D2D_SUPPORT__)
+    color(const D2D1_COLOR_F& d2c) : r_(d2c.r), g_(d2c.g), b_(d2c.b), a_(d2c.a) {}
+
+    operator D2D1_COLOR_F() const {
+        return D2D1::ColorF(r_, g_, b_, a_);
+    }
+#endif
+
+    bool is_opaque() const {
+        return a_ >= 1.0f;
+    }
+};
+
+inline
+bool
+operator==(const color& lhs, const color& rhs) {
+    return lhs.r_ == rhs.r_ && lhs.g_ == rhs.g_ &&
+        lhs.b_ == rhs.b_ && lhs.a_ == rhs.a_;
+}
+
+inline
+bool
+operator!=(const color& lhs, const color& rhs) {
+    return !(lhs == rhs);
+}
+
+/*
+ * Packs a colour as a premultiplied RGBA8 pixel, R in the lowest byte, so
+ * that on little endian machines the bytes in memory are R, G, B, A
+ * (DXGI_FORMAT_R8G8B8A8_UNORM).
+ */
+inline
+uint32_t
+pack_premultiplied_rgba8(
+    const color& clr
+    )
+{
+    const float a = clamp(clr.a_, 0.0f, 1.0f);
+    const uint32_t r = static_cast<uint32_t>(clamp(clr.r_, 0.0f, 1.0f) * a * 255.0f + 0.5f);
+    const uint32_t g = static_cast<uint32_t>(clamp(clr.g_, 0.0f, 1.0f) * a * 255.0f + 0.5f);
+    const uint32_t b = static_cast<uint32_t>(clamp(clr.b_, 0.0f, 1.0f) * a * 255.0f + 0.5f);
+    const uint32_t alpha = static_cast<uint32_t>(a * 255.0f + 0.5f);
+    return r | (g << 8) | (b << 16) | (alpha << 24);
+}
+
+} // ns gfx
+
+#endif /* GFX_COLOR_H_ */
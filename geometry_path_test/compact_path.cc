@@ -0,0 +1,61 @@
+/*
+ * compact_path.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "compact_path.h"
+
+#include <cfloat>
+
+void
+gfx::compact_path::transform(
+    const matrix3X3& xform
+    )
+{
+    //
+    // Affine, the bottom row is not used.
+    const float a11 = xform.a11_;
+    const float a12 = xform.a12_;
+    const float a13 = xform.a13_;
+    const float a21 = xform.a21_;
+    const float a22 = xform.a22_;
+    const float a23 = xform.a23_;
+
+    for (size_t i = 0; i < points_.size(); ++i) {
+        const float x = points_[i].x_;
+        const float y = points_[i].y_;
+        points_[i].x_ = a11 * x + a12 * y + a13;
+        points_[i].y_ = a21 * x + a22 * y + a23;
+    }
+}
+
+gfx::rectangle
+gfx::compact_path::control_bounds() const {
+    rectangle bounds(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (size_t i = 0; i < points_.size(); ++i)
+        bounds.add_point(points_[i]);
+    return bounds;
+}
+
+const float gfx::compact_path_builder::C_DefaultArcTolerance = 0.01f;
+
+void
+gfx::compact_path_builder::add_arc(
+    const arc_segment& arc
+    )
+{
+    arc_cubics_.clear();
+    const bool converted = arc_cache_ ?
+        arc_cache_->append_cubics(current_point_, arc, arc_tolerance_, &arc_cubics_) :
+        arc_to_cubics(current_point_, arc, arc_tolerance_, &arc_cubics_);
+
+    if (!converted) {
+        add_line(arc.point_);
+        return;
+    }
+
+    for (size_t i = 0; i < arc_cubics_.size(); ++i)
+        add_bezier(arc_cubics_[i]);
+}
@@ -0,0 +1,226 @@
+/*
+ * compact_path.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_COMPACT_PATH_H_
+#define GFX_COMPACT_PATH_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "elliptic_arc.h"
+#include "matrix3x3.h"
+#include "path_geometry.h"
+#include "path_sink.h"
+#include "rectangle.h"
+#include "vector2.h"
+
+namespace gfx {
+
+/*
+ * Every verb uses the next path_verb_point_count() points of the path.
+ */
+enum path_verb {
+    path_verb_begin_filled,
+    path_verb_begin_hollow,
+    path_verb_line,
+    path_verb_quadratic,
+    path_verb_cubic,
+    path_verb_end_open,
+    path_verb_end_closed
+};
+
+inline
+int
+path_verb_point_count(
+    path_verb verb
+    )
+{
+    static const int C_PointCounts[] = { 1, 1, 1, 2, 3, 0, 0 };
+    return C_PointCounts[verb];
+}
+
+/*
+ * A path as three flat arrays : one verb per segment, the points the
+ * verbs use (in order, as float pairs) and the index of the verb starting
+ * each figure. Nothing is allocated per segment and the content can be
+ * walked, transformed or copied as plain arrays.
+ *
+ * Arcs are stored as the cubic Beziers approximating them, so every point
+ * is a real point and transforms apply to all of them alike.
+ */
+class compact_path {
+public :
+    std::vector<uint8_t>    verbs_;
+    std::vector<vector2>    points_;
+    std::vector<uint32_t>   figure_starts_;
+    fill_mode               fill_mode_;
+
+    compact_path() : fill_mode_(fill_mode_alternate) {}
+
+    void clear() {
+        verbs_.clear();
+        points_.clear();
+        figure_starts_.clear();
+    }
+
+    void reserve(size_t verbs, size_t points) {
+        verbs_.reserve(verbs);
+        points_.reserve(points);
+    }
+
+    bool empty() const {
+        return verbs_.empty();
+    }
+
+    size_t figure_count() const {
+        return figure_starts_.size();
+    }
+
+    /*
+     * Applies xform to every point, in place.
+     */
+    void transform(const matrix3X3& xform);
+
+    /*
+     * Bounds of the points (control points included, so they also bound
+     * the curves).
+     */
+    rectangle control_bounds() const;
+
+    /*
+     * Calls the visitor for every segment, with the path_sink method
+     * names and arguments : any sink works, and so does any class with
+     * those methods (no virtual call needed). Does not call close().
+     */
+    template<typename Visitor>
+    void visit(Visitor* visitor) const;
+
+    void stream(path_sink* sink) const {
+        visit(sink);
+    }
+};
+
+/*
+ * Appends to a compact_path, with the calls of path_sink (non virtual).
+ *
+ * Arcs become cubics within arc_tolerance (in path units), through
+ * arc_cache when there is one : paths rebuilt every frame or repeating
+ * the same arcs then convert each of them once.
+ */
+class compact_path_builder {
+public :
+    static const float C_DefaultArcTolerance;
+
+    explicit compact_path_builder(
+        compact_path* path, arc_cubic_cache* arc_cache = nullptr,
+        float arc_tolerance = C_DefaultArcTolerance)
+        : path_(path), arc_cache_(arc_cache), arc_tolerance_(arc_tolerance),
+          current_point_(0.0f, 0.0f) {
+        assert(path_);
+        assert(arc_tolerance_ > 0.0f);
+    }
+
+    void begin_figure(const vector2& start_point, figure_begin begin) {
+        path_->figure_starts_.push_back(static_cast<uint32_t>(path_->verbs_.size()));
+        path_->verbs_.push_back(static_cast<uint8_t>(
+            begin == figure_begin_filled ? path_verb_begin_filled : path_verb_begin_hollow));
+        path_->points_.push_back(start_point);
+        current_point_ = start_point;
+    }
+
+    void add_line(const vector2& point) {
+        path_->verbs_.push_back(path_verb_line);
+        path_->points_.push_back(point);
+        current_point_ = point;
+    }
+
+    void add_bezier(const bezier_segment& bezier) {
+        path_->verbs_.push_back(path_verb_cubic);
+        path_->points_.push_back(bezier.point1_);
+        path_->points_.push_back(bezier.point2_);
+        path_->points_.push_back(bezier.point3_);
+        current_point_ = bezier.point3_;
+    }
+
+    void add_quadratic_bezier(const quadratic_bezier_segment& bezier) {
+        path_->verbs_.push_back(path_verb_quadratic);
+        path_->points_.push_back(bezier.point1_);
+        path_->points_.push_back(bezier.point2_);
+        current_point_ = bezier.point2_;
+    }
+
+    void add_arc(const arc_segment& arc);
+
+    void end_figure(figure_end end) {
+        path_->verbs_.push_back(static_cast<uint8_t>(
+            end == figure_end_closed ? path_verb_end_closed : path_verb_end_open));
+    }
+
+    bool close() {
+        return true;
+    }
+
+private :
+    compact_path*               path_;
+    arc_cubic_cache*            arc_cache_;
+    float                       arc_tolerance_;
+    vector2                     current_point_;
+    //
+    // Reused by add_arc.
+    std::vector<bezier_segment> arc_cubics_;
+};
+
+template<typename Visitor>
+void
+compact_path::visit(
+    Visitor* visitor
+    ) const
+{
+    const vector2* pt = points_.empty() ? nullptr : &points_[0];
+
+    for (size_t i = 0; i < verbs_.size(); ++i) {
+        switch (verbs_[i]) {
+        case path_verb_begin_filled :
+            visitor->begin_figure(*pt++, figure_begin_filled);
+            break;
+
+        case path_verb_begin_hollow :
+            visitor->begin_figure(*pt++, figure_begin_hollow);
+            break;
+
+        case path_verb_line :
+            visitor->add_line(*pt++);
+            break;
+
+        case path_verb_quadratic :
+            visitor->add_quadratic_bezier(quadratic_bezier_segment(pt[0], pt[1]));
+            pt += 2;
+            break;
+
+        case path_verb_cubic :
+            visitor->add_bezier(bezier_segment(pt[0], pt[1], pt[2]));
+            pt += 3;
+            break;
+
+        case path_verb_end_open :
+            visitor->end_figure(figure_end_open);
+            break;
+
+        case path_verb_end_closed :
+            visitor->end_figure(figure_end_closed);
+            break;
+
+        default :
+            assert(false && "unknown path verb");
+            break;
+        }
+    }
+}
+
+} // ns gfx
+
+#endif /* GFX_COMPACT_PATH_H_ */
@@ -0,0 +1,279 @@
+/*
+ * d2d_render_target.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_D2D_RENDER_TARGET_H_
+#define GFX_D2D_RENDER_TARGET_H_
+
+#if defined(D2D_SUPPORT__)
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+#include <d2d1.h>
+#include <d2d1helper.h>
+
+#include "intrusive_ptr.h"
+#include "path_sink.h"
+#include "render_target.h"
+
+namespace gfx {
+
+inline
+D2D1_MATRIX_3X2_F
+to_d2d_matrix(
+    const matrix3X3& mtx
+    )
+{
+    //
+    // Direct2D uses row vectors, matrix3X3 column vectors.
+    return D2D1::Matrix3x2F(
+        mtx.a11_, mtx.a21_,
+        mtx.a12_, mtx.a22_,
+        mtx.a13_, mtx.a23_);
+}
+
+/*
+ * render_target on top of a Direct2D render target. Does not own the
+ * Direct2D target; must be discarded together with it when EndDraw asks
+ * for the target to be recreated.
+ */
+class d2d_render_target : public render_target {
+public :
+    explicit d2d_render_target(ID2D1RenderTarget* target)
+        : target_(target), transform_(matrix3X3::identity), frame_(0)
+    {
+        assert(target_);
+
+        target_->CreateSolidColorBrush(
+            D2D1::ColorF(D2D1::ColorF::Black), solid_brush_.reset_and_get_address());
+    }
+
+    ID2D1RenderTarget* get_d2d_target() const {
+        return target_;
+    }
+
+    int width() const {
+        return static_cast<int>(target_->GetPixelSize().width);
+    }
+
+    int height() const {
+        return static_cast<int>(target_->GetPixelSize().height);
+    }
+
+    void begin_draw() {
+        target_->BeginDraw();
+    }
+
+    end_draw_result end_draw() {
+        ++frame_;
+        prune_geometries();
+
+        const HRESULT ret_code = target_->EndDraw();
+        if (ret_code == D2DERR_RECREATE_TARGET)
+            return end_draw_recreate_target;
+        return SUCCEEDED(ret_code) ? end_draw_ok : end_draw_failed;
+    }
+
+    void clear(const color& clear_color) {
+        target_->Clear(clear_color);
+    }
+
+    void set_transform(const matrix3X3& xform) {
+        transform_ = xform;
+        target_->SetTransform(to_d2d_matrix(xform));
+    }
+
+    const matrix3X3& get_transform() const {
+        return transform_;
+    }
+
+    void fill_rectangle(const rectangle& rect, const brush* fill_brush) {
+        if (ID2D1Brush* d2d_brush = realize_brush(fill_brush))
+            target_->FillRectangle(rect, d2d_brush);
+    }
+
+    void draw_line(
+        const vector2& p0, const vector2& p1, const brush* stroke_brush,
+        float stroke_width = 1.0f)
+    {
+        if (ID2D1Brush* d2d_brush = realize_brush(stroke_brush))
+            target_->DrawLine(p0, p1, d2d_brush, stroke_width);
+    }
+
+    void fill_geometry(const path_geometry& geometry, const brush* fill_brush) {
+        ID2D1Brush* d2d_brush = realize_brush(fill_brush);
+        ID2D1Geometry* d2d_geometry = realize_geometry(geometry);
+        if (d2d_brush && d2d_geometry)
+            target_->FillGeometry(d2d_geometry, d2d_brush);
+    }
+
+    std::shared_ptr<bitmap_layer> create_layer(int width, int height);
+
+    void draw_layer(const bitmap_layer* layer);
+
+private :
+    //
+    // Frames a realization is kept without being drawn.
+    static const uint64_t C_GeometryMaxAge = 120;
+
+    struct realized_geometry {
+        uint32_t                            revision_;
+        uint64_t                            last_used_;
+        intrusive_ptr<ID2D1PathGeometry>    geometry_;
+    };
+
+    typedef std::unordered_map<const path_geometry*, realized_geometry> geometry_map;
+
+    ID2D1Brush* realize_brush(const brush* fill_brush) {
+        assert(fill_brush);
+        if (!solid_brush_)
+            return nullptr;
+
+        switch (fill_brush->type()) {
+        case brush_type_solid_color :
+            solid_brush_->SetColor(
+                static_cast<const solid_color_brush*>(fill_brush)->get_color());
+            return solid_brush_.get();
+            break;
+
+        default :
+            break;
+        }
+
+        return nullptr;
+    }
+
+    /*
+     * Path geometries are device independent in Direct2D too, so they are
+     * built once per revision and reused across frames. Revisions are
+     * unique process wide : a geometry freed and another one allocated at
+     * its address does not match the old realization.
+     */
+    ID2D1Geometry* realize_geometry(const path_geometry& geometry) {
+        realized_geometry& cached = geometries_[&geometry];
+        cached.last_used_ = frame_;
+        if (cached.geometry_ && cached.revision_ == geometry.revision())
+            return cached.geometry_.get();
+
+        cached.geometry_.reset();
+
+        intrusive_ptr<ID2D1Factory> factory_ptr;
+        target_->GetFactory(factory_ptr.reset_and_get_address());
+
+        intrusive_ptr<ID2D1PathGeometry> geometry_ptr;
+        HRESULT ret_code = factory_ptr->CreatePathGeometry(geometry_ptr.reset_and_get_address());
+        if (FAILED(ret_code))
+            return nullptr;
+
+        intrusive_ptr<ID2D1GeometrySink> sink_ptr;
+        ret_code = geometry_ptr->Open(sink_ptr.reset_and_get_address());
+        if (FAILED(ret_code))
+            return nullptr;
+
+        sink_ptr->SetFillMode(static_cast<D2D1_FILL_MODE>(geometry.get_fill_mode()));
+
+        d2d_geometry_sink_adapter adapter(sink_ptr.get());
+        geometry.stream(&adapter);
+        if (!adapter.close())
+            return nullptr;
+
+        cached.revision_ = geometry.revision();
+        cached.geometry_ = std::move(geometry_ptr);
+        return cached.geometry_.get();
+    }
+
+    /*
+     * Drops the realizations of geometries not drawn for a while (freed,
+     * or just not drawn anymore). Runs every C_GeometryMaxAge frames.
+     */
+    void prune_geometries() {
+        if (frame_ % C_GeometryMaxAge)
+            return;
+
+        for (geometry_map::iterator it = geometries_.begin(); it != geometries_.end(); ) {
+            if (frame_ - it->second.last_used_ > C_GeometryMaxAge)
+                it = geometries_.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    ID2D1RenderTarget*                      target_;
+    matrix3X3                               transform_;
+    intrusive_ptr<ID2D1SolidColorBrush>     solid_brush_;
+    geometry_map                            geometries_;
+    uint64_t                                frame_;
+};
+
+/*
+ * Layer backed by an ID2D1BitmapRenderTarget compatible with the target
+ * that created it.
+ */
+class d2d_bitmap_layer : public bitmap_layer {
+public :
+    explicit d2d_bitmap_layer(intrusive_ptr<ID2D1BitmapRenderTarget>&& bitmap_target)
+        : bitmap_target_(std::move(bitmap_target)), target_(bitmap_target_.get()) {}
+
+    render_target* target() {
+        return &target_;
+    }
+
+    ID2D1BitmapRenderTarget* get_bitmap_target() const {
+        return bitmap_target_.get();
+    }
+
+private :
+    intrusive_ptr<ID2D1BitmapRenderTarget>      bitmap_target_;
+    d2d_render_target                           target_;
+};
+
+inline
+std::shared_ptr<bitmap_layer>
+d2d_render_target::create_layer(
+    int width,
+    int height
+    )
+{
+    intrusive_ptr<ID2D1BitmapRenderTarget> bitmap_target;
+    const HRESULT ret_code = target_->CreateCompatibleRenderTarget(
+        D2D1::SizeF(static_cast<float>(width), static_cast<float>(height)),
+        D2D1::SizeU(width, height), bitmap_target.reset_and_get_address());
+    if (FAILED(ret_code))
+        return nullptr;
+
+    return std::make_shared<d2d_bitmap_layer>(std::move(bitmap_target));
+}
+
+inline
+void
+d2d_render_target::draw_layer(
+    const bitmap_layer* layer
+    )
+{
+    assert(layer);
+
+    intrusive_ptr<ID2D1Bitmap> bitmap_ptr;
+    if (FAILED(static_cast<const d2d_bitmap_layer*>(layer)->get_bitmap_target()->GetBitmap(
+            bitmap_ptr.reset_and_get_address())))
+        return;
+
+    const D2D1_SIZE_F size = bitmap_ptr->GetSize();
+
+    target_->SetTransform(D2D1::Matrix3x2F::Identity());
+    target_->DrawBitmap(bitmap_ptr.get(), D2D1::RectF(0.0f, 0.0f, size.width, size.height),
+                        1.0f, D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR);
+    target_->SetTransform(to_d2d_matrix(transform_));
+}
+
+} // ns gfx
+
+#endif /* D2D_SUPPORT__ */
+
+#endif /* GFX_D2D_RENDER_TARGET_H_ */
@@ -0,0 +1,308 @@
+/*
+ * demo_scenes.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "demo_scenes.h"
+
+#include "matrix3x3.h"
+#include "svg_path_parser.h"
+
+namespace {
+
+//
+// Same values as the matching D2D1::ColorF::Enum entries.
+const uint32_t C_Black = 0x000000;
+const uint32_t C_White = 0xFFFFFF;
+const uint32_t C_Orange = 0xFFA500;
+const uint32_t C_DeepSkyBlue = 0x00BFFF;
+const uint32_t C_Crimson = 0xDC143C;
+const uint32_t C_LawnGreen = 0x7CFC00;
+const uint32_t C_LightSkyBlue = 0x87CEFA;
+const uint32_t C_DarkGreen = 0x006400;
+
+//
+// Block speed in pixels per second, at full direction.
+const float C_BlockSpeed = 300.0f;
+
+//
+// The outline in unit space, into a gfx::path_sink or anything with the
+// same calls (gfx::compact_path_builder).
+template<typename Sink>
+void
+BuildFighterOutline(
+    Sink* sink
+    )
+{
+    sink->begin_figure(gfx::vector2(-5.0f, 0.0f), gfx::figure_begin_filled);
+    sink->add_line(gfx::vector2(-5.0f, 1.0f));
+    sink->add_bezier(
+        gfx::bezier_segment(gfx::vector2(-4.5f, 2.0f),
+                            gfx::vector2(-3.5f, 3.5f),
+                            gfx::vector2(-1.0f, 5.0f)));
+    sink->add_arc(gfx::arc_segment(
+        gfx::vector2(1.0f, 5.0f), gfx::vector2(1.0f, 4.0f), 0.0f,
+        gfx::sweep_direction_counter_clockwise, gfx::arc_size_large));
+
+    sink->add_bezier(
+        gfx::bezier_segment(gfx::vector2(2.0f, 4.5f),
+        gfx::vector2(3.5f, 3.5f),
+        gfx::vector2(5.0f, 1.0f)));
+
+    sink->add_line(gfx::vector2(5.0f, 0.0f));
+    sink->add_line(gfx::vector2(0.50f, -1.0f));
+
+    sink->add_bezier(
+        gfx::bezier_segment(gfx::vector2(0.5f, -1.0f),
+                            gfx::vector2(0.0f, -4.0f),
+                            gfx::vector2(-0.5f, -1.0f)));
+
+    sink->add_line(gfx::vector2(-5.0f, 0.0f));
+    sink->end_figure(gfx::figure_end_closed);
+}
+
+} // anonymous namespace
+
+Fighter_Mig21::Fighter_Mig21()
+    : geometry_(std::make_shared<gfx::path_geometry>()),
+      fbrush_(gfx::color(C_LawnGreen)) {}
+
+void
+Fighter_Mig21::BuildFighterGeometry(
+    gfx::geometry_pool* pool
+    )
+{
+    //
+    // Pooled geometries are shared and immutable, always build a new one.
+    std::shared_ptr<gfx::path_geometry> geometry(std::make_shared<gfx::path_geometry>());
+    gfx::path_sink* sink = geometry->open();
+    BuildFighterOutline(sink);
+    sink->close();
+    geometry_ = pool ? pool->intern(geometry) : geometry;
+}
+
+void
+Fighter_Mig21::BuildCompactGeometry(
+    gfx::compact_path* path,
+    gfx::arc_cubic_cache* arc_cache
+    ) const
+{
+    path->clear();
+    gfx::compact_path_builder builder(path, arc_cache);
+    BuildFighterOutline(&builder);
+    builder.close();
+}
+
+bool
+Fighter_Mig21::BuildGeometryFromPathData(
+    const char* path_data,
+    gfx::geometry_pool* pool
+    )
+{
+    std::shared_ptr<gfx::path_geometry> geometry(std::make_shared<gfx::path_geometry>());
+    gfx::path_sink* sink = geometry->open();
+    gfx::svg_path_parser parser(sink);
+    const bool parsed = parser.parse(path_data);
+    const bool closed = sink->close();
+    geometry_ = pool ? pool->intern(geometry) : geometry;
+    return closed && parsed;
+}
+
+void
+FighterScene::Initialize(
+    int width,
+    int height
+    )
+{
+    width_ = width;
+    height_ = height;
+    world_origin_.x_ = static_cast<float>(width / 2);
+    world_origin_.y_ = static_cast<float>(height / 2);
+
+    brushes_.clear();
+    brushes_.push_back(gfx::solid_color_brush(gfx::color(C_DeepSkyBlue)));
+    brushes_.push_back(gfx::solid_color_brush(gfx::color(C_Black)));
+    brushes_.push_back(gfx::solid_color_brush(gfx::color(C_Crimson)));
+
+    const gfx::gradient_stop sky_stops[] = {
+        gfx::gradient_stop(0.0f, gfx::color(C_DeepSkyBlue)),
+        gfx::gradient_stop(0.7f, gfx::color(C_LightSkyBlue)),
+        gfx::gradient_stop(1.0f, gfx::color(C_White))
+    };
+    sky_gradient_.reset(new gfx::linear_gradient_brush(
+        gfx::vector2(0.0f, 0.0f), gfx::vector2(0.0f, static_cast<float>(height)),
+        gfx::gradient_stop_collection(sky_stops, sizeof(sky_stops) / sizeof(sky_stops[0]))));
+
+    //
+    // In fighter space, lit from above the canopy.
+    const gfx::gradient_stop fighter_stops[] = {
+        gfx::gradient_stop(0.0f, gfx::color(C_LawnGreen)),
+        gfx::gradient_stop(1.0f, gfx::color(C_DarkGreen))
+    };
+    fighter_gradient_.reset(new gfx::radial_gradient_brush(
+        gfx::vector2(0.0f, 1.0f), gfx::vector2(0.0f, 2.0f), 5.0f, 5.0f,
+        gfx::gradient_stop_collection(fighter_stops, sizeof(fighter_stops) / sizeof(fighter_stops[0]))));
+
+    fmig21_.reset(new Fighter_Mig21());
+    fmig21_->BuildFighterGeometry();
+
+    //
+    // Called again after the render target is recreated, the old layer
+    // belongs to the lost device.
+    background_.invalidate();
+}
+
+void
+FighterScene::Draw(
+    gfx::render_target* target
+    ) const
+{
+    DrawView(target, gfx::matrix3X3::identity, &background_);
+}
+
+void
+FighterScene::DrawView(
+    gfx::render_target* target,
+    const gfx::matrix3X3& camera,
+    gfx::cached_layer* background
+    ) const
+{
+    if (cache_background_ && background) {
+        background->draw(target, BackgroundKey(),
+                         [this](gfx::render_target* layer) { DrawBackground(layer); });
+    } else {
+        DrawBackground(target);
+    }
+
+    target->set_transform(
+        camera *
+        gfx::matrix3X3::translation(world_origin_) *
+        gfx::matrix3X3::scale(25.0f, 25.0f) *
+        gfx::matrix3X3::rotation(180.0f)
+        );
+    const gfx::brush* fighter_brush = gradient_fills_ ?
+        static_cast<const gfx::brush*>(fighter_gradient_.get()) : fmig21_->GetBrush();
+    target->fill_geometry(fmig21_->GetGeometry(), fighter_brush);
+}
+
+void
+FighterScene::DrawBackground(
+    gfx::render_target* target
+    ) const
+{
+    const float width = static_cast<float>(width_);
+    const float height = static_cast<float>(height_);
+
+    target->clear(gfx::color(C_White));
+    target->set_transform(gfx::matrix3X3::identity);
+    const gfx::brush* sky_brush = gradient_fills_ ?
+        static_cast<const gfx::brush*>(sky_gradient_.get()) : &brushes_[Brush_DeepSkyBlue];
+    target->fill_rectangle(gfx::rectangle(0.0f, 0.0f, width, height), sky_brush);
+    target->draw_line(
+        gfx::vector2(width / 2, 0.0f),
+        gfx::vector2(width / 2, height),
+        &brushes_[Brush_Black],
+        1.0f);
+    target->draw_line(
+        gfx::vector2(0.0f, height / 2),
+        gfx::vector2(width, height / 2),
+        &brushes_[Brush_Black],
+        1.0f);
+}
+
+uint64_t
+FighterScene::BackgroundKey() const {
+    return static_cast<uint64_t>(width_) |
+        (static_cast<uint64_t>(height_) << 24) |
+        (static_cast<uint64_t>(gradient_fills_) << 48);
+}
+
+void
+BlockScene::Initialize(
+    int width,
+    int height
+    )
+{
+    width_ = width;
+    height_ = height;
+
+    brush_cache_.clear();
+    brush_cache_.push_back(gfx::solid_color_brush(gfx::color(C_Black)));
+    brush_cache_.push_back(gfx::solid_color_brush(gfx::color(C_White)));
+    brush_cache_.push_back(gfx::solid_color_brush(gfx::color(C_Orange)));
+
+    const gfx::vector2 position(static_cast<float>(width / 2),
+                                static_cast<float>(height / 2));
+    const gfx::vector2 geometry(200.0f, 200.0f);
+
+    block_.SetBrush(&brush_cache_[BlockScene::Brush_Orange]);
+    block_.SetPosition(position);
+    block_.SetGeometry(geometry);
+
+    //
+    // The block must stay inside the window : its centre is kept half its
+    // size away from the edges.
+    direction_ = 0.0f;
+    pending_input_ = applied_input_ = 0;
+    bodies_.clear();
+    block_body_ = bodies_.add(
+        position, gfx::vector2(0.0f, 0.0f),
+        gfx::rectangle(geometry.x_ / 2, geometry.y_ / 2,
+                       static_cast<float>(width) - geometry.x_ / 2,
+                       static_cast<float>(height) - geometry.y_ / 2));
+    timestep_.reset();
+}
+
+void
+BlockScene::Update(
+    uint64_t elapsed_ns
+    )
+{
+    const int steps = timestep_.advance(elapsed_ns);
+    const float dt = timestep_.step_seconds();
+
+    for (int i = 0; i < steps; ++i) {
+        bodies_.set_velocity(block_body_, gfx::vector2(C_BlockSpeed * direction_, 0.0f));
+        bodies_.step(dt);
+    }
+    if (steps)
+        applied_input_ = pending_input_;
+
+    block_.SetPosition(
+        bodies_.interpolated_position(block_body_, timestep_.interpolation_alpha()));
+}
+
+void
+BlockScene::HandleKeyDown(
+    DemoKey key,
+    uint64_t input_sequence
+    )
+{
+    pending_input_ = std::max(pending_input_, input_sequence);
+    if (key == DemoKey_Left)
+        SetMoveDirection(0.5f);
+    else if (key == DemoKey_Right)
+        SetMoveDirection(-0.5f);
+}
+
+void
+BlockScene::HandleKeyUp(
+    DemoKey key,
+    uint64_t input_sequence
+    )
+{
+    pending_input_ = std::max(pending_input_, input_sequence);
+    if (key == DemoKey_Left || key == DemoKey_Right)
+        SetMoveDirection(0.0f);
+}
+
+void
+BlockScene::Draw(
+    gfx::render_target* target
+    ) const
+{
+    target->clear(gfx::color(C_White));
+    block_.Draw(target);
+}
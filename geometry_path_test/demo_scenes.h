@@ -0,0 +1,272 @@
+/*
+ * demo_scenes.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef DEMO_SCENES_H_
+#define DEMO_SCENES_H_
+
+#include <memory>
+#include <vector>
+
+#include "brush.h"
+#include "compact_path.h"
+#include "geometry_pool.h"
+#include "gradient_brush.h"
+#include "layer_cache.h"
+#include "path_geometry.h"
+#include "rectangle.h"
+#include "render_target.h"
+#include "simulation.h"
+#include "vector2.h"
+
+/*
+ * The content of the demo programs, drawn through gfx::render_target so it
+ * renders the same on Direct2D and on the software backend.
+ */
+
+class Fighter_Mig21 {
+public :
+    Fighter_Mig21();
+
+    const gfx::path_geometry& GetGeometry() const {
+        return *geometry_;
+    }
+
+    const gfx::geometry_pool::geometry_handle& GetSharedGeometry() const {
+        return geometry_;
+    }
+
+    const gfx::solid_color_brush* GetBrush() const {
+        return &fbrush_;
+    }
+
+    //
+    // With a pool, fighters share one geometry.
+    void BuildFighterGeometry(gfx::geometry_pool* pool = nullptr);
+
+    //
+    // The same outline, as a compact_path (arcs become cubics, converted
+    // through arc_cache when given).
+    void BuildCompactGeometry(
+        gfx::compact_path* path, gfx::arc_cubic_cache* arc_cache = nullptr) const;
+
+    //
+    // Builds the geometry from SVG path data (the 'd' attribute of a path).
+    bool BuildGeometryFromPathData(
+        const char* path_data, gfx::geometry_pool* pool = nullptr);
+
+    void SetBrush(const gfx::solid_color_brush& brsh) {
+        fbrush_ = brsh;
+    }
+
+private :
+    gfx::geometry_pool::geometry_handle geometry_;
+    gfx::solid_color_brush              fbrush_;
+};
+
+/*
+ * geometry_path_test : sky, axes and the fighter.
+ */
+class FighterScene {
+public :
+    FighterScene() : width_(0), height_(0), gradient_fills_(false), cache_background_(true) {}
+
+    void Initialize(int width, int height);
+
+    //
+    // Paints the sky and the fighter with gradients instead of solid
+    // colours (software backend only for now).
+    void SetGradientFills(bool enabled) {
+        gradient_fills_ = enabled;
+    }
+
+    //
+    // The sky and the axes never move : by default they are drawn once
+    // into a layer and the layer is composited every frame.
+    void SetCacheBackground(bool enabled) {
+        cache_background_ = enabled;
+        background_.invalidate();
+    }
+
+    const gfx::layer_cache_statistics& GetBackgroundStatistics() const {
+        return background_.statistics();
+    }
+
+    //
+    // Draws the frame, must be called between begin_draw() and end_draw().
+    void Draw(gfx::render_target* target) const;
+
+    //
+    // Draws the frame seen through camera (applied on top of the world
+    // transform), keeping the background in background (one per view, or
+    // nullptr to draw it directly). Only reads the scene : several views
+    // can be drawn at the same time.
+    void DrawView(
+        gfx::render_target* target, const gfx::matrix3X3& camera,
+        gfx::cached_layer* background) const;
+
+    const Fighter_Mig21& GetFighter() const {
+        return *fmig21_;
+    }
+
+private :
+    void DrawBackground(gfx::render_target* target) const;
+
+    //
+    // Everything the background depends on.
+    uint64_t BackgroundKey() const;
+
+    enum {
+        Brush_DeepSkyBlue,
+        Brush_Black,
+        Brush_Red
+    };
+
+    int                                 width_;
+    int                                 height_;
+    gfx::vector2                        world_origin_;
+    std::vector<gfx::solid_color_brush> brushes_;
+    std::shared_ptr<gfx::linear_gradient_brush> sky_gradient_;
+    std::shared_ptr<gfx::radial_gradient_brush> fighter_gradient_;
+    std::shared_ptr<Fighter_Mig21>      fmig21_;
+    bool                                gradient_fills_;
+    bool                                cache_background_;
+    mutable gfx::cached_layer           background_;
+};
+
+class MovingRectangle {
+public :
+    MovingRectangle() : brush_(nullptr) {}
+
+    void SetPosition(const gfx::vector2& pos) {
+        pos_ = pos;
+    }
+
+    const gfx::vector2& GetPosition() const {
+        return pos_;
+    }
+
+    void SetGeometry(const gfx::vector2& geometry) {
+        geometry_ = geometry;
+    }
+
+    const gfx::vector2& GetGeometry() const {
+        return geometry_;
+    }
+
+    void SetBrush(const gfx::brush* brush) {
+        brush_ = brush;
+    }
+
+    gfx::rectangle GetRectangle() const {
+        return gfx::rectangle(pos_.x_ - geometry_.x_ / 2,
+                              pos_.y_ - geometry_.y_ / 2,
+                              pos_.x_ + geometry_.x_ / 2,
+                              pos_.y_ + geometry_.y_ / 2);
+    }
+
+    void Draw(gfx::render_target* target) const {
+        assert(brush_);
+        target->fill_rectangle(GetRectangle(), brush_);
+    }
+
+private :
+    gfx::vector2        pos_;
+    gfx::vector2        geometry_;
+    const gfx::brush*   brush_;
+};
+
+//
+// Keys the scenes respond to, whatever the platform's key codes. Input
+// recordings store these, so they replay anywhere.
+enum DemoKey {
+    DemoKey_Other,
+    DemoKey_Left,
+    DemoKey_Right,
+    DemoKey_Escape
+};
+
+/*
+ * d2d_flicker_test : a block moved left and right with the arrow keys.
+ */
+class BlockScene {
+public :
+    //
+    // The block is simulated at 120 Hz, whatever the frame rate.
+    static const uint64_t C_StepNs = 1000000000 / 120;
+
+    BlockScene()
+        : width_(0), height_(0), direction_(0.0f), block_body_(0), timestep_(C_StepNs),
+          pending_input_(0), applied_input_(0) {}
+
+    void Initialize(int width, int height);
+
+    //
+    // Draws the frame, must be called between begin_draw() and end_draw().
+    void Draw(gfx::render_target* target) const;
+
+    //
+    // The block moves while the direction is not zero (from -1 to 1, the
+    // sign picks the side). Applies from the next simulation step.
+    void SetMoveDirection(float direction) {
+        direction_ = direction;
+    }
+
+    //
+    // The block moves for as long as an arrow key is held, at the same
+    // speed whatever the key repeat rate. input_sequence is the key's id
+    // in a gfx::latency_tracker (0 when not tracked).
+    void HandleKeyDown(DemoKey key, uint64_t input_sequence = 0);
+
+    void HandleKeyUp(DemoKey key, uint64_t input_sequence = 0);
+
+    //
+    // Highest input sequence id the simulated state reflects : a key only
+    // counts once a simulation step has run with it.
+    uint64_t GetAppliedInput() const {
+        return applied_input_;
+    }
+
+    //
+    // Runs the simulation steps due after elapsed_ns more nanoseconds and
+    // places the block between the last two steps, for drawing.
+    void Update(uint64_t elapsed_ns);
+
+    const MovingRectangle& GetBlock() const {
+        return block_;
+    }
+
+    //
+    // Position at the last simulation step (GetBlock() has the
+    // interpolated one).
+    gfx::vector2 GetSimulatedPosition() const {
+        return bodies_.position(block_body_);
+    }
+
+    uint64_t GetStepCount() const {
+        return timestep_.step_count();
+    }
+
+private :
+    enum Brushes {
+        Brush_Black,
+        Brush_White,
+        Brush_Orange
+    };
+
+    int                                 width_;
+    int                                 height_;
+    std::vector<gfx::solid_color_brush> brush_cache_;
+    MovingRectangle                     block_;
+    float                               direction_;
+    size_t                              block_body_;
+    gfx::kinematic_bodies               bodies_;
+    gfx::fixed_timestep                 timestep_;
+    uint64_t                            pending_input_;
+    uint64_t                            applied_input_;
+};
+
+#endif /* DEMO_SCENES_H_ */
@@ -0,0 +1,238 @@
+/*
+ * distance_field.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "distance_field.h"
+
+#include <cfloat>
+#include <cmath>
+
+namespace {
+
+//
+// The outline is flattened this far below the grid spacing, which keeps
+// the flattening error out of the distances.
+const float C_FlatteningFraction = 1.0f / 64.0f;
+
+//
+// Distances are clamped to this fraction of the shape's size (or the
+// margin, when larger).
+const float C_ClampFraction = 0.25f;
+
+struct outline_edge {
+    gfx::vector2    p0_;
+    gfx::vector2    p1_;
+    //
+    // Bounds, for skipping edges farther than the clamp distance.
+    float           min_x_;
+    float           min_y_;
+    float           max_x_;
+    float           max_y_;
+};
+
+struct row_crossing {
+    float   x_;
+    int     winding_;
+
+    bool operator<(const row_crossing& rhs) const {
+        return x_ < rhs.x_;
+    }
+};
+
+inline
+float
+squared_distance_to_segment(
+    const gfx::vector2& p,
+    const gfx::vector2& a,
+    const gfx::vector2& b
+    )
+{
+    const gfx::vector2 ab(b - a);
+    const gfx::vector2 ap(p - a);
+    const float length2 = gfx::dot_product(ab, ab);
+    float t = length2 > 0.0f ? gfx::dot_product(ap, ab) / length2 : 0.0f;
+    t = std::max(0.0f, std::min(t, 1.0f));
+    const gfx::vector2 d(ap - ab * t);
+    return gfx::dot_product(d, d);
+}
+
+} // anonymous namespace
+
+bool
+gfx::distance_field::build(
+    const path_geometry& geometry,
+    int resolution,
+    int margin
+    )
+{
+    assert(resolution > 0 && margin >= 0);
+
+    distances_.clear();
+    width_ = height_ = 0;
+
+    //
+    // Coarse pass for the bounds, then the outline fine enough for the
+    // grid spacing.
+    flattened_path outline;
+    geometry.flatten(matrix3X3::identity, 1.0e-2f, &outline);
+    if (outline.empty())
+        return false;
+
+    const rectangle shape_bounds(outline.bounds());
+    const float extent = std::max(shape_bounds.right_ - shape_bounds.left_,
+                                  shape_bounds.bottom_ - shape_bounds.top_);
+    if (!(extent > 0.0f))
+        return false;
+
+    cell_size_ = extent / static_cast<float>(resolution);
+    //
+    // Large enough for drawing to skip over the inside of the shape in big
+    // steps, small enough for building to skip most edges.
+    max_distance_ = std::max(cell_size_ * static_cast<float>(std::max(margin, 1)),
+                             extent * C_ClampFraction);
+    geometry.flatten(matrix3X3::identity, cell_size_ * C_FlatteningFraction, &outline);
+
+    const float pad = cell_size_ * static_cast<float>(margin);
+    origin_ = vector2(shape_bounds.left_ - pad, shape_bounds.top_ - pad);
+    width_ = static_cast<int>(std::ceil((shape_bounds.right_ + pad - origin_.x_) / cell_size_)) + 1;
+    height_ = static_cast<int>(std::ceil((shape_bounds.bottom_ + pad - origin_.y_) / cell_size_)) + 1;
+
+    std::vector<outline_edge> edges;
+    for (size_t fig = 0; fig < outline.figure_count(); ++fig) {
+        const size_t first = outline.figure_begin(fig);
+        const size_t last = outline.figure_ends_[fig];
+        for (size_t i = first; i < last; ++i) {
+            //
+            // Figures are closed when filled.
+            outline_edge edge;
+            edge.p0_ = outline.points_[i];
+            edge.p1_ = outline.points_[i + 1 < last ? i + 1 : first];
+            edge.min_x_ = std::min(edge.p0_.x_, edge.p1_.x_);
+            edge.min_y_ = std::min(edge.p0_.y_, edge.p1_.y_);
+            edge.max_x_ = std::max(edge.p0_.x_, edge.p1_.x_);
+            edge.max_y_ = std::max(edge.p0_.y_, edge.p1_.y_);
+            edges.push_back(edge);
+        }
+    }
+
+    distances_.resize(static_cast<size_t>(width_) * height_);
+    std::vector<row_crossing> crossings;
+    const float max_distance2 = max_distance_ * max_distance_;
+
+    for (int y = 0; y < height_; ++y) {
+        const float py = origin_.y_ + cell_size_ * static_cast<float>(y);
+
+        //
+        // Inside or outside : crossings of the row with the outline,
+        // half open in y so vertices are counted once.
+        crossings.clear();
+        for (size_t e = 0; e < edges.size(); ++e) {
+            const vector2& p0 = edges[e].p0_;
+            const vector2& p1 = edges[e].p1_;
+            if ((p0.y_ <= py) == (p1.y_ <= py))
+                continue;
+
+            row_crossing crossing;
+            crossing.x_ = p0.x_ + (py - p0.y_) * (p1.x_ - p0.x_) / (p1.y_ - p0.y_);
+            crossing.winding_ = p1.y_ > p0.y_ ? 1 : -1;
+            crossings.push_back(crossing);
+        }
+        std::sort(crossings.begin(), crossings.end());
+
+        size_t next_crossing = 0;
+        int winding = 0;
+        float* row = &distances_[static_cast<size_t>(y) * width_];
+
+        for (int x = 0; x < width_; ++x) {
+            const vector2 p(origin_.x_ + cell_size_ * static_cast<float>(x), py);
+
+            while (next_crossing < crossings.size() && crossings[next_crossing].x_ < p.x_)
+                winding += crossings[next_crossing++].winding_;
+            const bool inside = outline.fill_mode_ == fill_mode_winding ?
+                winding != 0 : (winding & 1) != 0;
+
+            float best2 = max_distance2;
+            for (size_t e = 0; e < edges.size(); ++e) {
+                const outline_edge& edge = edges[e];
+                const float dx = std::max(std::max(edge.min_x_ - p.x_, p.x_ - edge.max_x_), 0.0f);
+                const float dy = std::max(std::max(edge.min_y_ - p.y_, p.y_ - edge.max_y_), 0.0f);
+                if (dx * dx + dy * dy >= best2)
+                    continue;
+
+                best2 = std::min(best2, squared_distance_to_segment(p, edge.p0_, edge.p1_));
+            }
+
+            const float distance = std::sqrt(best2);
+            row[x] = inside ? -distance : distance;
+        }
+    }
+
+    return true;
+}
+
+float
+gfx::distance_field::sample(
+    const vector2& local
+    ) const
+{
+    if (distances_.empty())
+        return max_distance_;
+
+    const float gx = (local.x_ - origin_.x_) / cell_size_;
+    const float gy = (local.y_ - origin_.y_) / cell_size_;
+    if (!(gx >= 0.0f) || !(gy >= 0.0f) ||
+        gx > static_cast<float>(width_ - 1) || gy > static_cast<float>(height_ - 1))
+        return max_distance_;
+
+    const int x0 = std::min(static_cast<int>(gx), width_ - 2);
+    const int y0 = std::min(static_cast<int>(gy), height_ - 2);
+    const float fx = gx - static_cast<float>(x0);
+    const float fy = gy - static_cast<float>(y0);
+    const float* row0 = &distances_[static_cast<size_t>(y0) * width_ + x0];
+    const float* row1 = row0 + width_;
+    const float top = row0[0] + (row0[1] - row0[0]) * fx;
+    const float bottom = row1[0] + (row1[1] - row1[0]) * fx;
+    return top + (bottom - top) * fy;
+}
+
+const gfx::distance_field&
+gfx::distance_field_cache::find(
+    const path_geometry& geometry,
+    int resolution
+    )
+{
+    const field_key key = { &geometry, geometry.revision(), resolution };
+
+    std::unordered_map<field_key, field_list::iterator, field_key_hash>::iterator found =
+        index_.find(key);
+    if (found != index_.end()) {
+        ++stats_.hits_;
+        entries_.splice(entries_.begin(), entries_, found->second);
+        return entries_.front().field_;
+    }
+
+    ++stats_.misses_;
+    if (entries_.size() >= capacity_) {
+        index_.erase(entries_.back().key_);
+        entries_.pop_back();
+        ++stats_.evictions_;
+    }
+
+    entries_.push_front(field_entry());
+    field_entry& entry = entries_.front();
+    entry.key_ = key;
+    entry.field_.build(geometry, resolution);
+    index_[key] = entries_.begin();
+    return entry.field_;
+}
+
+size_t
+gfx::distance_field_cache::memory_used() const {
+    size_t bytes = 0;
+    for (field_list::const_iterator it = entries_.begin(); it != entries_.end(); ++it)
+        bytes += it->field_.memory_size();
+    return bytes;
+}
@@ -0,0 +1,206 @@
+/*
+ * distance_field.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_DISTANCE_FIELD_H_
+#define GFX_DISTANCE_FIELD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "path_geometry.h"
+#include "rectangle.h"
+#include "vector2.h"
+
+namespace gfx {
+
+/*
+ * Signed distance to the outline of a geometry, in the geometry's own
+ * space, sampled on a grid : negative inside (per the geometry's fill
+ * mode), positive outside. Drawing thresholds the interpolated distance,
+ * so one field serves every scale and rotation.
+ *
+ * The distances are computed from the segments, flattened far below the
+ * grid spacing, not from a rasterized bitmap. They are clamped to a
+ * quarter of the shape's size (or the margin around it, when larger) :
+ * farther than that, only the sign matters.
+ * Corners sharper than the grid spacing come out rounded at large scales.
+ */
+class distance_field {
+public :
+    static const int C_DefaultMargin = 4;
+
+    distance_field()
+        : width_(0), height_(0), origin_(0.0f, 0.0f), cell_size_(0.0f), max_distance_(0.0f) {}
+
+    /*
+     * Samples the field with resolution cells along the longer side of
+     * the geometry's bounds, plus margin cells all around. Returns false
+     * (and leaves the field empty) for an empty geometry.
+     */
+    bool build(const path_geometry& geometry, int resolution, int margin = C_DefaultMargin);
+
+    bool empty() const {
+        return distances_.empty();
+    }
+
+    int width() const {
+        return width_;
+    }
+
+    int height() const {
+        return height_;
+    }
+
+    /*
+     * Local position of the sample (0, 0), and the distance between
+     * samples.
+     */
+    const vector2& origin() const {
+        return origin_;
+    }
+
+    float cell_size() const {
+        return cell_size_;
+    }
+
+    /*
+     * Distances are clamped to [-max_distance(), max_distance()].
+     */
+    float max_distance() const {
+        return max_distance_;
+    }
+
+    /*
+     * The area the samples cover, in local space.
+     */
+    rectangle bounds() const {
+        return rectangle(origin_.x_, origin_.y_,
+                         origin_.x_ + cell_size_ * static_cast<float>(width_ - 1),
+                         origin_.y_ + cell_size_ * static_cast<float>(height_ - 1));
+    }
+
+    /*
+     * Row major samples, width() per row.
+     */
+    const float* distances() const {
+        return &distances_[0];
+    }
+
+    /*
+     * Bilinear interpolation of the samples around a local point,
+     * max_distance() outside the grid.
+     */
+    float sample(const vector2& local) const;
+
+    size_t memory_size() const {
+        return sizeof(*this) + distances_.capacity() * sizeof(float);
+    }
+
+private :
+    std::vector<float>  distances_;
+    int                 width_;
+    int                 height_;
+    vector2             origin_;
+    float               cell_size_;
+    float               max_distance_;
+};
+
+struct distance_field_statistics {
+    uint64_t    hits_;
+    uint64_t    misses_;
+    uint64_t    evictions_;
+
+    distance_field_statistics() {
+        reset();
+    }
+
+    void reset() {
+        hits_ = misses_ = evictions_ = 0;
+    }
+};
+
+/*
+ * Distance fields of the geometries drawn, built on first use. Keyed by
+ * geometry address, revision and resolution like geometry_lod_cache : a
+ * reopened geometry misses and its old field ages out. Holds at most
+ * capacity fields, least recently used ones are dropped first.
+ */
+class distance_field_cache {
+public :
+    static const size_t C_DefaultCapacity = 64;
+
+    explicit distance_field_cache(size_t capacity = C_DefaultCapacity)
+        : capacity_(capacity) {
+        assert(capacity_ > 0);
+    }
+
+    /*
+     * The field of geometry at resolution, built if missing. Valid until
+     * the next call to find().
+     */
+    const distance_field& find(const path_geometry& geometry, int resolution);
+
+    size_t size() const {
+        return entries_.size();
+    }
+
+    size_t memory_used() const;
+
+    void clear() {
+        entries_.clear();
+        index_.clear();
+    }
+
+    const distance_field_statistics& statistics() const {
+        return stats_;
+    }
+
+    void reset_statistics() {
+        stats_.reset();
+    }
+
+private :
+    struct field_key {
+        const path_geometry*    geometry_;
+        uint32_t                revision_;
+        int                     resolution_;
+
+        bool operator==(const field_key& rhs) const {
+            return geometry_ == rhs.geometry_ && revision_ == rhs.revision_ &&
+                resolution_ == rhs.resolution_;
+        }
+    };
+
+    struct field_key_hash {
+        size_t operator()(const field_key& key) const {
+            size_t h = std::hash<const void*>()(key.geometry_);
+            h ^= (static_cast<size_t>(key.revision_) << 12) + static_cast<size_t>(key.resolution_);
+            return h;
+        }
+    };
+
+    struct field_entry {
+        field_key       key_;
+        distance_field  field_;
+    };
+
+    typedef std::list<field_entry> field_list;
+
+    size_t                                                          capacity_;
+    //
+    // Most recently used first.
+    field_list                                                      entries_;
+    std::unordered_map<field_key, field_list::iterator, field_key_hash> index_;
+    distance_field_statistics                                       stats_;
+};
+
+} // ns gfx
+
+#endif /* GFX_DISTANCE_FIELD_H_ */
@@ -0,0 +1,317 @@
+/*
+ * elliptic_arc.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "elliptic_arc.h"
+
+#include <cstring>
+
+namespace {
+
+const int C_MaxCubicsPerArc = 256;
+
+//
+// Signed angle from u to v, in radians.
+inline
+float
+vector_angle(
+    const gfx::vector2& u,
+    const gfx::vector2& v
+    )
+{
+    return std::atan2(u.x_ * v.y_ - u.y_ * v.x_, gfx::dot_product(u, v));
+}
+
+inline
+uint32_t
+float_bits(
+    float value
+    )
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+/*
+ * The arc with its start point at the origin. Ellipses repeat every half
+ * turn and circles do not rotate, so equal arcs normalize alike.
+ */
+gfx::arc_segment
+normalize_arc(
+    const gfx::vector2& start,
+    const gfx::arc_segment& arc
+    )
+{
+    gfx::arc_segment normalized(arc);
+    normalized.point_ = arc.point_ - start;
+    normalized.size_ = gfx::vector2(std::fabs(arc.size_.x_), std::fabs(arc.size_.y_));
+
+    float rotation = std::fmod(arc.rotation_angle_, 180.0f);
+    if (rotation < 0.0f)
+        rotation += 180.0f;
+    if (normalized.size_.x_ == normalized.size_.y_)
+        rotation = 0.0f;
+    normalized.rotation_angle_ = rotation;
+
+    return normalized;
+}
+
+//
+// Cubics of a normalized arc, relative to the origin.
+bool
+convert_normalized(
+    const gfx::arc_segment& arc,
+    float tolerance,
+    std::vector<gfx::bezier_segment>* cubics
+    )
+{
+    gfx::arc_centre_form centre;
+    if (!gfx::arc_to_centre_form(gfx::vector2(0.0f, 0.0f), arc, &centre))
+        return false;
+
+    const int segments = gfx::arc_cubic_count(centre, tolerance);
+    const float step = centre.sweep_angle_ / static_cast<float>(segments);
+    const float k = 4.0f / 3.0f * std::tan(step * 0.25f);
+
+    //
+    // Tangents of the unit circle, scaled and rotated like its points.
+    const float rx = centre.rx_;
+    const float ry = centre.ry_;
+    const float cos_phi = centre.cos_phi_;
+    const float sin_phi = centre.sin_phi_;
+    float ct = std::cos(centre.start_angle_);
+    float st = std::sin(centre.start_angle_);
+
+    for (int i = 0; i < segments; ++i) {
+        const float next_angle = centre.start_angle_ + step * static_cast<float>(i + 1);
+        const float nct = std::cos(next_angle);
+        const float nst = std::sin(next_angle);
+
+        const float p1x = ct - k * st;
+        const float p1y = st + k * ct;
+        const float p2x = nct + k * nst;
+        const float p2y = nst - k * nct;
+
+        const gfx::vector2 c1(centre.centre_.x_ + rx * p1x * cos_phi - ry * p1y * sin_phi,
+                              centre.centre_.y_ + rx * p1x * sin_phi + ry * p1y * cos_phi);
+        const gfx::vector2 c2(centre.centre_.x_ + rx * p2x * cos_phi - ry * p2y * sin_phi,
+                              centre.centre_.y_ + rx * p2x * sin_phi + ry * p2y * cos_phi);
+        const gfx::vector2 p3 = i + 1 == segments ? arc.point_ : centre.point_at(next_angle);
+
+        cubics->push_back(gfx::bezier_segment(c1, c2, p3));
+
+        ct = nct;
+        st = nst;
+    }
+
+    return true;
+}
+
+void
+append_translated(
+    const gfx::bezier_segment* relative,
+    size_t count,
+    const gfx::vector2& start,
+    const gfx::vector2& end,
+    std::vector<gfx::bezier_segment>* cubics
+    )
+{
+    for (size_t i = 0; i < count; ++i) {
+        cubics->push_back(gfx::bezier_segment(
+            relative[i].point1_ + start, relative[i].point2_ + start,
+            relative[i].point3_ + start));
+    }
+
+    if (count)
+        cubics->back().point3_ = end;
+}
+
+} // anonymous namespace
+
+bool
+gfx::arc_to_centre_form(
+    const vector2& start,
+    const arc_segment& arc,
+    arc_centre_form* centre
+    )
+{
+    assert(centre);
+
+    const vector2 end(arc.point_);
+    float rx = std::fabs(arc.size_.x_);
+    float ry = std::fabs(arc.size_.y_);
+    if (is_zero(rx) || is_zero(ry) || start == end)
+        return false;
+
+    const bool clockwise = arc.sweep_direction_ == sweep_direction_clockwise;
+    const bool large_arc = arc.arc_size_ == arc_size_large;
+    const float phi = deg2rads(arc.rotation_angle_);
+    const float cos_phi = std::cos(phi);
+    const float sin_phi = std::sin(phi);
+
+    const vector2 half_diff = (start - end) * 0.5f;
+    const float x1p = cos_phi * half_diff.x_ + sin_phi * half_diff.y_;
+    const float y1p = -sin_phi * half_diff.x_ + cos_phi * half_diff.y_;
+
+    //
+    // Scale up radii that are too small for the arc to reach the end point.
+    // The centre is then exactly half way : computing it would take the
+    // square root of a rounding error, off by pixels on large ellipses.
+    float coef = 0.0f;
+    const float lambda = (x1p * x1p) / (rx * rx) + (y1p * y1p) / (ry * ry);
+    if (lambda >= 1.0f) {
+        const float s = std::sqrt(lambda);
+        rx *= s;
+        ry *= s;
+    } else {
+        const float rx2 = rx * rx;
+        const float ry2 = ry * ry;
+        const float num = rx2 * ry2 - rx2 * y1p * y1p - ry2 * x1p * x1p;
+        const float den = rx2 * y1p * y1p + ry2 * x1p * x1p;
+        coef = den > 0.0f ? std::sqrt(std::max(0.0f, num / den)) : 0.0f;
+        if (large_arc == clockwise)
+            coef = -coef;
+    }
+
+    const float cxp = coef * (rx * y1p / ry);
+    const float cyp = coef * -(ry * x1p / rx);
+    const vector2 mid = (start + end) * 0.5f;
+
+    const vector2 u((x1p - cxp) / rx, (y1p - cyp) / ry);
+    const vector2 v((-x1p - cxp) / rx, (-y1p - cyp) / ry);
+    float delta = vector_angle(u, v);
+
+    const float two_pi = 2.0f * PI;
+    if (!clockwise && delta > 0.0f)
+        delta -= two_pi;
+    else if (clockwise && delta < 0.0f)
+        delta += two_pi;
+
+    centre->centre_ = vector2(cos_phi * cxp - sin_phi * cyp + mid.x_,
+                              sin_phi * cxp + cos_phi * cyp + mid.y_);
+    centre->rx_ = rx;
+    centre->ry_ = ry;
+    centre->cos_phi_ = cos_phi;
+    centre->sin_phi_ = sin_phi;
+    centre->start_angle_ = vector_angle(vector2(1.0f, 0.0f), u);
+    centre->sweep_angle_ = delta;
+    return true;
+}
+
+/*
+ * The cubic with control points at 4/3 tan(a / 4) along the tangents
+ * strays at most r sin^6(a / 4) * 4 / (27 cos^2(a / 4)) from a circular arc
+ * of angle a, about r a^6 / 27648 : the largest angle within tolerance is
+ * (27648 tolerance / r)^(1 / 6).
+ */
+int
+gfx::arc_cubic_count(
+    const arc_centre_form& centre,
+    float tolerance
+    )
+{
+    assert(tolerance > 0.0f);
+
+    const float sweep = std::fabs(centre.sweep_angle_);
+    const float r = std::max(centre.rx_, centre.ry_);
+    const float max_angle = std::min(
+        PI * 0.5f, std::pow(27648.0f * tolerance / r, 1.0f / 6.0f));
+    const int segments = static_cast<int>(std::ceil(sweep / max_angle - 0.001f));
+    return std::max(1, std::min(segments, C_MaxCubicsPerArc));
+}
+
+bool
+gfx::arc_to_cubics(
+    const vector2& start,
+    const arc_segment& arc,
+    float tolerance,
+    std::vector<bezier_segment>* cubics
+    )
+{
+    assert(cubics);
+
+    const size_t first = cubics->size();
+    if (!convert_normalized(normalize_arc(start, arc), tolerance, cubics))
+        return false;
+
+    for (size_t i = first; i < cubics->size(); ++i) {
+        bezier_segment& cubic = (*cubics)[i];
+        cubic.point1_ += start;
+        cubic.point2_ += start;
+        cubic.point3_ += start;
+    }
+
+    cubics->back().point3_ = arc.point_;
+    return true;
+}
+
+size_t
+gfx::arc_cubic_cache::arc_key_hash::operator()(
+    const arc_key& key
+    ) const
+{
+    //
+    // FNV-1a over the words.
+    const uint32_t words[] = {
+        key.dx_, key.dy_, key.rx_, key.ry_, key.rotation_, key.tolerance_, key.flags_
+    };
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); ++i) {
+        h ^= words[i];
+        h *= 1099511628211ULL;
+    }
+    return static_cast<size_t>(h);
+}
+
+bool
+gfx::arc_cubic_cache::append_cubics(
+    const vector2& start,
+    const arc_segment& arc,
+    float tolerance,
+    std::vector<bezier_segment>* cubics
+    )
+{
+    assert(cubics);
+
+    const arc_segment normalized(normalize_arc(start, arc));
+    const arc_key key = {
+        float_bits(normalized.point_.x_), float_bits(normalized.point_.y_),
+        float_bits(normalized.size_.x_), float_bits(normalized.size_.y_),
+        float_bits(normalized.rotation_angle_), float_bits(tolerance),
+        static_cast<uint32_t>(normalized.sweep_direction_) |
+            (static_cast<uint32_t>(normalized.arc_size_) << 1)
+    };
+
+    std::unordered_map<arc_key, arc_list::iterator, arc_key_hash>::iterator found =
+        index_.find(key);
+    if (found != index_.end()) {
+        ++stats_.hits_;
+        entries_.splice(entries_.begin(), entries_, found->second);
+    } else {
+        ++stats_.misses_;
+
+        if (entries_.size() >= capacity_) {
+            index_.erase(entries_.back().key_);
+            entries_.pop_back();
+            ++stats_.evictions_;
+        }
+
+        entries_.push_front(arc_entry());
+        arc_entry& entry = entries_.front();
+        entry.key_ = key;
+        entry.line_ = !convert_normalized(normalized, tolerance, &entry.cubics_);
+        entry.cubics_.shrink_to_fit();
+        index_[key] = entries_.begin();
+    }
+
+    const arc_entry& entry = entries_.front();
+    if (entry.line_)
+        return false;
+
+    append_translated(&entry.cubics_[0], entry.cubics_.size(), start, arc.point_, cubics);
+    return true;
+}
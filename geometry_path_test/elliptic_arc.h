@@ -0,0 +1,190 @@
+/*
+ * elliptic_arc.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_ELLIPTIC_ARC_H_
+#define GFX_ELLIPTIC_ARC_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "path_sink.h"
+#include "vector2.h"
+
+namespace gfx {
+
+/*
+ * Centre parameterization of an elliptical arc : the points
+ * centre + rotate(phi) * (rx cos(angle), ry sin(angle)) for angle going
+ * from start_angle_ to start_angle_ + sweep_angle_ (radians, negative
+ * sweeps are counter clockwise).
+ */
+struct arc_centre_form {
+    vector2 centre_;
+    float   rx_;
+    float   ry_;
+    float   cos_phi_;
+    float   sin_phi_;
+    float   start_angle_;
+    float   sweep_angle_;
+
+    vector2 point_at(float angle) const {
+        const float x = rx_ * std::cos(angle);
+        const float y = ry_ * std::sin(angle);
+        return vector2(centre_.x_ + x * cos_phi_ - y * sin_phi_,
+                       centre_.y_ + x * sin_phi_ + y * cos_phi_);
+    }
+};
+
+/*
+ * Converts the endpoint parameterization (the arc starts at start) to the
+ * centre one, as in the SVG implementation notes (F.6.5, F.6.6). Radii too
+ * small for the arc to reach its end point are scaled up (F.6.6.2).
+ * Returns false when the arc is a straight line to arc.point_ : a zero
+ * radius or the end point on the start point.
+ */
+bool
+arc_to_centre_form(
+    const vector2& start,
+    const arc_segment& arc,
+    arc_centre_form* centre
+    );
+
+/*
+ * Number of cubics approximating the arc within tolerance : one per
+ * quarter turn at least, more when the larger radius needs them.
+ */
+int
+arc_cubic_count(
+    const arc_centre_form& centre,
+    float tolerance
+    );
+
+/*
+ * Appends the cubics approximating the arc (starting at start) within
+ * tolerance, the last one ends exactly on arc.point_. Returns false and
+ * appends nothing when the arc is a straight line.
+ *
+ * The conversion is done with the start point at the origin and the
+ * result moved there afterwards, so an arc gives the same cubics wherever
+ * it is and arc_cubic_cache hits are identical to conversions.
+ */
+bool
+arc_to_cubics(
+    const vector2& start,
+    const arc_segment& arc,
+    float tolerance,
+    std::vector<bezier_segment>* cubics
+    );
+
+struct arc_cache_statistics {
+    uint64_t    hits_;
+    uint64_t    misses_;
+    uint64_t    evictions_;
+
+    arc_cache_statistics() {
+        reset();
+    }
+
+    void reset() {
+        hits_ = misses_ = evictions_ = 0;
+    }
+};
+
+/*
+ * Remembers arc conversions, keyed by the normalized arc : the end point
+ * relative to the start, absolute radii, the rotation modulo half a turn
+ * (none for circles), the flags and the tolerance. An arc repeated at
+ * another position (instanced shapes, rebuilt paths) is converted once.
+ *
+ * Holds at most capacity arcs, least recently used ones are dropped
+ * first.
+ */
+class arc_cubic_cache {
+public :
+    static const size_t C_DefaultCapacity = 1024;
+
+    explicit arc_cubic_cache(size_t capacity = C_DefaultCapacity)
+        : capacity_(capacity) {
+        assert(capacity_ > 0);
+    }
+
+    /*
+     * Same as arc_to_cubics(start, arc, tolerance, cubics).
+     */
+    bool append_cubics(
+        const vector2& start, const arc_segment& arc, float tolerance,
+        std::vector<bezier_segment>* cubics);
+
+    size_t size() const {
+        return entries_.size();
+    }
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    void clear() {
+        entries_.clear();
+        index_.clear();
+    }
+
+    const arc_cache_statistics& statistics() const {
+        return stats_;
+    }
+
+    void reset_statistics() {
+        stats_.reset();
+    }
+
+private :
+    struct arc_key {
+        //
+        // Bit patterns of the normalized floats.
+        uint32_t    dx_;
+        uint32_t    dy_;
+        uint32_t    rx_;
+        uint32_t    ry_;
+        uint32_t    rotation_;
+        uint32_t    tolerance_;
+        uint32_t    flags_;
+
+        bool operator==(const arc_key& rhs) const {
+            return dx_ == rhs.dx_ && dy_ == rhs.dy_ && rx_ == rhs.rx_ && ry_ == rhs.ry_ &&
+                rotation_ == rhs.rotation_ && tolerance_ == rhs.tolerance_ &&
+                flags_ == rhs.flags_;
+        }
+    };
+
+    struct arc_key_hash {
+        size_t operator()(const arc_key& key) const;
+    };
+
+    struct arc_entry {
+        arc_key                     key_;
+        bool                        line_;
+        //
+        // Relative to the start point.
+        std::vector<bezier_segment> cubics_;
+    };
+
+    typedef std::list<arc_entry> arc_list;
+
+    size_t                                                      capacity_;
+    //
+    // Most recently used first.
+    arc_list                                                    entries_;
+    std::unordered_map<arc_key, arc_list::iterator, arc_key_hash>   index_;
+    arc_cache_statistics                                        stats_;
+};
+
+} // ns gfx
+
+#endif /* GFX_ELLIPTIC_ARC_H_ */
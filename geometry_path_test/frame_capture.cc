@@ -0,0 +1,179 @@
+/*
+ * frame_capture.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "frame_capture.h"
+#include "trace.h"
+
+bool
+gfx::image_file_writer::write_frame(
+    uint64_t frame_id,
+    const uint8_t* data,
+    size_t size
+    )
+{
+    char file_name[512];
+    std::snprintf(file_name, sizeof(file_name), "%s_%06llu.%s", prefix_.c_str(),
+                  static_cast<unsigned long long>(frame_id),
+                  image_format_extension(format_));
+
+    FILE* fp = std::fopen(file_name, "wb");
+    if (!fp)
+        return false;
+
+    const bool written = std::fwrite(data, 1, size, fp) == size;
+    return (std::fclose(fp) == 0) && written;
+}
+
+gfx::frame_capture::frame_capture(
+    int width,
+    int height,
+    size_t buffer_count,
+    image_format format,
+    capture_overflow_policy policy,
+    frame_writer* writer
+    )
+    : format_(format),
+      policy_(policy),
+      writer_(writer),
+      buffers_(buffer_count),
+      stop_(false)
+{
+    assert(width > 0 && height > 0);
+    assert(buffer_count > 0);
+    assert(writer_);
+
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+        capture_buffer& buffer = buffers_[i];
+        buffer.pixels_.resize(static_cast<size_t>(width) * height);
+        buffer.surface_ = pixel_surface(&buffer.pixels_[0], width, height, width);
+        buffer.frame_id_ = 0;
+        free_buffers_.push_back(&buffer);
+    }
+
+    encoder_thread_ = std::thread(&frame_capture::encoder_thread_proc, this);
+}
+
+gfx::frame_capture::~frame_capture() {
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        stop_ = true;
+    }
+    buffer_ready_.notify_one();
+    encoder_thread_.join();
+}
+
+gfx::capture_buffer*
+gfx::frame_capture::acquire(
+    uint64_t frame_index
+    )
+{
+    std::unique_lock<std::mutex> guard(lock_);
+
+    if (free_buffers_.empty()) {
+        if (policy_ == capture_overflow_drop) {
+            ++counters_.dropped_;
+            return nullptr;
+        }
+
+        buffer_freed_.wait(guard, [this]() { return !free_buffers_.empty(); });
+    }
+
+    capture_buffer* buffer = free_buffers_.back();
+    free_buffers_.pop_back();
+    buffer->frame_id_ = frame_index;
+    return buffer;
+}
+
+void
+gfx::frame_capture::submit(
+    capture_buffer* buffer
+    )
+{
+    assert(buffer);
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        ready_buffers_.push_back(buffer);
+        ++counters_.queued_;
+    }
+    buffer_ready_.notify_one();
+}
+
+void
+gfx::frame_capture::cancel(
+    capture_buffer* buffer
+    )
+{
+    assert(buffer);
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        free_buffers_.push_back(buffer);
+    }
+    buffer_freed_.notify_all();
+}
+
+void
+gfx::frame_capture::flush() {
+    std::unique_lock<std::mutex> guard(lock_);
+    buffer_freed_.wait(guard, [this]() { return counters_.queued_ == 0; });
+}
+
+gfx::capture_counters
+gfx::frame_capture::counters() const {
+    std::lock_guard<std::mutex> guard(lock_);
+    return counters_;
+}
+
+void
+gfx::frame_capture::encoder_thread_proc() {
+    GFX_TRACE_THREAD_NAME("capture encoder");
+
+    //
+    // Reused for every frame, grows to the size of the largest encoded
+    // frame and stays there.
+    std::vector<uint8_t> encoded;
+
+    for (;;) {
+        capture_buffer* buffer = nullptr;
+        {
+            std::unique_lock<std::mutex> guard(lock_);
+            buffer_ready_.wait(guard, [this]() {
+                return stop_ || !ready_buffers_.empty();
+            });
+
+            //
+            // Frames submitted before shutdown are still written.
+            if (ready_buffers_.empty())
+                break;
+
+            buffer = ready_buffers_.front();
+            ready_buffers_.pop_front();
+        }
+
+        bool written;
+        {
+            GFX_TRACE_ZONE("encode");
+            encode_image(format_, buffer->surface_, &encoded);
+            //
+            // Nothing encoded is an encoder failure.
+            written = !encoded.empty() &&
+                writer_->write_frame(buffer->frame_id_, &encoded[0], encoded.size());
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            if (written) {
+                ++counters_.captured_;
+                counters_.bytes_written_ += encoded.size();
+            } else {
+                ++counters_.failed_;
+            }
+            --counters_.queued_;
+            free_buffers_.push_back(buffer);
+        }
+        buffer_freed_.notify_all();
+    }
+}
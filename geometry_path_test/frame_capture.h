@@ -0,0 +1,154 @@
+/*
+ * frame_capture.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_FRAME_CAPTURE_H_
+#define GFX_FRAME_CAPTURE_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "image_encoders.h"
+#include "software_render_target.h"
+
+namespace gfx {
+
+/*
+ * Stores encoded frames. Called on the encoder thread.
+ */
+class frame_writer {
+public :
+    virtual ~frame_writer() {}
+
+    virtual bool write_frame(uint64_t frame_id, const uint8_t* data, size_t size) = 0;
+};
+
+/*
+ * Writes every frame to its own file, <prefix>_<frame id>.<ext>. Dropped
+ * frames show up as gaps in the numbering.
+ */
+class image_file_writer : public frame_writer {
+public :
+    image_file_writer(const std::string& prefix, image_format format)
+        : prefix_(prefix), format_(format) {}
+
+    bool write_frame(uint64_t frame_id, const uint8_t* data, size_t size);
+
+private :
+    std::string     prefix_;
+    image_format    format_;
+};
+
+/*
+ * What to do when the render thread wants a buffer and all of them are
+ * still waiting for the encoder.
+ */
+enum capture_overflow_policy {
+    //
+    // Wait for the encoder, the render loop slows down to encoding speed.
+    capture_overflow_block,
+    //
+    // Skip capturing the frame, the render loop never waits.
+    capture_overflow_drop
+};
+
+struct capture_counters {
+    //
+    // Frames encoded and stored.
+    uint64_t    captured_;
+    //
+    // Frames not captured because no buffer was free.
+    uint64_t    dropped_;
+    //
+    // Frames the encoder or the writer failed on.
+    uint64_t    failed_;
+    //
+    // Frames submitted and waiting for (or being processed by) the encoder.
+    uint64_t    queued_;
+    uint64_t    bytes_written_;
+
+    capture_counters()
+        : captured_(0), dropped_(0), failed_(0), queued_(0), bytes_written_(0) {}
+};
+
+struct capture_buffer {
+    std::vector<uint32_t>   pixels_;
+    pixel_surface           surface_;
+    //
+    // The source frame index given to acquire().
+    uint64_t                frame_id_;
+};
+
+/*
+ * Hands finished frames to a background encoder thread.
+ *
+ * The frames are rendered straight into buffers from a fixed pool (bind
+ * the buffer's surface to a software_render_target), so the render thread
+ * never copies pixels : acquire() a buffer, render into it, submit() it.
+ * The encoder thread encodes the buffer, passes the bytes to the writer
+ * and puts the buffer back in the pool.
+ */
+class frame_capture {
+public :
+    frame_capture(
+        int width, int height, size_t buffer_count, image_format format,
+        capture_overflow_policy policy, frame_writer* writer);
+
+    ~frame_capture();
+
+    /*
+     * Returns a free buffer for the source frame frame_index, or nullptr
+     * if the frame has to be dropped (capture_overflow_drop and no free
+     * buffer).
+     */
+    capture_buffer* acquire(uint64_t frame_index);
+
+    /*
+     * Queues a buffer returned by acquire() for encoding. The render
+     * thread must not touch it afterwards.
+     */
+    void submit(capture_buffer* buffer);
+
+    /*
+     * Gives back a buffer returned by acquire() without capturing it.
+     */
+    void cancel(capture_buffer* buffer);
+
+    /*
+     * Waits until every submitted frame has been stored.
+     */
+    void flush();
+
+    capture_counters counters() const;
+
+private :
+    frame_capture(const frame_capture&);
+    frame_capture& operator=(const frame_capture&);
+
+    void encoder_thread_proc();
+
+    image_format                    format_;
+    capture_overflow_policy         policy_;
+    frame_writer*                   writer_;
+    std::vector<capture_buffer>     buffers_;
+    std::vector<capture_buffer*>    free_buffers_;
+    std::deque<capture_buffer*>     ready_buffers_;
+    mutable std::mutex              lock_;
+    std::condition_variable         buffer_freed_;
+    std::condition_variable         buffer_ready_;
+    capture_counters                counters_;
+    bool                            stop_;
+    std::thread                     encoder_thread_;
+};
+
+} // ns gfx
+
+#endif /* GFX_FRAME_CAPTURE_H_ */
@@ -0,0 +1,126 @@
+/*
+ * geometry_lod_cache.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "geometry_lod_cache.h"
+
+#include <cmath>
+
+namespace {
+
+//
+// The band holding a local tolerance : 2^band <= tolerance < 2^(band + 1).
+inline
+int
+tolerance_band(
+    float tolerance
+    )
+{
+    int exponent = 0;
+    std::frexp(tolerance, &exponent);
+    return exponent - 1;
+}
+
+inline
+size_t
+lod_bytes(
+    const gfx::flattened_path& path
+    )
+{
+    return sizeof(gfx::flattened_path) +
+        path.points_.capacity() * sizeof(gfx::vector2) +
+        path.figure_ends_.capacity() * sizeof(size_t);
+}
+
+} // anonymous namespace
+
+const gfx::flattened_path&
+gfx::geometry_lod_cache::find_lod(
+    const path_geometry& geometry,
+    float local_tolerance
+    )
+{
+    assert(local_tolerance > 0.0f);
+
+    const lod_key key = { &geometry, geometry.revision(), tolerance_band(local_tolerance) };
+
+    std::unordered_map<lod_key, lod_list::iterator, lod_key_hash>::iterator found =
+        index_.find(key);
+    if (found != index_.end()) {
+        ++stats_.hits_;
+        entries_.splice(entries_.begin(), entries_, found->second);
+        return found->second->path_;
+    }
+
+    ++stats_.misses_;
+
+    entries_.push_front(lod_entry());
+    lod_entry& entry = entries_.front();
+    entry.key_ = key;
+    geometry.flatten(matrix3X3::identity, std::ldexp(1.0f, key.band_), &entry.path_);
+    entry.path_.points_.shrink_to_fit();
+    entry.path_.figure_ends_.shrink_to_fit();
+    entry.bytes_ = lod_bytes(entry.path_);
+
+    memory_used_ += entry.bytes_;
+    stats_.points_flattened_ += entry.path_.points_.size();
+    index_[key] = entries_.begin();
+
+    //
+    // The new LOD itself is never evicted, even if it is over budget on
+    // its own.
+    evict_to_budget();
+    return entry.path_;
+}
+
+void
+gfx::geometry_lod_cache::flatten(
+    const path_geometry& geometry,
+    const matrix3X3& xform,
+    float tolerance,
+    flattened_path* result
+    )
+{
+    assert(result);
+    assert(tolerance > 0.0f);
+
+    const float scale = transform_scale_factor(xform);
+    const float local_tolerance = scale > EPSILON ? tolerance / scale : tolerance;
+    const flattened_path& lod = find_lod(geometry, local_tolerance);
+
+    result->fill_mode_ = lod.fill_mode_;
+    result->figure_ends_ = lod.figure_ends_;
+    result->points_.resize(lod.points_.size());
+    for (size_t i = 0; i < lod.points_.size(); ++i)
+        result->points_[i] = xform * lod.points_[i];
+}
+
+void
+gfx::geometry_lod_cache::set_budget(
+    size_t budget_bytes
+    )
+{
+    budget_ = budget_bytes;
+    evict_to_budget();
+}
+
+void
+gfx::geometry_lod_cache::evict_to_budget() {
+    while (memory_used_ > budget_ && entries_.size() > 1) {
+        const lod_entry& oldest = entries_.back();
+        memory_used_ -= oldest.bytes_;
+        index_.erase(oldest.key_);
+        entries_.pop_back();
+        ++stats_.evictions_;
+    }
+}
+
+void
+gfx::geometry_lod_cache::clear() {
+    entries_.clear();
+    index_.clear();
+    memory_used_ = 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * geometry_lod_cache.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_GEOMETRY_LOD_CACHE_H_
+#define GFX_GEOMETRY_LOD_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+#include "matrix3x3.h"
+#include "path_geometry.h"
+
+namespace gfx {
+
+struct geometry_lod_statistics {
+    uint64_t    hits_;
+    uint64_t    misses_;
+    uint64_t    evictions_;
+    //
+    // Points produced by flattening on misses, the work the hits saved.
+    uint64_t    points_flattened_;
+
+    geometry_lod_statistics() {
+        reset();
+    }
+
+    void reset() {
+        hits_ = misses_ = evictions_ = points_flattened_ = 0;
+    }
+};
+
+/*
+ * Keeps flattened versions (levels of detail) of geometries, in the
+ * geometry's own space, so drawing a geometry only transforms points
+ * instead of subdividing its curves again.
+ *
+ * The tolerance a draw needs in local space is the device tolerance
+ * divided by the scale of the transform. LODs are made for power of two
+ * bands of that local tolerance (a LOD at 2^k serves every request from
+ * 2^k up to 2^(k + 1)), so a geometry drawn at a fixed scale uses a single
+ * LOD and zooming creates the missing ones as it goes.
+ *
+ * Memory is bounded by a budget in bytes, least recently used LODs are
+ * dropped first. Entries are keyed by geometry address and revision : a
+ * reopened geometry misses, its old LODs age out.
+ */
+class geometry_lod_cache {
+public :
+    static const size_t C_DefaultBudget = 4 * 1024 * 1024;
+
+    explicit geometry_lod_cache(size_t budget_bytes = C_DefaultBudget)
+        : budget_(budget_bytes), memory_used_(0) {}
+
+    /*
+     * Same as geometry.flatten(xform, tolerance, result), through the
+     * cached LOD for that scale (never coarser than tolerance).
+     */
+    void flatten(
+        const path_geometry& geometry, const matrix3X3& xform, float tolerance,
+        flattened_path* result);
+
+    /*
+     * The LOD of geometry flattened at most at local_tolerance, created if
+     * missing. Valid until the next call that may create a LOD.
+     */
+    const flattened_path& find_lod(const path_geometry& geometry, float local_tolerance);
+
+    void set_budget(size_t budget_bytes);
+
+    size_t budget() const {
+        return budget_;
+    }
+
+    size_t memory_used() const {
+        return memory_used_;
+    }
+
+    size_t lod_count() const {
+        return entries_.size();
+    }
+
+    void clear();
+
+    const geometry_lod_statistics& statistics() const {
+        return stats_;
+    }
+
+    void reset_statistics() {
+        stats_.reset();
+    }
+
+private :
+    struct lod_key {
+        const path_geometry*    geometry_;
+        uint32_t                revision_;
+        int                     band_;
+
+        bool operator==(const lod_key& rhs) const {
+            return geometry_ == rhs.geometry_ && revision_ == rhs.revision_ &&
+                band_ == rhs.band_;
+        }
+    };
+
+    struct lod_key_hash {
+        size_t operator()(const lod_key& key) const {
+            size_t h = std::hash<const void*>()(key.geometry_);
+            h ^= (static_cast<size_t>(key.revision_) << 8) + static_cast<size_t>(key.band_);
+            return h;
+        }
+    };
+
+    struct lod_entry {
+        lod_key         key_;
+        flattened_path  path_;
+        size_t          bytes_;
+    };
+
+    typedef std::list<lod_entry> lod_list;
+
+    void evict_to_budget();
+
+    size_t                                                      budget_;
+    size_t                                                      memory_used_;
+    //
+    // Most recently used first.
+    lod_list                                                    entries_;
+    std::unordered_map<lod_key, lod_list::iterator, lod_key_hash>   index_;
+    geometry_lod_statistics                                     stats_;
+};
+
+} // ns gfx
+
+#endif /* GFX_GEOMETRY_LOD_CACHE_H_ */
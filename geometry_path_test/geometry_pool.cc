@@ -0,0 +1,57 @@
+/*
+ * geometry_pool.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "geometry_pool.h"
+
+gfx::geometry_pool::geometry_handle
+gfx::geometry_pool::intern(
+    const std::shared_ptr<path_geometry>& geometry
+    )
+{
+    assert(geometry);
+    ++stats_.lookups_;
+
+    const uint64_t hash = geometry->content_hash();
+    typedef std::unordered_multimap<uint64_t, geometry_handle>::iterator pool_iterator;
+    const std::pair<pool_iterator, pool_iterator> range = geometries_.equal_range(hash);
+    for (pool_iterator it = range.first; it != range.second; ++it) {
+        if (it->second == geometry || it->second->same_content(*geometry)) {
+            ++stats_.hits_;
+            if (it->second != geometry)
+                stats_.bytes_saved_ += geometry->memory_size();
+            return it->second;
+        }
+    }
+
+    geometries_.insert(std::make_pair(hash, geometry_handle(geometry)));
+    return geometry;
+}
+
+size_t
+gfx::geometry_pool::purge_unused() {
+    size_t purged = 0;
+    for (std::unordered_multimap<uint64_t, geometry_handle>::iterator it = geometries_.begin();
+         it != geometries_.end(); ) {
+        if (it->second.use_count() == 1) {
+            it = geometries_.erase(it);
+            ++purged;
+        } else {
+            ++it;
+        }
+    }
+
+    return purged;
+}
+
+size_t
+gfx::geometry_pool::memory_used() const {
+    size_t bytes = 0;
+    for (std::unordered_multimap<uint64_t, geometry_handle>::const_iterator it =
+             geometries_.begin(); it != geometries_.end(); ++it)
+        bytes += it->second->memory_size();
+    return bytes;
+}
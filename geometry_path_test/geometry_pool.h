@@ -0,0 +1,93 @@
+/*
+ * geometry_pool.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_GEOMETRY_POOL_H_
+#define GFX_GEOMETRY_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+#include "path_geometry.h"
+
+namespace gfx {
+
+struct geometry_pool_statistics {
+    uint64_t    lookups_;
+    //
+    // Lookups that found a geometry with the same content.
+    uint64_t    hits_;
+    //
+    // Bytes of the duplicates handed back instead of being kept.
+    uint64_t    bytes_saved_;
+
+    geometry_pool_statistics() {
+        reset();
+    }
+
+    void reset() {
+        lookups_ = hits_ = bytes_saved_ = 0;
+    }
+};
+
+/*
+ * Interns geometries by content : identical shapes (a squadron of
+ * fighters built from the same outline) end up sharing one immutable
+ * geometry, so the path data is stored once and the render target's LOD
+ * cache flattens it once.
+ *
+ * Pooled geometries are const : a shape that changes has to be built
+ * into a new geometry and interned again. Not thread safe.
+ */
+class geometry_pool {
+public :
+    typedef std::shared_ptr<const path_geometry> geometry_handle;
+
+    /*
+     * Returns the pooled geometry with the same content as geometry,
+     * adding geometry to the pool if there is none yet.
+     */
+    geometry_handle intern(const std::shared_ptr<path_geometry>& geometry);
+
+    /*
+     * Drops the geometries only the pool still holds, returns how many.
+     */
+    size_t purge_unused();
+
+    size_t size() const {
+        return geometries_.size();
+    }
+
+    /*
+     * Bytes used by the pooled geometries.
+     */
+    size_t memory_used() const;
+
+    void clear() {
+        geometries_.clear();
+    }
+
+    const geometry_pool_statistics& statistics() const {
+        return stats_;
+    }
+
+    void reset_statistics() {
+        stats_.reset();
+    }
+
+private :
+    //
+    // By content hash, colliding geometries are told apart with
+    // path_geometry::same_content().
+    std::unordered_multimap<uint64_t, geometry_handle>  geometries_;
+    geometry_pool_statistics                            stats_;
+};
+
+} // ns gfx
+
+#endif /* GFX_GEOMETRY_POOL_H_ */
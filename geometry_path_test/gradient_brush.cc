@@ -0,0 +1,397 @@
+/*
+ * gradient_brush.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "gradient_brush.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "pixel_ops.h"
+
+#if defined(GFX_HAVE_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+const float C_TableScale = static_cast<float>(gfx::gradient_stop_collection::Table_Size - 1);
+
+//
+// Keeps t far enough from the int32 limits for the float -> int conversions.
+const float C_MaxGradientParam = 1.0e6f;
+
+bool
+stop_position_less(
+    const gfx::gradient_stop& lhs,
+    const gfx::gradient_stop& rhs
+    )
+{
+    return lhs.position_ < rhs.position_;
+}
+
+//
+// The extend mode is resolved once per span : each of these is a branch
+// free mapping of the gradient parameter to [0, 1].
+struct extend_clamp {
+    static float apply(float t) {
+        return gfx::clamp(t, 0.0f, 1.0f);
+    }
+
+#if defined(GFX_HAVE_SSE2)
+    static __m128 apply(__m128 t) {
+        return _mm_min_ps(_mm_max_ps(t, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+    }
+#endif
+};
+
+#if defined(GFX_HAVE_SSE2)
+//
+// floor() for values well inside the int32 range.
+inline
+__m128
+floor_ps(
+    __m128 value
+    )
+{
+    const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(value));
+    return _mm_sub_ps(truncated,
+                      _mm_and_ps(_mm_cmpgt_ps(truncated, value), _mm_set1_ps(1.0f)));
+}
+
+inline
+__m128
+abs_ps(
+    __m128 value
+    )
+{
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), value);
+}
+#endif
+
+struct extend_wrap {
+    static float apply(float t) {
+        return t - std::floor(t);
+    }
+
+#if defined(GFX_HAVE_SSE2)
+    static __m128 apply(__m128 t) {
+        return _mm_sub_ps(t, floor_ps(t));
+    }
+#endif
+};
+
+struct extend_mirror {
+    //
+    // Period 2 triangle wave : 1 - |(t mod 2) - 1|.
+    static float apply(float t) {
+        const float m = t - 2.0f * std::floor(t * 0.5f);
+        return 1.0f - std::fabs(m - 1.0f);
+    }
+
+#if defined(GFX_HAVE_SSE2)
+    static __m128 apply(__m128 t) {
+        const __m128 two = _mm_set1_ps(2.0f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 m = _mm_sub_ps(t, _mm_mul_ps(two, floor_ps(_mm_mul_ps(t, _mm_set1_ps(0.5f)))));
+        return _mm_sub_ps(one, abs_ps(_mm_sub_ps(m, one)));
+    }
+#endif
+};
+
+inline
+uint32_t
+lookup(
+    const uint32_t* table,
+    float t
+    )
+{
+    return table[static_cast<int>(t * C_TableScale + 0.5f)];
+}
+
+/*
+ * Linear gradient : t grows by dt from one pixel to the next.
+ */
+template<typename Extend>
+void
+shade_linear(
+    const uint32_t* table,
+    float t,
+    float dt,
+    int count,
+    uint32_t* out
+    )
+{
+#if defined(GFX_HAVE_SSE2)
+    if (count >= 4) {
+        __m128 tv = _mm_add_ps(_mm_set1_ps(t),
+                               _mm_mul_ps(_mm_set1_ps(dt), _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f)));
+        const __m128 step = _mm_set1_ps(4.0f * dt);
+        const __m128 scale = _mm_set1_ps(C_TableScale);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 limit = _mm_set1_ps(C_MaxGradientParam);
+        const __m128 neg_limit = _mm_set1_ps(-C_MaxGradientParam);
+
+        while (count >= 4) {
+            const __m128 clamped = _mm_min_ps(_mm_max_ps(tv, neg_limit), limit);
+            const __m128i index = _mm_cvttps_epi32(
+                _mm_add_ps(_mm_mul_ps(Extend::apply(clamped), scale), half));
+
+            int32_t idx[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(idx), index);
+            out[0] = table[idx[0]];
+            out[1] = table[idx[1]];
+            out[2] = table[idx[2]];
+            out[3] = table[idx[3]];
+
+            out += 4;
+            count -= 4;
+            tv = _mm_add_ps(tv, step);
+            t += 4.0f * dt;
+        }
+    }
+#endif
+
+    for (; count > 0; --count, t += dt)
+        *out++ = lookup(table, Extend::apply(gfx::clamp(t, -C_MaxGradientParam, C_MaxGradientParam)));
+}
+
+/*
+ * Radial gradient, in the space where the end ellipse is the unit circle
+ * centred at the origin and the gradient origin is f (|f| < 1). For a
+ * point q, with d = q - f, t is the fraction of the way from f to the
+ * circle along the ray through q :
+ *
+ *  t = |d|^2 / (-(f.d) + sqrt((f.d)^2 + |d|^2 * (1 - |f|^2)))
+ *
+ * (the positive root of |f + d / t| = 1). q steps by (dqx, dqy) per pixel.
+ */
+template<typename Extend>
+void
+shade_radial(
+    const uint32_t* table,
+    float qx,
+    float qy,
+    float dqx,
+    float dqy,
+    float fx,
+    float fy,
+    int count,
+    uint32_t* out
+    )
+{
+    const float one_minus_f2 = 1.0f - (fx * fx + fy * fy);
+
+#if defined(GFX_HAVE_SSE2)
+    if (count >= 4) {
+        const __m128 lane = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+        __m128 dx = _mm_add_ps(_mm_set1_ps(qx - fx), _mm_mul_ps(_mm_set1_ps(dqx), lane));
+        __m128 dy = _mm_add_ps(_mm_set1_ps(qy - fy), _mm_mul_ps(_mm_set1_ps(dqy), lane));
+        const __m128 step_x = _mm_set1_ps(4.0f * dqx);
+        const __m128 step_y = _mm_set1_ps(4.0f * dqy);
+        const __m128 fxv = _mm_set1_ps(fx);
+        const __m128 fyv = _mm_set1_ps(fy);
+        const __m128 k = _mm_set1_ps(one_minus_f2);
+        const __m128 scale = _mm_set1_ps(C_TableScale);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 limit = _mm_set1_ps(C_MaxGradientParam);
+        const __m128 tiny = _mm_set1_ps(1.0e-12f);
+
+        while (count >= 4) {
+            const __m128 fd = _mm_add_ps(_mm_mul_ps(fxv, dx), _mm_mul_ps(fyv, dy));
+            const __m128 dd = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            const __m128 root = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(fd, fd), _mm_mul_ps(dd, k)));
+            //
+            // The denominator is 0 only at the gradient origin, where t = 0.
+            const __m128 denom = _mm_max_ps(_mm_sub_ps(root, fd), tiny);
+            const __m128 t = _mm_min_ps(_mm_div_ps(dd, denom), limit);
+            const __m128i index = _mm_cvttps_epi32(
+                _mm_add_ps(_mm_mul_ps(Extend::apply(t), scale), half));
+
+            int32_t idx[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(idx), index);
+            out[0] = table[idx[0]];
+            out[1] = table[idx[1]];
+            out[2] = table[idx[2]];
+            out[3] = table[idx[3]];
+
+            out += 4;
+            count -= 4;
+            dx = _mm_add_ps(dx, step_x);
+            dy = _mm_add_ps(dy, step_y);
+            qx += 4.0f * dqx;
+            qy += 4.0f * dqy;
+        }
+    }
+#endif
+
+    for (; count > 0; --count, qx += dqx, qy += dqy) {
+        const float dx = qx - fx;
+        const float dy = qy - fy;
+        const float fd = fx * dx + fy * dy;
+        const float dd = dx * dx + dy * dy;
+        const float denom = std::max(std::sqrt(fd * fd + dd * one_minus_f2) - fd, 1.0e-12f);
+        *out++ = lookup(table, Extend::apply(std::min(dd / denom, C_MaxGradientParam)));
+    }
+}
+
+} // anonymous namespace
+
+gfx::gradient_stop_collection::gradient_stop_collection(
+    const gradient_stop* stops,
+    size_t count,
+    extend_mode mode
+    )
+    : stops_(stops, stops + count),
+      table_(Table_Size),
+      extend_mode_(mode),
+      opaque_(true)
+{
+    assert(stops && count);
+
+    //
+    // Like Direct2D, stops are used in position order, positions outside
+    // [0, 1] are clamped.
+    for (size_t i = 0; i < stops_.size(); ++i)
+        stops_[i].position_ = clamp(stops_[i].position_, 0.0f, 1.0f);
+    std::stable_sort(stops_.begin(), stops_.end(), stop_position_less);
+
+    build_table();
+}
+
+void
+gfx::gradient_stop_collection::build_table() {
+    //
+    // Interpolation is done on premultiplied colours, so a stop fading to
+    // transparent doesn't bleed its colour into the neighbours.
+    size_t next = 0;
+    for (int i = 0; i < Table_Size; ++i) {
+        const float t = static_cast<float>(i) / C_TableScale;
+        while (next < stops_.size() && stops_[next].position_ <= t)
+            ++next;
+
+        color clr;
+        if (next == 0) {
+            clr = stops_.front().color_;
+        } else if (next == stops_.size()) {
+            clr = stops_.back().color_;
+        } else {
+            const gradient_stop& s0 = stops_[next - 1];
+            const gradient_stop& s1 = stops_[next];
+            const float k = (t - s0.position_) / (s1.position_ - s0.position_);
+            const float a0 = clamp(s0.color_.a_, 0.0f, 1.0f);
+            const float a1 = clamp(s1.color_.a_, 0.0f, 1.0f);
+            const float a = a0 + (a1 - a0) * k;
+            clr.a_ = a;
+            if (is_zero(a)) {
+                clr.r_ = clr.g_ = clr.b_ = 0.0f;
+            } else {
+                clr.r_ = (s0.color_.r_ * a0 + (s1.color_.r_ * a1 - s0.color_.r_ * a0) * k) / a;
+                clr.g_ = (s0.color_.g_ * a0 + (s1.color_.g_ * a1 - s0.color_.g_ * a0) * k) / a;
+                clr.b_ = (s0.color_.b_ * a0 + (s1.color_.b_ * a1 - s0.color_.b_ * a0) * k) / a;
+            }
+        }
+
+        table_[i] = pack_premultiplied_rgba8(clr);
+    }
+
+    opaque_ = true;
+    for (size_t i = 0; i < stops_.size(); ++i)
+        opaque_ = opaque_ && stops_[i].color_.is_opaque();
+}
+
+void
+gfx::linear_gradient_brush::shade_span(
+    const matrix3X3& device_to_brush,
+    int x,
+    int y,
+    int count,
+    uint32_t* out
+    ) const
+{
+    const uint32_t* table = stops_.lookup_table();
+    const vector2 axis(end_point_ - start_point_);
+    const float axis_len2 = axis.x_ * axis.x_ + axis.y_ * axis.y_;
+
+    //
+    // Degenerate gradient, D2D paints it with the last stop.
+    if (is_zero(axis_len2)) {
+        fill_span(out, count, table[gradient_stop_collection::Table_Size - 1]);
+        return;
+    }
+
+    //
+    // Sample at pixel centres. t is affine in device x, so it is computed
+    // once for the span and then stepped.
+    const vector2 p(device_to_brush * vector2(x + 0.5f, y + 0.5f));
+    const vector2 dp(device_to_brush.a11_, device_to_brush.a21_);
+    const float t = dot_product(p - start_point_, axis) / axis_len2;
+    const float dt = dot_product(dp, axis) / axis_len2;
+
+    switch (stops_.get_extend_mode()) {
+    case extend_mode_wrap :
+        shade_linear<extend_wrap>(table, t, dt, count, out);
+        break;
+
+    case extend_mode_mirror :
+        shade_linear<extend_mirror>(table, t, dt, count, out);
+        break;
+
+    default :
+        shade_linear<extend_clamp>(table, t, dt, count, out);
+        break;
+    }
+}
+
+void
+gfx::radial_gradient_brush::shade_span(
+    const matrix3X3& device_to_brush,
+    int x,
+    int y,
+    int count,
+    uint32_t* out
+    ) const
+{
+    const uint32_t* table = stops_.lookup_table();
+
+    if (is_zero(radius_x_) || is_zero(radius_y_)) {
+        fill_span(out, count, table[gradient_stop_collection::Table_Size - 1]);
+        return;
+    }
+
+    const float inv_rx = 1.0f / radius_x_;
+    const float inv_ry = 1.0f / radius_y_;
+    const vector2 p(device_to_brush * vector2(x + 0.5f, y + 0.5f) - center_);
+    const float qx = p.x_ * inv_rx;
+    const float qy = p.y_ * inv_ry;
+    const float dqx = device_to_brush.a11_ * inv_rx;
+    const float dqy = device_to_brush.a21_ * inv_ry;
+
+    //
+    // Like Direct2D, an origin on or outside the ellipse is pulled just
+    // inside it.
+    float fx = origin_offset_.x_ * inv_rx;
+    float fy = origin_offset_.y_ * inv_ry;
+    const float flen = std::sqrt(fx * fx + fy * fy);
+    if (flen > 0.999f) {
+        fx *= 0.999f / flen;
+        fy *= 0.999f / flen;
+    }
+
+    switch (stops_.get_extend_mode()) {
+    case extend_mode_wrap :
+        shade_radial<extend_wrap>(table, qx, qy, dqx, dqy, fx, fy, count, out);
+        break;
+
+    case extend_mode_mirror :
+        shade_radial<extend_mirror>(table, qx, qy, dqx, dqy, fx, fy, count, out);
+        break;
+
+    default :
+        shade_radial<extend_clamp>(table, qx, qy, dqx, dqy, fx, fy, count, out);
+        break;
+    }
+}
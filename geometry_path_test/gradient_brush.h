@@ -0,0 +1,189 @@
+/*
+ * gradient_brush.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_GRADIENT_BRUSH_H_
+#define GFX_GRADIENT_BRUSH_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "brush.h"
+#include "color.h"
+#include "matrix3x3.h"
+#include "vector2.h"
+
+namespace gfx {
+
+struct gradient_stop {
+    float   position_;
+    color   color_;
+
+    gradient_stop() {}
+
+    gradient_stop(float position, const color& clr)
+        : position_(position), color_(clr) {}
+};
+
+/*
+ * Same values as D2D1_EXTEND_MODE.
+ */
+enum extend_mode {
+    extend_mode_clamp,
+    extend_mode_wrap,
+    extend_mode_mirror
+};
+
+/*
+ * The stops of a gradient, baked into a lookup table of premultiplied
+ * RGBA8 pixels, so shading a pixel is a table lookup no matter how many
+ * stops there are.
+ */
+class gradient_stop_collection {
+public :
+    static const int Table_Size = 256;
+
+    gradient_stop_collection(
+        const gradient_stop* stops, size_t count, extend_mode mode = extend_mode_clamp);
+
+    extend_mode get_extend_mode() const {
+        return extend_mode_;
+    }
+
+    const std::vector<gradient_stop>& stops() const {
+        return stops_;
+    }
+
+    /*
+     * Table_Size premultiplied pixels, entry i is the colour at i / (Table_Size - 1).
+     */
+    const uint32_t* lookup_table() const {
+        return &table_[0];
+    }
+
+    /*
+     * True if every stop is opaque.
+     */
+    bool is_opaque() const {
+        return opaque_;
+    }
+
+private :
+    void build_table();
+
+    std::vector<gradient_stop>  stops_;
+    std::vector<uint32_t>       table_;
+    extend_mode                 extend_mode_;
+    bool                        opaque_;
+};
+
+/*
+ * Base for brushes that compute a colour per pixel. Shading works on whole
+ * spans : the brush maps the span to gradient space once and steps along
+ * it, evaluating four pixels per iteration where SSE2 is available.
+ */
+class gradient_brush : public brush {
+public :
+    const gradient_stop_collection& get_stops() const {
+        return stops_;
+    }
+
+    /*
+     * Brush space to user space, same as ID2D1Brush::SetTransform.
+     */
+    void set_transform(const matrix3X3& xform) {
+        transform_ = xform;
+    }
+
+    const matrix3X3& get_transform() const {
+        return transform_;
+    }
+
+    /*
+     * Writes the colours of pixels [x, x + count) of row y into out.
+     * device_to_brush maps device pixel coordinates to brush space (the
+     * inverse of render transform * brush transform).
+     */
+    virtual void shade_span(
+        const matrix3X3& device_to_brush, int x, int y, int count,
+        uint32_t* out) const = 0;
+
+protected :
+    gradient_brush(brush_type type, const gradient_stop_collection& stops)
+        : brush(type), stops_(stops), transform_(matrix3X3::identity) {}
+
+    gradient_stop_collection    stops_;
+    matrix3X3                   transform_;
+};
+
+/*
+ * Colour varies along the line from start to end, constant across it.
+ */
+class linear_gradient_brush : public gradient_brush {
+public :
+    linear_gradient_brush(
+        const vector2& start_point, const vector2& end_point,
+        const gradient_stop_collection& stops)
+        : gradient_brush(brush_type_linear_gradient, stops),
+          start_point_(start_point), end_point_(end_point) {}
+
+    void set_start_point(const vector2& pt) {
+        start_point_ = pt;
+    }
+
+    void set_end_point(const vector2& pt) {
+        end_point_ = pt;
+    }
+
+    void shade_span(
+        const matrix3X3& device_to_brush, int x, int y, int count,
+        uint32_t* out) const;
+
+private :
+    vector2     start_point_;
+    vector2     end_point_;
+};
+
+/*
+ * Colour varies from the gradient origin (center + origin offset) to the
+ * ellipse given by center and radii, like ID2D1RadialGradientBrush.
+ */
+class radial_gradient_brush : public gradient_brush {
+public :
+    radial_gradient_brush(
+        const vector2& center, const vector2& origin_offset,
+        float radius_x, float radius_y, const gradient_stop_collection& stops)
+        : gradient_brush(brush_type_radial_gradient, stops),
+          center_(center), origin_offset_(origin_offset),
+          radius_x_(radius_x), radius_y_(radius_y) {}
+
+    void set_center(const vector2& center) {
+        center_ = center;
+    }
+
+    void set_origin_offset(const vector2& offset) {
+        origin_offset_ = offset;
+    }
+
+    void set_radii(float radius_x, float radius_y) {
+        radius_x_ = radius_x;
+        radius_y_ = radius_y;
+    }
+
+    void shade_span(
+        const matrix3X3& device_to_brush, int x, int y, int count,
+        uint32_t* out) const;
+
+private :
+    vector2     center_;
+    vector2     origin_offset_;
+    float       radius_x_;
+    float       radius_y_;
+};
+
+} // ns gfx
+
+#endif /* GFX_GRADIENT_BRUSH_H_ */
@@ -0,0 +1,3486 @@
+/*
+ * headless_main.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ *
+ * Runs the demo scenes against the software render target, without a
+ * window or a GPU, and reports the pixel fill throughput. Not part of the
+ * Visual Studio project : it is built from the portable sources (all the
+ * .cc files in this directory except main.cc), e.g. on the Linux CI boxes.
+ *
+ *  headless_main [--scene=fighter|block] [--frames=N] [--size=WxH] [--samples=N]
+ *                [--fill=solid|gradient] [--static-layer=on|off] [--overdraw-pass]
+ *                [--capture=PREFIX] [--capture-format=ppm|qoi]
+ *                [--capture-policy=block|drop] [--capture-buffers=N]
+ *                [--distance-field=N] [--replay=FILE] [--trace=FILE]
+ *  headless_main --bench-kernels
+ *  headless_main --bench-collision
+ *  headless_main --check-timestep
+ *  headless_main --bench-animation
+ *  headless_main --bench-lod
+ *  headless_main --bench-hit-test
+ *  headless_main --bench-compact-path
+ *  headless_main --check-bezier
+ *  headless_main --check-arc
+ *  headless_main --bench-handles
+ *  headless_main --bench-viewports
+ *  headless_main --check-quality
+ *  headless_main --check-present
+ *  headless_main --bench-instances
+ *  headless_main --bench-distance-field
+ *  headless_main --bench-sprites
+ *  headless_main --check-replay
+ *  headless_main --check-latency [--latency-csv=FILE]
+ *  headless_main --bench-trace
+ *  headless_main --check-svg
+ *  headless_main --bench-svg
+ *
+ * --bench-kernels checks every pixel kernel set this machine supports
+ * against the scalar reference (bit exact) and reports their throughput.
+ *
+ * --bench-collision moves 1K, 10K and 100K bodies around and reports the
+ * time spent in the collision world update.
+ *
+ * --check-timestep runs the same simulations at several render rates and
+ * fails unless every run ends in the same state, bit for bit.
+ *
+ * --bench-animation evaluates keyframed transforms for 100K objects, and
+ * checks them against matrix3X3 compositions at the key times.
+ *
+ * --bench-lod zooms the fighter in and out and compares flattening it
+ * every frame with going through the geometry LOD cache.
+ *
+ * --bench-hit-test compares the banded point in path test with a loop
+ * over all the edges, on the fighter and on a 4K edge outline.
+ *
+ * --bench-compact-path compares building and transforming the fighter as
+ * a compact_path with doing it through path_geometry and virtual sinks.
+ *
+ * --check-bezier checks the batch and forward differencing cubic Bezier
+ * evaluations against de Casteljau and reports their throughput.
+ *
+ * --check-arc checks the arc to cubic conversion against the ellipses the
+ * arcs lie on and compares converting arcs with the arc cache.
+ *
+ * --bench-handles compares copying, moving and destroying intrusive_ptr
+ * handles with std::shared_ptr plus a Release deleter, on a mock
+ * reference counted object.
+ *
+ * --bench-viewports renders the fighter scene into 1, 4 and 16 viewports
+ * with their own cameras on the thread pool, checks the result against a
+ * single threaded run and reports the throughput.
+ *
+ * --check-quality drives the quality controller with a synthetic load
+ * (rising, falling, and sitting between two levels) and checks it holds
+ * the budget without flickering; then reports the real cost of the
+ * fighter frame at every level.
+ *
+ * --check-present renders through the present queue faster and slower
+ * than a simulated refresh rate, with both policies, checks which frames
+ * got presented and reports the render to present latency.
+ *
+ * --bench-instances draws squadrons of fighters, each with its own
+ * geometry and brush, then sharing one pooled geometry drawn with
+ * fill_geometry_instances(); checks both give the same pixels and
+ * compares their memory use and frame time.
+ *
+ * --bench-distance-field draws the fighter zoomed and rotated, rasterized
+ * and from distance fields of several resolutions, and reports the time
+ * and the coverage error against the rasterized frame, then once more
+ * stretched ten times more along one axis than the other.
+ *
+ * --bench-sprites draws a swarm of small fighters rasterized and from the
+ * sprite atlas, at 4 and 16 samples per pixel, reports the frame times,
+ * the atlas hit rate and the coverage error, then draws it again with a
+ * one page budget to exercise the eviction, and unrotated on whole pixels,
+ * where sprites are copied without filtering.
+ *
+ * --replay=FILE plays back an input recording (d2d_flicker_test
+ * --record=FILE) through the scene's key handlers, with the recorded frame
+ * times, rendering every frame as fast as possible. Everything in the
+ * report but the render times comes from the recording, so runs of
+ * different builds line up.
+ *
+ * --check-replay records a scripted session, replays it twice and fails
+ * unless both replays match each other and the session they came from.
+ *
+ * --check-latency presses keys at random in the block scene, rendered
+ * through a present queue, and reports the input to photon latency
+ * percentiles per present policy (every input with --latency-csv).
+ *
+ * --trace=FILE writes the trace zones as Chrome trace-event JSON on exit,
+ * for chrome://tracing or ui.perfetto.dev. Zones are only recorded in
+ * builds with GFX_TRACE defined.
+ *
+ * --bench-trace measures the cost of a trace zone against an empty loop,
+ * checks the ring buffer wraps and can be read while being written, and
+ * times the export of a full buffer.
+ *
+ * --check-svg parses path data covering the whole grammar (relative and
+ * absolute commands, smooth curves, packed arc flags, exponents) and
+ * malformed data, and checks the segments and the error offsets; then
+ * checks the fighter outline parses to the same geometry.
+ *
+ * --bench-svg parses 8 MB of random path data and reports the throughput,
+ * into a sink doing nothing and into a path_geometry.
+ */
+#include "pch_hdr.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <type_traits>
+
+#include "animation.h"
+#include "bezier.h"
+#include "collision.h"
+#include "compact_path.h"
+#include "demo_scenes.h"
+#include "distance_field.h"
+#include "elliptic_arc.h"
+#include "frame_capture.h"
+#include "geometry_pool.h"
+#include "geometry_lod_cache.h"
+#include "hit_test.h"
+#include "input_recording.h"
+#include "intrusive_ptr.h"
+#include "latency_tracker.h"
+#include "overdraw_pass.h"
+#include "pixel_ops.h"
+#include "present_queue.h"
+#include "quality_controller.h"
+#include "simulation.h"
+#include "thread_pool.h"
+#include "trace.h"
+#include "viewport_renderer.h"
+#include "software_render_target.h"
+#include "svg_path_parser.h"
+
+namespace {
+
+struct HeadlessOptions {
+    std::string scene;
+    int         frames;
+    int         width;
+    int         height;
+    int         samples;
+    bool        gradient_fills;
+    bool        static_layer;
+    bool        overdraw_pass;
+    std::string capture_prefix;
+    gfx::image_format               capture_format;
+    gfx::capture_overflow_policy    capture_policy;
+    int                             capture_buffers;
+    int                             distance_field;
+    std::string                     replay;
+    std::string                     latency_csv;
+    std::string                     trace;
+    bool                            bench_kernels;
+    bool                            bench_collision;
+    bool                            check_timestep;
+    bool                            bench_animation;
+    bool                            bench_lod;
+    bool                            bench_hit_test;
+    bool                            bench_compact_path;
+    bool                            check_bezier;
+    bool                            check_arc;
+    bool                            bench_handles;
+    bool                            bench_viewports;
+    bool                            check_quality;
+    bool                            check_present;
+    bool                            bench_instances;
+    bool                            bench_distance_field;
+    bool                            bench_sprites;
+    bool                            check_replay;
+    bool                            check_latency;
+    bool                            bench_trace;
+    bool                            check_svg;
+    bool                            bench_svg;
+
+    HeadlessOptions()
+        : scene("fighter"), frames(200), width(1280), height(1024), samples(4),
+          gradient_fills(false),
+          static_layer(true),
+          overdraw_pass(false),
+          capture_format(gfx::image_format_qoi),
+          capture_policy(gfx::capture_overflow_block),
+          capture_buffers(3),
+          distance_field(0),
+          bench_kernels(false),
+          bench_collision(false),
+          check_timestep(false),
+          bench_animation(false),
+          bench_lod(false),
+          bench_hit_test(false),
+          bench_compact_path(false),
+          check_bezier(false),
+          check_arc(false),
+          bench_handles(false),
+          bench_viewports(false),
+          check_quality(false),
+          check_present(false),
+          bench_instances(false),
+          bench_distance_field(false),
+          bench_sprites(false),
+          check_replay(false),
+          check_latency(false),
+          bench_trace(false),
+          check_svg(false),
+          bench_svg(false) {}
+};
+
+bool
+ParseOptions(
+    int argc,
+    char** argv,
+    HeadlessOptions* options
+    )
+{
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (!std::strncmp(arg, "--scene=", 8)) {
+            options->scene = arg + 8;
+        } else if (!std::strncmp(arg, "--frames=", 9)) {
+            options->frames = std::atoi(arg + 9);
+        } else if (!std::strncmp(arg, "--size=", 7)) {
+            if (std::sscanf(arg + 7, "%dx%d", &options->width, &options->height) != 2)
+                return false;
+        } else if (!std::strncmp(arg, "--samples=", 10)) {
+            options->samples = std::atoi(arg + 10);
+        } else if (!std::strcmp(arg, "--fill=solid")) {
+            options->gradient_fills = false;
+        } else if (!std::strcmp(arg, "--fill=gradient")) {
+            options->gradient_fills = true;
+        } else if (!std::strcmp(arg, "--static-layer=on")) {
+            options->static_layer = true;
+        } else if (!std::strcmp(arg, "--static-layer=off")) {
+            options->static_layer = false;
+        } else if (!std::strcmp(arg, "--overdraw-pass")) {
+            options->overdraw_pass = true;
+        } else if (!std::strncmp(arg, "--capture=", 10)) {
+            options->capture_prefix = arg + 10;
+        } else if (!std::strcmp(arg, "--capture-format=ppm")) {
+            options->capture_format = gfx::image_format_ppm;
+        } else if (!std::strcmp(arg, "--capture-format=qoi")) {
+            options->capture_format = gfx::image_format_qoi;
+        } else if (!std::strcmp(arg, "--capture-policy=block")) {
+            options->capture_policy = gfx::capture_overflow_block;
+        } else if (!std::strcmp(arg, "--capture-policy=drop")) {
+            options->capture_policy = gfx::capture_overflow_drop;
+        } else if (!std::strncmp(arg, "--capture-buffers=", 18)) {
+            options->capture_buffers = std::atoi(arg + 18);
+        } else if (!std::strncmp(arg, "--distance-field=", 17)) {
+            options->distance_field = std::atoi(arg + 17);
+        } else if (!std::strncmp(arg, "--replay=", 9)) {
+            options->replay = arg + 9;
+        } else if (!std::strncmp(arg, "--latency-csv=", 14)) {
+            options->latency_csv = arg + 14;
+        } else if (!std::strncmp(arg, "--trace=", 8)) {
+            options->trace = arg + 8;
+        } else if (!std::strcmp(arg, "--bench-kernels")) {
+            options->bench_kernels = true;
+        } else if (!std::strcmp(arg, "--bench-collision")) {
+            options->bench_collision = true;
+        } else if (!std::strcmp(arg, "--check-timestep")) {
+            options->check_timestep = true;
+        } else if (!std::strcmp(arg, "--bench-animation")) {
+            options->bench_animation = true;
+        } else if (!std::strcmp(arg, "--bench-lod")) {
+            options->bench_lod = true;
+        } else if (!std::strcmp(arg, "--bench-hit-test")) {
+            options->bench_hit_test = true;
+        } else if (!std::strcmp(arg, "--bench-compact-path")) {
+            options->bench_compact_path = true;
+        } else if (!std::strcmp(arg, "--check-bezier")) {
+            options->check_bezier = true;
+        } else if (!std::strcmp(arg, "--check-arc")) {
+            options->check_arc = true;
+        } else if (!std::strcmp(arg, "--bench-handles")) {
+            options->bench_handles = true;
+        } else if (!std::strcmp(arg, "--bench-viewports")) {
+            options->bench_viewports = true;
+        } else if (!std::strcmp(arg, "--check-quality")) {
+            options->check_quality = true;
+        } else if (!std::strcmp(arg, "--check-present")) {
+            options->check_present = true;
+        } else if (!std::strcmp(arg, "--bench-instances")) {
+            options->bench_instances = true;
+        } else if (!std::strcmp(arg, "--bench-distance-field")) {
+            options->bench_distance_field = true;
+        } else if (!std::strcmp(arg, "--bench-sprites")) {
+            options->bench_sprites = true;
+        } else if (!std::strcmp(arg, "--check-replay")) {
+            options->check_replay = true;
+        } else if (!std::strcmp(arg, "--check-latency")) {
+            options->check_latency = true;
+        } else if (!std::strcmp(arg, "--bench-trace")) {
+            options->bench_trace = true;
+        } else if (!std::strcmp(arg, "--check-svg")) {
+            options->check_svg = true;
+        } else if (!std::strcmp(arg, "--bench-svg")) {
+            options->bench_svg = true;
+        } else {
+            return false;
+        }
+    }
+
+    return options->frames > 0 && options->width > 0 && options->height > 0 &&
+        options->capture_buffers > 0 && options->distance_field >= 0 &&
+        (options->scene == "fighter" || options->scene == "block");
+}
+
+template<typename Scene>
+void
+RunScene(
+    const Scene& scene,
+    const HeadlessOptions& options,
+    const gfx::pixel_surface& frame_surface,
+    gfx::software_render_target* target,
+    gfx::frame_capture* capture
+    )
+{
+    //
+    // With the overdraw pass, frames are recorded, culled, then replayed.
+    gfx::recording_render_target recorder(target);
+    gfx::overdraw_statistics overdraw;
+
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+
+    for (int frame = 0; frame < options.frames; ++frame) {
+        GFX_TRACE_ZONE("frame");
+
+        //
+        // Captured frames are rendered straight into a capture buffer.
+        gfx::capture_buffer* capture_buffer = nullptr;
+        if (capture) {
+            GFX_TRACE_ZONE("acquire capture buffer");
+            capture_buffer = capture->acquire(static_cast<uint64_t>(frame));
+        }
+        target->bind_surface(capture_buffer ? capture_buffer->surface_ : frame_surface);
+
+        if (options.overdraw_pass) {
+            {
+                GFX_TRACE_ZONE("record");
+                recorder.begin_draw();
+                scene.Draw(&recorder);
+                recorder.end_draw();
+            }
+            {
+                GFX_TRACE_ZONE("eliminate overdraw");
+                gfx::eliminate_overdraw(target->width(), target->height(),
+                                        &recorder.commands(), &overdraw);
+            }
+
+            GFX_TRACE_ZONE("replay");
+            target->begin_draw();
+            recorder.replay(target);
+            target->end_draw();
+        } else {
+            GFX_TRACE_ZONE("draw");
+            target->begin_draw();
+            scene.Draw(target);
+            target->end_draw();
+        }
+
+        if (capture_buffer)
+            capture->submit(capture_buffer);
+    }
+
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    const gfx::fill_statistics& stats = target->statistics();
+    const double frames = static_cast<double>(stats.frames_);
+    std::printf("scene %s, %dx%d, %d samples, %s fills\n", options.scene.c_str(),
+                options.width, options.height, target->sample_count(),
+                options.gradient_fills ? "gradient" : "solid");
+    std::printf("  frames          : %llu (%.3f ms/frame)\n",
+                static_cast<unsigned long long>(stats.frames_),
+                seconds * 1000.0 / frames);
+    std::printf("  draw calls      : %.1f per frame\n",
+                static_cast<double>(stats.draw_calls_) / frames);
+    std::printf("  pixels filled   : %.0f per frame\n",
+                static_cast<double>(stats.pixels_filled_) / frames);
+    std::printf("  pixels blended  : %.0f per frame\n",
+                static_cast<double>(stats.pixels_blended_) / frames);
+    std::printf("  pixels composed : %.0f per frame\n",
+                static_cast<double>(stats.pixels_composited_) / frames);
+    std::printf("  fill throughput : %.1f Mpixels/s\n",
+                static_cast<double>(stats.pixels_written()) / seconds / 1.0e6);
+
+    if (options.overdraw_pass) {
+        std::printf("  overdraw pass   : %.1f of %.1f commands culled per frame, "
+                    "%.0f of %.0f bounded pixels culled per frame\n",
+                    static_cast<double>(overdraw.commands_culled_) / frames,
+                    static_cast<double>(overdraw.commands_) / frames,
+                    static_cast<double>(overdraw.pixels_culled_) / frames,
+                    static_cast<double>(overdraw.pixels_culled_ + overdraw.pixels_drawn_) / frames);
+    }
+
+    if (capture) {
+        const gfx::capture_counters queued_at_end = capture->counters();
+        capture->flush();
+        const gfx::capture_counters counters = capture->counters();
+        std::printf("  capture         : %llu captured, %llu dropped, %llu failed, "
+                    "%llu queued at end of run, %.1f MB written\n",
+                    static_cast<unsigned long long>(counters.captured_),
+                    static_cast<unsigned long long>(counters.dropped_),
+                    static_cast<unsigned long long>(counters.failed_),
+                    static_cast<unsigned long long>(queued_at_end.queued_),
+                    static_cast<double>(counters.bytes_written_) / 1.0e6);
+    }
+}
+
+//
+// Random pixels and coverage. The pixels are valid premultiplied colours,
+// except for every 16th one, so the saturating paths get exercised too.
+void
+FillRandom(
+    std::mt19937* rng,
+    std::vector<uint32_t>* pixels,
+    std::vector<uint8_t>* coverage
+    )
+{
+    std::uniform_int_distribution<uint32_t> byte(0, 255);
+    for (size_t i = 0; i < pixels->size(); ++i) {
+        uint32_t pixel = (*rng)();
+        if (i % 16) {
+            const uint32_t a = byte(*rng);
+            pixel = gfx::div255((pixel & 0xFF) * a) |
+                (gfx::div255(((pixel >> 8) & 0xFF) * a) << 8) |
+                (gfx::div255(((pixel >> 16) & 0xFF) * a) << 16) | (a << 24);
+        }
+        (*pixels)[i] = pixel;
+    }
+
+    //
+    // Runs of 0 and 255 like the rasterizer produces, mixed with edges.
+    for (size_t i = 0; i < coverage->size(); ++i) {
+        const uint32_t kind = byte(*rng) & 3;
+        (*coverage)[i] = static_cast<uint8_t>(kind == 0 ? 0 : kind == 1 ? 255 : byte(*rng));
+    }
+}
+
+bool
+CheckKernels(
+    const gfx::pixel_kernels& kernels
+    )
+{
+    const gfx::pixel_kernels& reference = *gfx::find_pixel_kernels(gfx::pixel_isa_scalar);
+    std::mt19937 rng(1234);
+    const size_t max_count = 131;
+
+    std::vector<uint32_t> src(max_count + 8);
+    std::vector<uint32_t> dst(max_count + 8);
+    std::vector<uint32_t> expected(max_count + 8);
+    std::vector<uint8_t> coverage(max_count + 8);
+
+    //
+    // Every length up to a few vector widths, at every alignment.
+    for (int iteration = 0; iteration < 64; ++iteration) {
+        for (size_t offset = 0; offset < 8; ++offset) {
+            for (size_t count = 0; count <= max_count; ++count) {
+                FillRandom(&rng, &src, &coverage);
+                const uint32_t pixel = src[0];
+                const uint32_t* s = &src[offset];
+                const uint8_t* cov = &coverage[offset];
+
+                FillRandom(&rng, &dst, &coverage);
+                expected = dst;
+                reference.blend_solid_span_(&expected[offset], cov, count, pixel);
+                kernels.blend_solid_span_(&dst[offset], cov, count, pixel);
+                if (dst != expected)
+                    return false;
+
+                reference.blend_uniform_span_(&expected[offset], count, pixel);
+                kernels.blend_uniform_span_(&dst[offset], count, pixel);
+                if (dst != expected)
+                    return false;
+
+                reference.blend_span_(&expected[offset], s, cov, count);
+                kernels.blend_span_(&dst[offset], s, cov, count);
+                if (dst != expected)
+                    return false;
+
+                reference.fill_span_(&expected[offset], count, pixel);
+                kernels.fill_span_(&dst[offset], count, pixel);
+                if (dst != expected)
+                    return false;
+
+                reference.copy_span_(&expected[offset], s, count);
+                kernels.copy_span_(&dst[offset], s, count);
+                if (dst != expected)
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+template<typename Kernel>
+double
+MeasureGBs(
+    size_t bytes_per_call,
+    Kernel kernel
+    )
+{
+    const int calls = 2000;
+    kernel();
+
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; ++i)
+        kernel();
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    return static_cast<double>(bytes_per_call) * calls / seconds / 1.0e9;
+}
+
+//
+// Throughput is counted as bytes read plus bytes written, over a
+// 64K pixel span (stays in L2).
+int
+BenchKernels() {
+    const gfx::pixel_isa isas[] = {
+        gfx::pixel_isa_scalar, gfx::pixel_isa_sse2, gfx::pixel_isa_avx2, gfx::pixel_isa_neon
+    };
+    const size_t count = 64 * 1024;
+
+    std::mt19937 rng(5678);
+    std::vector<uint32_t> src(count);
+    std::vector<uint32_t> dst(count);
+    std::vector<uint8_t> coverage(count);
+    FillRandom(&rng, &src, &coverage);
+    const uint32_t translucent = 0x80402010;
+
+    std::printf("%-8s %10s %10s %12s %12s %12s %8s\n", "kernels", "clear", "copy",
+                "solid+mask", "solid", "span+mask", "exact");
+
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(isas) / sizeof(isas[0]); ++i) {
+        const gfx::pixel_kernels* kernels = gfx::find_pixel_kernels(isas[i]);
+        if (!kernels)
+            continue;
+
+        const bool exact = CheckKernels(*kernels);
+        failures += exact ? 0 : 1;
+
+        uint32_t* d = &dst[0];
+        const uint32_t* s = &src[0];
+        const uint8_t* cov = &coverage[0];
+        const double clear = MeasureGBs(count * 4, [=]() {
+            kernels->fill_span_(d, count, translucent);
+        });
+        const double copy = MeasureGBs(count * 8, [=]() {
+            kernels->copy_span_(d, s, count);
+        });
+        const double solid_mask = MeasureGBs(count * 9, [=]() {
+            kernels->blend_solid_span_(d, cov, count, translucent);
+        });
+        const double solid = MeasureGBs(count * 8, [=]() {
+            kernels->blend_uniform_span_(d, count, translucent);
+        });
+        const double span_mask = MeasureGBs(count * 13, [=]() {
+            kernels->blend_span_(d, s, cov, count);
+        });
+
+        std::printf("%-8s %8.1f GB/s %6.1f GB/s %8.1f GB/s %8.1f GB/s %8.1f GB/s %8s\n",
+                    kernels->name_, clear, copy, solid_mask, solid, span_mask,
+                    exact ? "yes" : "NO");
+    }
+
+    std::printf("active : %s\n", gfx::active_pixel_kernels().name_);
+    return failures ? 1 : 0;
+}
+
+//
+// Boxes of 4 to 12 units and a fighter every 64 bodies, at the same
+// density whatever the count (about one body per 400 square units), moving
+// with random velocities and bouncing off the walls.
+void
+BenchCollisionWorld(
+    int body_count,
+    int updates,
+    const gfx::collision_shape* box_shapes,
+    int box_shape_count,
+    const gfx::collision_shape* fighter_shape,
+    float fighter_scale
+    )
+{
+    const float side = std::sqrt(static_cast<float>(body_count) * 400.0f);
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> position(0.0f, side);
+    std::uniform_real_distribution<float> velocity(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+
+    struct Body {
+        gfx::vector2    position;
+        gfx::vector2    velocity;
+        float           angle;
+        float           scale;
+    };
+
+    gfx::collision_world world;
+    std::vector<Body> bodies(body_count);
+    for (int i = 0; i < body_count; ++i) {
+        Body& b = bodies[i];
+        b.position = gfx::vector2(position(rng), position(rng));
+        b.velocity = gfx::vector2(velocity(rng), velocity(rng));
+        b.angle = angle(rng);
+
+        const bool fighter = (i % 64) == 63;
+        b.scale = fighter ? fighter_scale : 1.0f;
+        world.add_body(fighter ? fighter_shape : &box_shapes[i % box_shape_count],
+                       gfx::matrix3X3::identity);
+    }
+
+    std::vector<gfx::contact_pair> contacts;
+    double seconds = 0.0;
+    for (int frame = 0; frame < updates; ++frame) {
+        for (int i = 0; i < body_count; ++i) {
+            Body& b = bodies[i];
+            b.position += b.velocity;
+            if (b.position.x_ < 0.0f || b.position.x_ > side)
+                b.velocity.x_ = -b.velocity.x_;
+            if (b.position.y_ < 0.0f || b.position.y_ > side)
+                b.velocity.y_ = -b.velocity.y_;
+
+            world.set_transform(
+                i,
+                gfx::matrix3X3::translation(b.position) *
+                gfx::matrix3X3::rotation(b.angle) *
+                gfx::matrix3X3::scale(b.scale, b.scale));
+        }
+
+        //
+        // The first update sorts from scratch, leave it out.
+        if (frame == 1)
+            world.reset_statistics();
+
+        const std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+        world.update(&contacts);
+        if (frame >= 1) {
+            seconds += std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    const gfx::collision_statistics& stats = world.statistics();
+    const double n = static_cast<double>(stats.updates_);
+    std::printf("%8d %10.3f ms %12.0f %12.0f %12.0f %10.0f\n",
+                body_count, seconds * 1000.0 / n, stats.sort_swaps_ / n,
+                stats.broadphase_pairs_ / n, stats.piece_tests_ / n,
+                stats.contacts_ / n);
+}
+
+int
+BenchCollision() {
+    const int box_shape_count = 8;
+    gfx::collision_shape box_shapes[box_shape_count];
+    for (int i = 0; i < box_shape_count; ++i)
+        box_shapes[i].set_box(2.0f + static_cast<float>(i), 6.0f - static_cast<float>(i) * 0.5f);
+
+    //
+    // The fighter is scaled down to about 24 units.
+    Fighter_Mig21 fighter;
+    fighter.BuildFighterGeometry();
+    gfx::collision_shape fighter_shape;
+    if (!fighter_shape.set_geometry(fighter.GetGeometry(), 0.05f)) {
+        std::fprintf(stderr, "failed to build the fighter collision shape\n");
+        return 1;
+    }
+
+    const gfx::rectangle& bounds = fighter_shape.bounds_;
+    const float fighter_scale = 24.0f / std::max(bounds.width(), bounds.height());
+    std::printf("fighter shape : %u convex pieces\n",
+                static_cast<unsigned>(fighter_shape.piece_count()));
+
+    std::printf("%8s %13s %12s %12s %12s %10s\n", "bodies", "update", "sort swaps",
+                "pairs", "piece tests", "contacts");
+
+    const int counts[] = { 1000, 10000, 100000 };
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+        BenchCollisionWorld(counts[i], 60, box_shapes, box_shape_count,
+                            &fighter_shape, fighter_scale);
+    }
+
+    return 0;
+}
+
+//
+// Frame times for a render rate, summing to exactly total_ns. A rate of
+// zero gives irregular frames, from 1 to 50 ms.
+std::vector<uint64_t>
+MakeFrameTimes(
+    int rate,
+    uint64_t total_ns,
+    uint32_t seed
+    )
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint64_t> jitter(1000000, 50000000);
+
+    std::vector<uint64_t> frames;
+    uint64_t elapsed = 0;
+    while (elapsed < total_ns) {
+        const uint64_t frame = rate ? 1000000000 / rate : jitter(rng);
+        frames.push_back(std::min(frame, total_ns - elapsed));
+        elapsed += frames.back();
+    }
+
+    return frames;
+}
+
+//
+// Bodies whose velocities change on a schedule tied to the step index,
+// the way replayed input is applied.
+void
+SimulateBodies(
+    const std::vector<uint64_t>& frames,
+    std::vector<gfx::vector2>* final_positions,
+    uint64_t* steps
+    )
+{
+    const int body_count = 1000;
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> position(0.0f, 1000.0f);
+    std::uniform_real_distribution<float> velocity(-200.0f, 200.0f);
+
+    gfx::kinematic_bodies bodies;
+    for (int i = 0; i < body_count; ++i) {
+        bodies.add(gfx::vector2(position(rng), position(rng)),
+                   gfx::vector2(velocity(rng), velocity(rng)),
+                   gfx::rectangle(0.0f, 0.0f, 1000.0f, 1000.0f));
+    }
+
+    std::vector<float> render_x(body_count);
+    std::vector<float> render_y(body_count);
+    gfx::fixed_timestep timestep(BlockScene::C_StepNs, 1000);
+
+    for (size_t frame = 0; frame < frames.size(); ++frame) {
+        const int step_count = timestep.advance(frames[frame]);
+        for (int i = 0; i < step_count; ++i) {
+            const uint64_t step = timestep.step_count() - step_count + i;
+            if (step % 37 == 0) {
+                for (int b = static_cast<int>(step % 7); b < body_count; b += 7)
+                    bodies.set_velocity(b, -bodies.velocity(b));
+            }
+            bodies.step(timestep.step_seconds());
+        }
+
+        bodies.interpolate(timestep.interpolation_alpha(), &render_x[0], &render_y[0]);
+    }
+
+    final_positions->resize(body_count);
+    for (int i = 0; i < body_count; ++i)
+        (*final_positions)[i] = bodies.position(i);
+    *steps = timestep.step_count();
+}
+
+bool
+SameBits(
+    const gfx::vector2& lhs,
+    const gfx::vector2& rhs
+    )
+{
+    return !std::memcmp(&lhs.x_, &rhs.x_, sizeof(float)) &&
+        !std::memcmp(&lhs.y_, &rhs.y_, sizeof(float));
+}
+
+//
+// Ten simulated seconds at several render rates (and an irregular one) :
+// same step count and bit identical states expected. The block scene gets
+// the same treatment, with the key held all along (slowly enough that the
+// block does not reach the edge).
+int
+CheckTimestep() {
+    const int rates[] = { 24, 30, 60, 75, 144, 240, 0 };
+    const uint64_t total_ns = 10000000000ull;
+
+    std::vector<gfx::vector2> reference_bodies;
+    uint64_t reference_steps = 0;
+    gfx::vector2 reference_block;
+    gfx::vector2 reference_block_drawn;
+    int failures = 0;
+
+    std::printf("%8s %8s %8s %8s %8s\n", "rate", "frames", "steps", "bodies", "block");
+
+    for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); ++r) {
+        const std::vector<uint64_t> frames(MakeFrameTimes(rates[r], total_ns, 7));
+
+        std::vector<gfx::vector2> bodies;
+        uint64_t steps = 0;
+        SimulateBodies(frames, &bodies, &steps);
+
+        BlockScene scene;
+        scene.Initialize(1280, 1024);
+        scene.SetMoveDirection(-0.05f);
+        for (size_t i = 0; i < frames.size(); ++i)
+            scene.Update(frames[i]);
+
+        if (!r) {
+            reference_bodies = bodies;
+            reference_steps = steps;
+            reference_block = scene.GetSimulatedPosition();
+            reference_block_drawn = scene.GetBlock().GetPosition();
+        }
+
+        bool same_bodies = steps == reference_steps;
+        for (size_t i = 0; i < bodies.size() && same_bodies; ++i)
+            same_bodies = SameBits(bodies[i], reference_bodies[i]);
+
+        const bool same_block =
+            scene.GetStepCount() == reference_steps &&
+            SameBits(scene.GetSimulatedPosition(), reference_block) &&
+            SameBits(scene.GetBlock().GetPosition(), reference_block_drawn);
+
+        char rate_name[16];
+        if (rates[r])
+            std::snprintf(rate_name, sizeof(rate_name), "%d Hz", rates[r]);
+        else
+            std::snprintf(rate_name, sizeof(rate_name), "jitter");
+
+        std::printf("%8s %8u %8llu %8s %8s\n", rate_name,
+                    static_cast<unsigned>(frames.size()),
+                    static_cast<unsigned long long>(steps),
+                    same_bodies ? "same" : "DIFFER", same_block ? "same" : "DIFFER");
+        failures += same_bodies && same_block ? 0 : 1;
+    }
+
+    return failures ? 1 : 0;
+}
+
+float
+MaxDifference(
+    const gfx::matrix3X3& lhs,
+    const gfx::matrix3X3& rhs
+    )
+{
+    float difference = 0.0f;
+    for (int i = 0; i < 9; ++i)
+        difference = std::max(difference, std::fabs(lhs.elements_[i] - rhs.elements_[i]));
+    return difference;
+}
+
+//
+// Every object gets a looping cubic translation track and a linear
+// rotation track, every other one an eased scale track. Keys are one
+// second apart, with per object offsets so the objects do not move in
+// lock step.
+int
+BenchAnimation() {
+    const int object_count = 100000;
+    const int frames = 600;
+
+    std::mt19937 rng(4321);
+    std::uniform_real_distribution<float> coordinate(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> degrees(-180.0f, 180.0f);
+    std::uniform_real_distribution<float> factor(0.5f, 2.0f);
+
+    gfx::transform_animation_set animations;
+    const float times[] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f };
+    std::vector<gfx::vector2> translations(object_count * 5);
+    std::vector<float> rotations(object_count * 3);
+    std::vector<gfx::vector2> scales(object_count * 3);
+
+    for (int i = 0; i < object_count; ++i) {
+        const size_t object = animations.add_object();
+
+        gfx::vector2* translation = &translations[i * 5];
+        for (int k = 0; k < 4; ++k)
+            translation[k] = gfx::vector2(coordinate(rng), coordinate(rng));
+        translation[4] = translation[0];
+        animations.set_translation_track(
+            object, times, translation, 5, gfx::track_options(gfx::interpolation_cubic));
+
+        float* rotation = &rotations[i * 3];
+        for (int k = 0; k < 3; ++k)
+            rotation[k] = degrees(rng);
+        animations.set_rotation_track(object, times, rotation, 3);
+
+        if (i % 2) {
+            gfx::vector2* scale = &scales[i * 3];
+            for (int k = 0; k < 3; ++k)
+                scale[k] = gfx::vector2(factor(rng), factor(rng));
+            animations.set_scale_track(
+                object, times, scale, 3,
+                gfx::track_options(gfx::interpolation_linear, gfx::easing_in_out_quad, false));
+        }
+    }
+
+    std::vector<gfx::matrix3X3> transforms(object_count);
+
+    //
+    // At the key times, the transforms are the compositions of the key
+    // values (the second key, for all three tracks).
+    animations.evaluate(1.0f, &transforms[0]);
+    float max_error = 0.0f;
+    for (int i = 0; i < object_count; ++i) {
+        const gfx::vector2 scale = i % 2 ? scales[i * 3 + 1] : gfx::vector2(1.0f, 1.0f);
+        const gfx::matrix3X3 expected =
+            gfx::matrix3X3::translation(translations[i * 5 + 1]) *
+            gfx::matrix3X3::rotation(rotations[i * 3 + 1]) *
+            gfx::matrix3X3::scale(scale.x_, scale.y_);
+        max_error = std::max(max_error, MaxDifference(transforms[i], expected));
+    }
+
+    animations.reset_statistics();
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame)
+        animations.evaluate(static_cast<float>(frame) / 60.0f, &transforms[0]);
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    const gfx::animation_statistics& stats = animations.statistics();
+    std::printf("objects          : %d\n", object_count);
+    std::printf("evaluate         : %.3f ms per frame (%.1f ns per object)\n",
+                seconds * 1000.0 / frames, seconds * 1.0e9 / frames / object_count);
+    std::printf("cursor hits      : %.2f %%\n",
+                100.0 * stats.cursor_hits_ / std::max<uint64_t>(stats.track_lookups_, 1));
+    std::printf("max error at keys: %g\n", max_error);
+
+    return max_error < 1.0e-3f ? 0 : 1;
+}
+
+//
+// The fighter zooms from 5x to 400x and back, twice, with a slow rotation,
+// flattened at the software target's default tolerance.
+int
+BenchLod() {
+    const int frames = 2000;
+    const float tolerance = 0.25f;
+
+    Fighter_Mig21 fighter;
+    fighter.BuildFighterGeometry();
+    const gfx::path_geometry& geometry = fighter.GetGeometry();
+
+    std::vector<gfx::matrix3X3> transforms(frames);
+    for (int i = 0; i < frames; ++i) {
+        const float phase = static_cast<float>(i % (frames / 2)) / (frames / 2);
+        const float zoom = 5.0f * std::pow(80.0f, phase < 0.5f ? phase * 2.0f : 2.0f - phase * 2.0f);
+        transforms[i] = gfx::matrix3X3::translation(640.0f, 512.0f) *
+            gfx::matrix3X3::rotation(static_cast<float>(i) * 0.1f) *
+            gfx::matrix3X3::scale(zoom, zoom);
+    }
+
+    gfx::flattened_path path;
+    size_t direct_points = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; ++i) {
+        geometry.flatten(transforms[i], tolerance, &path);
+        direct_points += path.points_.size();
+    }
+    const double direct = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    gfx::geometry_lod_cache cache;
+    size_t cached_points = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; ++i) {
+        cache.flatten(geometry, transforms[i], tolerance, &path);
+        cached_points += path.points_.size();
+    }
+    const double cached = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    const gfx::geometry_lod_statistics& stats = cache.statistics();
+    std::printf("direct flatten : %.2f us per frame, %.0f points\n",
+                direct * 1.0e6 / frames, static_cast<double>(direct_points) / frames);
+    std::printf("lod cache      : %.2f us per frame, %.0f points\n",
+                cached * 1.0e6 / frames, static_cast<double>(cached_points) / frames);
+    std::printf("  %llu hits, %llu misses, %u lods, %u bytes\n",
+                static_cast<unsigned long long>(stats.hits_),
+                static_cast<unsigned long long>(stats.misses_),
+                static_cast<unsigned>(cache.lod_count()),
+                static_cast<unsigned>(cache.memory_used()));
+
+    //
+    // A budget too small for all the LODs : the zoom keeps evicting and
+    // recreating them.
+    gfx::geometry_lod_cache small_cache(cache.memory_used() / 2);
+    for (int i = 0; i < frames; ++i)
+        small_cache.flatten(geometry, transforms[i], tolerance, &path);
+    std::printf("half budget    : %llu hits, %llu misses, %llu evictions, %u bytes\n",
+                static_cast<unsigned long long>(small_cache.statistics().hits_),
+                static_cast<unsigned long long>(small_cache.statistics().misses_),
+                static_cast<unsigned long long>(small_cache.statistics().evictions_),
+                static_cast<unsigned>(small_cache.memory_used()));
+
+    return 0;
+}
+
+//
+// Queries at random device points around the object's bounds, half of
+// them usually inside. Both methods map the point through the cached
+// inverse; they must agree on every point.
+int
+BenchHitTestPath(
+    const char* name,
+    const gfx::path_geometry& geometry,
+    float tolerance,
+    const gfx::matrix3X3& xform
+    )
+{
+    const int queries = 1000000;
+
+    gfx::flattened_path path;
+    geometry.flatten(gfx::matrix3X3::identity, tolerance, &path);
+
+    gfx::path_hit_tester tester;
+    tester.build(path);
+    const gfx::hit_test_object object(&tester, xform);
+
+    gfx::flattened_path device_path;
+    geometry.flatten(xform, tolerance, &device_path);
+    const gfx::rectangle bounds(device_path.bounds());
+
+    std::mt19937 rng(2468);
+    std::uniform_real_distribution<float> x(bounds.left_ - 10.0f, bounds.right_ + 10.0f);
+    std::uniform_real_distribution<float> y(bounds.top_ - 10.0f, bounds.bottom_ + 10.0f);
+    std::vector<gfx::vector2> points(queries);
+    for (int i = 0; i < queries; ++i)
+        points[i] = gfx::vector2(x(rng), y(rng));
+
+    const gfx::matrix3X3 inverse(gfx::inverse_of(xform));
+    std::vector<char> brute_hits(queries);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < queries; ++i) {
+        brute_hits[i] = gfx::point_in_flattened_path(
+            path, inverse * points[i], path.fill_mode_);
+    }
+    const double brute = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::vector<char> banded_hits(queries);
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < queries; ++i)
+        banded_hits[i] = object.hit(points[i]);
+    const double banded = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    int mismatches = 0;
+    int hits = 0;
+    for (int i = 0; i < queries; ++i) {
+        mismatches += brute_hits[i] != banded_hits[i];
+        hits += banded_hits[i] ? 1 : 0;
+    }
+
+    std::printf("%-10s %6u edges %5u bands  brute force %8.1f ns  banded %6.1f ns"
+                "  %5.1f %% hits  %d mismatches\n",
+                name, static_cast<unsigned>(tester.edge_count()),
+                static_cast<unsigned>(tester.band_count()),
+                brute * 1.0e9 / queries, banded * 1.0e9 / queries,
+                100.0 * hits / queries, mismatches);
+    return mismatches;
+}
+
+int
+BenchHitTest() {
+    //
+    // The fighter as the scene draws it, 25x, plus a rotation.
+    Fighter_Mig21 fighter;
+    fighter.BuildFighterGeometry();
+    const gfx::matrix3X3 fighter_xform =
+        gfx::matrix3X3::translation(640.0f, 512.0f) *
+        gfx::matrix3X3::rotation(30.0f) *
+        gfx::matrix3X3::scale(25.0f, 25.0f);
+
+    //
+    // A wavy ring (outer and inner outline, non zero), 2K points each.
+    gfx::path_geometry ring;
+    ring.set_fill_mode(gfx::fill_mode_winding);
+    gfx::path_sink* sink = ring.open();
+    const int ring_points = 2048;
+    for (int outline = 0; outline < 2; ++outline) {
+        const float radius = outline ? 60.0f : 100.0f;
+        for (int i = 0; i < ring_points; ++i) {
+            const float angle = (outline ? -1.0f : 1.0f) * 6.2831853f * i / ring_points;
+            const float r = radius + 8.0f * std::sin(angle * 24.0f);
+            const gfx::vector2 pt(r * std::cos(angle), r * std::sin(angle));
+            if (!i)
+                sink->begin_figure(pt, gfx::figure_begin_filled);
+            else
+                sink->add_line(pt);
+        }
+        sink->end_figure(gfx::figure_end_closed);
+    }
+    sink->close();
+
+    int mismatches = 0;
+    mismatches += BenchHitTestPath("fighter", fighter.GetGeometry(), 0.01f, fighter_xform);
+    mismatches += BenchHitTestPath("ring", ring, 0.01f,
+                                   gfx::matrix3X3::translation(300.0f, 300.0f));
+    return mismatches ? 1 : 0;
+}
+
+//
+// The virtual sink way of transforming a path : every segment goes
+// through a sink that maps its points and forwards it to another sink.
+// Arcs become cubics first (their radii do not transform as points), with
+// the tolerance compact_path_builder uses.
+class TransformingSink : public gfx::path_sink {
+public :
+    TransformingSink(gfx::path_sink* target, const gfx::matrix3X3& xform)
+        : target_(target), xform_(xform) {}
+
+    void begin_figure(const gfx::vector2& start_point, gfx::figure_begin begin) {
+        target_->begin_figure(xform_ * start_point, begin);
+        current_point_ = start_point;
+    }
+
+    void add_line(const gfx::vector2& point) {
+        target_->add_line(xform_ * point);
+        current_point_ = point;
+    }
+
+    void add_bezier(const gfx::bezier_segment& bezier) {
+        target_->add_bezier(gfx::bezier_segment(
+            xform_ * bezier.point1_, xform_ * bezier.point2_, xform_ * bezier.point3_));
+        current_point_ = bezier.point3_;
+    }
+
+    void add_quadratic_bezier(const gfx::quadratic_bezier_segment& bezier) {
+        target_->add_quadratic_bezier(gfx::quadratic_bezier_segment(
+            xform_ * bezier.point1_, xform_ * bezier.point2_));
+        current_point_ = bezier.point2_;
+    }
+
+    void add_arc(const gfx::arc_segment& arc) {
+        arc_cubics_.clear();
+        if (!gfx::arc_to_cubics(current_point_, arc,
+                                gfx::compact_path_builder::C_DefaultArcTolerance,
+                                &arc_cubics_)) {
+            add_line(arc.point_);
+            return;
+        }
+
+        for (size_t i = 0; i < arc_cubics_.size(); ++i)
+            add_bezier(arc_cubics_[i]);
+    }
+
+    void end_figure(gfx::figure_end end) {
+        target_->end_figure(end);
+    }
+
+    bool close() {
+        return target_->close();
+    }
+
+private :
+    gfx::path_sink*                     target_;
+    gfx::matrix3X3                      xform_;
+    gfx::vector2                        current_point_;
+    std::vector<gfx::bezier_segment>    arc_cubics_;
+};
+
+float
+BoundsDistance(
+    const gfx::rectangle& a,
+    const gfx::rectangle& b
+    )
+{
+    return std::max(std::max(std::fabs(a.left_ - b.left_), std::fabs(a.right_ - b.right_)),
+                    std::max(std::fabs(a.top_ - b.top_), std::fabs(a.bottom_ - b.bottom_)));
+}
+
+template<typename Work>
+double
+MeasureNs(
+    int iterations,
+    Work work
+    )
+{
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+        work(i);
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count() * 1.0e9 / iterations;
+}
+
+int
+BenchCompactPath() {
+    const int iterations = 200000;
+    const gfx::matrix3X3 xform =
+        gfx::matrix3X3::translation(640.0f, 512.0f) *
+        gfx::matrix3X3::rotation(30.0f) *
+        gfx::matrix3X3::scale(25.0f, 25.0f);
+
+    //
+    // Build : the compact path is reused, as when a shape is rebuilt every
+    // frame, so only its first build allocates. The fighter builds a new
+    // geometry every time (it may be shared through a geometry_pool).
+    Fighter_Mig21 fighter;
+    gfx::compact_path compact;
+    const double build_geometry = MeasureNs(iterations, [&](int) {
+        fighter.BuildFighterGeometry();
+    });
+    const double build_compact = MeasureNs(iterations, [&](int) {
+        fighter.BuildCompactGeometry(&compact);
+    });
+
+    //
+    // Transform : from the compact path's cubics, so both sides hold the
+    // same segments.
+    gfx::path_geometry source;
+    gfx::path_sink* sink = source.open();
+    compact.stream(sink);
+    sink->close();
+
+    gfx::path_geometry transformed;
+    const double transform_sink = MeasureNs(iterations, [&](int) {
+        TransformingSink transforming(transformed.open(), xform);
+        source.stream(&transforming);
+        transforming.close();
+    });
+
+    gfx::compact_path copy;
+    const double transform_compact = MeasureNs(iterations, [&](int) {
+        copy = compact;
+        copy.transform(xform);
+    });
+
+    //
+    // Same shape : the transformed compact path against the original
+    // geometry, arcs included, flattened the same way.
+    gfx::path_geometry from_compact;
+    sink = from_compact.open();
+    copy.stream(sink);
+    sink->close();
+
+    gfx::flattened_path expected;
+    gfx::flattened_path actual;
+    fighter.GetGeometry().flatten(xform, 0.1f, &expected);
+    from_compact.flatten(gfx::matrix3X3::identity, 0.1f, &actual);
+    const float bounds_error = BoundsDistance(expected.bounds(), actual.bounds());
+
+    //
+    // The sink converts the original's arc itself.
+    gfx::path_geometry through_sink;
+    TransformingSink transforming(through_sink.open(), xform);
+    fighter.GetGeometry().stream(&transforming);
+    transforming.close();
+    through_sink.flatten(gfx::matrix3X3::identity, 0.1f, &actual);
+    const float sink_bounds_error = BoundsDistance(expected.bounds(), actual.bounds());
+
+    std::printf("fighter : %u verbs, %u points, %u bytes as a compact path\n",
+                static_cast<unsigned>(compact.verbs_.size()),
+                static_cast<unsigned>(compact.points_.size()),
+                static_cast<unsigned>(compact.verbs_.size() +
+                                      compact.points_.size() * sizeof(gfx::vector2) +
+                                      compact.figure_starts_.size() * sizeof(uint32_t)));
+    std::printf("%-28s %10s %10s\n", "", "build", "transform");
+    std::printf("%-28s %7.1f ns %7.1f ns\n", "path_geometry + path_sink",
+                build_geometry, transform_sink);
+    std::printf("%-28s %7.1f ns %7.1f ns\n", "compact_path", build_compact,
+                transform_compact);
+    std::printf("bounds difference after transform : %.4f pixels (compact), "
+                "%.4f pixels (sink, arcs included)\n", bounds_error, sink_bounds_error);
+
+    return (bounds_error < 0.5f && sink_bounds_error < 0.5f) ? 0 : 1;
+}
+
+float
+MaxDistance(
+    const std::vector<gfx::vector2>& a,
+    const std::vector<gfx::vector2>& b
+    )
+{
+    float error = 0.0f;
+    for (size_t i = 0; i < a.size(); ++i)
+        error = std::max(error, (a[i] - b[i]).magnitude());
+    return error;
+}
+
+int
+CheckBezier() {
+    const int curve_count = 1000;
+    const int samples = 256;
+
+    std::mt19937 rng(39);
+    std::uniform_real_distribution<float> coord(-1000.0f, 1000.0f);
+    std::vector<gfx::cubic_bezier> curves(curve_count);
+    for (size_t i = 0; i < curves.size(); ++i) {
+        curves[i] = gfx::cubic_bezier(
+            gfx::vector2(coord(rng), coord(rng)), gfx::vector2(coord(rng), coord(rng)),
+            gfx::vector2(coord(rng), coord(rng)), gfx::vector2(coord(rng), coord(rng)));
+    }
+
+    std::vector<float> t(samples + 1);
+    for (int i = 0; i <= samples; ++i)
+        t[i] = static_cast<float>(i) / samples;
+
+    //
+    // Accuracy : every evaluation against de Casteljau at the same t. The
+    // derivative is checked against the hodograph (a quadratic, by
+    // de Casteljau as well).
+    std::vector<gfx::vector2> expected(t.size());
+    std::vector<gfx::vector2> actual(t.size());
+    float batch_error = 0.0f;
+    float derivative_error = 0.0f;
+    float difference_error = 0.0f;
+
+    for (size_t c = 0; c < curves.size(); ++c) {
+        const gfx::cubic_bezier& curve = curves[c];
+        for (size_t i = 0; i < t.size(); ++i)
+            expected[i] = gfx::de_casteljau(curve, t[i]);
+
+        gfx::evaluate_cubic(curve, &t[0], t.size(), &actual[0]);
+        batch_error = std::max(batch_error, MaxDistance(expected, actual));
+
+        gfx::forward_difference_cubic(curve, samples, &actual[0]);
+        difference_error = std::max(difference_error, MaxDistance(expected, actual));
+
+        const gfx::vector2 d0(3.0f * (curve.p1_ - curve.p0_));
+        const gfx::vector2 d1(3.0f * (curve.p2_ - curve.p1_));
+        const gfx::vector2 d2(3.0f * (curve.p3_ - curve.p2_));
+        for (size_t i = 0; i < t.size(); ++i) {
+            const gfx::vector2 a(d0 + (d1 - d0) * t[i]);
+            const gfx::vector2 b(d1 + (d2 - d1) * t[i]);
+            expected[i] = a + (b - a) * t[i];
+        }
+
+        gfx::evaluate_cubic_derivative(curve, &t[0], t.size(), &actual[0]);
+        derivative_error = std::max(derivative_error, MaxDistance(expected, actual));
+    }
+
+    float many_error = 0.0f;
+    std::vector<gfx::vector2> many_expected(curves.size());
+    std::vector<gfx::vector2> many_actual(curves.size());
+    for (size_t i = 0; i < t.size(); ++i) {
+        for (size_t c = 0; c < curves.size(); ++c)
+            many_expected[c] = gfx::de_casteljau(curves[c], t[i]);
+        gfx::evaluate_cubics(&curves[0], curves.size(), t[i], &many_actual[0]);
+        many_error = std::max(many_error, MaxDistance(many_expected, many_actual));
+    }
+
+    //
+    // A long run, where plain float forward differences drift.
+    const int long_steps = 1 << 16;
+    std::vector<gfx::vector2> long_run(long_steps + 1);
+    float long_error = 0.0f;
+    for (size_t c = 0; c < 16; ++c) {
+        gfx::forward_difference_cubic(curves[c], long_steps, &long_run[0]);
+        for (int i = 0; i <= long_steps; ++i) {
+            const float ti = static_cast<float>(static_cast<double>(i) / long_steps);
+            long_error = std::max(
+                long_error, (long_run[i] - gfx::de_casteljau(curves[c], ti)).magnitude());
+        }
+    }
+
+    //
+    // Throughput, per point.
+    const int iterations = 2000;
+    const double per_point = 1.0 / samples;
+    const double de_casteljau_ns = MeasureNs(iterations, [&](int k) {
+        const gfx::cubic_bezier& curve = curves[k % curve_count];
+        for (int i = 0; i < samples; ++i)
+            actual[i] = gfx::de_casteljau(curve, t[i]);
+    }) * per_point;
+    const double batch_ns = MeasureNs(iterations, [&](int k) {
+        gfx::evaluate_cubic(curves[k % curve_count], &t[0], samples, &actual[0]);
+    }) * per_point;
+    const double difference_ns = MeasureNs(iterations, [&](int k) {
+        gfx::forward_difference_cubic(curves[k % curve_count], samples - 1, &actual[0]);
+    }) * per_point;
+    const double many_ns = MeasureNs(iterations, [&](int k) {
+        gfx::evaluate_cubics(&curves[0], curves.size(), t[k % samples], &many_actual[0]);
+    }) / curve_count;
+
+    std::printf("%-26s %12s %10s\n", "", "max error", "per point");
+    std::printf("%-26s %12s %7.2f ns\n", "de Casteljau", "-", de_casteljau_ns);
+    std::printf("%-26s %12.6f %7.2f ns\n", "evaluate_cubic", batch_error, batch_ns);
+    std::printf("%-26s %12.6f %7.2f ns\n", "evaluate_cubics", many_error, many_ns);
+    std::printf("%-26s %12.6f %7.2f ns\n", "forward_difference_cubic", difference_error,
+                difference_ns);
+    std::printf("%-26s %12.6f\n", "  65536 steps", long_error);
+    std::printf("%-26s %12.6f\n", "evaluate_cubic_derivative", derivative_error);
+
+    //
+    // Coordinates up to 1000, float rounding is around 1e-4 there.
+    const float limit = 0.01f;
+    const bool passed = batch_error < limit && many_error < limit &&
+        difference_error < limit && long_error < limit && derivative_error < 0.1f;
+    std::printf("%s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
+
+gfx::arc_segment
+RandomArc(
+    std::mt19937* rng
+    )
+{
+    std::uniform_real_distribution<float> coord(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> radius(1.0f, 600.0f);
+    std::uniform_real_distribution<float> rotation(-360.0f, 360.0f);
+    std::uniform_int_distribution<int> flag(0, 1);
+
+    return gfx::arc_segment(
+        gfx::vector2(coord(*rng), coord(*rng)), gfx::vector2(radius(*rng), radius(*rng)),
+        rotation(*rng), static_cast<gfx::sweep_direction>(flag(*rng)),
+        static_cast<gfx::arc_size>(flag(*rng)));
+}
+
+int
+CheckArc() {
+    std::mt19937 rng(40);
+    std::uniform_real_distribution<float> coord(-500.0f, 500.0f);
+    const float tolerances[] = { 0.01f, 0.1f, 1.0f };
+
+    //
+    // Accuracy : samples of every cubic must be within tolerance of the
+    // ellipse and turn around it by the sweep angle, in its direction. Cache hits must be the conversions, bit for
+    // bit.
+    const int arc_count = 5000;
+    const int samples_per_cubic = 16;
+    float worst_ratio = 0.0f;
+    float end_error = 0.0f;
+    float sweep_error = 0.0f;
+    size_t cubic_total = 0;
+    size_t cache_mismatches = 0;
+    gfx::arc_cubic_cache check_cache;
+    std::vector<gfx::bezier_segment> cubics;
+    std::vector<gfx::bezier_segment> cached;
+
+    for (int i = 0; i < arc_count; ++i) {
+        const gfx::vector2 start(coord(rng), coord(rng));
+        const gfx::arc_segment arc(RandomArc(&rng));
+        const float tolerance = tolerances[i % 3];
+
+        gfx::arc_centre_form centre;
+        if (!gfx::arc_to_centre_form(start, arc, &centre))
+            continue;
+
+        //
+        // The ellipse goes through both end points.
+        const float r = std::max(centre.rx_, centre.ry_);
+        const float end_distance = std::max(
+            (centre.point_at(centre.start_angle_) - start).magnitude(),
+            (centre.point_at(centre.start_angle_ + centre.sweep_angle_) - arc.point_).magnitude());
+        end_error = std::max(end_error, end_distance - 1.0e-6f * r);
+
+        cubics.clear();
+        gfx::arc_to_cubics(start, arc, tolerance, &cubics);
+        cubic_total += cubics.size();
+
+        cached.clear();
+        check_cache.append_cubics(start, arc, tolerance, &cached);
+        if (cached.size() != cubics.size() ||
+            std::memcmp(&cached[0], &cubics[0], cubics.size() * sizeof(cubics[0])))
+            ++cache_mismatches;
+
+        float turned = 0.0f;
+        float previous_angle = centre.start_angle_;
+        gfx::vector2 p0(start);
+
+        for (size_t c = 0; c < cubics.size(); ++c) {
+            const gfx::cubic_bezier curve(
+                p0, cubics[c].point1_, cubics[c].point2_, cubics[c].point3_);
+
+            for (int k = 1; k <= samples_per_cubic; ++k) {
+                const gfx::vector2 d(
+                    curve.point_at(static_cast<float>(k) / samples_per_cubic) - centre.centre_);
+                const double x = d.x_ * centre.cos_phi_ + d.y_ * centre.sin_phi_;
+                const double y = -d.x_ * centre.sin_phi_ + d.y_ * centre.cos_phi_;
+
+                //
+                // Distance to the ellipse, to first order : the implicit
+                // function over its gradient. Float rounding grows with the
+                // radius, the largest ones are many times the coordinates.
+                const double rx2 = static_cast<double>(centre.rx_) * centre.rx_;
+                const double ry2 = static_cast<double>(centre.ry_) * centre.ry_;
+                const double f = x * x / rx2 + y * y / ry2 - 1.0;
+                const double gx = 2.0 * x / rx2;
+                const double gy = 2.0 * y / ry2;
+                const double error = std::fabs(f) / std::sqrt(gx * gx + gy * gy);
+                worst_ratio = std::max(
+                    worst_ratio,
+                    static_cast<float>((error - 0.001 - 1.0e-6 * r) / tolerance));
+
+                const gfx::vector2 q(static_cast<float>(x / centre.rx_),
+                                     static_cast<float>(y / centre.ry_));
+                const float angle = std::atan2(q.y_, q.x_);
+                float step = angle - previous_angle;
+                if (step > gfx::PI)
+                    step -= 2.0f * gfx::PI;
+                else if (step < -gfx::PI)
+                    step += 2.0f * gfx::PI;
+                turned += step;
+                previous_angle = angle;
+            }
+
+            p0 = cubics[c].point3_;
+        }
+
+        sweep_error = std::max(sweep_error, std::fabs(turned - centre.sweep_angle_));
+    }
+
+    //
+    // Throughput : instanced shapes, 64 distinct arcs at many positions.
+    const int distinct = 64;
+    const int instances = 100000;
+    std::vector<gfx::arc_segment> shapes(distinct);
+    std::vector<gfx::vector2> starts(distinct);
+    for (int i = 0; i < distinct; ++i) {
+        starts[i] = gfx::vector2(coord(rng), coord(rng));
+        shapes[i] = RandomArc(&rng);
+    }
+
+    std::vector<gfx::vector2> offsets(instances);
+    for (int i = 0; i < instances; ++i)
+        offsets[i] = gfx::vector2(std::floor(coord(rng)), std::floor(coord(rng)));
+
+    const double convert_ns = MeasureNs(instances, [&](int i) {
+        cubics.clear();
+        gfx::arc_to_cubics(starts[i % distinct] + offsets[i],
+                           gfx::arc_segment(shapes[i % distinct].point_ + offsets[i],
+                                            shapes[i % distinct].size_,
+                                            shapes[i % distinct].rotation_angle_,
+                                            shapes[i % distinct].sweep_direction_,
+                                            shapes[i % distinct].arc_size_),
+                           0.1f, &cubics);
+    });
+
+    gfx::arc_cubic_cache cache;
+    const double cached_ns = MeasureNs(instances, [&](int i) {
+        cubics.clear();
+        cache.append_cubics(starts[i % distinct] + offsets[i],
+                            gfx::arc_segment(shapes[i % distinct].point_ + offsets[i],
+                                             shapes[i % distinct].size_,
+                                             shapes[i % distinct].rotation_angle_,
+                                             shapes[i % distinct].sweep_direction_,
+                                             shapes[i % distinct].arc_size_),
+                            0.1f, &cubics);
+    });
+    const gfx::arc_cache_statistics stats(cache.statistics());
+
+    //
+    // The fighter rebuilt every frame.
+    const int builds = 100000;
+    Fighter_Mig21 fighter;
+    gfx::compact_path compact;
+    gfx::arc_cubic_cache fighter_cache;
+    const double build_ns = MeasureNs(builds, [&](int) {
+        fighter.BuildCompactGeometry(&compact);
+    });
+    const double build_cached_ns = MeasureNs(builds, [&](int) {
+        fighter.BuildCompactGeometry(&compact, &fighter_cache);
+    });
+
+    std::printf("%d arcs, %u cubics : worst error %.3f of the tolerance, end points "
+                "%.5f, sweep %.5f rad, cache mismatches %u\n",
+                arc_count, static_cast<unsigned>(cubic_total), worst_ratio, end_error,
+                sweep_error, static_cast<unsigned>(cache_mismatches));
+    std::printf("%-24s %7.1f ns per arc\n", "arc_to_cubics", convert_ns);
+    std::printf("%-24s %7.1f ns per arc (%.1f%% hits)\n", "arc_cubic_cache", cached_ns,
+                100.0 * stats.hits_ / std::max<uint64_t>(stats.hits_ + stats.misses_, 1));
+    std::printf("%-24s %7.1f ns, %7.1f ns cached\n", "fighter compact build", build_ns,
+                build_cached_ns);
+
+    const bool passed = worst_ratio <= 1.0f && end_error < 0.01f && sweep_error < 0.01f &&
+        cache_mismatches == 0;
+    std::printf("%s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
+
+/*
+ * Counts its references like a COM object (interlocked, destroyed by the
+ * last Release), so the handles can be measured without Direct2D.
+ */
+class RefCountedMock {
+public :
+    RefCountedMock() : refs_(1), value_(0) {
+        ++live_count_;
+    }
+
+    unsigned long AddRef() {
+        return ++refs_;
+    }
+
+    unsigned long Release() {
+        const unsigned long refs = --refs_;
+        if (!refs)
+            delete this;
+        return refs;
+    }
+
+    unsigned long refs() const {
+        return refs_;
+    }
+
+    int value() const {
+        return value_;
+    }
+
+    static int live_count() {
+        return live_count_;
+    }
+
+private :
+    ~RefCountedMock() {
+        --live_count_;
+    }
+
+    std::atomic<unsigned long>  refs_;
+    int                         value_;
+    static std::atomic<int>     live_count_;
+};
+
+std::atomic<int> RefCountedMock::live_count_(0);
+
+struct MockReleaser {
+    void operator()(RefCountedMock* ptr) const {
+        if (ptr)
+            ptr->Release();
+    }
+};
+
+/*
+ * Create, copy, move and destroy costs of a handle type, per handle.
+ * Destroy releases the last reference, deleting the object; releasing the
+ * copies is left out of every column.
+ */
+template<typename Handle, typename Factory>
+void
+MeasureHandles(
+    const char* name,
+    Factory make
+    )
+{
+    const int handles = 1024;
+    const int iterations = 2000;
+    std::vector<Handle> sources(handles);
+    std::vector<Handle> copies(handles);
+    std::vector<Handle> moved(handles);
+
+    typedef std::chrono::steady_clock clock;
+    double create_ns = 0.0;
+    double destroy_ns = 0.0;
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        const clock::time_point start = clock::now();
+        for (int i = 0; i < handles; ++i)
+            sources[i] = make();
+        const clock::time_point created = clock::now();
+        for (int i = 0; i < handles; ++i)
+            sources[i] = nullptr;
+        create_ns += std::chrono::duration<double, std::nano>(created - start).count();
+        destroy_ns += std::chrono::duration<double, std::nano>(clock::now() - created).count();
+    }
+    create_ns /= static_cast<double>(iterations) * handles;
+    destroy_ns /= static_cast<double>(iterations) * handles;
+
+    for (int i = 0; i < handles; ++i)
+        sources[i] = make();
+
+    double copy_ns = 0.0;
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        const clock::time_point start = clock::now();
+        for (int i = 0; i < handles; ++i)
+            copies[i] = sources[i];
+        copy_ns += std::chrono::duration<double, std::nano>(clock::now() - start).count();
+        for (int i = 0; i < handles; ++i)
+            copies[i] = nullptr;
+    }
+    copy_ns /= static_cast<double>(iterations) * handles;
+
+    const double move_ns = MeasureNs(iterations, [&](int) {
+        for (int i = 0; i < handles; ++i)
+            moved[i] = std::move(sources[i]);
+        for (int i = 0; i < handles; ++i)
+            sources[i] = std::move(moved[i]);
+    }) / (2 * handles);
+
+    std::printf("%-34s %7.2f ns %7.2f ns %7.2f ns %7.2f ns\n", name, create_ns, copy_ns,
+                move_ns, destroy_ns);
+}
+
+int
+BenchHandles() {
+    typedef gfx::intrusive_ptr<RefCountedMock> intrusive_handle;
+    typedef std::shared_ptr<RefCountedMock> shared_handle;
+
+    //
+    // Otherwise growing a vector of handles copies them, an AddRef and a
+    // Release each.
+    static_assert(std::is_nothrow_move_constructible<intrusive_handle>::value &&
+                  std::is_nothrow_move_assignable<intrusive_handle>::value,
+                  "intrusive_ptr moves must be noexcept");
+
+    //
+    // Semantics : adopting, sharing, copies and moves.
+    bool passed = true;
+    {
+        intrusive_handle first(new RefCountedMock());
+        intrusive_handle second(first);
+        intrusive_handle third(intrusive_handle::share(first.get()));
+        passed = passed && first->refs() == 3 && first == second && first == third;
+
+        intrusive_handle moved(std::move(second));
+        passed = passed && !second && moved == first && first->refs() == 3;
+
+        third = third;
+        moved = nullptr;
+        passed = passed && first->refs() == 2 && first->value() == 0;
+
+        RefCountedMock* raw = third.detach();
+        passed = passed && raw->refs() == 2;
+        raw->Release();
+    }
+    passed = passed && RefCountedMock::live_count() == 0;
+
+    //
+    // libstdc++ drops to plain increments in shared_ptr until a thread has
+    // been started; the windowed apps always have several.
+    std::thread([] {}).join();
+
+    std::printf("%-34s %10s %10s %10s %10s\n", "per handle", "create", "copy", "move",
+                "destroy");
+    MeasureHandles<shared_handle>("shared_ptr + Release deleter", [] {
+        return shared_handle(new RefCountedMock(), MockReleaser());
+    });
+    MeasureHandles<intrusive_handle>("intrusive_ptr", [] {
+        return intrusive_handle(new RefCountedMock());
+    });
+
+    passed = passed && RefCountedMock::live_count() == 0;
+    std::printf("%s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
+
+/*
+ * Viewports of the fighter scene, each with its own pixels, target and
+ * background layer.
+ */
+class ViewportSet {
+public :
+    ViewportSet(
+        size_t count, int width, int height, gfx::thread_pool* pool,
+        bool parallel_submit = true)
+        : renderer_(pool), width_(width), height_(height), pixels_(count),
+          backgrounds_(count), caller_(std::this_thread::get_id()), foreign_draws_(0) {
+        renderer_.set_parallel_submit(parallel_submit);
+        for (size_t i = 0; i < count; ++i) {
+            pixels_[i].resize(static_cast<size_t>(width) * height);
+            targets_.push_back(std::make_shared<gfx::software_render_target>(
+                gfx::pixel_surface(&pixels_[i][0], width, height, width)));
+            renderer_.add_viewport(targets_.back().get());
+        }
+    }
+
+    //
+    // Every viewport looks at the scene from its own angle and distance,
+    // changing with the frame.
+    void Render(const FighterScene& scene, int frame) {
+        const gfx::vector2 centre(width_ * 0.5f, height_ * 0.5f);
+        for (size_t i = 0; i < renderer_.viewport_count(); ++i) {
+            const float angle = static_cast<float>(frame * 3 + i * 25);
+            const float zoom = 0.5f + 0.05f * static_cast<float>((frame + i * 7) % 10);
+            renderer_.set_camera(i,
+                gfx::matrix3X3::translation(centre) *
+                gfx::matrix3X3::rotation(angle) *
+                gfx::matrix3X3::scale(zoom, zoom) *
+                gfx::matrix3X3::translation(-centre.x_, -centre.y_));
+        }
+
+        renderer_.render([&](gfx::render_target* target, const gfx::matrix3X3& camera,
+                             size_t viewport) {
+            if (std::this_thread::get_id() != caller_)
+                ++foreign_draws_;
+            scene.DrawView(target, camera, &backgrounds_[viewport]);
+        });
+    }
+
+    const std::vector<uint32_t>& Pixels(size_t viewport) const {
+        return pixels_[viewport];
+    }
+
+    //
+    // Viewports drawn on another thread than the one that made the set.
+    int ForeignDraws() const {
+        return foreign_draws_.load();
+    }
+
+private :
+    gfx::viewport_renderer                                      renderer_;
+    int                                                         width_;
+    int                                                         height_;
+    std::vector<std::vector<uint32_t> >                         pixels_;
+    std::vector<std::shared_ptr<gfx::software_render_target> >  targets_;
+    std::vector<gfx::cached_layer>                              backgrounds_;
+    std::thread::id                                             caller_;
+    std::atomic<int>                                            foreign_draws_;
+};
+
+int
+BenchViewports() {
+    const int width = 640;
+    const int height = 512;
+    const int frames = 60;
+
+    FighterScene scene;
+    scene.Initialize(width, height);
+    scene.SetGradientFills(true);
+
+    //
+    // Same pixels with three workers as on the calling thread alone, and
+    // with parallel submit off, where nothing may be drawn on the workers.
+    bool identical = true;
+    bool serial_submit_on_caller = true;
+    {
+        gfx::thread_pool serial_pool(0);
+        gfx::thread_pool parallel_pool(3);
+        ViewportSet serial(16, width, height, &serial_pool);
+        ViewportSet parallel(16, width, height, &parallel_pool);
+        ViewportSet serial_submit(16, width, height, &parallel_pool, false);
+        for (int frame = 0; frame < 3; ++frame) {
+            serial.Render(scene, frame);
+            parallel.Render(scene, frame);
+            serial_submit.Render(scene, frame);
+        }
+
+        for (size_t i = 0; i < 16; ++i) {
+            identical = identical && serial.Pixels(i) == parallel.Pixels(i) &&
+                serial.Pixels(i) == serial_submit.Pixels(i);
+        }
+        serial_submit_on_caller = serial_submit.ForeignDraws() == 0;
+
+        //
+        // And the cameras do show different views.
+        identical = identical && serial.Pixels(0) != serial.Pixels(1);
+    }
+
+    gfx::thread_pool pool;
+    std::printf("%u hardware threads, %u workers, %dx%d viewports\n",
+                std::thread::hardware_concurrency(),
+                static_cast<unsigned>(pool.worker_count()), width, height);
+    std::printf("%-10s %14s %14s\n", "viewports", "views / s", "Mpixels / s");
+
+    const size_t counts[] = { 1, 4, 16 };
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+        ViewportSet views(counts[c], width, height, &pool);
+        views.Render(scene, 0);
+
+        const double frame_ns = MeasureNs(frames, [&](int frame) {
+            views.Render(scene, frame);
+        });
+        const double views_per_second = counts[c] * 1.0e9 / frame_ns;
+        std::printf("%-10u %14.1f %14.1f\n", static_cast<unsigned>(counts[c]),
+                    views_per_second, views_per_second * width * height * 1.0e-6);
+    }
+
+    std::printf("parallel output %s\n", identical ? "identical" : "DIFFERS");
+    std::printf("serial submit   %s\n", serial_submit_on_caller ?
+                "drawn on the calling thread" : "FAILED, drawn on the workers");
+    return (identical && serial_submit_on_caller) ? 0 : 1;
+}
+
+struct LoadPhase {
+    const char* name;
+    int         frames;
+    //
+    // Frame time at level 1 (the default settings), in ms.
+    double      load_ms;
+};
+
+int
+CheckQuality() {
+    const uint64_t budget_ns = 16666667;
+    //
+    // Cost of every default level relative to level 1.
+    const double level_cost[] = { 1.6, 1.0, 0.8, 0.55, 0.35 };
+    const LoadPhase phases[] = {
+        { "light", 300, 9.0 },
+        { "heavy", 600, 28.0 },
+        { "medium", 600, 13.0 },
+        //
+        // Level 1 is under the step up threshold, level 0 over budget.
+        { "between levels", 3000, 11.0 },
+        { "idle", 900, 5.0 }
+    };
+    //
+    // Between two levels, where it ends up depends on the timing.
+    const size_t C_AnyLevel = static_cast<size_t>(-1);
+    const size_t expected_levels[] = { 0, 3, 1, C_AnyLevel, 0 };
+
+    gfx::quality_controller controller(budget_ns);
+    std::mt19937 rng(43);
+    std::uniform_real_distribution<double> noise(0.95, 1.05);
+    bool passed = true;
+
+    std::printf("%-16s %8s %8s %8s %10s %10s\n", "load", "frames", "missed", "level",
+                "miss rate", "changes");
+    for (size_t p = 0; p < sizeof(phases) / sizeof(phases[0]); ++p) {
+        const LoadPhase& phase = phases[p];
+        const uint64_t changes_before = controller.statistics().level_changes_;
+        const uint64_t misses_before = controller.statistics().budget_misses_;
+
+        for (int frame = 0; frame < phase.frames; ++frame) {
+            const double ms = phase.load_ms * level_cost[controller.level()] * noise(rng);
+            controller.add_frame(static_cast<uint64_t>(ms * 1.0e6));
+        }
+
+        const uint64_t changes = controller.statistics().level_changes_ - changes_before;
+        const uint64_t misses = controller.statistics().budget_misses_ - misses_before;
+        std::printf("%-16s %8d %8u %8u %9.1f%% %10u\n", phase.name, phase.frames,
+                    static_cast<unsigned>(misses), static_cast<unsigned>(controller.level()),
+                    100.0f * controller.budget_miss_rate(), static_cast<unsigned>(changes));
+
+        //
+        // Without the growing wait, sitting between two levels would be
+        // about one change a second, each try at level 0 missing a few
+        // frames.
+        if (expected_levels[p] == C_AnyLevel) {
+            passed = passed && changes <= 12 &&
+                misses * 50 < static_cast<uint64_t>(phase.frames);
+        } else {
+            passed = passed && controller.level() == expected_levels[p] &&
+                controller.budget_miss_rate() < 0.05f;
+        }
+    }
+
+    //
+    // What the knobs buy on a real frame.
+    const int width = 1280;
+    const int height = 1024;
+    std::vector<uint32_t> pixels(static_cast<size_t>(width) * height);
+    gfx::software_render_target target(gfx::pixel_surface(&pixels[0], width, height, width));
+    FighterScene scene;
+    scene.Initialize(width, height);
+    scene.SetGradientFills(true);
+    scene.SetCacheBackground(false);
+
+    std::printf("\n%-6s %8s %10s %10s\n", "level", "samples", "tolerance", "frame");
+    for (size_t level = 0; level < controller.level_count(); ++level) {
+        controller.set_level(level);
+        controller.apply(&target);
+        const double frame_ns = MeasureNs(50, [&](int) {
+            target.begin_draw();
+            scene.Draw(&target);
+            target.end_draw();
+        });
+        std::printf("%-6u %8d %10.2f %7.2f ms\n", static_cast<unsigned>(level),
+                    controller.settings().sample_count_,
+                    controller.settings().flattening_tolerance_, frame_ns * 1.0e-6);
+    }
+
+    std::printf("%s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
+
+//
+// Each frame gets its own colour, so the front buffer shows which one was
+// presented last.
+gfx::color
+PresentFrameColor(
+    uint64_t frame_id
+    )
+{
+    return gfx::color(static_cast<uint32_t>((frame_id * 2654435761u) & 0xFFFFFF));
+}
+
+struct PresentRun {
+    gfx::present_policy policy;
+    //
+    // Render time per frame and refresh interval, in ms.
+    int                 render_ms;
+    int                 refresh_ms;
+};
+
+int
+CheckPresent() {
+    const int width = 320;
+    const int height = 240;
+    const int frames = 60;
+    const PresentRun runs[] = {
+        { gfx::present_fifo, 2, 6 },
+        { gfx::present_latest, 2, 6 },
+        { gfx::present_fifo, 6, 2 },
+        { gfx::present_latest, 6, 2 }
+    };
+
+    //
+    // The last frame as it should look on screen.
+    std::vector<uint32_t> expected_pixels(static_cast<size_t>(width) * height);
+    gfx::software_render_target expected(
+        gfx::pixel_surface(&expected_pixels[0], width, height, width));
+    expected.begin_draw();
+    expected.clear(PresentFrameColor(frames - 1));
+    expected.end_draw();
+
+    gfx::software_render_target target(width, height);
+    bool passed = true;
+    double fifo_latency_ns = 0.0;
+
+    std::printf("%-7s %7s %8s %10s %8s %6s %13s %13s\n", "policy", "render", "refresh",
+                "presented", "dropped", "waits", "avg latency", "max latency");
+    for (size_t r = 0; r < sizeof(runs) / sizeof(runs[0]); ++r) {
+        const PresentRun& run = runs[r];
+        gfx::headless_presenter presenter(width, height, run.refresh_ms * 1000000ULL);
+        gfx::present_statistics stats;
+        {
+            gfx::present_queue queue(width, height, run.policy, &presenter);
+            for (int frame = 0; frame < frames; ++frame) {
+                gfx::present_buffer* buffer = queue.acquire();
+                target.bind_surface(buffer->surface_);
+                target.begin_draw();
+                target.clear(PresentFrameColor(buffer->frame_id_));
+                target.end_draw();
+                std::this_thread::sleep_for(std::chrono::milliseconds(run.render_ms));
+                queue.submit(buffer);
+            }
+            queue.flush();
+            stats = queue.statistics();
+        }
+
+        const bool fifo = run.policy == gfx::present_fifo;
+        std::printf("%-7s %4d ms %5d ms %10u %8u %6u %10.2f ms %10.2f ms\n",
+                    fifo ? "fifo" : "latest", run.render_ms, run.refresh_ms,
+                    static_cast<unsigned>(stats.presented_), static_cast<unsigned>(stats.dropped_),
+                    static_cast<unsigned>(stats.render_waits_),
+                    stats.average_latency_ns() * 1.0e-6,
+                    static_cast<double>(stats.latency_max_ns_) * 1.0e-6);
+
+        //
+        // Presented frames are always in order and the last one always
+        // makes it to the screen.
+        const std::vector<uint64_t>& ids = presenter.presented_ids();
+        bool in_order = ids.size() == stats.presented_;
+        for (size_t i = 1; in_order && i < ids.size(); ++i)
+            in_order = ids[i] > ids[i - 1];
+
+        passed = passed && in_order &&
+            stats.submitted_ == static_cast<uint64_t>(frames) &&
+            stats.presented_ + stats.dropped_ == stats.submitted_ &&
+            stats.last_presented_id_ == static_cast<uint64_t>(frames - 1) &&
+            !std::memcmp(&expected_pixels[0], presenter.front().pixels_,
+                         expected_pixels.size() * sizeof(uint32_t));
+
+        if (fifo) {
+            passed = passed && stats.dropped_ == 0;
+            if (run.render_ms < run.refresh_ms) {
+                passed = passed && stats.render_waits_ > 0;
+                fifo_latency_ns = stats.average_latency_ns();
+            }
+        } else {
+            passed = passed && stats.render_waits_ == 0;
+            //
+            // Rendering faster than the refresh, latest-frame-wins drops
+            // frames instead of queueing them.
+            if (run.render_ms < run.refresh_ms) {
+                passed = passed && stats.dropped_ > 0 &&
+                    stats.average_latency_ns() < fifo_latency_ns;
+            }
+        }
+    }
+
+    std::printf("%s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
+
+int
+BenchInstances() {
+    const int width = 1280;
+    const int height = 1024;
+    const size_t squadron_sizes[] = { 16, 256, 2048 };
+    std::vector<uint32_t> per_object_pixels(static_cast<size_t>(width) * height);
+    std::vector<uint32_t> instanced_pixels(per_object_pixels.size());
+    gfx::software_render_target per_object_target(
+        gfx::pixel_surface(&per_object_pixels[0], width, height, width));
+    gfx::software_render_target instanced_target(
+        gfx::pixel_surface(&instanced_pixels[0], width, height, width));
+    const gfx::color background(0xFFFFFF);
+    int mismatches = 0;
+
+    std::printf("%-9s %12s %12s %12s %12s %10s\n", "fighters", "", "geometries",
+                "geometry KB", "LOD KB", "frame");
+    for (size_t s = 0; s < sizeof(squadron_sizes) / sizeof(squadron_sizes[0]); ++s) {
+        const size_t count = squadron_sizes[s];
+
+        //
+        // Same scale for every fighter, so both sides flatten at the same
+        // tolerance and must give the same pixels. Small fighters, so the
+        // per draw costs are not lost in the coverage work.
+        std::mt19937 rng(45);
+        std::uniform_real_distribution<float> x(0.0f, static_cast<float>(width));
+        std::uniform_real_distribution<float> y(0.0f, static_cast<float>(height));
+        std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+        std::uniform_int_distribution<uint32_t> rgb(0, 0xFFFFFF);
+        std::vector<gfx::matrix3X3> transforms(count);
+        std::vector<gfx::color> colors(count);
+        for (size_t i = 0; i < count; ++i) {
+            transforms[i] = gfx::matrix3X3::translation(x(rng), y(rng)) *
+                gfx::matrix3X3::rotation(angle(rng)) * gfx::matrix3X3::scale(1.5f, 1.5f);
+            colors[i] = gfx::color(rgb(rng));
+        }
+
+        std::vector<Fighter_Mig21> separate(count);
+        std::vector<Fighter_Mig21> pooled(count);
+        gfx::geometry_pool pool;
+        for (size_t i = 0; i < count; ++i) {
+            separate[i].BuildFighterGeometry();
+            separate[i].SetBrush(gfx::solid_color_brush(colors[i]));
+            pooled[i].BuildFighterGeometry(&pool);
+        }
+
+        per_object_target.lod_cache().clear();
+        instanced_target.lod_cache().clear();
+
+        const int frames = count > 256 ? 10 : 50;
+        const double per_object_ns = MeasureNs(frames, [&](int) {
+            per_object_target.begin_draw();
+            per_object_target.clear(background);
+            for (size_t i = 0; i < count; ++i) {
+                per_object_target.set_transform(transforms[i]);
+                per_object_target.fill_geometry(separate[i].GetGeometry(), separate[i].GetBrush());
+            }
+            per_object_target.end_draw();
+        });
+
+        const double instanced_ns = MeasureNs(frames, [&](int) {
+            instanced_target.begin_draw();
+            instanced_target.clear(background);
+            instanced_target.set_transform(gfx::matrix3X3::identity);
+            instanced_target.fill_geometry_instances(
+                pooled[0].GetGeometry(), &transforms[0], &colors[0], count);
+            instanced_target.end_draw();
+        });
+
+        size_t separate_bytes = 0;
+        for (size_t i = 0; i < count; ++i)
+            separate_bytes += separate[i].GetGeometry().memory_size();
+
+        std::printf("%-9u %12s %12u %12.1f %12.1f %7.2f ms\n", static_cast<unsigned>(count),
+                    "per object", static_cast<unsigned>(count), separate_bytes / 1024.0,
+                    per_object_target.lod_cache().memory_used() / 1024.0,
+                    per_object_ns * 1.0e-6);
+        std::printf("%-9s %12s %12u %12.1f %12.1f %7.2f ms (%.2fx)\n", "",
+                    "instanced", static_cast<unsigned>(pool.size()),
+                    pool.memory_used() / 1024.0,
+                    instanced_target.lod_cache().memory_used() / 1024.0,
+                    instanced_ns * 1.0e-6, per_object_ns / instanced_ns);
+
+        if (pool.size() != 1 || per_object_pixels != instanced_pixels)
+            ++mismatches;
+    }
+
+    //
+    // Drawn from distance fields, instances match single fills too.
+    {
+        const size_t count = 32;
+        std::mt19937 rng(46);
+        std::uniform_real_distribution<float> x(0.0f, static_cast<float>(width));
+        std::uniform_real_distribution<float> y(0.0f, static_cast<float>(height));
+        std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+        std::vector<gfx::matrix3X3> transforms(count);
+        std::vector<gfx::color> colors(count, gfx::color(0x000000));
+        for (size_t i = 0; i < count; ++i) {
+            transforms[i] = gfx::matrix3X3::translation(x(rng), y(rng)) *
+                gfx::matrix3X3::rotation(angle(rng)) * gfx::matrix3X3::scale(12.0f, 12.0f);
+        }
+
+        Fighter_Mig21 fighter;
+        fighter.BuildFighterGeometry();
+        const gfx::solid_color_brush black(colors[0]);
+        per_object_target.set_distance_field_resolution(64);
+        instanced_target.set_distance_field_resolution(64);
+
+        per_object_target.begin_draw();
+        per_object_target.clear(background);
+        for (size_t i = 0; i < count; ++i) {
+            per_object_target.set_transform(transforms[i]);
+            per_object_target.fill_geometry(fighter.GetGeometry(), &black);
+        }
+        per_object_target.end_draw();
+
+        instanced_target.begin_draw();
+        instanced_target.clear(background);
+        instanced_target.set_transform(gfx::matrix3X3::identity);
+        instanced_target.fill_geometry_instances(
+            fighter.GetGeometry(), &transforms[0], &colors[0], count);
+        instanced_target.end_draw();
+
+        const bool same = per_object_pixels == instanced_pixels;
+        std::printf("distance field instances %s\n", same ? "match" : "DIFFER");
+        if (!same)
+            ++mismatches;
+    }
+
+    std::printf("%s\n", mismatches ? "FAILED" : "passed");
+    return mismatches ? 1 : 0;
+}
+
+struct CoverageError {
+    //
+    // Over the pixels where either frame has some coverage, in 1 / 255.
+    double  mean;
+    int     max;
+    //
+    // Share of those pixels off by more than a quarter.
+    double  large;
+};
+
+//
+// Black shapes on white : the red channel is 255 minus the coverage.
+CoverageError
+CompareCoverage(
+    const std::vector<uint32_t>& expected,
+    const std::vector<uint32_t>& actual
+    )
+{
+    CoverageError error = { 0.0, 0, 0.0 };
+    uint64_t total = 0;
+    uint64_t large = 0;
+    uint64_t pixels = 0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        const int e = static_cast<int>(expected[i] & 0xFF);
+        const int a = static_cast<int>(actual[i] & 0xFF);
+        if (e == 0xFF && a == 0xFF)
+            continue;
+
+        const int diff = std::abs(e - a);
+        total += diff;
+        large += diff > 64;
+        error.max = std::max(error.max, diff);
+        ++pixels;
+    }
+
+    if (pixels) {
+        error.mean = static_cast<double>(total) / pixels;
+        error.large = static_cast<double>(large) / pixels;
+    }
+    return error;
+}
+
+int
+BenchDistanceField() {
+    const int width = 1280;
+    const int height = 1024;
+    const float scales[] = { 25.0f, 100.0f, 400.0f };
+    const int resolutions[] = { 64, 128, 256 };
+    const gfx::color background(0xFFFFFF);
+    const gfx::solid_color_brush black(gfx::color(0x000000));
+
+    Fighter_Mig21 fighter;
+    fighter.BuildFighterGeometry();
+    const gfx::path_geometry& geometry = fighter.GetGeometry();
+
+    std::vector<uint32_t> raster_pixels(static_cast<size_t>(width) * height);
+    std::vector<uint32_t> field_pixels(raster_pixels.size());
+    gfx::software_render_target raster_target(
+        gfx::pixel_surface(&raster_pixels[0], width, height, width));
+    gfx::software_render_target field_target(
+        gfx::pixel_surface(&field_pixels[0], width, height, width));
+
+    std::printf("%-6s %-12s %10s %10s %10s %10s %8s\n", "scale", "method", "field KB",
+                "frame", "mean err", "max err", "> 1/4");
+    bool passed = true;
+    for (size_t s = 0; s < sizeof(scales) / sizeof(scales[0]); ++s) {
+        const gfx::matrix3X3 xform =
+            gfx::matrix3X3::translation(width * 0.5f, height * 0.5f) *
+            gfx::matrix3X3::rotation(30.0f) *
+            gfx::matrix3X3::scale(scales[s], scales[s]);
+
+        const double raster_ns = MeasureNs(20, [&](int) {
+            raster_target.begin_draw();
+            raster_target.clear(background);
+            raster_target.set_transform(xform);
+            raster_target.fill_geometry(geometry, &black);
+            raster_target.end_draw();
+        });
+        std::printf("%-6.0f %-12s %10s %7.2f ms\n", scales[s], "rasterized", "",
+                    raster_ns * 1.0e-6);
+
+        for (size_t r = 0; r < sizeof(resolutions) / sizeof(resolutions[0]); ++r) {
+            field_target.set_distance_field_resolution(resolutions[r]);
+            //
+            // The field is built by the first frame, before the timing.
+            field_target.begin_draw();
+            field_target.fill_geometry(geometry, &black);
+            field_target.end_draw();
+
+            const double field_ns = MeasureNs(20, [&](int) {
+                field_target.begin_draw();
+                field_target.clear(background);
+                field_target.set_transform(xform);
+                field_target.fill_geometry(geometry, &black);
+                field_target.end_draw();
+            });
+
+            const gfx::distance_field& field =
+                field_target.distance_fields().find(geometry, resolutions[r]);
+            const CoverageError error = CompareCoverage(raster_pixels, field_pixels);
+            char method[32];
+            std::snprintf(method, sizeof(method), "field %dx%d", field.width(), field.height());
+            std::printf("%-6s %-12s %10.1f %7.2f ms %10.2f %10d %7.2f%%\n", "", method,
+                        field.memory_size() / 1024.0, field_ns * 1.0e-6, error.mean,
+                        error.max, 100.0 * error.large);
+
+            //
+            // At the scale the demo draws, a modest field is as good as
+            // antialiasing gets.
+            if (scales[s] == 25.0f && resolutions[r] >= 128)
+                passed = passed && error.mean < 8.0 && error.large < 0.01;
+        }
+    }
+
+    //
+    // Stretched ten times more along one axis than the other : distances
+    // must be converted along the direction they are measured in, not by
+    // the largest stretch.
+    {
+        const gfx::matrix3X3 xform =
+            gfx::matrix3X3::translation(width * 0.5f, height * 0.5f) *
+            gfx::matrix3X3::rotation(30.0f) *
+            gfx::matrix3X3::scale(8.0f, 80.0f);
+
+        raster_target.begin_draw();
+        raster_target.clear(background);
+        raster_target.set_transform(xform);
+        raster_target.fill_geometry(geometry, &black);
+        raster_target.end_draw();
+
+        field_target.set_distance_field_resolution(256);
+        field_target.begin_draw();
+        field_target.clear(background);
+        field_target.set_transform(xform);
+        field_target.fill_geometry(geometry, &black);
+        field_target.end_draw();
+
+        const CoverageError error = CompareCoverage(raster_pixels, field_pixels);
+        std::printf("%-6s %-12s %10s %10s %10.2f %10d %7.2f%%\n", "8x80", "field 256", "", "",
+                    error.mean, error.max, 100.0 * error.large);
+        passed = passed && error.mean < 8.0 && error.large < 0.01;
+    }
+
+    //
+    // What building a field costs, once per geometry.
+    for (size_t r = 0; r < sizeof(resolutions) / sizeof(resolutions[0]); ++r) {
+        gfx::distance_field field;
+        const double build_ns = MeasureNs(5, [&](int) {
+            field.build(geometry, resolutions[r]);
+        });
+        std::printf("build %d : %.2f ms\n", resolutions[r], build_ns * 1.0e-6);
+    }
+
+    std::printf("%s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
+
+int
+BenchSprites() {
+    const int width = 1280;
+    const int height = 1024;
+    const size_t count = 2000;
+    const int sample_counts[] = { 4, 16 };
+    const gfx::color background(0xFFFFFF);
+    const gfx::solid_color_brush black(gfx::color(0x000000));
+
+    Fighter_Mig21 fighter;
+    fighter.BuildFighterGeometry();
+    const gfx::path_geometry& geometry = fighter.GetGeometry();
+
+    //
+    // Black fighters, so the coverage can be read back from the pixels.
+    std::mt19937 rng(47);
+    std::uniform_real_distribution<float> x(0.0f, static_cast<float>(width));
+    std::uniform_real_distribution<float> y(0.0f, static_cast<float>(height));
+    std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+    std::uniform_real_distribution<float> scale(1.0f, 4.0f);
+    std::vector<gfx::matrix3X3> transforms(count);
+    for (size_t i = 0; i < count; ++i) {
+        const float s = scale(rng);
+        transforms[i] = gfx::matrix3X3::translation(x(rng), y(rng)) *
+            gfx::matrix3X3::rotation(angle(rng)) * gfx::matrix3X3::scale(s, s);
+    }
+
+    std::vector<uint32_t> raster_pixels(static_cast<size_t>(width) * height);
+    std::vector<uint32_t> sprite_pixels(raster_pixels.size());
+    gfx::software_render_target raster_target(
+        gfx::pixel_surface(&raster_pixels[0], width, height, width));
+    gfx::software_render_target sprite_target(
+        gfx::pixel_surface(&sprite_pixels[0], width, height, width));
+    sprite_target.set_sprite_atlas_enabled(true);
+    gfx::sprite_atlas& atlas = sprite_target.sprites();
+
+    auto draw_swarm = [&](gfx::software_render_target& target) {
+        target.begin_draw();
+        target.clear(background);
+        for (size_t i = 0; i < count; ++i) {
+            target.set_transform(transforms[i]);
+            target.fill_geometry(geometry, &black);
+        }
+        target.end_draw();
+    };
+
+    std::printf("%u fighters\n", static_cast<unsigned>(count));
+    bool passed = true;
+    for (size_t s = 0; s < sizeof(sample_counts) / sizeof(sample_counts[0]); ++s) {
+        raster_target.set_sample_count(sample_counts[s]);
+        sprite_target.set_sample_count(sample_counts[s]);
+
+        //
+        // The first frame fills the atlas, the timed ones only hit it.
+        // Best of a few runs : a single core box gets preempted.
+        atlas.reset_statistics();
+        draw_swarm(sprite_target);
+        const gfx::sprite_atlas_statistics first = atlas.statistics();
+        atlas.reset_statistics();
+        double raster_ns = 1.0e12;
+        double sprite_ns = 1.0e12;
+        for (int run = 0; run < 3; ++run) {
+            raster_ns = std::min(raster_ns, MeasureNs(10, [&](int) { draw_swarm(raster_target); }));
+            sprite_ns = std::min(sprite_ns, MeasureNs(10, [&](int) { draw_swarm(sprite_target); }));
+        }
+        const gfx::sprite_atlas_statistics later = atlas.statistics();
+        const CoverageError error = CompareCoverage(raster_pixels, sprite_pixels);
+
+        std::printf("%2d samples : rasterized %7.2f ms, atlas %7.2f ms (%.2fx)\n",
+                    sample_counts[s], raster_ns * 1.0e-6, sprite_ns * 1.0e-6,
+                    raster_ns / sprite_ns);
+        std::printf("             %u sprites in %u pages (%.0f KB), %u over %d pixels, "
+                    "hit rate %.1f%% after the first frame\n",
+                    static_cast<unsigned>(first.misses_), static_cast<unsigned>(atlas.page_count()),
+                    atlas.memory_used() / 1024.0, static_cast<unsigned>(first.rejected_),
+                    atlas.max_sprite_size(), 100.0 * later.hit_rate());
+        std::printf("             mean err %.2f, max err %d, %.2f%% off by > 1/4\n",
+                    error.mean, error.max, 100.0 * error.large);
+        passed = passed && later.misses_ == 0 && error.mean < 16.0 && error.large < 0.02;
+    }
+
+    //
+    // A budget too small for the swarm : pages keep getting recycled.
+    // Sprites land in other slots, which only moves the rounding.
+    const std::vector<uint32_t> unbounded_pixels(sprite_pixels);
+    atlas.set_budget(0);
+    atlas.reset_statistics();
+    const double evicting_ns = MeasureNs(5, [&](int) { draw_swarm(sprite_target); });
+    const gfx::sprite_atlas_statistics evicting = atlas.statistics();
+    const CoverageError evicting_error = CompareCoverage(unbounded_pixels, sprite_pixels);
+    std::printf("one page   : atlas %7.2f ms, hit rate %.1f%%, %u pages evicted (%u sprites), "
+                "max err %d\n", evicting_ns * 1.0e-6, 100.0 * evicting.hit_rate(),
+                static_cast<unsigned>(evicting.pages_evicted_),
+                static_cast<unsigned>(evicting.sprites_evicted_), evicting_error.max);
+    passed = passed && evicting.pages_evicted_ > 0 && evicting_error.max <= 2;
+
+    //
+    // Unrotated at a scale the atlas keeps, on whole pixels : sprites are
+    // copied, not filtered, and match the rasterizer.
+    for (size_t i = 0; i < count; ++i)
+        transforms[i] = gfx::matrix3X3::translation(std::floor(x(rng)), std::floor(y(rng)));
+    atlas.set_budget(gfx::sprite_atlas::C_DefaultBudget);
+    raster_target.set_sample_count(4);
+    sprite_target.set_sample_count(4);
+    draw_swarm(sprite_target);
+    double aligned_raster_ns = 1.0e12;
+    double aligned_sprite_ns = 1.0e12;
+    for (int run = 0; run < 3; ++run) {
+        aligned_raster_ns = std::min(aligned_raster_ns,
+                                     MeasureNs(10, [&](int) { draw_swarm(raster_target); }));
+        aligned_sprite_ns = std::min(aligned_sprite_ns,
+                                     MeasureNs(10, [&](int) { draw_swarm(sprite_target); }));
+    }
+    const CoverageError aligned_error = CompareCoverage(raster_pixels, sprite_pixels);
+    std::printf("aligned    : 4 samples, rasterized %7.2f ms, atlas %7.2f ms (%.2fx), max err %d\n",
+                aligned_raster_ns * 1.0e-6, aligned_sprite_ns * 1.0e-6,
+                aligned_raster_ns / aligned_sprite_ns, aligned_error.max);
+    passed = passed && aligned_error.max <= 2;
+
+    //
+    // Shapes too large for the atlas, at every rotation and many scales,
+    // must not take up sprite slots.
+    const size_t held = atlas.sprite_count();
+    size_t too_large = 0;
+    for (int step = 0; step < 32; ++step) {
+        const float s = 64.0f * std::exp2(step * 0.25f);
+        for (int r = 0; r < 64; ++r) {
+            const gfx::matrix3X3 xform =
+                gfx::matrix3X3::rotation(r * (360.0f / 64)) * gfx::matrix3X3::scale(s, s);
+            too_large += atlas.find(geometry, xform) == nullptr;
+        }
+    }
+    std::printf("too large  : %u of %u shapes rejected, %u sprites held before, %u after\n",
+                static_cast<unsigned>(too_large), 32u * 64u, static_cast<unsigned>(held),
+                static_cast<unsigned>(atlas.sprite_count()));
+    passed = passed && too_large == 32 * 64 && atlas.sprite_count() == held;
+
+    std::printf("%s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
+
+//
+// What the windowed demos do with a key : d2d_flicker_test moves the
+// block, geometry_path_test quits on any key. False ends the replay.
+bool
+ReplayKey(
+    BlockScene* scene,
+    const gfx::input_event& event
+    )
+{
+    if (event.type_ == gfx::input_event_key_down)
+        scene->HandleKeyDown(static_cast<DemoKey>(event.key_));
+    else
+        scene->HandleKeyUp(static_cast<DemoKey>(event.key_));
+    return true;
+}
+
+bool
+ReplayKey(
+    FighterScene*,
+    const gfx::input_event& event
+    )
+{
+    return event.type_ != gfx::input_event_key_down;
+}
+
+void
+AdvanceScene(
+    BlockScene* scene,
+    uint64_t elapsed_ns
+    )
+{
+    scene->Update(elapsed_ns);
+}
+
+void
+AdvanceScene(
+    FighterScene*,
+    uint64_t
+    )
+{
+}
+
+uint64_t
+SimulationSteps(
+    const BlockScene& scene
+    )
+{
+    return scene.GetStepCount();
+}
+
+uint64_t
+SimulationSteps(
+    const FighterScene&
+    )
+{
+    return 0;
+}
+
+struct ReplayReport {
+    //
+    // From the recording : the same for every replay of it.
+    uint64_t    frames;
+    uint64_t    key_events;
+    uint64_t    recorded_ns;
+    uint64_t    max_frame_ns;
+    uint64_t    steps;
+    //
+    // FNV-1a of the last frame, changes only when the drawing does.
+    uint64_t    checksum;
+    //
+    // False when the recording ended on a damaged event.
+    bool        complete;
+    //
+    // Measured.
+    double      render_ns;
+    double      max_render_ns;
+};
+
+template<typename Scene>
+ReplayReport
+ReplayScene(
+    Scene* scene,
+    gfx::input_playback* playback,
+    gfx::software_render_target* target
+    )
+{
+    ReplayReport report = { 0, 0, 0, 0, 0, 0, true, 0.0, 0.0 };
+    playback->rewind();
+
+    gfx::input_event event;
+    while (playback->next(&event)) {
+        if (event.type_ != gfx::input_event_frame) {
+            ++report.key_events;
+            if (!ReplayKey(scene, event))
+                break;
+            continue;
+        }
+
+        //
+        // Frame times are the differences between frame events, exactly
+        // what the scene got when recording.
+        const uint64_t elapsed_ns = event.time_ns_ - report.recorded_ns;
+        report.recorded_ns = event.time_ns_;
+        report.max_frame_ns = std::max(report.max_frame_ns, elapsed_ns);
+        ++report.frames;
+        AdvanceScene(scene, elapsed_ns);
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        target->begin_draw();
+        scene->Draw(target);
+        target->end_draw();
+        const double render_ns = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count());
+        report.render_ns += render_ns;
+        report.max_render_ns = std::max(report.max_render_ns, render_ns);
+    }
+
+    report.complete = !playback->failed();
+    report.steps = SimulationSteps(*scene);
+
+    const gfx::pixel_surface& surface = target->surface();
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (int y = 0; y < surface.height_; ++y) {
+        const uint32_t* row = surface.row(y);
+        for (int x = 0; x < surface.width_; ++x)
+            hash = (hash ^ row[x]) * 0x100000001B3ull;
+    }
+    report.checksum = hash;
+    return report;
+}
+
+void
+PrintReplayReport(
+    const ReplayReport& report
+    )
+{
+    const double frames = std::max(1.0, static_cast<double>(report.frames));
+    std::printf("  recording       : %llu frames, %llu key events, %.3f s%s\n",
+                static_cast<unsigned long long>(report.frames),
+                static_cast<unsigned long long>(report.key_events),
+                static_cast<double>(report.recorded_ns) * 1.0e-9,
+                report.complete ? "" : ", DAMAGED");
+    std::printf("  frame times     : %.3f ms mean, %.3f ms max (recorded)\n",
+                static_cast<double>(report.recorded_ns) * 1.0e-6 / frames,
+                static_cast<double>(report.max_frame_ns) * 1.0e-6);
+    std::printf("  simulation      : %llu steps, last frame %016llx\n",
+                static_cast<unsigned long long>(report.steps),
+                static_cast<unsigned long long>(report.checksum));
+    std::printf("  render          : %.3f ms/frame, %.3f ms max\n",
+                report.render_ns * 1.0e-6 / frames, report.max_render_ns * 1.0e-6);
+}
+
+bool
+SameReplay(
+    const ReplayReport& a,
+    const ReplayReport& b
+    )
+{
+    return a.frames == b.frames && a.key_events == b.key_events &&
+        a.recorded_ns == b.recorded_ns && a.max_frame_ns == b.max_frame_ns &&
+        a.steps == b.steps && a.checksum == b.checksum && a.complete == b.complete;
+}
+
+int
+CheckReplay() {
+    const int width = 640;
+    const int height = 480;
+    const int frames = 1200;
+
+    //
+    // A session as the window would run it : uneven frame times, arrow
+    // keys held for a while, the handlers called as the events come.
+    gfx::input_recorder recorder;
+    BlockScene live;
+    live.Initialize(width, height);
+    std::mt19937 rng(48);
+    std::uniform_int_distribution<uint64_t> frame_ns(4000000, 40000000);
+    std::uniform_int_distribution<int> key_roll(0, 29);
+    uint64_t time_ns = 0;
+    DemoKey held = DemoKey_Other;
+    for (int frame = 0; frame < frames; ++frame) {
+        const uint64_t elapsed_ns = frame ? frame_ns(rng) : 0;
+        time_ns += elapsed_ns;
+        recorder.frame(time_ns);
+        live.Update(elapsed_ns);
+
+        if (key_roll(rng))
+            continue;
+
+        //
+        // Key events land between frames, a millisecond after this one.
+        const uint64_t key_ns = time_ns + 1000000;
+        if (held != DemoKey_Other) {
+            recorder.key_up(key_ns, held);
+            live.HandleKeyUp(held);
+            held = DemoKey_Other;
+        } else {
+            held = key_roll(rng) & 1 ? DemoKey_Left : DemoKey_Right;
+            recorder.key_down(key_ns, held);
+            live.HandleKeyDown(held);
+        }
+    }
+
+    std::vector<uint32_t> pixels(static_cast<size_t>(width) * height);
+    gfx::software_render_target target(gfx::pixel_surface(&pixels[0], width, height, width));
+    gfx::input_playback playback;
+    bool passed = playback.assign(&recorder.data()[0], recorder.data().size());
+
+    ReplayReport reports[2];
+    gfx::vector2 positions[2];
+    for (int run = 0; run < 2; ++run) {
+        BlockScene scene;
+        scene.Initialize(width, height);
+        reports[run] = ReplayScene(&scene, &playback, &target);
+        positions[run] = scene.GetSimulatedPosition();
+    }
+
+    std::printf("recorded %u events (%u frames) in %u bytes, %.2f bytes per event\n",
+                static_cast<unsigned>(recorder.event_count()),
+                static_cast<unsigned>(recorder.frame_count()),
+                static_cast<unsigned>(recorder.data().size()),
+                static_cast<double>(recorder.data().size()) / recorder.event_count());
+    for (int run = 0; run < 2; ++run) {
+        std::printf("replay %d, block at (%.3f, %.3f)\n", run + 1,
+                    positions[run].x_, positions[run].y_);
+        PrintReplayReport(reports[run]);
+    }
+
+    const gfx::vector2 live_position(live.GetSimulatedPosition());
+    passed = passed && reports[0].complete && SameReplay(reports[0], reports[1]) &&
+        reports[0].frames == static_cast<uint64_t>(frames) &&
+        reports[0].key_events + reports[0].frames == recorder.event_count() &&
+        reports[0].steps == live.GetStepCount() &&
+        SameBits(positions[0], live_position) && SameBits(positions[1], live_position);
+
+    //
+    // A cut recording replays up to the cut and says so.
+    gfx::input_playback truncated;
+    truncated.assign(&recorder.data()[0], recorder.data().size() - 1);
+    BlockScene scene;
+    scene.Initialize(width, height);
+    const ReplayReport cut = ReplayScene(&scene, &truncated, &target);
+    passed = passed && !cut.complete && cut.frames <= reports[0].frames;
+
+    std::printf("%s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
+
+uint64_t
+SteadyNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+//
+// Closes the inputs of the frames as they reach the screen.
+class LatencyPresenter : public gfx::frame_presenter {
+public :
+    LatencyPresenter(gfx::frame_presenter* screen, gfx::latency_tracker* latency)
+        : screen_(screen), latency_(latency) {}
+
+    void present_frame(const gfx::present_buffer& buffer) {
+        screen_->present_frame(buffer);
+        latency_->frame_completed(buffer.frame_id_, SteadyNs());
+    }
+
+private :
+    gfx::frame_presenter*   screen_;
+    gfx::latency_tracker*   latency_;
+};
+
+void
+MeasureInputLatency(
+    const PresentRun& run,
+    int frames,
+    gfx::latency_tracker* latency
+    )
+{
+    const int width = 320;
+    const int height = 240;
+    BlockScene scene;
+    scene.Initialize(width, height);
+    gfx::software_render_target target(width, height);
+    gfx::headless_presenter screen(width, height, run.refresh_ms * 1000000ULL);
+    LatencyPresenter presenter(&screen, latency);
+    gfx::present_queue queue(width, height, run.policy, &presenter);
+
+    std::mt19937 rng(49);
+    std::uniform_int_distribution<int> key_roll(0, 3);
+    std::uniform_real_distribution<double> arrival(0.0, 1.0);
+    DemoKey held = DemoKey_Other;
+    uint64_t last_frame_ns = SteadyNs();
+
+    for (int frame = 0; frame < frames; ++frame) {
+        gfx::present_buffer* buffer = queue.acquire();
+        const uint64_t now_ns = SteadyNs();
+        const uint64_t elapsed_ns = now_ns - last_frame_ns;
+        last_frame_ns = now_ns;
+
+        //
+        // Synthetic keys, handled now like the window handles its queued
+        // messages, stamped sometime during the last frame.
+        if (!key_roll(rng)) {
+            const uint64_t input_ns = now_ns - static_cast<uint64_t>(
+                arrival(rng) * static_cast<double>(elapsed_ns));
+            const uint64_t sequence = latency->input_event(input_ns);
+            if (held != DemoKey_Other) {
+                scene.HandleKeyUp(held, sequence);
+                held = DemoKey_Other;
+            } else {
+                held = key_roll(rng) & 1 ? DemoKey_Left : DemoKey_Right;
+                scene.HandleKeyDown(held, sequence);
+            }
+        }
+
+        scene.Update(elapsed_ns);
+        latency->frame_started(buffer->frame_id_, scene.GetAppliedInput());
+        target.bind_surface(buffer->surface_);
+        target.begin_draw();
+        scene.Draw(&target);
+        target.end_draw();
+        std::this_thread::sleep_for(std::chrono::milliseconds(run.render_ms));
+        queue.submit(buffer);
+    }
+
+    queue.flush();
+}
+
+int
+CheckLatency(
+    const std::string& csv_path
+    )
+{
+    const int frames = 120;
+    const PresentRun runs[] = {
+        { gfx::present_fifo, 2, 16 },
+        { gfx::present_latest, 2, 16 },
+        { gfx::present_fifo, 24, 16 }
+    };
+
+    std::printf("%-7s %7s %8s %7s %9s %9s %9s %9s %9s %7s\n", "policy", "render", "refresh",
+                "inputs", "mean", "p50", "p90", "p99", "max", "frames");
+    bool passed = true;
+    double fifo_p50_ns = 0.0;
+    for (size_t r = 0; r < sizeof(runs) / sizeof(runs[0]); ++r) {
+        const PresentRun& run = runs[r];
+        gfx::latency_tracker latency;
+        MeasureInputLatency(run, frames, &latency);
+        const gfx::latency_summary summary = latency.summary();
+
+        const bool fifo = run.policy == gfx::present_fifo;
+        std::printf("%-7s %4d ms %5d ms %7u %6.2f ms %6.2f ms %6.2f ms %6.2f ms %6.2f ms %7.2f\n",
+                    fifo ? "fifo" : "latest", run.render_ms, run.refresh_ms,
+                    static_cast<unsigned>(summary.count_), summary.mean_ns_ * 1.0e-6,
+                    summary.p50_ns_ * 1.0e-6, summary.p90_ns_ * 1.0e-6,
+                    summary.p99_ns_ * 1.0e-6, summary.max_ns_ * 1.0e-6, summary.mean_frames_);
+
+        //
+        // Every input shows up at least a frame later, except the last
+        // ones when the run ends before a simulation step picks them up.
+        passed = passed && summary.count_ > 0 && summary.open_ <= 2 &&
+            summary.mean_frames_ >= 1.0 && summary.p50_ns_ <= summary.p90_ns_ &&
+            summary.p90_ns_ <= summary.p99_ns_ && summary.p99_ns_ <= summary.max_ns_;
+
+        if (r == 0) {
+            fifo_p50_ns = summary.p50_ns_;
+            if (!csv_path.empty() && !latency.export_csv(csv_path)) {
+                std::fprintf(stderr, "cannot write %s\n", csv_path.c_str());
+                passed = false;
+            }
+        } else if (!fifo && run.render_ms < run.refresh_ms) {
+            //
+            // Rendering faster than the refresh, a queue of frames is a
+            // queue of latency.
+            passed = passed && summary.p50_ns_ < fifo_p50_ns;
+        }
+    }
+
+    std::printf("%s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
+
+//
+// Zones recorded with trace_zone directly, so this runs in any build.
+double
+TraceZoneNs(
+    int count
+    )
+{
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+        gfx::trace_zone zone("bench zone");
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+    return std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count() / count;
+}
+
+double
+EmptyLoopNs(
+    int count
+    )
+{
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i)
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    return std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count() / count;
+}
+
+int
+BenchTrace() {
+    const int count = 2000000;
+    bool passed = true;
+
+    //
+    // Best of a few runs : a single core box gets preempted.
+    gfx::trace_clear();
+    double zone_ns = 1.0e9;
+    double empty_ns = 1.0e9;
+    for (int run = 0; run < 5; ++run) {
+        zone_ns = std::min(zone_ns, TraceZoneNs(count));
+        empty_ns = std::min(empty_ns, EmptyLoopNs(count));
+    }
+    const double overhead_ns = zone_ns - empty_ns;
+    std::printf("trace zone       : %6.1f ns (empty loop %.1f ns)\n", overhead_ns, empty_ns);
+    if (overhead_ns > 100.0) {
+        std::printf("  FAILED : a zone costs more than 100 ns\n");
+        passed = false;
+    }
+
+    //
+    // The buffer keeps the newest C_Capacity zones, in order.
+    gfx::trace_buffer* buffer = gfx::trace_thread_buffer();
+    std::vector<gfx::trace_event> events;
+    buffer->snapshot(&events);
+    bool ordered = events.size() == gfx::trace_buffer::C_Capacity;
+    for (size_t i = 1; ordered && i < events.size(); ++i)
+        ordered = events[i - 1].end_ns_ <= events[i].begin_ns_ &&
+            events[i].begin_ns_ <= events[i].end_ns_;
+    std::printf("wrapped buffer   : %llu recorded, %u kept\n",
+                static_cast<unsigned long long>(buffer->recorded()),
+                static_cast<unsigned>(events.size()));
+    if (!ordered) {
+        std::printf("  FAILED : the kept zones are not the newest, in order\n");
+        passed = false;
+    }
+
+    //
+    // Another thread writes zones numbered 1, 2, ... as fast as it can;
+    // snapshots must hold consecutive, whole zones.
+    std::atomic<gfx::trace_buffer*> writer_buffer(nullptr);
+    std::atomic<bool> stop(false);
+    std::thread writer([&writer_buffer, &stop]() {
+        GFX_TRACE_THREAD_NAME("bench writer");
+        gfx::trace_buffer* own = gfx::trace_thread_buffer();
+        writer_buffer.store(own);
+        for (uint64_t i = 1; !stop.load(std::memory_order_relaxed); ++i)
+            own->record("writer zone", i, i + 1);
+    });
+
+    while (!writer_buffer.load())
+        std::this_thread::yield();
+
+    size_t snapshots = 0;
+    size_t read = 0;
+    size_t torn = 0;
+    while (snapshots < 50 || writer_buffer.load()->recorded() < 2 * gfx::trace_buffer::C_Capacity) {
+        std::vector<gfx::trace_event> copy;
+        writer_buffer.load()->snapshot(&copy);
+        for (size_t i = 0; i < copy.size(); ++i) {
+            torn += copy[i].end_ns_ != copy[i].begin_ns_ + 1 ||
+                (i && copy[i].begin_ns_ != copy[i - 1].begin_ns_ + 1);
+        }
+        read += copy.size();
+        ++snapshots;
+        std::this_thread::yield();
+    }
+    stop.store(true);
+    writer.join();
+
+    std::printf("concurrent reads : %u snapshots, %u zones, %u torn\n",
+                static_cast<unsigned>(snapshots), static_cast<unsigned>(read),
+                static_cast<unsigned>(torn));
+    if (torn) {
+        std::printf("  FAILED : a snapshot held torn or overwritten zones\n");
+        passed = false;
+    }
+
+    //
+    // Two full buffers, this thread's and the writer's.
+    const char* path = "bench_trace.json";
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    const bool written = gfx::trace_write_chrome_json(path);
+    const double export_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    std::remove(path);
+    std::printf("export           : %.1f ms for %u zones\n", export_ms,
+                static_cast<unsigned>(2 * gfx::trace_buffer::C_Capacity));
+    if (!written) {
+        std::printf("  FAILED : cannot write %s\n", path);
+        passed = false;
+    }
+
+    //
+    // Threads come and go, as when a pool is restarted : clearing frees
+    // the buffers of those that exited, this thread's is kept.
+    for (int restart = 0; restart < 4; ++restart) {
+        std::vector<std::thread> workers;
+        for (int i = 0; i < 4; ++i)
+            workers.push_back(std::thread([]() { gfx::trace_set_thread_name("bench worker"); }));
+        for (size_t i = 0; i < workers.size(); ++i)
+            workers[i].join();
+        gfx::trace_clear();
+    }
+    const size_t buffers = gfx::trace_buffer_count();
+    std::printf("exited threads   : %u buffers held after 16 threads were cleared\n",
+                static_cast<unsigned>(buffers));
+    if (buffers != 1) {
+        std::printf("  FAILED : the buffers of exited threads were not freed\n");
+        passed = false;
+    }
+
+    gfx::trace_clear();
+    return passed ? 0 : 1;
+}
+
+//
+// Writes the segments it gets as text, e.g. "M0,0 L1,1 Z" : a closed
+// figure ends with Z, an open one with E.
+class SvgLogSink : public gfx::path_sink {
+public :
+    const std::string& log() const {
+        return log_;
+    }
+
+    void begin_figure(const gfx::vector2& start_point, gfx::figure_begin) {
+        Append("M%g,%g", start_point.x_, start_point.y_);
+    }
+
+    void add_line(const gfx::vector2& point) {
+        Append("L%g,%g", point.x_, point.y_);
+    }
+
+    void add_bezier(const gfx::bezier_segment& bezier) {
+        Append("C%g,%g %g,%g %g,%g", bezier.point1_.x_, bezier.point1_.y_,
+               bezier.point2_.x_, bezier.point2_.y_, bezier.point3_.x_, bezier.point3_.y_);
+    }
+
+    void add_quadratic_bezier(const gfx::quadratic_bezier_segment& bezier) {
+        Append("Q%g,%g %g,%g", bezier.point1_.x_, bezier.point1_.y_,
+               bezier.point2_.x_, bezier.point2_.y_);
+    }
+
+    void add_arc(const gfx::arc_segment& arc) {
+        Append("A%g,%g %g %s %s %g,%g", arc.size_.x_, arc.size_.y_, arc.rotation_angle_,
+               arc.arc_size_ == gfx::arc_size_large ? "large" : "small",
+               arc.sweep_direction_ == gfx::sweep_direction_clockwise ? "cw" : "ccw",
+               arc.point_.x_, arc.point_.y_);
+    }
+
+    void end_figure(gfx::figure_end end) {
+        Append(end == gfx::figure_end_closed ? "Z" : "E");
+    }
+
+    bool close() {
+        return true;
+    }
+
+private :
+    void Append(const char* format, ...) {
+        char text[256];
+        va_list args;
+        va_start(args, format);
+        std::vsnprintf(text, sizeof(text), format, args);
+        va_end(args);
+        if (!log_.empty())
+            log_ += ' ';
+        log_ += text;
+    }
+
+    std::string log_;
+};
+
+struct SvgCase {
+    const char* path_data;
+    //
+    // What the sink gets; for rejected data, the segments before the error.
+    const char* segments;
+    bool        accepted;
+    size_t      error_offset;
+};
+
+int
+CheckSvg() {
+    const SvgCase cases[] = {
+        //
+        // Absolute and relative commands, implicit linetos after a moveto.
+        { "M10 20 L30 40 H50 V60 Z", "M10,20 L30,40 L50,40 L50,60 Z", true, 0 },
+        { "m10 20 l5 5 h5 v-5 z m1 1 2 2",
+          "M10,20 L15,25 L20,25 L20,20 Z M11,21 L13,23 E", true, 0 },
+        { "M0 0 L1 1 2 2 3 3", "M0,0 L1,1 L2,2 L3,3 E", true, 0 },
+        //
+        // Smooth curves reflect the previous control point, or start at the
+        // current point after a segment of another kind.
+        { "M0 0 C10 0 20 10 20 20 S30 40 40 40 s10 0 10 10",
+          "M0,0 C10,0 20,10 20,20 C20,30 30,40 40,40 C50,40 50,40 50,50 E", true, 0 },
+        { "M0 0 L10 0 S20 10 30 0", "M0,0 L10,0 C10,0 20,10 30,0 E", true, 0 },
+        { "M0 0 Q10 10 20 0 T40 0 t20 0",
+          "M0,0 Q10,10 20,0 Q30,-10 40,0 Q50,10 60,0 E", true, 0 },
+        { "M0 0 C1 1 2 2 3 3 T5 5", "M0,0 C1,1 2,2 3,3 Q3,3 5,5 E", true, 0 },
+        //
+        // Arcs : packed flags, a zero radius is a line, an arc ending on its
+        // start point is left out.
+        { "M0 0a1 1 0 013 4", "M0,0 A1,1 0 small cw 3,4 E", true, 0 },
+        { "M0 0A5,5 30 1,0 10,0", "M0,0 A5,5 30 large ccw 10,0 E", true, 0 },
+        { "M1 1 A0 5 0 0 0 4 5 A3 3 0 0 0 4 5", "M1,1 L4,5 E", true, 0 },
+        //
+        // Compact numbers and exponents.
+        { "M1-2.5.5.5", "M1,-2.5 L0.5,0.5 E", true, 0 },
+        { "M1e2-1E-1L.5e1+2", "M100,-0.1 L5,2 E", true, 0 },
+        { "M0,0L1.5.5,2.,3", "M0,0 L1.5,0.5 L2,3 E", true, 0 },
+        { "  M 0 , 0 \n\t L 1 , 1  ", "M0,0 L1,1 E", true, 0 },
+        //
+        // Rejections.
+        { "L1 1", "", false, 0 },
+        { "M1-2.5.5", "M1,-2.5 E", false, 8 },
+        { "M0 0 X1 1", "M0,0 E", false, 5 },
+        { "M0 0 Z 1 1", "M0,0 Z", false, 7 },
+        { "M0 0 A1 1 0 2 0 3 3", "M0,0 E", false, 12 },
+        { "M0 0 L1 1 L2", "M0,0 L1,1 E", false, 12 },
+        { "M0 0 L1e", "M0,0 E", false, 7 },
+        { "M0 0 L--1 1", "M0,0 E", false, 6 }
+    };
+
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        const SvgCase& test = cases[i];
+        SvgLogSink sink;
+        gfx::svg_path_parser parser(&sink);
+        const bool accepted = parser.parse(test.path_data);
+
+        if (accepted != test.accepted || sink.log() != test.segments ||
+            (!accepted && parser.error_offset() != test.error_offset)) {
+            std::printf("FAILED \"%s\"\n  expected %s \"%s\" (offset %u)\n"
+                        "  got      %s \"%s\" (offset %u)\n", test.path_data,
+                        test.accepted ? "accepted" : "rejected", test.segments,
+                        static_cast<unsigned>(test.error_offset),
+                        accepted ? "accepted" : "rejected", sink.log().c_str(),
+                        static_cast<unsigned>(parser.error_offset()));
+            ++failures;
+        }
+    }
+    std::printf("path data : %u cases, %d failed\n",
+                static_cast<unsigned>(sizeof(cases) / sizeof(cases[0])), failures);
+
+    //
+    // The fighter outline as path data gives the same geometry.
+    Fighter_Mig21 built;
+    built.BuildFighterGeometry();
+    Fighter_Mig21 parsed;
+    const bool fighter_parsed = parsed.BuildGeometryFromPathData(
+        "M-5 0L-5 1C-4.5 2-3.5 3.5-1 5A1 4 0 101 5C2 4.5 3.5 3.5 5 1L5 0L.5-1"
+        "C.5-1 0-4-.5-1L-5 0Z");
+    const bool same_fighter = fighter_parsed &&
+        parsed.GetGeometry().same_content(built.GetGeometry());
+    std::printf("fighter   : %s\n", same_fighter ? "same geometry" : "FAILED, geometry differs");
+
+    return (failures || !same_fighter) ? 1 : 0;
+}
+
+//
+// Random path data using every command, about size bytes.
+std::string
+MakeSvgPathData(
+    size_t size
+    )
+{
+    std::mt19937 rng(26);
+    std::uniform_int_distribution<int> command(0, 9);
+    std::uniform_real_distribution<float> coord(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> radius(1.0f, 200.0f);
+
+    std::string data("M0 0 ");
+    data.reserve(size + 256);
+    char text[256];
+    while (data.size() < size) {
+        switch (command(rng)) {
+        case 0 :
+            std::snprintf(text, sizeof(text), "M%.2f,%.2f ", coord(rng), coord(rng));
+            break;
+        case 1 :
+            std::snprintf(text, sizeof(text), "L%.2f %.2f %.2f %.2f ",
+                          coord(rng), coord(rng), coord(rng), coord(rng));
+            break;
+        case 2 :
+            std::snprintf(text, sizeof(text), "h%.3f v%.3f ", coord(rng), coord(rng));
+            break;
+        case 3 :
+            std::snprintf(text, sizeof(text), "C%.2f,%.2f %.2f,%.2f %.2f,%.2f ",
+                          coord(rng), coord(rng), coord(rng), coord(rng), coord(rng),
+                          coord(rng));
+            break;
+        case 4 :
+            std::snprintf(text, sizeof(text), "s%.2f-%.2f.5e1,%.1f ",
+                          coord(rng), radius(rng), coord(rng));
+            break;
+        case 5 :
+            std::snprintf(text, sizeof(text), "q%.2f %.2f %.2f %.2f ",
+                          coord(rng), coord(rng), coord(rng), coord(rng));
+            break;
+        case 6 :
+            std::snprintf(text, sizeof(text), "T%.2f %.2f ", coord(rng), coord(rng));
+            break;
+        case 7 :
+            std::snprintf(text, sizeof(text), "a%.1f %.1f %.0f 01%.2f %.2f ",
+                          radius(rng), radius(rng), coord(rng), coord(rng), coord(rng));
+            break;
+        case 8 :
+            std::snprintf(text, sizeof(text), "A%.1f,%.1f,0,1,0,%.2f,%.2f ",
+                          radius(rng), radius(rng), coord(rng), coord(rng));
+            break;
+        default :
+            std::snprintf(text, sizeof(text), "Z M%.2f %.2f ", coord(rng), coord(rng));
+            break;
+        }
+        data += text;
+    }
+    return data;
+}
+
+//
+// Counts the segments, so the parser is measured alone.
+class CountingSink : public gfx::path_sink {
+public :
+    CountingSink() : segments_(0) {}
+
+    void begin_figure(const gfx::vector2&, gfx::figure_begin) { ++segments_; }
+    void add_line(const gfx::vector2&) { ++segments_; }
+    void add_bezier(const gfx::bezier_segment&) { ++segments_; }
+    void add_quadratic_bezier(const gfx::quadratic_bezier_segment&) { ++segments_; }
+    void add_arc(const gfx::arc_segment&) { ++segments_; }
+    void end_figure(gfx::figure_end) {}
+    bool close() { return true; }
+
+    size_t segments_;
+};
+
+int
+BenchSvg() {
+    const std::string data = MakeSvgPathData(8 << 20);
+    const double megabytes = static_cast<double>(data.size()) / (1 << 20);
+    const int runs = 5;
+
+    //
+    // Best of a few runs, into a sink doing nothing and into a geometry.
+    double parse_seconds = 1.0e9;
+    double geometry_seconds = 1.0e9;
+    size_t segments = 0;
+    size_t commands = 0;
+    bool parsed = true;
+    for (int run = 0; run < runs; ++run) {
+        CountingSink counting;
+        gfx::svg_path_parser parser(&counting);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        parsed = parser.parse(data.data(), data.data() + data.size()) && parsed;
+        parse_seconds = std::min(parse_seconds, std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count());
+        segments = counting.segments_;
+        commands = parser.command_count();
+
+        gfx::path_geometry geometry;
+        start = std::chrono::steady_clock::now();
+        gfx::path_sink* sink = geometry.open();
+        gfx::svg_path_parser into_geometry(sink);
+        parsed = into_geometry.parse(data.data(), data.data() + data.size()) && parsed;
+        parsed = sink->close() && parsed;
+        geometry_seconds = std::min(geometry_seconds, std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+
+    std::printf("path data : %.1f MB, %u commands, %u segments\n", megabytes,
+                static_cast<unsigned>(commands), static_cast<unsigned>(segments));
+    std::printf("%-28s %8.1f MB/s %8.1f ms\n", "parse", megabytes / parse_seconds,
+                parse_seconds * 1.0e3);
+    std::printf("%-28s %8.1f MB/s %8.1f ms\n", "parse into path_geometry",
+                megabytes / geometry_seconds, geometry_seconds * 1.0e3);
+    if (!parsed)
+        std::printf("FAILED : the generated path data was rejected\n");
+    return parsed ? 0 : 1;
+}
+
+} // anonymous namespace
+
+int
+main(
+    int argc,
+    char** argv
+    )
+{
+    HeadlessOptions options;
+    if (!ParseOptions(argc, argv, &options)) {
+        std::fprintf(stderr, "usage : %s [--scene=fighter|block] [--frames=N] "
+                     "[--size=WxH] [--samples=N] [--fill=solid|gradient] "
+                     "[--static-layer=on|off] [--overdraw-pass] [--capture=PREFIX] "
+                     "[--capture-format=ppm|qoi] [--capture-policy=block|drop] "
+                     "[--capture-buffers=N] [--distance-field=N] [--replay=FILE] "
+                     "[--trace=FILE] | "
+                     "--bench-kernels | "
+                     "--bench-collision | "
+                     "--check-timestep | --bench-animation | --bench-lod | "
+                     "--bench-hit-test | --bench-compact-path | --check-bezier | "
+                     "--check-arc | --bench-handles | --bench-viewports | "
+                     "--check-quality | --check-present | --bench-instances | "
+                     "--bench-distance-field | --bench-sprites | --check-replay | "
+                     "--check-latency [--latency-csv=FILE] | --bench-trace | --check-svg | "
+                     "--bench-svg\n",
+                     argv[0]);
+        return -1;
+    }
+
+    if (!options.trace.empty()) {
+#if !defined(GFX_TRACE)
+        std::fprintf(stderr, "built without GFX_TRACE : %s will hold no zones\n",
+                     options.trace.c_str());
+#endif
+        gfx::trace_write_at_exit(options.trace);
+    }
+    GFX_TRACE_THREAD_NAME("main");
+
+    if (options.bench_kernels)
+        return BenchKernels();
+
+    if (options.bench_collision)
+        return BenchCollision();
+
+    if (options.check_timestep)
+        return CheckTimestep();
+
+    if (options.bench_animation)
+        return BenchAnimation();
+
+    if (options.bench_lod)
+        return BenchLod();
+
+    if (options.bench_hit_test)
+        return BenchHitTest();
+
+    if (options.bench_compact_path)
+        return BenchCompactPath();
+
+    if (options.check_bezier)
+        return CheckBezier();
+
+    if (options.check_arc)
+        return CheckArc();
+
+    if (options.bench_handles)
+        return BenchHandles();
+
+    if (options.bench_viewports)
+        return BenchViewports();
+
+    if (options.check_quality)
+        return CheckQuality();
+
+    if (options.check_present)
+        return CheckPresent();
+
+    if (options.bench_instances)
+        return BenchInstances();
+
+    if (options.bench_distance_field)
+        return BenchDistanceField();
+
+    if (options.bench_sprites)
+        return BenchSprites();
+
+    if (options.check_replay)
+        return CheckReplay();
+
+    if (options.check_latency)
+        return CheckLatency(options.latency_csv);
+
+    if (options.bench_trace)
+        return BenchTrace();
+
+    if (options.check_svg)
+        return CheckSvg();
+
+    if (options.bench_svg)
+        return BenchSvg();
+
+    std::vector<uint32_t> frame_pixels(
+        static_cast<size_t>(options.width) * options.height);
+    const gfx::pixel_surface frame_surface(
+        &frame_pixels[0], options.width, options.height, options.width);
+
+    gfx::software_render_target target(frame_surface);
+    target.set_sample_count(options.samples);
+    target.set_distance_field_resolution(options.distance_field);
+
+    if (!options.replay.empty()) {
+        gfx::input_playback playback;
+        if (!playback.load(options.replay)) {
+            std::fprintf(stderr, "%s is not an input recording\n", options.replay.c_str());
+            return 1;
+        }
+
+        ReplayReport report;
+        if (options.scene == "fighter") {
+            FighterScene scene;
+            scene.Initialize(options.width, options.height);
+            scene.SetGradientFills(options.gradient_fills);
+            scene.SetCacheBackground(options.static_layer);
+            report = ReplayScene(&scene, &playback, &target);
+        } else {
+            BlockScene scene;
+            scene.Initialize(options.width, options.height);
+            report = ReplayScene(&scene, &playback, &target);
+        }
+
+        std::printf("replay of %s (%u bytes), scene %s, %dx%d\n", options.replay.c_str(),
+                    static_cast<unsigned>(playback.size()), options.scene.c_str(),
+                    options.width, options.height);
+        PrintReplayReport(report);
+        return report.complete ? 0 : 1;
+    }
+
+    std::shared_ptr<gfx::image_file_writer> capture_writer;
+    std::shared_ptr<gfx::frame_capture> capture;
+    if (!options.capture_prefix.empty()) {
+        capture_writer.reset(new gfx::image_file_writer(
+            options.capture_prefix, options.capture_format));
+        capture.reset(new gfx::frame_capture(
+            options.width, options.height, options.capture_buffers,
+            options.capture_format, options.capture_policy, capture_writer.get()));
+    }
+
+    if (options.scene == "fighter") {
+        FighterScene scene;
+        scene.Initialize(options.width, options.height);
+        scene.SetGradientFills(options.gradient_fills);
+        scene.SetCacheBackground(options.static_layer);
+        RunScene(scene, options, frame_surface, &target, capture.get());
+
+        //
+        // The layer is drawn through its own target, so the fill work
+        // above is only what is left per frame once the background is
+        // cached.
+        const gfx::layer_cache_statistics& layer = scene.GetBackgroundStatistics();
+        std::printf("  static layer    : %s, %llu renders, %llu reuses\n",
+                    options.static_layer ? "on" : "off",
+                    static_cast<unsigned long long>(layer.renders_),
+                    static_cast<unsigned long long>(layer.reuses_));
+    } else {
+        BlockScene scene;
+        scene.Initialize(options.width, options.height);
+        RunScene(scene, options, frame_surface, &target, capture.get());
+    }
+
+    return 0;
+}
@@ -0,0 +1,211 @@
+/*
+ * hit_test.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "hit_test.h"
+
+#include <cfloat>
+#include <cmath>
+
+namespace {
+
+//
+// About four edges per band on average, more bands do not pay for their
+// memory on the paths the demos draw.
+const size_t C_EdgesPerBand = 4;
+const size_t C_MaxBands = 1024;
+
+/*
+ * Signed crossing of the edge (x0, y0) -> (x1, y1) with the ray going
+ * from pt towards +x. Edges cover [y0, y1) so a ray through a vertex
+ * counts it once.
+ */
+inline
+int
+edge_crossing(
+    float x0,
+    float y0,
+    float x1,
+    float y1,
+    const gfx::vector2& pt
+    )
+{
+    int dir = 1;
+    if (y0 > y1) {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+        dir = -1;
+    }
+
+    if (pt.y_ < y0 || pt.y_ >= y1)
+        return 0;
+
+    const float x = x0 + (pt.y_ - y0) * (x1 - x0) / (y1 - y0);
+    return x > pt.x_ ? dir : 0;
+}
+
+inline
+bool
+inside(
+    int winding,
+    gfx::fill_mode mode
+    )
+{
+    return mode == gfx::fill_mode_winding ? winding != 0 : (winding & 1) != 0;
+}
+
+} // anonymous namespace
+
+bool
+gfx::point_in_flattened_path(
+    const flattened_path& path,
+    const vector2& pt,
+    fill_mode mode
+    )
+{
+    int winding = 0;
+
+    for (size_t figure = 0; figure < path.figure_count(); ++figure) {
+        const size_t first = path.figure_begin(figure);
+        const size_t last = path.figure_ends_[figure];
+        if (last - first < 2)
+            continue;
+
+        for (size_t i = first, j = last - 1; i < last; j = i++) {
+            const vector2& p0 = path.points_[j];
+            const vector2& p1 = path.points_[i];
+            winding += edge_crossing(p0.x_, p0.y_, p1.x_, p1.y_, pt);
+        }
+    }
+
+    return inside(winding, mode);
+}
+
+void
+gfx::path_hit_tester::build(
+    const path_geometry& geometry,
+    float tolerance
+    )
+{
+    flattened_path path;
+    geometry.flatten(matrix3X3::identity, tolerance, &path);
+    build(path);
+}
+
+void
+gfx::path_hit_tester::build(
+    const flattened_path& path
+    )
+{
+    fill_mode_ = path.fill_mode_;
+    x0_.clear();
+    y0_.clear();
+    x1_.clear();
+    y1_.clear();
+    dir_.clear();
+    band_edges_.clear();
+    band_ends_.clear();
+    bounds_ = rectangle(0.0f, 0.0f, 0.0f, 0.0f);
+    band_scale_ = 0.0f;
+
+    for (size_t figure = 0; figure < path.figure_count(); ++figure) {
+        const size_t first = path.figure_begin(figure);
+        const size_t last = path.figure_ends_[figure];
+        if (last - first < 2)
+            continue;
+
+        for (size_t i = first, j = last - 1; i < last; j = i++) {
+            vector2 p0(path.points_[j]);
+            vector2 p1(path.points_[i]);
+            if (p0.y_ == p1.y_)
+                continue;
+
+            int8_t dir = 1;
+            if (p0.y_ > p1.y_) {
+                std::swap(p0, p1);
+                dir = -1;
+            }
+
+            x0_.push_back(p0.x_);
+            y0_.push_back(p0.y_);
+            x1_.push_back(p1.x_);
+            y1_.push_back(p1.y_);
+            dir_.push_back(dir);
+        }
+    }
+
+    if (x0_.empty())
+        return;
+
+    bounds_ = rectangle(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (size_t i = 0; i < x0_.size(); ++i) {
+        bounds_.add_point(vector2(x0_[i], y0_[i]));
+        bounds_.add_point(vector2(x1_[i], y1_[i]));
+    }
+
+    const size_t bands = std::min(std::max<size_t>(x0_.size() / C_EdgesPerBand, 1), C_MaxBands);
+    band_scale_ = static_cast<float>(bands) / (bounds_.bottom_ - bounds_.top_);
+    band_ends_.resize(bands);
+
+    //
+    // Counting pass, then each edge goes into every band it crosses.
+    std::vector<uint32_t> counts(bands, 0);
+    for (size_t i = 0; i < x0_.size(); ++i) {
+        for (int band = band_of(y0_[i]), last = band_of(y1_[i]); band <= last; ++band)
+            ++counts[band];
+    }
+
+    uint32_t total = 0;
+    for (size_t band = 0; band < bands; ++band) {
+        total += counts[band];
+        band_ends_[band] = total;
+    }
+
+    band_edges_.resize(total);
+    for (size_t band = 0; band < bands; ++band)
+        counts[band] = band ? band_ends_[band - 1] : 0;
+
+    for (size_t i = 0; i < x0_.size(); ++i) {
+        for (int band = band_of(y0_[i]), last = band_of(y1_[i]); band <= last; ++band)
+            band_edges_[counts[band]++] = static_cast<uint32_t>(i);
+    }
+}
+
+int
+gfx::path_hit_tester::band_of(
+    float y
+    ) const
+{
+    const int band = static_cast<int>((y - bounds_.top_) * band_scale_);
+    return std::min(std::max(band, 0), static_cast<int>(band_ends_.size()) - 1);
+}
+
+bool
+gfx::path_hit_tester::contains(
+    const vector2& pt,
+    fill_mode mode
+    ) const
+{
+    if (band_ends_.empty() || !point_in_rectangle(pt, bounds_))
+        return false;
+
+    const int band = band_of(pt.y_);
+    const uint32_t first = band ? band_ends_[band - 1] : 0;
+    const uint32_t last = band_ends_[band];
+
+    int winding = 0;
+    for (uint32_t k = first; k < last; ++k) {
+        const uint32_t i = band_edges_[k];
+        if (pt.y_ < y0_[i] || pt.y_ >= y1_[i])
+            continue;
+
+        const float x = x0_[i] + (pt.y_ - y0_[i]) * (x1_[i] - x0_[i]) / (y1_[i] - y0_[i]);
+        if (x > pt.x_)
+            winding += dir_[i];
+    }
+
+    return inside(winding, mode);
+}
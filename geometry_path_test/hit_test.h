@@ -0,0 +1,134 @@
+/*
+ * hit_test.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_HIT_TEST_H_
+#define GFX_HIT_TEST_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "matrix3x3.h"
+#include "path_geometry.h"
+#include "rectangle.h"
+#include "vector2.h"
+
+namespace gfx {
+
+/*
+ * True if the point is inside the flattened path, testing every edge :
+ * the reference the banded tester is checked against. fill_mode_winding
+ * is the non zero rule, fill_mode_alternate even-odd. Figures are
+ * implicitly closed, as when filling.
+ */
+bool
+point_in_flattened_path(
+    const flattened_path& path,
+    const vector2& pt,
+    fill_mode mode
+    );
+
+/*
+ * Point in path queries against one geometry, in its own space. The edges
+ * of the flattened geometry are sorted into horizontal bands of equal
+ * height; a query only looks at the edges crossing the band of the point.
+ */
+class path_hit_tester {
+public :
+    path_hit_tester() : fill_mode_(fill_mode_alternate), band_scale_(0.0f) {}
+
+    /*
+     * Flattens the geometry (tolerance in geometry units) and builds the
+     * bands. The geometry is not referenced afterwards.
+     */
+    void build(const path_geometry& geometry, float tolerance);
+
+    void build(const flattened_path& path);
+
+    /*
+     * With the fill mode of the path.
+     */
+    bool contains(const vector2& pt) const {
+        return contains(pt, fill_mode_);
+    }
+
+    bool contains(const vector2& pt, fill_mode mode) const;
+
+    const rectangle& bounds() const {
+        return bounds_;
+    }
+
+    size_t edge_count() const {
+        return x0_.size();
+    }
+
+    size_t band_count() const {
+        return band_ends_.size();
+    }
+
+private :
+    int band_of(float y) const;
+
+    fill_mode               fill_mode_;
+    rectangle               bounds_;
+    float                   band_scale_;
+    //
+    // Edges, going down (y0_ < y1_) with the original direction in dir_.
+    // Horizontal edges never cross the test ray and are left out.
+    std::vector<float>      x0_;
+    std::vector<float>      y0_;
+    std::vector<float>      x1_;
+    std::vector<float>      y1_;
+    std::vector<int8_t>     dir_;
+    //
+    // Edge indices per band, band_ends_ holds one past the last index of
+    // each band.
+    std::vector<uint32_t>   band_edges_;
+    std::vector<uint32_t>   band_ends_;
+};
+
+/*
+ * A hit tester placed in the scene with a transform. The inverse of the
+ * transform is computed once, when it changes, so every query maps the
+ * device point into geometry space with one matrix-vector product.
+ */
+class hit_test_object {
+public :
+    hit_test_object(const path_hit_tester* tester, const matrix3X3& xform)
+        : tester_(tester) {
+        assert(tester_);
+        set_transform(xform);
+    }
+
+    void set_transform(const matrix3X3& xform) {
+        transform_ = xform;
+        invertible_ = xform.is_invertible();
+        if (invertible_)
+            inverse_ = inverse_of(xform);
+    }
+
+    const matrix3X3& get_transform() const {
+        return transform_;
+    }
+
+    /*
+     * Objects with a degenerate transform cover no area, nothing hits
+     * them.
+     */
+    bool hit(const vector2& device_point) const {
+        return invertible_ && tester_->contains(inverse_ * device_point);
+    }
+
+private :
+    const path_hit_tester*  tester_;
+    matrix3X3               transform_;
+    matrix3X3               inverse_;
+    bool                    invertible_;
+};
+
+} // ns gfx
+
+#endif /* GFX_HIT_TEST_H_ */
@@ -0,0 +1,216 @@
+/*
+ * image_encoders.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "image_encoders.h"
+
+#include <cstring>
+
+namespace {
+
+inline
+void
+put_u32_be(
+    uint32_t value,
+    std::vector<uint8_t>* output
+    )
+{
+    output->push_back(static_cast<uint8_t>(value >> 24));
+    output->push_back(static_cast<uint8_t>(value >> 16));
+    output->push_back(static_cast<uint8_t>(value >> 8));
+    output->push_back(static_cast<uint8_t>(value));
+}
+
+//
+// Premultiplied RGBA8 to straight RGBA8, same byte layout.
+inline
+uint32_t
+unpremultiply(
+    uint32_t pixel
+    )
+{
+    const uint32_t a = pixel >> 24;
+    if (a == 0xFF || !a)
+        return a ? pixel : 0;
+
+    const uint32_t r = ((pixel & 0xFF) * 255 + a / 2) / a;
+    const uint32_t g = (((pixel >> 8) & 0xFF) * 255 + a / 2) / a;
+    const uint32_t b = (((pixel >> 16) & 0xFF) * 255 + a / 2) / a;
+    return std::min(r, 255u) | (std::min(g, 255u) << 8) |
+        (std::min(b, 255u) << 16) | (a << 24);
+}
+
+inline
+uint32_t
+qoi_hash(
+    uint32_t pixel
+    )
+{
+    const uint32_t r = pixel & 0xFF;
+    const uint32_t g = (pixel >> 8) & 0xFF;
+    const uint32_t b = (pixel >> 16) & 0xFF;
+    const uint32_t a = pixel >> 24;
+    return (r * 3 + g * 5 + b * 7 + a * 11) & 63;
+}
+
+const uint8_t C_QoiOpIndex = 0x00;
+const uint8_t C_QoiOpDiff = 0x40;
+const uint8_t C_QoiOpLuma = 0x80;
+const uint8_t C_QoiOpRun = 0xC0;
+const uint8_t C_QoiOpRgb = 0xFE;
+const uint8_t C_QoiOpRgba = 0xFF;
+const int C_QoiMaxRun = 62;
+
+} // anonymous namespace
+
+void
+gfx::encode_ppm(
+    const pixel_surface& pixels,
+    std::vector<uint8_t>* output
+    )
+{
+    assert(output);
+
+    char header[64];
+    const int header_len = std::sprintf(
+        header, "P6\n%d %d\n255\n", pixels.width_, pixels.height_);
+
+    output->resize(header_len + static_cast<size_t>(pixels.width_) * pixels.height_ * 3);
+    std::memcpy(&(*output)[0], header, header_len);
+
+    uint8_t* out = &(*output)[header_len];
+    for (int y = 0; y < pixels.height_; ++y) {
+        const uint32_t* row = pixels.row(y);
+        for (int x = 0; x < pixels.width_; ++x) {
+            const uint32_t pixel = row[x];
+            *out++ = static_cast<uint8_t>(pixel);
+            *out++ = static_cast<uint8_t>(pixel >> 8);
+            *out++ = static_cast<uint8_t>(pixel >> 16);
+        }
+    }
+}
+
+void
+gfx::encode_qoi(
+    const pixel_surface& pixels,
+    std::vector<uint8_t>* output
+    )
+{
+    assert(output);
+
+    output->push_back('q');
+    output->push_back('o');
+    output->push_back('i');
+    output->push_back('f');
+    put_u32_be(static_cast<uint32_t>(pixels.width_), output);
+    put_u32_be(static_cast<uint32_t>(pixels.height_), output);
+    output->push_back(4);   // channels
+    output->push_back(0);   // sRGB with linear alpha
+
+    uint32_t index[64];
+    std::memset(index, 0, sizeof(index));
+    uint32_t prev = 0xFF000000;
+    int run = 0;
+
+    for (int y = 0; y < pixels.height_; ++y) {
+        const uint32_t* row = pixels.row(y);
+        for (int x = 0; x < pixels.width_; ++x) {
+            const uint32_t pixel = unpremultiply(row[x]);
+
+            if (pixel == prev) {
+                if (++run == C_QoiMaxRun) {
+                    output->push_back(static_cast<uint8_t>(C_QoiOpRun | (run - 1)));
+                    run = 0;
+                }
+                continue;
+            }
+
+            if (run) {
+                output->push_back(static_cast<uint8_t>(C_QoiOpRun | (run - 1)));
+                run = 0;
+            }
+
+            const uint32_t hash = qoi_hash(pixel);
+            if (index[hash] == pixel) {
+                output->push_back(static_cast<uint8_t>(C_QoiOpIndex | hash));
+                prev = pixel;
+                continue;
+            }
+            index[hash] = pixel;
+
+            if ((pixel >> 24) == (prev >> 24)) {
+                const int8_t vr = static_cast<int8_t>((pixel & 0xFF) - (prev & 0xFF));
+                const int8_t vg = static_cast<int8_t>(((pixel >> 8) & 0xFF) - ((prev >> 8) & 0xFF));
+                const int8_t vb = static_cast<int8_t>(((pixel >> 16) & 0xFF) - ((prev >> 16) & 0xFF));
+                const int vg_r = vr - vg;
+                const int vg_b = vb - vg;
+
+                if (vr >= -2 && vr <= 1 && vg >= -2 && vg <= 1 && vb >= -2 && vb <= 1) {
+                    output->push_back(static_cast<uint8_t>(
+                        C_QoiOpDiff | ((vr + 2) << 4) | ((vg + 2) << 2) | (vb + 2)));
+                } else if (vg >= -32 && vg <= 31 && vg_r >= -8 && vg_r <= 7 &&
+                           vg_b >= -8 && vg_b <= 7) {
+                    output->push_back(static_cast<uint8_t>(C_QoiOpLuma | (vg + 32)));
+                    output->push_back(static_cast<uint8_t>(((vg_r + 8) << 4) | (vg_b + 8)));
+                } else {
+                    output->push_back(C_QoiOpRgb);
+                    output->push_back(static_cast<uint8_t>(pixel));
+                    output->push_back(static_cast<uint8_t>(pixel >> 8));
+                    output->push_back(static_cast<uint8_t>(pixel >> 16));
+                }
+            } else {
+                output->push_back(C_QoiOpRgba);
+                output->push_back(static_cast<uint8_t>(pixel));
+                output->push_back(static_cast<uint8_t>(pixel >> 8));
+                output->push_back(static_cast<uint8_t>(pixel >> 16));
+                output->push_back(static_cast<uint8_t>(pixel >> 24));
+            }
+
+            prev = pixel;
+        }
+    }
+
+    if (run)
+        output->push_back(static_cast<uint8_t>(C_QoiOpRun | (run - 1)));
+
+    //
+    // End marker.
+    for (int i = 0; i < 7; ++i)
+        output->push_back(0);
+    output->push_back(1);
+}
+
+void
+gfx::encode_image(
+    image_format format,
+    const pixel_surface& pixels,
+    std::vector<uint8_t>* output
+    )
+{
+    output->clear();
+
+    switch (format) {
+    case image_format_ppm :
+        encode_ppm(pixels, output);
+        break;
+
+    case image_format_qoi :
+        encode_qoi(pixels, output);
+        break;
+
+    default :
+        assert(false && "unknown image format");
+        break;
+    }
+}
+
+const char*
+gfx::image_format_extension(
+    image_format format
+    )
+{
+    return format == image_format_qoi ? "qoi" : "ppm";
+}
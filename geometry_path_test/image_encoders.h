@@ -0,0 +1,62 @@
+/*
+ * image_encoders.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_IMAGE_ENCODERS_H_
+#define GFX_IMAGE_ENCODERS_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "software_render_target.h"
+
+namespace gfx {
+
+enum image_format {
+    image_format_ppm,
+    image_format_qoi
+};
+
+/*
+ * Binary PPM (P6). PPM has no alpha, pixels are written as they are
+ * (premultiplied colours composited over black).
+ */
+void
+encode_ppm(
+    const pixel_surface& pixels,
+    std::vector<uint8_t>* output
+    );
+
+/*
+ * QOI ("Quite OK Image" format, qoiformat.org), RGBA, straight alpha.
+ * Lossless and much faster to encode than PNG, good enough for golden
+ * images and for piping frames into a video encoder.
+ */
+void
+encode_qoi(
+    const pixel_surface& pixels,
+    std::vector<uint8_t>* output
+    );
+
+/*
+ * Encodes in the requested format. output is cleared first but keeps its
+ * capacity, so reusing the same vector avoids allocating per frame.
+ */
+void
+encode_image(
+    image_format format,
+    const pixel_surface& pixels,
+    std::vector<uint8_t>* output
+    );
+
+const char*
+image_format_extension(
+    image_format format
+    );
+
+} // ns gfx
+
+#endif /* GFX_IMAGE_ENCODERS_H_ */
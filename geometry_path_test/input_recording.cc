@@ -0,0 +1,166 @@
+/*
+ * input_recording.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "input_recording.h"
+
+#include <cstring>
+
+namespace {
+
+//
+// "GXIR", the format version, three reserved bytes.
+const uint8_t C_Header[] = { 'G', 'X', 'I', 'R', 1, 0, 0, 0 };
+const size_t C_HeaderSize = sizeof(C_Header);
+
+//
+// At most 64 bits, 7 per byte.
+const int C_MaxVarintBytes = 10;
+
+void
+append_varint(
+    uint64_t value,
+    std::vector<uint8_t>* data
+    )
+{
+    while (value >= 0x80) {
+        data->push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    data->push_back(static_cast<uint8_t>(value));
+}
+
+} // anonymous namespace
+
+gfx::input_recorder::input_recorder() {
+    clear();
+}
+
+void
+gfx::input_recorder::clear() {
+    data_.assign(C_Header, C_Header + C_HeaderSize);
+    last_time_ns_ = 0;
+    events_ = 0;
+    frames_ = 0;
+}
+
+void
+gfx::input_recorder::append(
+    input_event_type type,
+    uint64_t time_ns,
+    uint32_t key
+    )
+{
+    assert(type != input_event_frame || time_ns >= last_time_ns_);
+    time_ns = std::max(time_ns, last_time_ns_);
+
+    data_.push_back(static_cast<uint8_t>(type));
+    append_varint(time_ns - last_time_ns_, &data_);
+    if (type != input_event_frame)
+        append_varint(key, &data_);
+
+    last_time_ns_ = time_ns;
+    ++events_;
+    frames_ += type == input_event_frame;
+}
+
+bool
+gfx::input_recorder::save(
+    const std::string& path
+    ) const
+{
+    FILE* fp = std::fopen(path.c_str(), "wb");
+    if (!fp)
+        return false;
+
+    const bool written = std::fwrite(&data_[0], 1, data_.size(), fp) == data_.size();
+    return (std::fclose(fp) == 0) && written;
+}
+
+bool
+gfx::input_playback::load(
+    const std::string& path
+    )
+{
+    data_.clear();
+    rewind();
+
+    FILE* fp = std::fopen(path.c_str(), "rb");
+    if (!fp)
+        return false;
+
+    std::vector<uint8_t> data;
+    uint8_t buffer[4096];
+    size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), fp)) > 0)
+        data.insert(data.end(), buffer, buffer + read);
+
+    const bool read_all = !std::ferror(fp);
+    std::fclose(fp);
+    return read_all && assign(data.empty() ? nullptr : &data[0], data.size());
+}
+
+bool
+gfx::input_playback::assign(
+    const uint8_t* data,
+    size_t size
+    )
+{
+    data_.clear();
+    rewind();
+    if (size < C_HeaderSize || std::memcmp(data, C_Header, C_HeaderSize))
+        return false;
+
+    data_.assign(data, data + size);
+    return true;
+}
+
+void
+gfx::input_playback::rewind() {
+    position_ = C_HeaderSize;
+    time_ns_ = 0;
+    failed_ = false;
+}
+
+bool
+gfx::input_playback::read_varint(
+    uint64_t* value
+    )
+{
+    *value = 0;
+    for (int i = 0; i < C_MaxVarintBytes && position_ < data_.size(); ++i) {
+        const uint8_t byte = data_[position_++];
+        *value |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+        if (!(byte & 0x80))
+            return true;
+    }
+
+    return false;
+}
+
+bool
+gfx::input_playback::next(
+    input_event* event
+    )
+{
+    if (failed_ || position_ >= data_.size())
+        return false;
+
+    const uint8_t type = data_[position_++];
+    uint64_t delta_ns;
+    uint64_t key = 0;
+    if (type > input_event_key_up || !read_varint(&delta_ns) ||
+        (type != input_event_frame && !read_varint(&key))) {
+        failed_ = true;
+        return false;
+    }
+
+    time_ns_ += delta_ns;
+    event->type_ = static_cast<input_event_type>(type);
+    event->time_ns_ = time_ns_;
+    event->key_ = static_cast<uint32_t>(key);
+    return true;
+}
@@ -0,0 +1,130 @@
+/*
+ * input_recording.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_INPUT_RECORDING_H_
+#define GFX_INPUT_RECORDING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gfx {
+
+enum input_event_type {
+    //
+    // A frame starts : the scene is updated and drawn.
+    input_event_frame,
+    input_event_key_down,
+    input_event_key_up
+};
+
+struct input_event {
+    input_event_type    type_;
+    //
+    // Nanoseconds since the start of the recording.
+    uint64_t            time_ns_;
+    //
+    // Key code, for key events. Recordings store whatever the application
+    // passes in : portable codes replay on any platform.
+    uint32_t            key_;
+};
+
+/*
+ * Records timestamped key events and frame boundaries in a compact binary
+ * form : an 8 byte header, then per event a type byte and the time since
+ * the previous event as a variable length integer (plus the key code, the
+ * same way, for key events). A frame at 60 Hz takes 5 bytes.
+ */
+class input_recorder {
+public :
+    input_recorder();
+
+    /*
+     * Frame times must not go back; a key event stamped before the
+     * previous event (e.g. read from another clock) is moved up to it.
+     */
+    void key_down(uint64_t time_ns, uint32_t key) {
+        append(input_event_key_down, time_ns, key);
+    }
+
+    void key_up(uint64_t time_ns, uint32_t key) {
+        append(input_event_key_up, time_ns, key);
+    }
+
+    void frame(uint64_t time_ns) {
+        append(input_event_frame, time_ns, 0);
+    }
+
+    const std::vector<uint8_t>& data() const {
+        return data_;
+    }
+
+    size_t event_count() const {
+        return events_;
+    }
+
+    size_t frame_count() const {
+        return frames_;
+    }
+
+    bool save(const std::string& path) const;
+
+    void clear();
+
+private :
+    void append(input_event_type type, uint64_t time_ns, uint32_t key);
+
+    std::vector<uint8_t>    data_;
+    uint64_t                last_time_ns_;
+    size_t                  events_;
+    size_t                  frames_;
+};
+
+/*
+ * Reads back what input_recorder wrote, one event at a time.
+ */
+class input_playback {
+public :
+    input_playback() : position_(0), time_ns_(0), failed_(false) {}
+
+    /*
+     * Returns false (and leaves the playback empty) when the file cannot
+     * be read or is not a recording.
+     */
+    bool load(const std::string& path);
+
+    bool assign(const uint8_t* data, size_t size);
+
+    /*
+     * The next event, false at the end of the recording or on a truncated
+     * or unknown event (failed() tells which).
+     */
+    bool next(input_event* event);
+
+    void rewind();
+
+    bool failed() const {
+        return failed_;
+    }
+
+    size_t size() const {
+        return data_.size();
+    }
+
+private :
+    bool read_varint(uint64_t* value);
+
+    std::vector<uint8_t>    data_;
+    size_t                  position_;
+    uint64_t                time_ns_;
+    bool                    failed_;
+};
+
+} // ns gfx
+
+#endif /* GFX_INPUT_RECORDING_H_ */
@@ -0,0 +1,186 @@
+/*
+ * intrusive_ptr.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_INTRUSIVE_PTR_H_
+#define GFX_INTRUSIVE_PTR_H_
+
+#include <cassert>
+#include <cstddef>
+
+namespace gfx {
+
+/*
+ * Smart pointer for objects carrying their own reference count, with the
+ * COM calls : AddRef() and Release() (which destroys the object at zero).
+ * Direct2D interfaces work as they are.
+ *
+ * Unlike std::shared_ptr with a deleter there is no control block to
+ * allocate and no second count : a copy is one AddRef, a move is a pointer
+ * copy.
+ *
+ * Constructing from (or resetting to) a raw pointer adopts the reference
+ * the pointer holds, as returned by the Create... calls; use
+ * intrusive_ptr<T>::share() to take an additional one.
+ */
+template<typename T>
+class intrusive_ptr {
+public :
+    typedef T element_type;
+
+    intrusive_ptr() : ptr_(nullptr) {}
+
+    intrusive_ptr(std::nullptr_t) : ptr_(nullptr) {}
+
+    explicit intrusive_ptr(T* ptr) : ptr_(ptr) {}
+
+    intrusive_ptr(const intrusive_ptr& rhs) : ptr_(rhs.ptr_) {
+        if (ptr_)
+            ptr_->AddRef();
+    }
+
+    template<typename U>
+    intrusive_ptr(const intrusive_ptr<U>& rhs) : ptr_(rhs.get()) {
+        if (ptr_)
+            ptr_->AddRef();
+    }
+
+    //
+    // The moves are noexcept, so containers move handles when they grow
+    // instead of copying them.
+    intrusive_ptr(intrusive_ptr&& rhs) noexcept : ptr_(rhs.ptr_) {
+        rhs.ptr_ = nullptr;
+    }
+
+    template<typename U>
+    intrusive_ptr(intrusive_ptr<U>&& rhs) noexcept : ptr_(rhs.detach()) {}
+
+    ~intrusive_ptr() {
+        if (ptr_)
+            ptr_->Release();
+    }
+
+    /*
+     * Takes a new reference to ptr, for pointers owned elsewhere.
+     */
+    static intrusive_ptr share(T* ptr) {
+        if (ptr)
+            ptr->AddRef();
+        return intrusive_ptr(ptr);
+    }
+
+    intrusive_ptr& operator=(const intrusive_ptr& rhs) {
+        //
+        // AddRef first, in case rhs only lives through this pointer.
+        if (rhs.ptr_)
+            rhs.ptr_->AddRef();
+        reset(rhs.ptr_);
+        return *this;
+    }
+
+    intrusive_ptr& operator=(intrusive_ptr&& rhs) noexcept {
+        if (this != &rhs)
+            reset(rhs.detach());
+        return *this;
+    }
+
+    intrusive_ptr& operator=(std::nullptr_t) {
+        reset();
+        return *this;
+    }
+
+    /*
+     * Releases the current object, adopts ptr.
+     */
+    void reset(T* ptr = nullptr) {
+        T* old = ptr_;
+        ptr_ = ptr;
+        if (old)
+            old->Release();
+    }
+
+    /*
+     * Gives up the reference without releasing it.
+     */
+    T* detach() noexcept {
+        T* ptr = ptr_;
+        ptr_ = nullptr;
+        return ptr;
+    }
+
+    /*
+     * For COM out parameters : releases the current object and returns
+     * the address of the pointer, the call stores an adopted reference.
+     */
+    T** reset_and_get_address() {
+        reset();
+        return &ptr_;
+    }
+
+    void swap(intrusive_ptr& rhs) noexcept {
+        T* ptr = ptr_;
+        ptr_ = rhs.ptr_;
+        rhs.ptr_ = ptr;
+    }
+
+    T* get() const {
+        return ptr_;
+    }
+
+    T* operator->() const {
+        assert(ptr_);
+        return ptr_;
+    }
+
+    T& operator*() const {
+        assert(ptr_);
+        return *ptr_;
+    }
+
+    explicit operator bool() const {
+        return ptr_ != nullptr;
+    }
+
+private :
+    T*  ptr_;
+};
+
+template<typename T, typename U>
+inline
+bool
+operator==(
+    const intrusive_ptr<T>& lhs,
+    const intrusive_ptr<U>& rhs
+    )
+{
+    return lhs.get() == rhs.get();
+}
+
+template<typename T, typename U>
+inline
+bool
+operator!=(
+    const intrusive_ptr<T>& lhs,
+    const intrusive_ptr<U>& rhs
+    )
+{
+    return lhs.get() != rhs.get();
+}
+
+template<typename T>
+inline
+void
+swap(
+    intrusive_ptr<T>& lhs,
+    intrusive_ptr<T>& rhs
+    )
+{
+    lhs.swap(rhs);
+}
+
+} // ns gfx
+
+#endif /* GFX_INTRUSIVE_PTR_H_ */
@@ -0,0 +1,147 @@
+/*
+ * latency_tracker.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "latency_tracker.h"
+
+namespace {
+
+//
+// Nearest rank.
+double
+percentile(
+    const std::vector<uint64_t>& sorted,
+    double fraction
+    )
+{
+    if (sorted.empty())
+        return 0.0;
+
+    size_t rank = static_cast<size_t>(fraction * static_cast<double>(sorted.size()) + 0.999999);
+    rank = std::max<size_t>(1, std::min(rank, sorted.size()));
+    return static_cast<double>(sorted[rank - 1]);
+}
+
+} // anonymous namespace
+
+uint64_t
+gfx::latency_tracker::input_event(
+    uint64_t time_ns
+    )
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    open_input input;
+    input.sequence_ = next_sequence_++;
+    input.time_ns_ = time_ns;
+    input.frames_at_input_ = frames_started_;
+    input.frame_id_ = 0;
+    input.frame_ordinal_ = 0;
+    input.carried_ = false;
+    open_.push_back(input);
+    return input.sequence_;
+}
+
+void
+gfx::latency_tracker::frame_started(
+    uint64_t frame_id,
+    uint64_t reflected_sequence
+    )
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    ++frames_started_;
+
+    for (std::deque<open_input>::iterator it = open_.begin();
+         it != open_.end() && it->sequence_ <= reflected_sequence; ++it) {
+        if (it->carried_)
+            continue;
+
+        it->carried_ = true;
+        it->frame_id_ = frame_id;
+        it->frame_ordinal_ = frames_started_;
+    }
+}
+
+void
+gfx::latency_tracker::frame_completed(
+    uint64_t frame_id,
+    uint64_t time_ns
+    )
+{
+    std::lock_guard<std::mutex> lock(lock_);
+
+    //
+    // Carried inputs are a prefix of the open ones, in frame order.
+    while (!open_.empty() && open_.front().carried_ && open_.front().frame_id_ <= frame_id) {
+        const open_input& input = open_.front();
+        latency_sample sample;
+        sample.sequence_ = input.sequence_;
+        sample.input_ns_ = input.time_ns_;
+        sample.latency_ns_ = time_ns > input.time_ns_ ? time_ns - input.time_ns_ : 0;
+        sample.frames_ = input.frame_ordinal_ - input.frames_at_input_;
+        samples_.push_back(sample);
+        open_.pop_front();
+    }
+}
+
+gfx::latency_summary
+gfx::latency_tracker::summary() const {
+    std::lock_guard<std::mutex> lock(lock_);
+    latency_summary summary;
+    summary.count_ = samples_.size();
+    summary.open_ = open_.size();
+    if (samples_.empty())
+        return summary;
+
+    std::vector<uint64_t> latencies(samples_.size());
+    double total_ns = 0.0;
+    double total_frames = 0.0;
+    for (size_t i = 0; i < samples_.size(); ++i) {
+        latencies[i] = samples_[i].latency_ns_;
+        total_ns += static_cast<double>(samples_[i].latency_ns_);
+        total_frames += static_cast<double>(samples_[i].frames_);
+        summary.max_frames_ = std::max(summary.max_frames_, samples_[i].frames_);
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    summary.mean_ns_ = total_ns / static_cast<double>(samples_.size());
+    summary.mean_frames_ = total_frames / static_cast<double>(samples_.size());
+    summary.p50_ns_ = percentile(latencies, 0.50);
+    summary.p90_ns_ = percentile(latencies, 0.90);
+    summary.p99_ns_ = percentile(latencies, 0.99);
+    summary.max_ns_ = static_cast<double>(latencies.back());
+    return summary;
+}
+
+bool
+gfx::latency_tracker::export_csv(
+    const std::string& path
+    ) const
+{
+    FILE* fp = std::fopen(path.c_str(), "w");
+    if (!fp)
+        return false;
+
+    std::lock_guard<std::mutex> lock(lock_);
+    bool written = std::fprintf(fp, "sequence,input_ns,latency_ns,frames\n") > 0;
+    for (size_t i = 0; written && i < samples_.size(); ++i) {
+        const latency_sample& sample = samples_[i];
+        written = std::fprintf(fp, "%llu,%llu,%llu,%llu\n",
+                               static_cast<unsigned long long>(sample.sequence_),
+                               static_cast<unsigned long long>(sample.input_ns_),
+                               static_cast<unsigned long long>(sample.latency_ns_),
+                               static_cast<unsigned long long>(sample.frames_)) > 0;
+    }
+
+    return (std::fclose(fp) == 0) && written;
+}
+
+void
+gfx::latency_tracker::reset() {
+    std::lock_guard<std::mutex> lock(lock_);
+    open_.clear();
+    samples_.clear();
+    frames_started_ = 0;
+}
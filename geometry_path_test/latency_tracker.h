@@ -0,0 +1,112 @@
+/*
+ * latency_tracker.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_LATENCY_TRACKER_H_
+#define GFX_LATENCY_TRACKER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gfx {
+
+struct latency_summary {
+    //
+    // Inputs that made it to the screen, and those still on their way.
+    uint64_t    count_;
+    uint64_t    open_;
+    double      mean_ns_;
+    double      p50_ns_;
+    double      p90_ns_;
+    double      p99_ns_;
+    double      max_ns_;
+    //
+    // Frames started from the input to the one that showed it, that one
+    // included.
+    double      mean_frames_;
+    uint64_t    max_frames_;
+
+    latency_summary()
+        : count_(0), open_(0), mean_ns_(0.0), p50_ns_(0.0), p90_ns_(0.0), p99_ns_(0.0),
+          max_ns_(0.0), mean_frames_(0.0), max_frames_(0) {}
+};
+
+/*
+ * Input to photon latency. Every input event gets a sequence id; the
+ * simulation passes along the highest id its state reflects, the frame
+ * drawn from that state carries the inputs up to it, and they are closed
+ * when the frame is on screen (end_draw() returned, or the frame was
+ * presented).
+ *
+ * Frame completions may come from another thread (a presenter). A frame
+ * completing closes the inputs of earlier frames too : those were dropped,
+ * and the newer frame shows their effect.
+ */
+class latency_tracker {
+public :
+    latency_tracker() : next_sequence_(1), frames_started_(0) {}
+
+    /*
+     * Opens an input received at time_ns (any monotonic clock, the same
+     * for every call), returns its sequence id. Ids start at 1 : 0 stands
+     * for no input.
+     */
+    uint64_t input_event(uint64_t time_ns);
+
+    /*
+     * A frame is drawn from a state reflecting the inputs up to
+     * reflected_sequence. Frame ids must increase.
+     */
+    void frame_started(uint64_t frame_id, uint64_t reflected_sequence);
+
+    void frame_completed(uint64_t frame_id, uint64_t time_ns);
+
+    latency_summary summary() const;
+
+    /*
+     * One line per closed input : sequence id, input time, latency (ns)
+     * and frames.
+     */
+    bool export_csv(const std::string& path) const;
+
+    void reset();
+
+private :
+    struct open_input {
+        uint64_t    sequence_;
+        uint64_t    time_ns_;
+        //
+        // frames_started_ when the input came, and once carried, the
+        // frame showing it.
+        uint64_t    frames_at_input_;
+        uint64_t    frame_id_;
+        uint64_t    frame_ordinal_;
+        bool        carried_;
+    };
+
+    struct latency_sample {
+        uint64_t    sequence_;
+        uint64_t    input_ns_;
+        uint64_t    latency_ns_;
+        uint64_t    frames_;
+    };
+
+    mutable std::mutex          lock_;
+    //
+    // By sequence id.
+    std::deque<open_input>      open_;
+    std::vector<latency_sample> samples_;
+    uint64_t                    next_sequence_;
+    uint64_t                    frames_started_;
+};
+
+} // ns gfx
+
+#endif /* GFX_LATENCY_TRACKER_H_ */
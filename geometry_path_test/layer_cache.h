@@ -0,0 +1,102 @@
+/*
+ * layer_cache.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_LAYER_CACHE_H_
+#define GFX_LAYER_CACHE_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "render_target.h"
+
+namespace gfx {
+
+struct layer_cache_statistics {
+    //
+    // Times the content was drawn into the layer.
+    uint64_t    renders_;
+    //
+    // Times the layer was composited without redrawing the content.
+    uint64_t    reuses_;
+
+    layer_cache_statistics() : renders_(0), reuses_(0) {}
+};
+
+/*
+ * Keeps content that rarely changes (backgrounds, grids) in an offscreen
+ * layer, so drawing it is a single composite instead of all the original
+ * fills.
+ *
+ * The owner describes everything the content depends on with a key, the
+ * content is redrawn only when the key or the target size changes, or
+ * after invalidate(). The layer is a device resource : call invalidate()
+ * (or drop the cache) when the render target is recreated.
+ */
+class cached_layer {
+public :
+    cached_layer() : key_(0), width_(0), height_(0), valid_(false) {}
+
+    void invalidate() {
+        valid_ = false;
+        layer_.reset();
+    }
+
+    /*
+     * Composites the cached content into target, first redrawing it with
+     * draw_content(render_target*) if it is out of date. Must be called
+     * between target->begin_draw() and target->end_draw().
+     */
+    template<typename DrawContent>
+    void draw(render_target* target, uint64_t key, DrawContent draw_content) {
+        assert(target);
+
+        const int width = target->width();
+        const int height = target->height();
+
+        if (!valid_ || key != key_ || width != width_ || height != height_) {
+            if (!layer_ || width != width_ || height != height_) {
+                layer_ = target->create_layer(width, height);
+                width_ = width;
+                height_ = height;
+            }
+
+            if (!layer_)
+                return;
+
+            render_target* layer_target = layer_->target();
+            layer_target->begin_draw();
+            layer_target->set_transform(matrix3X3::identity);
+            draw_content(layer_target);
+            valid_ = layer_target->end_draw() == end_draw_ok;
+            key_ = key;
+            ++stats_.renders_;
+
+            if (!valid_)
+                return;
+        } else {
+            ++stats_.reuses_;
+        }
+
+        target->draw_layer(layer_.get());
+    }
+
+    const layer_cache_statistics& statistics() const {
+        return stats_;
+    }
+
+private :
+    std::shared_ptr<bitmap_layer>   layer_;
+    uint64_t                        key_;
+    int                             width_;
+    int                             height_;
+    bool                            valid_;
+    layer_cache_statistics          stats_;
+};
+
+} // ns gfx
+
+#endif /* GFX_LAYER_CACHE_H_ */
@@ -1,71 +1,7 @@
 #include "pch_hdr.h"
-#include "vector2.h"
-
-template<typename D2D1Interface>
-struct D2D1_Obj_Deleter {
-    void operator()(D2D1Interface* iptr) {
-        if (iptr)
-            iptr->Release();
-    }
-};
-
-class Fighter_Mig21 {
-public :
-    Fighter_Mig21(ID2D1PathGeometry* geometry, ID2D1SolidColorBrush* brush) 
-        : geometry_(geometry, D2D1_Obj_Deleter<ID2D1Geometry>()),
-          fbrush_(brush, D2D1_Obj_Deleter<ID2D1SolidColorBrush>()) {}
-
-   ID2D1PathGeometry* GetGeometry() const {
-       return geometry_.get();
-   }
-
-   ID2D1SolidColorBrush* GetBrush() const {
-       return fbrush_.get();
-   }
-   
-   void BuildFighterGeometry() {
-        ID2D1GeometrySink* gsink;
-        HRESULT ret_code = geometry_->Open(&gsink);
-        if (FAILED(ret_code))
-            return;
-
-        std::shared_ptr<ID2D1GeometrySink> skptr(
-            gsink, D2D1_Obj_Deleter<ID2D1GeometrySink>());
-        skptr->BeginFigure(D2D1::Point2F(-5.0f, 0.0f), D2D1_FIGURE_BEGIN_FILLED);
-        skptr->AddLine(D2D1::Point2F(-5.0f, 1.0f));
-        skptr->AddBezier(
-            D2D1::BezierSegment(D2D1::Point2F(-4.5f, 2.0f), 
-                                D2D1::Point2F(-3.5f, 3.5f), 
-                                D2D1::Point2F(-1.0f, 5.0f)));
-        skptr->AddArc(D2D1::ArcSegment(
-            D2D1::Point2F(1.0f, 5.0f), D2D1::SizeF(1.0f, 4.0f), 0.0f, 
-            D2D1_SWEEP_DIRECTION_COUNTER_CLOCKWISE, D2D1_ARC_SIZE_LARGE));
-
-        skptr->AddBezier(
-            D2D1::BezierSegment(D2D1::Point2F(2.0f, 4.5f), 
-            D2D1::Point2F(3.5f, 3.5f), 
-            D2D1::Point2F(5.0f, 1.0f)));
-
-        skptr->AddLine(D2D1::Point2F(5.0f, 0.0f));
-        skptr->AddLine(D2D1::Point2F(0.50f, -1.0f));
-
-        skptr->AddBezier(
-            D2D1::BezierSegment(D2D1::Point2F(0.5f, -1.0f), 
-                                D2D1::Point2F(0.0f, -4.0f), 
-                                D2D1::Point2F(-0.5f, -1.0f)));
-
-        skptr->AddLine(D2D1::Point2F(-5.0f, 0.0f));
-        skptr->EndFigure(D2D1_FIGURE_END_CLOSED);
-        skptr->Close();
-    }
-
-   void SetBrush(ID2D1SolidColorBrush* brsh) {
-       fbrush_.reset(brsh);
-   }
-private :
-    std::shared_ptr<ID2D1PathGeometry>      geometry_;
-    std::shared_ptr<ID2D1SolidColorBrush>   fbrush_;
-};
+#include "d2d_render_target.h"
+#include "demo_scenes.h"
+#include "trace.h"
 
 class W32Window {
 public :
@@ -109,6 +45,7 @@ public :
                 if (msg_data.message == WM_QUIT)
                     break;
 
+                GFX_TRACE_ZONE("message");
                 ::TranslateMessage(&msg_data);
                 ::DispatchMessageW(&msg_data);
             }
@@ -118,28 +55,23 @@ public :
     }
 
     void DrawFrame() {
-        rtarget_->BeginDraw();
-        rtarget_->Clear(D2D1::ColorF(D2D1::ColorF::White));
-        rtarget_->SetTransform(D2D1::Matrix3x2F::Identity());
-        rtarget_->FillRectangle(D2D1::RectF(0.0f, 0.0f, width_, height_), brushes_[Brush_DeepSkyBlue].get());
-        rtarget_->DrawLine(
-            D2D1::Point2F(width_ / 2, 0.0f),
-            D2D1::Point2F(width_ / 2, height_),
-            brushes_[Brush_Black].get(),
-            1.0f);
-        rtarget_->DrawLine(
-            D2D1::Point2F(0.0f, height_ / 2),
-            D2D1::Point2F(width_, height_ / 2),
-            brushes_[Brush_Black].get(),
-            1.0f);
-
-        rtarget_->SetTransform(
-            D2D1::Matrix3x2F::Rotation(180.0f) * 
-            D2D1::Matrix3x2F::Scale(25.0f, 25.0f) * 
-            D2D1::Matrix3x2F::Translation(world_origin_)
-            );
-        rtarget_->FillGeometry(fmig21_->GetGeometry(), fmig21_->GetBrush());
-        if (rtarget_->EndDraw() == D2DERR_RECREATE_TARGET)
+        GFX_TRACE_ZONE("frame");
+        if (!CreateDeviceDependentResources())
+            return;
+
+        {
+            GFX_TRACE_ZONE("draw");
+            target_->begin_draw();
+            scene_.Draw(target_.get());
+        }
+
+        gfx::end_draw_result result;
+        {
+            GFX_TRACE_ZONE("end draw");
+            result = target_->end_draw();
+        }
+
+        if (result == gfx::end_draw_recreate_target)
             DiscardResources();
     }
 
@@ -163,8 +95,6 @@ public :
         if (!wnd_)
             return false;
 
-        world_origin_.x_ = wnd_geometry.right / 2;
-        world_origin_.y_ = wnd_geometry.bottom / 2;
         ::ShowWindow(wnd_, SW_SHOWNORMAL);
         ::UpdateWindow(wnd_);
         //::ClipCursor(&wnd_geometry);
@@ -190,12 +120,11 @@ private :
     }
 
     bool InitializeRenderer() {
-        ID2D1Factory* factory;
-        HRESULT ret_code = ::D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, &factory);
+        HRESULT ret_code = ::D2D1CreateFactory(
+            D2D1_FACTORY_TYPE_SINGLE_THREADED, factory_.reset_and_get_address());
         if (FAILED(ret_code))
             return false;
 
-        factory_.reset(factory, D2D1_Obj_Deleter<ID2D1Factory>());
         return CreateDeviceDependentResources();
     }
 
@@ -203,8 +132,7 @@ private :
         if (rtarget_.get())
             return true;
 
-        ID2D1HwndRenderTarget* ptarget;
-        
+        GFX_TRACE_ZONE("create resources");
         D2D1_RENDER_TARGET_PROPERTIES rtarget_props;
         rtarget_props.type = D2D1_RENDER_TARGET_TYPE_HARDWARE;
         rtarget_props.pixelFormat = ::D2D1::PixelFormat(DXGI_FORMAT_R8G8B8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED);
@@ -218,48 +146,21 @@ private :
         hwnd_rprops.presentOptions = D2D1_PRESENT_OPTIONS_NONE;
 
         HRESULT ret_code = factory_->CreateHwndRenderTarget(
-            rtarget_props, hwnd_rprops, &ptarget);
+            rtarget_props, hwnd_rprops, rtarget_.reset_and_get_address());
         if (FAILED(ret_code))
             return false;
 
-        rtarget_.reset(ptarget, D2D1_Obj_Deleter<ID2D1HwndRenderTarget>());
-
-        D2D1_COLOR_F brush_colors[] = {
-            D2D1::ColorF(D2D1::ColorF::DeepSkyBlue),
-            D2D1::ColorF(D2D1::ColorF::Black),
-            D2D1::ColorF(D2D1::ColorF::Crimson)
-        };
-
-        std::transform(
-            std::begin(brush_colors), std::end(brush_colors),
-            std::back_inserter(brushes_), 
-            [ptarget](const D2D1_COLOR_F& brush_color) -> std::shared_ptr<ID2D1SolidColorBrush> {
-                ID2D1SolidColorBrush* pbrush = nullptr;
-                HRESULT ret = ptarget->CreateSolidColorBrush(brush_color, &pbrush); 
-                return std::shared_ptr<ID2D1SolidColorBrush>(pbrush, D2D1_Obj_Deleter<ID2D1SolidColorBrush>());
-        });
-
+        target_.reset(new gfx::d2d_render_target(rtarget_.get()));
         return InitializeObjects();
     }
 
     void DiscardResources() {
+        target_.reset();
         rtarget_.reset();
-        brushes_.clear();
     }
 
     bool InitializeObjects() {
-        ID2D1PathGeometry* geometry;
-        HRESULT ret_code = factory_->CreatePathGeometry(&geometry);
-        if (FAILED(ret_code))
-            return false;
-
-        ID2D1SolidColorBrush* fbrush;
-        ret_code = rtarget_->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::LawnGreen), &fbrush);
-        if (FAILED(ret_code))
-            return false;
-
-        fmig21_.reset(new Fighter_Mig21(geometry, fbrush));
-        fmig21_->BuildFighterGeometry();
+        scene_.Initialize(width_, height_);
         return true;
     }
 
@@ -282,24 +183,17 @@ private :
         return false;
     }
 
-    enum {
-        Brush_DeepSkyBlue,
-        Brush_Black,
-        Brush_Red
-    };
-
     static HINSTANCE    inst_;
     static W32Window*   instance_ptr_;
     static const wchar_t* Class_Name;
 
-    HWND        wnd_;
-    int         width_;
-    int         height_;
-    std::shared_ptr<ID2D1Factory>           factory_;
-    std::shared_ptr<ID2D1HwndRenderTarget>  rtarget_;
-    std::vector<std::shared_ptr<ID2D1SolidColorBrush>> brushes_;
-    gfx::vector2    world_origin_;
-    std::shared_ptr<Fighter_Mig21>  fmig21_;
+    HWND                                        wnd_;
+    int                                         width_;
+    int                                         height_;
+    gfx::intrusive_ptr<ID2D1Factory>            factory_;
+    gfx::intrusive_ptr<ID2D1HwndRenderTarget>   rtarget_;
+    std::shared_ptr<gfx::d2d_render_target>     target_;
+    FighterScene                                scene_;
 };
 
 const wchar_t* W32Window::Class_Name = L"D2D1_Window_Class";
@@ -318,13 +212,32 @@ bool GetScreenResolution(std::pair<DWORD, DWORD>* res) {
     return false;
 }
 
+//
+// geometry_path_test [--trace=FILE]
 int WINAPI wWinMain( 
     __in HINSTANCE hinst, 
     __in_opt HINSTANCE, 
-    __in LPWSTR, 
+    __in LPWSTR command_line, 
     __in int
     )
 {
+    const wchar_t C_TraceOption[] = L"--trace=";
+    int arg_count = 0;
+    LPWSTR* args = command_line && *command_line ?
+        ::CommandLineToArgvW(command_line, &arg_count) : nullptr;
+    for (int i = 0; i < arg_count; ++i) {
+        //
+        // Plain ASCII paths only.
+        const std::wstring arg(args[i]);
+        const std::string narrow(arg.begin(), arg.end());
+        if (!arg.compare(0, _countof(C_TraceOption) - 1, C_TraceOption))
+            gfx::trace_write_at_exit(narrow.substr(_countof(C_TraceOption) - 1));
+    }
+    if (args)
+        ::LocalFree(args);
+
+    GFX_TRACE_THREAD_NAME("ui");
+
     W32Window::Set_Instance(hinst);
 
     std::pair<DWORD, DWORD> screen_res;
@@ -123,7 +123,7 @@ public:
 
 	float determinant() const {
 		float A11 = a22_ * a33_ - a23_ * a32_;
-		float A12 = a23_ * a31_ + a21_ * a33_;
+		float A12 = a23_ * a31_ - a21_ * a33_;
 		float A13 = a21_ * a32_ - a22_ * a31_;
 
 		return a11_ * A11 + a12_ * A12 + a13_ * A13;
@@ -135,14 +135,14 @@ public:
 
 	matrix3X3 adjoint() const {
 		float A11 = a22_ * a33_ - a23_ * a32_;
-		float A12 = a23_ * a31_ + a21_ * a33_;
+		float A12 = a23_ * a31_ - a21_ * a33_;
 		float A13 = a21_ * a32_ - a22_ * a31_;
 		float A21 = a13_ * a32_ - a12_ * a33_;
 		float A22 = a11_ * a33_ - a13_ * a31_;
 		float A23 = a12_ * a31_ - a11_ * a32_;
 		float A31 = a12_ * a23_ - a13_ * a22_;
 		float A32 = a13_ * a21_ - a11_ * a23_;
-		float A33 = a11_ * a12_ - a12_ * a21_;
+		float A33 = a11_ * a22_ - a12_ * a21_;
 
 		return matrix3X3(A11, A21, A31, A12, A22, A32, A13, A23, A33);
 	}
@@ -0,0 +1,181 @@
+/*
+ * overdraw_pass.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "overdraw_pass.h"
+
+#include <cmath>
+
+#include "gradient_brush.h"
+
+namespace {
+
+//
+// Frames have a handful of big occluders, when there are more the
+// smallest ones are dropped.
+const size_t C_MaxOccluders = 8;
+
+inline
+uint64_t
+pixel_area(
+    const gfx::rectangle& rect
+    )
+{
+    if (rect.is_empty())
+        return 0;
+    return static_cast<uint64_t>(rect.width()) * static_cast<uint64_t>(rect.height());
+}
+
+//
+// The pixels fully covered by an opaque rectangle fill, or an empty
+// rectangle if the command does not occlude anything.
+gfx::rectangle
+occluded_rectangle(
+    const gfx::draw_command& cmd,
+    int width,
+    int height
+    )
+{
+    const gfx::rectangle empty(0.0f, 0.0f, 0.0f, 0.0f);
+    const gfx::rectangle target(0.0f, 0.0f, static_cast<float>(width),
+                                static_cast<float>(height));
+
+    switch (cmd.type_) {
+    case gfx::draw_command_clear :
+        return target;
+
+    case gfx::draw_command_fill_rectangle : {
+        const gfx::matrix3X3& xf = cmd.transform_;
+        if (xf.a12_ != 0.0f || xf.a21_ != 0.0f || !gfx::brush_is_opaque(cmd.brush_, xf))
+            return empty;
+
+        const gfx::vector2 p0(xf * gfx::vector2(cmd.rect_.left_, cmd.rect_.top_));
+        const gfx::vector2 p1(xf * gfx::vector2(cmd.rect_.right_, cmd.rect_.bottom_));
+        const gfx::rectangle inner(
+            std::max(std::ceil(std::min(p0.x_, p1.x_)), 0.0f),
+            std::max(std::ceil(std::min(p0.y_, p1.y_)), 0.0f),
+            std::min(std::floor(std::max(p0.x_, p1.x_)), target.right_),
+            std::min(std::floor(std::max(p0.y_, p1.y_)), target.bottom_));
+        return inner.is_empty() ? empty : inner;
+        }
+
+    default :
+        break;
+    }
+
+    return empty;
+}
+
+void
+add_occluder(
+    const gfx::rectangle& occluder,
+    std::vector<gfx::rectangle>* occluders
+    )
+{
+    if (occluders->size() < C_MaxOccluders) {
+        occluders->push_back(occluder);
+        return;
+    }
+
+    std::vector<gfx::rectangle>::iterator smallest = occluders->begin();
+    for (std::vector<gfx::rectangle>::iterator it = occluders->begin();
+         it != occluders->end(); ++it) {
+        if (pixel_area(*it) < pixel_area(*smallest))
+            smallest = it;
+    }
+
+    if (pixel_area(*smallest) < pixel_area(occluder))
+        *smallest = occluder;
+}
+
+} // anonymous namespace
+
+bool
+gfx::brush_is_opaque(
+    const brush* fill_brush,
+    const matrix3X3& transform
+    )
+{
+    if (!fill_brush)
+        return false;
+
+    switch (fill_brush->type()) {
+    case brush_type_solid_color :
+        return static_cast<const solid_color_brush*>(fill_brush)->get_color().is_opaque();
+
+    case brush_type_linear_gradient :
+    case brush_type_radial_gradient : {
+        //
+        // The software target paints nothing when brush space cannot be
+        // mapped back from device space.
+        const gradient_brush* gradient = static_cast<const gradient_brush*>(fill_brush);
+        return gradient->get_stops().is_opaque() &&
+            (transform * gradient->get_transform()).is_invertible();
+        }
+
+    default :
+        break;
+    }
+
+    return false;
+}
+
+size_t
+gfx::eliminate_overdraw(
+    int width,
+    int height,
+    std::vector<draw_command>* commands,
+    overdraw_statistics* stats
+    )
+{
+    assert(commands);
+
+    std::vector<rectangle> occluders;
+    std::vector<bool> culled(commands->size(), false);
+    size_t culled_count = 0;
+    uint64_t pixels_drawn = 0;
+    uint64_t pixels_culled = 0;
+
+    for (size_t i = commands->size(); i-- > 0; ) {
+        const draw_command& cmd = (*commands)[i];
+        const uint64_t area = pixel_area(cmd.device_bounds_);
+
+        bool hidden = cmd.device_bounds_.is_empty();
+        for (size_t j = 0; j < occluders.size() && !hidden; ++j)
+            hidden = rectangle_contains(occluders[j], cmd.device_bounds_);
+
+        if (hidden) {
+            culled[i] = true;
+            ++culled_count;
+            pixels_culled += area;
+            continue;
+        }
+
+        pixels_drawn += area;
+        const rectangle occluder(occluded_rectangle(cmd, width, height));
+        if (!occluder.is_empty())
+            add_occluder(occluder, &occluders);
+    }
+
+    if (stats) {
+        ++stats->frames_;
+        stats->commands_ += commands->size();
+        stats->commands_culled_ += culled_count;
+        stats->pixels_drawn_ += pixels_drawn;
+        stats->pixels_culled_ += pixels_culled;
+    }
+
+    if (culled_count) {
+        size_t kept = 0;
+        for (size_t i = 0; i < commands->size(); ++i) {
+            if (!culled[i])
+                (*commands)[kept++] = (*commands)[i];
+        }
+        commands->resize(kept);
+    }
+
+    return culled_count;
+}
@@ -0,0 +1,73 @@
+/*
+ * overdraw_pass.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_OVERDRAW_PASS_H_
+#define GFX_OVERDRAW_PASS_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "recording_render_target.h"
+
+namespace gfx {
+
+/*
+ * Pixel counts are areas of the conservative device bounds of the
+ * commands, an upper bound of the work done by the backend.
+ */
+struct overdraw_statistics {
+    uint64_t    frames_;
+    uint64_t    commands_;
+    uint64_t    commands_culled_;
+    uint64_t    pixels_drawn_;
+    uint64_t    pixels_culled_;
+
+    overdraw_statistics() {
+        reset();
+    }
+
+    void reset() {
+        frames_ = commands_ = commands_culled_ = pixels_drawn_ = pixels_culled_ = 0;
+    }
+};
+
+/*
+ * Removes the commands of a recorded frame whose pixels are all
+ * overwritten by later commands. The frame is walked front to back,
+ * collecting occluders :
+ *  - clears (they replace every pixel, whatever their alpha)
+ *  - rectangles filled with an opaque brush under an axis aligned
+ *    transform, shrunk to the pixels they fully cover.
+ * A command is removed if its device bounds lie inside one occluder.
+ * The tests are conservative, a command is never removed if any of its
+ * pixels could still be visible.
+ *
+ * Returns the number of commands removed and adds the frame to stats
+ * (may be null).
+ */
+size_t
+eliminate_overdraw(
+    int width,
+    int height,
+    std::vector<draw_command>* commands,
+    overdraw_statistics* stats
+    );
+
+/*
+ * True if every pixel painted with the brush, under the render transform,
+ * is opaque. A gradient whose brush space collapses under the transform
+ * paints nothing.
+ */
+bool
+brush_is_opaque(
+    const brush* fill_brush,
+    const matrix3X3& transform
+    );
+
+} // ns gfx
+
+#endif /* GFX_OVERDRAW_PASS_H_ */
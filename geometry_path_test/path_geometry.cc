@@ -0,0 +1,440 @@
+/*
+ * path_geometry.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "path_geometry.h"
+
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#include "elliptic_arc.h"
+
+namespace {
+
+std::atomic<uint32_t> revision_counter(0);
+
+uint32_t
+next_revision() {
+    return ++revision_counter;
+}
+
+//
+// Number of line segments needed to keep a uniformly subdivided curve
+// within tolerance. max_second_difference is the largest norm of the
+// second differences of the control points, the factor is d(d - 1) / 8
+// for a curve of degree d (Wang's formula).
+inline
+int
+curve_segment_count(
+    float max_second_difference,
+    float degree_factor,
+    float tolerance
+    )
+{
+    const float n = std::sqrt(degree_factor * max_second_difference / tolerance);
+    return std::max(1, std::min(static_cast<int>(std::ceil(n)), 1024));
+}
+
+void
+flatten_cubic(
+    const gfx::vector2& p0,
+    const gfx::vector2& p1,
+    const gfx::vector2& p2,
+    const gfx::vector2& p3,
+    const gfx::matrix3X3& xform,
+    float tolerance,
+    std::vector<gfx::vector2>* points
+    )
+{
+    const float dd = std::max(
+        (p0 - 2.0f * p1 + p2).magnitude(), (p1 - 2.0f * p2 + p3).magnitude());
+    const int segments = curve_segment_count(dd, 0.75f, tolerance);
+    const float dt = 1.0f / static_cast<float>(segments);
+
+    for (int i = 1; i < segments; ++i) {
+        const float t = static_cast<float>(i) * dt;
+        const float mt = 1.0f - t;
+        const gfx::vector2 pt =
+            (mt * mt * mt) * p0 + (3.0f * mt * mt * t) * p1 +
+            (3.0f * mt * t * t) * p2 + (t * t * t) * p3;
+        points->push_back(xform * pt);
+    }
+    points->push_back(xform * p3);
+}
+
+void
+flatten_quadratic(
+    const gfx::vector2& p0,
+    const gfx::vector2& p1,
+    const gfx::vector2& p2,
+    const gfx::matrix3X3& xform,
+    float tolerance,
+    std::vector<gfx::vector2>* points
+    )
+{
+    const float dd = (p0 - 2.0f * p1 + p2).magnitude();
+    const int segments = curve_segment_count(dd, 0.25f, tolerance);
+    const float dt = 1.0f / static_cast<float>(segments);
+
+    for (int i = 1; i < segments; ++i) {
+        const float t = static_cast<float>(i) * dt;
+        const float mt = 1.0f - t;
+        const gfx::vector2 pt = (mt * mt) * p0 + (2.0f * mt * t) * p1 + (t * t) * p2;
+        points->push_back(xform * pt);
+    }
+    points->push_back(xform * p2);
+}
+
+//
+// Samples the centre parameterization of the arc.
+void
+flatten_arc(
+    const gfx::vector2& start,
+    const gfx::arc_segment& arc,
+    const gfx::matrix3X3& xform,
+    float tolerance,
+    std::vector<gfx::vector2>* points
+    )
+{
+    gfx::arc_centre_form centre;
+    if (!gfx::arc_to_centre_form(start, arc, &centre)) {
+        points->push_back(xform * arc.point_);
+        return;
+    }
+
+    //
+    // Angle step for which the chord stays within tolerance of the circle
+    // of the larger radius.
+    const float r = std::max(centre.rx_, centre.ry_);
+    const float ratio = std::min(tolerance / r, 1.0f);
+    const float max_step = std::max(2.0f * std::acos(1.0f - ratio), 0.001f);
+    const int segments = std::max(1, std::min(
+        static_cast<int>(std::ceil(std::fabs(centre.sweep_angle_) / max_step)), 1024));
+    const float step = centre.sweep_angle_ / static_cast<float>(segments);
+
+    for (int i = 1; i < segments; ++i) {
+        const float angle = centre.start_angle_ + step * static_cast<float>(i);
+        points->push_back(xform * centre.point_at(angle));
+    }
+    points->push_back(xform * arc.point_);
+}
+
+inline
+uint32_t
+float_bits(
+    float value
+    )
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+//
+// FNV-1a step.
+inline
+uint64_t
+hash_word(
+    uint64_t h,
+    uint32_t word
+    )
+{
+    return (h ^ word) * 1099511628211ULL;
+}
+
+} // anonymous namespace
+
+float
+gfx::transform_scale_factor(
+    const matrix3X3& xform
+    )
+{
+    //
+    // Largest singular value of the linear part.
+    const float a = xform.a11_;
+    const float b = xform.a12_;
+    const float c = xform.a21_;
+    const float d = xform.a22_;
+    const float s = a * a + b * b + c * c + d * d;
+    const float det = a * d - b * c;
+    const float disc = std::sqrt(std::max(0.0f, s * s - 4.0f * det * det));
+    return std::sqrt((s + disc) * 0.5f);
+}
+
+float
+gfx::transform_min_scale_factor(
+    const matrix3X3& xform
+    )
+{
+    //
+    // The product of the singular values is the determinant.
+    const float largest = transform_scale_factor(xform);
+    if (!(largest > 0.0f))
+        return 0.0f;
+    return std::fabs(xform.a11_ * xform.a22_ - xform.a12_ * xform.a21_) / largest;
+}
+
+gfx::rectangle
+gfx::flattened_path::bounds() const {
+    rectangle bbox(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (size_t i = 0; i < points_.size(); ++i)
+        bbox.add_point(points_[i]);
+    return bbox;
+}
+
+gfx::path_geometry::path_geometry()
+    : sink_(this), fill_mode_(fill_mode_alternate), revision_(next_revision()) {}
+
+gfx::path_sink*
+gfx::path_geometry::open() {
+    segments_.clear();
+    revision_ = next_revision();
+    return &sink_;
+}
+
+uint64_t
+gfx::path_geometry::content_hash() const {
+    uint64_t h = hash_word(14695981039346656037ULL, static_cast<uint32_t>(fill_mode_));
+
+    for (size_t i = 0; i < segments_.size(); ++i) {
+        const path_segment& seg = segments_[i];
+        h = hash_word(h, static_cast<uint32_t>(seg.type_));
+        for (int p = 0; p < 3; ++p) {
+            h = hash_word(h, float_bits(seg.points_[p].x_));
+            h = hash_word(h, float_bits(seg.points_[p].y_));
+        }
+        h = hash_word(h, float_bits(seg.rotation_angle_));
+        h = hash_word(h, static_cast<uint32_t>(seg.flags_));
+    }
+
+    return h;
+}
+
+bool
+gfx::path_geometry::same_content(
+    const path_geometry& other
+    ) const
+{
+    if (fill_mode_ != other.fill_mode_ || segments_.size() != other.segments_.size())
+        return false;
+
+    for (size_t i = 0; i < segments_.size(); ++i) {
+        const path_segment& lhs = segments_[i];
+        const path_segment& rhs = other.segments_[i];
+        if (lhs.type_ != rhs.type_ || lhs.flags_ != rhs.flags_ ||
+            float_bits(lhs.rotation_angle_) != float_bits(rhs.rotation_angle_))
+            return false;
+
+        for (int p = 0; p < 3; ++p) {
+            if (float_bits(lhs.points_[p].x_) != float_bits(rhs.points_[p].x_) ||
+                float_bits(lhs.points_[p].y_) != float_bits(rhs.points_[p].y_))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void
+gfx::path_geometry::stream(
+    path_sink* sink
+    ) const
+{
+    assert(sink);
+
+    for (size_t i = 0; i < segments_.size(); ++i) {
+        const path_segment& seg = segments_[i];
+        switch (seg.type_) {
+        case segment_begin_figure :
+            sink->begin_figure(seg.points_[0], static_cast<figure_begin>(seg.flags_));
+            break;
+
+        case segment_line :
+            sink->add_line(seg.points_[0]);
+            break;
+
+        case segment_bezier :
+            sink->add_bezier(bezier_segment(
+                seg.points_[0], seg.points_[1], seg.points_[2]));
+            break;
+
+        case segment_quadratic_bezier :
+            sink->add_quadratic_bezier(quadratic_bezier_segment(
+                seg.points_[0], seg.points_[1]));
+            break;
+
+        case segment_arc :
+            sink->add_arc(arc_segment(
+                seg.points_[0], seg.points_[1], seg.rotation_angle_,
+                static_cast<sweep_direction>(seg.flags_ & 1),
+                static_cast<arc_size>((seg.flags_ >> 1) & 1)));
+            break;
+
+        case segment_end_figure :
+            sink->end_figure(static_cast<figure_end>(seg.flags_));
+            break;
+
+        default :
+            assert(false && "unknown segment type");
+            break;
+        }
+    }
+}
+
+void
+gfx::path_geometry::flatten(
+    const matrix3X3& xform,
+    float tolerance,
+    flattened_path* result
+    ) const
+{
+    assert(result);
+    assert(tolerance > 0.0f);
+
+    result->clear();
+    result->fill_mode_ = fill_mode_;
+
+    const float scale = transform_scale_factor(xform);
+    const float local_tolerance = scale > EPSILON ? tolerance / scale : tolerance;
+
+    std::vector<vector2>& points = result->points_;
+    vector2 current_point(0.0f, 0.0f);
+    bool in_figure = false;
+
+    for (size_t i = 0; i < segments_.size(); ++i) {
+        const path_segment& seg = segments_[i];
+        switch (seg.type_) {
+        case segment_begin_figure :
+            if (in_figure)
+                result->figure_ends_.push_back(points.size());
+            points.push_back(xform * seg.points_[0]);
+            current_point = seg.points_[0];
+            in_figure = true;
+            break;
+
+        case segment_line :
+            points.push_back(xform * seg.points_[0]);
+            current_point = seg.points_[0];
+            break;
+
+        case segment_bezier :
+            flatten_cubic(current_point, seg.points_[0], seg.points_[1],
+                          seg.points_[2], xform, local_tolerance, &points);
+            current_point = seg.points_[2];
+            break;
+
+        case segment_quadratic_bezier :
+            flatten_quadratic(current_point, seg.points_[0], seg.points_[1],
+                              xform, local_tolerance, &points);
+            current_point = seg.points_[1];
+            break;
+
+        case segment_arc :
+            flatten_arc(current_point,
+                        arc_segment(seg.points_[0], seg.points_[1], seg.rotation_angle_,
+                                    static_cast<sweep_direction>(seg.flags_ & 1),
+                                    static_cast<arc_size>((seg.flags_ >> 1) & 1)),
+                        xform, local_tolerance, &points);
+            current_point = seg.points_[0];
+            break;
+
+        case segment_end_figure :
+            if (in_figure) {
+                result->figure_ends_.push_back(points.size());
+                in_figure = false;
+            }
+            break;
+
+        default :
+            assert(false && "unknown segment type");
+            break;
+        }
+    }
+
+    if (in_figure)
+        result->figure_ends_.push_back(points.size());
+}
+
+void
+gfx::path_geometry::geometry_sink::begin_figure(
+    const vector2& start_point,
+    figure_begin begin
+    )
+{
+    path_segment seg;
+    seg.type_ = segment_begin_figure;
+    seg.points_[0] = start_point;
+    seg.flags_ = begin;
+    owner_->segments_.push_back(seg);
+}
+
+void
+gfx::path_geometry::geometry_sink::add_line(
+    const vector2& point
+    )
+{
+    path_segment seg;
+    seg.type_ = segment_line;
+    seg.points_[0] = point;
+    owner_->segments_.push_back(seg);
+}
+
+void
+gfx::path_geometry::geometry_sink::add_bezier(
+    const bezier_segment& bezier
+    )
+{
+    path_segment seg;
+    seg.type_ = segment_bezier;
+    seg.points_[0] = bezier.point1_;
+    seg.points_[1] = bezier.point2_;
+    seg.points_[2] = bezier.point3_;
+    owner_->segments_.push_back(seg);
+}
+
+void
+gfx::path_geometry::geometry_sink::add_quadratic_bezier(
+    const quadratic_bezier_segment& bezier
+    )
+{
+    path_segment seg;
+    seg.type_ = segment_quadratic_bezier;
+    seg.points_[0] = bezier.point1_;
+    seg.points_[1] = bezier.point2_;
+    owner_->segments_.push_back(seg);
+}
+
+void
+gfx::path_geometry::geometry_sink::add_arc(
+    const arc_segment& arc
+    )
+{
+    path_segment seg;
+    seg.type_ = segment_arc;
+    seg.points_[0] = arc.point_;
+    seg.points_[1] = arc.size_;
+    seg.rotation_angle_ = arc.rotation_angle_;
+    seg.flags_ = arc.sweep_direction_ | (arc.arc_size_ << 1);
+    owner_->segments_.push_back(seg);
+}
+
+void
+gfx::path_geometry::geometry_sink::end_figure(
+    figure_end end
+    )
+{
+    path_segment seg;
+    seg.type_ = segment_end_figure;
+    seg.flags_ = end;
+    owner_->segments_.push_back(seg);
+}
+
+bool
+gfx::path_geometry::geometry_sink::close() {
+    return true;
+}
@@ -0,0 +1,213 @@
+/*
+ * path_geometry.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_PATH_GEOMETRY_H_
+#define GFX_PATH_GEOMETRY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "matrix3x3.h"
+#include "path_sink.h"
+#include "rectangle.h"
+#include "vector2.h"
+
+namespace gfx {
+
+/*
+ * Same values as D2D1_FILL_MODE. Like Direct2D, paths default to
+ * fill_mode_alternate (even-odd).
+ */
+enum fill_mode {
+    fill_mode_alternate,
+    fill_mode_winding
+};
+
+/*
+ * A path reduced to polygons. Every figure is a run of points in points_;
+ * figure_ends_ holds one past the index of the last point of each figure.
+ * Figures are implicitly closed when filled.
+ */
+class flattened_path {
+public :
+    std::vector<vector2>    points_;
+    std::vector<size_t>     figure_ends_;
+    fill_mode               fill_mode_;
+
+    flattened_path() : fill_mode_(fill_mode_alternate) {}
+
+    void clear() {
+        points_.clear();
+        figure_ends_.clear();
+    }
+
+    bool empty() const {
+        return points_.empty();
+    }
+
+    size_t figure_count() const {
+        return figure_ends_.size();
+    }
+
+    size_t figure_begin(size_t figure) const {
+        return figure ? figure_ends_[figure - 1] : 0;
+    }
+
+    rectangle bounds() const;
+};
+
+/*
+ * Device independent path geometry, the portable counterpart of an
+ * ID2D1PathGeometry. Segments are recorded through the sink returned by
+ * open() and kept in their original (curved) form, so the geometry can be
+ * flattened at whatever tolerance the current transform calls for.
+ */
+class path_geometry {
+public :
+    path_geometry();
+
+    /*
+     * Discards the current content and returns a sink that records into
+     * this geometry. The sink stays owned by the geometry.
+     */
+    path_sink* open();
+
+    void set_fill_mode(fill_mode mode) {
+        fill_mode_ = mode;
+    }
+
+    fill_mode get_fill_mode() const {
+        return fill_mode_;
+    }
+
+    /*
+     * Replays the recorded segments into another sink (does not call
+     * close() on it).
+     */
+    void stream(path_sink* sink) const;
+
+    /*
+     * Flattens the geometry into polygons, applying xform to every point.
+     * tolerance is the maximum distance, after the transform, between the
+     * curves and the polygon that approximates them.
+     */
+    void flatten(
+        const matrix3X3& xform, float tolerance, flattened_path* result) const;
+
+    size_t segment_count() const {
+        return segments_.size();
+    }
+
+    bool empty() const {
+        return segments_.empty();
+    }
+
+    /*
+     * Changes every time the geometry is (re)opened. Revisions are unique
+     * process wide, so a cache keyed by geometry address can tell a reused
+     * address apart from the object it cached.
+     */
+    uint32_t revision() const {
+        return revision_;
+    }
+
+    /*
+     * Hash of the segments and the fill mode. Geometries with the same
+     * content (same_content()) hash the same.
+     */
+    uint64_t content_hash() const;
+
+    /*
+     * Same segments, bit for bit, and the same fill mode.
+     */
+    bool same_content(const path_geometry& other) const;
+
+    /*
+     * Bytes used by the geometry and its segments.
+     */
+    size_t memory_size() const {
+        return sizeof(*this) + segments_.capacity() * sizeof(path_segment);
+    }
+
+private :
+    enum segment_type {
+        segment_begin_figure,
+        segment_line,
+        segment_bezier,
+        segment_quadratic_bezier,
+        segment_arc,
+        segment_end_figure
+    };
+
+    struct path_segment {
+        segment_type    type_;
+        vector2         points_[3];
+        float           rotation_angle_;
+        int             flags_;
+
+        //
+        // Fields a segment type does not use stay zero, so segments can be
+        // compared and hashed as a whole.
+        path_segment()
+            : type_(segment_line), rotation_angle_(0.0f), flags_(0) {
+            points_[0] = points_[1] = points_[2] = vector2(0.0f, 0.0f);
+        }
+    };
+
+    class geometry_sink : public path_sink {
+    public :
+        explicit geometry_sink(path_geometry* owner) : owner_(owner) {}
+
+        void begin_figure(const vector2& start_point, figure_begin begin);
+
+        void add_line(const vector2& point);
+
+        void add_bezier(const bezier_segment& bezier);
+
+        void add_quadratic_bezier(const quadratic_bezier_segment& bezier);
+
+        void add_arc(const arc_segment& arc);
+
+        void end_figure(figure_end end);
+
+        bool close();
+
+    private :
+        path_geometry*  owner_;
+    };
+
+    path_geometry(const path_geometry&);
+    path_geometry& operator=(const path_geometry&);
+
+    std::vector<path_segment>   segments_;
+    geometry_sink               sink_;
+    fill_mode                   fill_mode_;
+    uint32_t                    revision_;
+};
+
+/*
+ * Largest factor by which the transform stretches a unit vector. Used to
+ * turn a device space flattening tolerance into a local space one.
+ */
+float
+transform_scale_factor(
+    const matrix3X3& xform
+    );
+
+/*
+ * Smallest factor by which the transform stretches a unit vector, zero
+ * for a singular transform.
+ */
+float
+transform_min_scale_factor(
+    const matrix3X3& xform
+    );
+
+} // ns gfx
+
+#endif /* GFX_PATH_GEOMETRY_H_ */
@@ -0,0 +1,160 @@
+/*
+ * path_sink.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_PATH_SINK_H_
+#define GFX_PATH_SINK_H_
+
+#if defined(D2D_SUPPORT__)
+#include <d2d1.h>
+#endif
+
+#include "vector2.h"
+
+namespace gfx {
+
+/*
+ * The enumerators have the same values as their D2D1_* counterparts, so
+ * converting between them is a static_cast.
+ */
+enum figure_begin {
+    figure_begin_filled,
+    figure_begin_hollow
+};
+
+enum figure_end {
+    figure_end_open,
+    figure_end_closed
+};
+
+enum sweep_direction {
+    sweep_direction_counter_clockwise,
+    sweep_direction_clockwise
+};
+
+enum arc_size {
+    arc_size_small,
+    arc_size_large
+};
+
+struct bezier_segment {
+    vector2 point1_;
+    vector2 point2_;
+    vector2 point3_;
+
+    bezier_segment() {}
+
+    bezier_segment(const vector2& p1, const vector2& p2, const vector2& p3)
+        : point1_(p1), point2_(p2), point3_(p3) {}
+};
+
+struct quadratic_bezier_segment {
+    vector2 point1_;
+    vector2 point2_;
+
+    quadratic_bezier_segment() {}
+
+    quadratic_bezier_segment(const vector2& p1, const vector2& p2)
+        : point1_(p1), point2_(p2) {}
+};
+
+/*
+ * Endpoint parameterization, same as ID2D1GeometrySink::AddArc and the
+ * SVG 'A' command : the arc starts at the current point and ends at point_.
+ */
+struct arc_segment {
+    vector2         point_;
+    vector2         size_;
+    float           rotation_angle_;
+    sweep_direction sweep_direction_;
+    arc_size        arc_size_;
+
+    arc_segment() {}
+
+    arc_segment(
+        const vector2& pt, const vector2& radii, float rotation_angle,
+        sweep_direction sweep, arc_size size)
+        : point_(pt), size_(radii), rotation_angle_(rotation_angle),
+          sweep_direction_(sweep), arc_size_(size) {}
+};
+
+/*
+ * Receives path geometry one segment at a time. Mirrors the calls made on
+ * an ID2D1GeometrySink, so code that builds a path does not need to know
+ * where the path ends up.
+ */
+class path_sink {
+public :
+    virtual ~path_sink() {}
+
+    virtual void begin_figure(const vector2& start_point, figure_begin begin) = 0;
+
+    virtual void add_line(const vector2& point) = 0;
+
+    virtual void add_bezier(const bezier_segment& bezier) = 0;
+
+    virtual void add_quadratic_bezier(const quadratic_bezier_segment& bezier) = 0;
+
+    virtual void add_arc(const arc_segment& arc) = 0;
+
+    virtual void end_figure(figure_end end) = 0;
+
+    virtual bool close() = 0;
+};
+
+#if defined(D2D_SUPPORT__)
+
+/*
+ * Forwards path_sink calls to a Direct2D geometry sink. Does not take
+ * ownership of the sink.
+ */
+class d2d_geometry_sink_adapter : public path_sink {
+public :
+    explicit d2d_geometry_sink_adapter(ID2D1GeometrySink* sink)
+        : sink_(sink) {}
+
+    void begin_figure(const vector2& start_point, figure_begin begin) {
+        sink_->BeginFigure(start_point, static_cast<D2D1_FIGURE_BEGIN>(begin));
+    }
+
+    void add_line(const vector2& point) {
+        sink_->AddLine(point);
+    }
+
+    void add_bezier(const bezier_segment& bezier) {
+        sink_->AddBezier(D2D1::BezierSegment(
+            bezier.point1_, bezier.point2_, bezier.point3_));
+    }
+
+    void add_quadratic_bezier(const quadratic_bezier_segment& bezier) {
+        sink_->AddQuadraticBezier(D2D1::QuadraticBezierSegment(
+            bezier.point1_, bezier.point2_));
+    }
+
+    void add_arc(const arc_segment& arc) {
+        sink_->AddArc(D2D1::ArcSegment(
+            arc.point_, arc.size_, arc.rotation_angle_,
+            static_cast<D2D1_SWEEP_DIRECTION>(arc.sweep_direction_),
+            static_cast<D2D1_ARC_SIZE>(arc.arc_size_)));
+    }
+
+    void end_figure(figure_end end) {
+        sink_->EndFigure(static_cast<D2D1_FIGURE_END>(end));
+    }
+
+    bool close() {
+        return SUCCEEDED(sink_->Close());
+    }
+
+private :
+    ID2D1GeometrySink*  sink_;
+};
+
+#endif
+
+} // ns gfx
+
+#endif /* GFX_PATH_SINK_H_ */
@@ -14,6 +14,8 @@
 #include <unordered_set>
 #include <utility>
 
+#if defined(_WIN32)
+
 #if defined(NTDDI_VERSION)
 #undef NTDDI_VERSION
 #endif
@@ -22,4 +24,6 @@
 
 #include <Windows.h>
 #include <d2d1.h>
-#include <d2d1Helper.h>
\ No newline at end of file
+#include <d2d1Helper.h>
+
+#endif
\ No newline at end of file
@@ -0,0 +1,106 @@
+/*
+ * pixel_kernels.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ *
+ * Shared by the pixel_ops*.cc files only : the scalar per pixel
+ * operations (which define the results every kernel set must match) and
+ * the per instruction set kernel tables.
+ */
+
+#ifndef GFX_PIXEL_KERNELS_H_
+#define GFX_PIXEL_KERNELS_H_
+
+#include "pixel_ops.h"
+
+namespace gfx {
+namespace detail {
+
+/*
+ * c * coverage / 255 on every channel.
+ */
+inline
+uint32_t
+scale_pixel(
+    uint32_t pixel,
+    uint32_t coverage
+    )
+{
+    const uint32_t r = div255((pixel & 0xFF) * coverage);
+    const uint32_t g = div255(((pixel >> 8) & 0xFF) * coverage);
+    const uint32_t b = div255(((pixel >> 16) & 0xFF) * coverage);
+    const uint32_t a = div255((pixel >> 24) * coverage);
+    return r | (g << 8) | (b << 16) | (a << 24);
+}
+
+/*
+ * Per channel saturated add. Only makes a difference for pixels that are
+ * not valid premultiplied colours, but keeps the SIMD kernels exact.
+ */
+inline
+uint32_t
+add_saturate(
+    uint32_t lhs,
+    uint32_t rhs
+    )
+{
+    uint32_t result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        const uint32_t sum = ((lhs >> shift) & 0xFF) + ((rhs >> shift) & 0xFF);
+        result |= (sum > 0xFF ? 0xFF : sum) << shift;
+    }
+    return result;
+}
+
+/*
+ * src + dst * (1 - src_alpha), src is premultiplied.
+ */
+inline
+uint32_t
+source_over(
+    uint32_t src,
+    uint32_t dst
+    )
+{
+    return add_saturate(src, scale_pixel(dst, 255 - (src >> 24)));
+}
+
+/*
+ * The reference for the per pixel coverage kernels. Full coverage of an
+ * opaque pixel is a plain store, zero coverage leaves dst alone; both
+ * give the same result as the general formula.
+ */
+inline
+uint32_t
+blend_pixel(
+    uint32_t src,
+    uint32_t coverage,
+    uint32_t dst
+    )
+{
+    return source_over(scale_pixel(src, coverage), dst);
+}
+
+const pixel_kernels&
+scalar_kernels();
+
+#if defined(GFX_HAVE_SSE2)
+const pixel_kernels&
+sse2_kernels();
+#endif
+
+#if defined(GFX_HAVE_AVX2)
+const pixel_kernels&
+avx2_kernels();
+#endif
+
+#if defined(GFX_HAVE_NEON)
+const pixel_kernels&
+neon_kernels();
+#endif
+
+} // ns detail
+} // ns gfx
+
+#endif /* GFX_PIXEL_KERNELS_H_ */
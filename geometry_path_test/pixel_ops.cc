@@ -0,0 +1,279 @@
+/*
+ * pixel_ops.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "pixel_ops.h"
+
+#include <atomic>
+#include <cstring>
+
+#if defined(GFX_HAVE_AVX2) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+#include "pixel_kernels.h"
+
+namespace {
+
+/*
+ * The scalar reference kernels.
+ */
+
+void
+scalar_fill_span(
+    uint32_t* dst,
+    size_t count,
+    uint32_t pixel
+    )
+{
+    while (count--)
+        *dst++ = pixel;
+}
+
+void
+scalar_copy_span(
+    uint32_t* dst,
+    const uint32_t* src,
+    size_t count
+    )
+{
+    if (count)
+        std::memcpy(dst, src, count * sizeof(*dst));
+}
+
+void
+scalar_blend_solid_span(
+    uint32_t* dst,
+    const uint8_t* coverage,
+    size_t count,
+    uint32_t pixel
+    )
+{
+    const bool opaque = (pixel >> 24) == 0xFF;
+
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t cov = coverage[i];
+        if (!cov)
+            continue;
+
+        if (cov == 0xFF && opaque)
+            dst[i] = pixel;
+        else
+            dst[i] = gfx::detail::blend_pixel(pixel, cov, dst[i]);
+    }
+}
+
+void
+scalar_blend_uniform_span(
+    uint32_t* dst,
+    size_t count,
+    uint32_t src
+    )
+{
+    for (size_t i = 0; i < count; ++i)
+        dst[i] = gfx::detail::source_over(src, dst[i]);
+}
+
+void
+scalar_blend_span(
+    uint32_t* dst,
+    const uint32_t* src,
+    const uint8_t* coverage,
+    size_t count
+    )
+{
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t cov = coverage[i];
+        if (!cov)
+            continue;
+
+        if (cov == 0xFF && (src[i] >> 24) == 0xFF)
+            dst[i] = src[i];
+        else
+            dst[i] = gfx::detail::blend_pixel(src[i], cov, dst[i]);
+    }
+}
+
+const gfx::pixel_kernels C_ScalarKernels = {
+    gfx::pixel_isa_scalar,
+    "scalar",
+    &scalar_fill_span,
+    &scalar_copy_span,
+    &scalar_blend_solid_span,
+    &scalar_blend_uniform_span,
+    &scalar_blend_span
+};
+
+#if defined(GFX_HAVE_AVX2)
+bool
+cpu_has_avx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    //
+    // The OS must also save the YMM registers on context switches.
+    __cpuid(info, 1);
+    const int osxsave_avx = (1 << 27) | (1 << 28);
+    if ((info[2] & osxsave_avx) != osxsave_avx || (_xgetbv(0) & 6) != 6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif
+
+const gfx::pixel_kernels*
+best_pixel_kernels() {
+    static const gfx::pixel_isa C_Preference[] = {
+        gfx::pixel_isa_avx2, gfx::pixel_isa_neon, gfx::pixel_isa_sse2
+    };
+
+    for (size_t i = 0; i < sizeof(C_Preference) / sizeof(C_Preference[0]); ++i) {
+        if (const gfx::pixel_kernels* kernels = gfx::find_pixel_kernels(C_Preference[i]))
+            return kernels;
+    }
+
+    return &C_ScalarKernels;
+}
+
+std::atomic<const gfx::pixel_kernels*> g_active_kernels(nullptr);
+
+inline
+const gfx::pixel_kernels&
+kernels() {
+    const gfx::pixel_kernels* active = g_active_kernels.load(std::memory_order_relaxed);
+    if (!active) {
+        active = best_pixel_kernels();
+        g_active_kernels.store(active, std::memory_order_relaxed);
+    }
+    return *active;
+}
+
+} // anonymous namespace
+
+const gfx::pixel_kernels&
+gfx::detail::scalar_kernels() {
+    return C_ScalarKernels;
+}
+
+const gfx::pixel_kernels*
+gfx::find_pixel_kernels(
+    pixel_isa isa
+    )
+{
+    switch (isa) {
+    case pixel_isa_scalar :
+        return &C_ScalarKernels;
+
+#if defined(GFX_HAVE_SSE2)
+    case pixel_isa_sse2 :
+        return &detail::sse2_kernels();
+#endif
+
+#if defined(GFX_HAVE_AVX2)
+    case pixel_isa_avx2 : {
+        static const bool supported = cpu_has_avx2();
+        return supported ? &detail::avx2_kernels() : nullptr;
+        }
+#endif
+
+#if defined(GFX_HAVE_NEON)
+    case pixel_isa_neon :
+        return &detail::neon_kernels();
+#endif
+
+    default :
+        break;
+    }
+
+    return nullptr;
+}
+
+const gfx::pixel_kernels&
+gfx::active_pixel_kernels() {
+    return kernels();
+}
+
+bool
+gfx::select_pixel_kernels(
+    pixel_isa isa
+    )
+{
+    const pixel_kernels* selected = find_pixel_kernels(isa);
+    if (!selected)
+        return false;
+
+    g_active_kernels.store(selected, std::memory_order_relaxed);
+    return true;
+}
+
+void
+gfx::fill_span(
+    uint32_t* dst,
+    size_t count,
+    uint32_t pixel
+    )
+{
+    kernels().fill_span_(dst, count, pixel);
+}
+
+void
+gfx::copy_span(
+    uint32_t* dst,
+    const uint32_t* src,
+    size_t count
+    )
+{
+    kernels().copy_span_(dst, src, count);
+}
+
+void
+gfx::blend_solid_span(
+    uint32_t* dst,
+    const uint8_t* coverage,
+    size_t count,
+    uint32_t pixel
+    )
+{
+    kernels().blend_solid_span_(dst, coverage, count, pixel);
+}
+
+void
+gfx::blend_solid_span(
+    uint32_t* dst,
+    uint8_t coverage,
+    size_t count,
+    uint32_t pixel
+    )
+{
+    if (!coverage)
+        return;
+
+    const uint32_t src = detail::scale_pixel(pixel, coverage);
+    if ((src >> 24) == 0xFF)
+        kernels().fill_span_(dst, count, src);
+    else
+        kernels().blend_uniform_span_(dst, count, src);
+}
+
+void
+gfx::blend_span(
+    uint32_t* dst,
+    const uint32_t* src,
+    const uint8_t* coverage,
+    size_t count
+    )
+{
+    kernels().blend_span_(dst, src, coverage, count);
+}
@@ -0,0 +1,162 @@
+/*
+ * pixel_ops.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_PIXEL_OPS_H_
+#define GFX_PIXEL_OPS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GFX_HAVE_SSE2 1
+#endif
+
+//
+// AVX2 kernels are compiled on any x86 build with SSE2 and only used
+// if the CPU has AVX2 (checked at run time).
+#if defined(GFX_HAVE_SSE2) && (defined(_MSC_VER) || defined(__GNUC__))
+#define GFX_HAVE_AVX2 1
+#endif
+
+#if defined(__ARM_NEON) || defined(_M_ARM64)
+#define GFX_HAVE_NEON 1
+#endif
+
+namespace gfx {
+
+/*
+ * Span level operations on premultiplied RGBA8 pixels (see
+ * pack_premultiplied_rgba8). Coverage values are in [0, 255].
+ *
+ * Blending is source over : dst = src * cov + dst * (1 - src_alpha * cov),
+ * every product rounded with div255 and the final add saturated per
+ * channel. Every kernel set gives bit identical results to the scalar
+ * one, the SIMD sets only change how many pixels are done per step.
+ */
+
+/*
+ * x / 255, rounded to nearest, exact for x in [0, 255 * 255].
+ */
+inline
+uint32_t
+div255(
+    uint32_t x
+    )
+{
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+/*
+ * Writes pixel to every element of the span (clears).
+ */
+void
+fill_span(
+    uint32_t* dst,
+    size_t count,
+    uint32_t pixel
+    );
+
+/*
+ * Copies pixels, the spans must not overlap.
+ */
+void
+copy_span(
+    uint32_t* dst,
+    const uint32_t* src,
+    size_t count
+    );
+
+/*
+ * Source over blend of a solid colour, with per pixel coverage.
+ */
+void
+blend_solid_span(
+    uint32_t* dst,
+    const uint8_t* coverage,
+    size_t count,
+    uint32_t pixel
+    );
+
+/*
+ * Source over blend of a solid colour, same coverage for all the pixels.
+ */
+void
+blend_solid_span(
+    uint32_t* dst,
+    uint8_t coverage,
+    size_t count,
+    uint32_t pixel
+    );
+
+/*
+ * Source over blend of a span of (premultiplied) source pixels, with per
+ * pixel coverage.
+ */
+void
+blend_span(
+    uint32_t* dst,
+    const uint32_t* src,
+    const uint8_t* coverage,
+    size_t count
+    );
+
+enum pixel_isa {
+    pixel_isa_scalar,
+    pixel_isa_sse2,
+    pixel_isa_avx2,
+    pixel_isa_neon
+};
+
+/*
+ * One implementation of the span operations above. The free functions
+ * forward to the active set, which is the widest one the CPU supports.
+ */
+struct pixel_kernels {
+    pixel_isa   isa_;
+    const char* name_;
+
+    void (*fill_span_)(uint32_t* dst, size_t count, uint32_t pixel);
+
+    void (*copy_span_)(uint32_t* dst, const uint32_t* src, size_t count);
+
+    void (*blend_solid_span_)(
+        uint32_t* dst, const uint8_t* coverage, size_t count, uint32_t pixel);
+
+    //
+    // Solid colour, uniform coverage, src already scaled by the coverage.
+    void (*blend_uniform_span_)(uint32_t* dst, size_t count, uint32_t src);
+
+    void (*blend_span_)(
+        uint32_t* dst, const uint32_t* src, const uint8_t* coverage, size_t count);
+};
+
+/*
+ * Returns the kernel set for an instruction set, or nullptr if it was not
+ * compiled in or the CPU does not support it.
+ */
+const pixel_kernels*
+find_pixel_kernels(
+    pixel_isa isa
+    );
+
+const pixel_kernels&
+active_pixel_kernels();
+
+/*
+ * Forces a kernel set (benchmarks, comparing against the scalar
+ * reference). Returns false and changes nothing if it is not available.
+ * Not meant to be called while other threads are rendering.
+ */
+bool
+select_pixel_kernels(
+    pixel_isa isa
+    );
+
+} // ns gfx
+
+#endif /* GFX_PIXEL_OPS_H_ */
@@ -0,0 +1,279 @@
+/*
+ * pixel_ops_avx2.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ *
+ * Same kernels as pixel_ops_sse2.cc, 8 pixels per step. Built without
+ * any special compiler switch (the functions are tagged for AVX2 with
+ * GCC/Clang, MSVC accepts the intrinsics as is), pixel_ops.cc only
+ * hands them out after checking the CPU.
+ */
+#include "pch_hdr.h"
+#include "pixel_kernels.h"
+
+#if defined(GFX_HAVE_AVX2)
+
+#include <cstring>
+
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#define GFX_AVX2_FUNCTION
+#else
+#define GFX_AVX2_FUNCTION __attribute__((target("avx2")))
+#endif
+
+namespace {
+
+GFX_AVX2_FUNCTION
+inline
+__m256i
+div255_epu16(
+    __m256i x
+    )
+{
+    x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+//
+// The unpacks and the pack work within 128 bit lanes, so the pixels end
+// up back in their original order.
+GFX_AVX2_FUNCTION
+inline
+__m256i
+scale_pixels(
+    __m256i pixels,
+    __m256i factors
+    )
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i lo = div255_epu16(_mm256_mullo_epi16(
+        _mm256_unpacklo_epi8(pixels, zero), _mm256_unpacklo_epi8(factors, zero)));
+    const __m256i hi = div255_epu16(_mm256_mullo_epi16(
+        _mm256_unpackhi_epi8(pixels, zero), _mm256_unpackhi_epi8(factors, zero)));
+    return _mm256_packus_epi16(lo, hi);
+}
+
+GFX_AVX2_FUNCTION
+inline
+__m256i
+broadcast_alpha(
+    __m256i pixels
+    )
+{
+    const __m256i alpha_shuffle = _mm256_setr_epi8(
+        3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15,
+        3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15);
+    return _mm256_shuffle_epi8(pixels, alpha_shuffle);
+}
+
+GFX_AVX2_FUNCTION
+inline
+__m256i
+source_over(
+    __m256i src,
+    __m256i dst
+    )
+{
+    const __m256i inv_alpha = _mm256_xor_si256(broadcast_alpha(src), _mm256_set1_epi32(-1));
+    return _mm256_adds_epu8(src, scale_pixels(dst, inv_alpha));
+}
+
+inline
+uint64_t
+load_coverage(
+    const uint8_t* coverage
+    )
+{
+    uint64_t value;
+    std::memcpy(&value, coverage, sizeof(value));
+    return value;
+}
+
+GFX_AVX2_FUNCTION
+inline
+__m256i
+expand_coverage(
+    const uint8_t* coverage
+    )
+{
+    const __m256i cov = _mm256_cvtepu8_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(coverage)));
+    const __m256i spread = _mm256_setr_epi8(
+        0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12,
+        0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12);
+    return _mm256_shuffle_epi8(cov, spread);
+}
+
+GFX_AVX2_FUNCTION
+inline
+bool
+all_opaque(
+    __m256i pixels
+    )
+{
+    const __m256i alpha_mask = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+    return _mm256_movemask_epi8(
+        _mm256_cmpeq_epi32(_mm256_and_si256(pixels, alpha_mask), alpha_mask)) == -1;
+}
+
+GFX_AVX2_FUNCTION
+void
+avx2_fill_span(
+    uint32_t* dst,
+    size_t count,
+    uint32_t pixel
+    )
+{
+    while (count && (reinterpret_cast<uintptr_t>(dst) & 31)) {
+        *dst++ = pixel;
+        --count;
+    }
+
+    const __m256i value = _mm256_set1_epi32(static_cast<int>(pixel));
+    while (count >= 32) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(dst), value);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(dst + 8), value);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(dst + 16), value);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(dst + 24), value);
+        dst += 32;
+        count -= 32;
+    }
+
+    while (count >= 8) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(dst), value);
+        dst += 8;
+        count -= 8;
+    }
+
+    while (count--)
+        *dst++ = pixel;
+}
+
+GFX_AVX2_FUNCTION
+void
+avx2_copy_span(
+    uint32_t* dst,
+    const uint32_t* src,
+    size_t count
+    )
+{
+    while (count && (reinterpret_cast<uintptr_t>(dst) & 31)) {
+        *dst++ = *src++;
+        --count;
+    }
+
+    while (count >= 32) {
+        const __m256i p0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        const __m256i p1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 8));
+        const __m256i p2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 16));
+        const __m256i p3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 24));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(dst), p0);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(dst + 8), p1);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(dst + 16), p2);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(dst + 24), p3);
+        src += 32;
+        dst += 32;
+        count -= 32;
+    }
+
+    while (count--)
+        *dst++ = *src++;
+}
+
+GFX_AVX2_FUNCTION
+void
+avx2_blend_solid_span(
+    uint32_t* dst,
+    const uint8_t* coverage,
+    size_t count,
+    uint32_t pixel
+    )
+{
+    const __m256i color = _mm256_set1_epi32(static_cast<int>(pixel));
+    const bool opaque = (pixel >> 24) == 0xFF;
+
+    for (; count >= 8; count -= 8, dst += 8, coverage += 8) {
+        const uint64_t cov = load_coverage(coverage);
+        if (!cov)
+            continue;
+
+        __m256i* out = reinterpret_cast<__m256i*>(dst);
+        if (cov == ~static_cast<uint64_t>(0) && opaque) {
+            _mm256_storeu_si256(out, color);
+            continue;
+        }
+
+        const __m256i src = scale_pixels(color, expand_coverage(coverage));
+        _mm256_storeu_si256(out, source_over(src, _mm256_loadu_si256(out)));
+    }
+
+    gfx::detail::scalar_kernels().blend_solid_span_(dst, coverage, count, pixel);
+}
+
+GFX_AVX2_FUNCTION
+void
+avx2_blend_uniform_span(
+    uint32_t* dst,
+    size_t count,
+    uint32_t src
+    )
+{
+    const __m256i color = _mm256_set1_epi32(static_cast<int>(src));
+
+    for (; count >= 8; count -= 8, dst += 8) {
+        __m256i* out = reinterpret_cast<__m256i*>(dst);
+        _mm256_storeu_si256(out, source_over(color, _mm256_loadu_si256(out)));
+    }
+
+    gfx::detail::scalar_kernels().blend_uniform_span_(dst, count, src);
+}
+
+GFX_AVX2_FUNCTION
+void
+avx2_blend_span(
+    uint32_t* dst,
+    const uint32_t* src,
+    const uint8_t* coverage,
+    size_t count
+    )
+{
+    for (; count >= 8; count -= 8, dst += 8, src += 8, coverage += 8) {
+        const uint64_t cov = load_coverage(coverage);
+        if (!cov)
+            continue;
+
+        __m256i* out = reinterpret_cast<__m256i*>(dst);
+        const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        if (cov == ~static_cast<uint64_t>(0) && all_opaque(pixels)) {
+            _mm256_storeu_si256(out, pixels);
+            continue;
+        }
+
+        const __m256i scaled = scale_pixels(pixels, expand_coverage(coverage));
+        _mm256_storeu_si256(out, source_over(scaled, _mm256_loadu_si256(out)));
+    }
+
+    gfx::detail::scalar_kernels().blend_span_(dst, src, coverage, count);
+}
+
+const gfx::pixel_kernels C_Avx2Kernels = {
+    gfx::pixel_isa_avx2,
+    "avx2",
+    &avx2_fill_span,
+    &avx2_copy_span,
+    &avx2_blend_solid_span,
+    &avx2_blend_uniform_span,
+    &avx2_blend_span
+};
+
+} // anonymous namespace
+
+const gfx::pixel_kernels&
+gfx::detail::avx2_kernels() {
+    return C_Avx2Kernels;
+}
+
+#endif /* GFX_HAVE_AVX2 */
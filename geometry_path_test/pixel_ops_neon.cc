@@ -0,0 +1,242 @@
+/*
+ * pixel_ops_neon.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ *
+ * 8 pixels per step, deinterleaved into planes with vld4 so every channel
+ * is blended with plain 8x8 -> 16 bit multiplies.
+ */
+#include "pch_hdr.h"
+#include "pixel_kernels.h"
+
+#if defined(GFX_HAVE_NEON)
+
+#include <cstring>
+
+#include <arm_neon.h>
+
+namespace {
+
+//
+// div255 on the 16 bit products, narrowed back to 8 bits.
+inline
+uint8x8_t
+div255_narrow(
+    uint16x8_t x
+    )
+{
+    x = vaddq_u16(x, vdupq_n_u16(128));
+    return vshrn_n_u16(vaddq_u16(x, vshrq_n_u16(x, 8)), 8);
+}
+
+inline
+uint8x8_t
+scale_plane(
+    uint8x8_t plane,
+    uint8x8_t factor
+    )
+{
+    return div255_narrow(vmull_u8(plane, factor));
+}
+
+inline
+uint8x8x4_t
+scale_pixels(
+    uint8x8x4_t pixels,
+    uint8x8_t factor
+    )
+{
+    uint8x8x4_t result;
+    result.val[0] = scale_plane(pixels.val[0], factor);
+    result.val[1] = scale_plane(pixels.val[1], factor);
+    result.val[2] = scale_plane(pixels.val[2], factor);
+    result.val[3] = scale_plane(pixels.val[3], factor);
+    return result;
+}
+
+inline
+uint8x8x4_t
+source_over(
+    uint8x8x4_t src,
+    uint8x8x4_t dst
+    )
+{
+    const uint8x8_t inv_alpha = vmvn_u8(src.val[3]);
+    uint8x8x4_t result;
+    result.val[0] = vqadd_u8(src.val[0], scale_plane(dst.val[0], inv_alpha));
+    result.val[1] = vqadd_u8(src.val[1], scale_plane(dst.val[1], inv_alpha));
+    result.val[2] = vqadd_u8(src.val[2], scale_plane(dst.val[2], inv_alpha));
+    result.val[3] = vqadd_u8(src.val[3], scale_plane(dst.val[3], inv_alpha));
+    return result;
+}
+
+inline
+uint64_t
+load_coverage(
+    const uint8_t* coverage
+    )
+{
+    uint64_t value;
+    std::memcpy(&value, coverage, sizeof(value));
+    return value;
+}
+
+inline
+uint8_t*
+as_bytes(
+    uint32_t* pixels
+    )
+{
+    return reinterpret_cast<uint8_t*>(pixels);
+}
+
+inline
+const uint8_t*
+as_bytes(
+    const uint32_t* pixels
+    )
+{
+    return reinterpret_cast<const uint8_t*>(pixels);
+}
+
+void
+neon_fill_span(
+    uint32_t* dst,
+    size_t count,
+    uint32_t pixel
+    )
+{
+    const uint32x4_t value = vdupq_n_u32(pixel);
+    for (; count >= 16; count -= 16, dst += 16) {
+        vst1q_u32(dst, value);
+        vst1q_u32(dst + 4, value);
+        vst1q_u32(dst + 8, value);
+        vst1q_u32(dst + 12, value);
+    }
+
+    for (; count >= 4; count -= 4, dst += 4)
+        vst1q_u32(dst, value);
+
+    while (count--)
+        *dst++ = pixel;
+}
+
+void
+neon_copy_span(
+    uint32_t* dst,
+    const uint32_t* src,
+    size_t count
+    )
+{
+    for (; count >= 16; count -= 16, dst += 16, src += 16) {
+        const uint32x4_t p0 = vld1q_u32(src);
+        const uint32x4_t p1 = vld1q_u32(src + 4);
+        const uint32x4_t p2 = vld1q_u32(src + 8);
+        const uint32x4_t p3 = vld1q_u32(src + 12);
+        vst1q_u32(dst, p0);
+        vst1q_u32(dst + 4, p1);
+        vst1q_u32(dst + 8, p2);
+        vst1q_u32(dst + 12, p3);
+    }
+
+    while (count--)
+        *dst++ = *src++;
+}
+
+void
+neon_blend_solid_span(
+    uint32_t* dst,
+    const uint8_t* coverage,
+    size_t count,
+    uint32_t pixel
+    )
+{
+    uint8x8x4_t color;
+    color.val[0] = vdup_n_u8(static_cast<uint8_t>(pixel));
+    color.val[1] = vdup_n_u8(static_cast<uint8_t>(pixel >> 8));
+    color.val[2] = vdup_n_u8(static_cast<uint8_t>(pixel >> 16));
+    color.val[3] = vdup_n_u8(static_cast<uint8_t>(pixel >> 24));
+    const bool opaque = (pixel >> 24) == 0xFF;
+
+    for (; count >= 8; count -= 8, dst += 8, coverage += 8) {
+        const uint64_t cov = load_coverage(coverage);
+        if (!cov)
+            continue;
+
+        if (cov == ~static_cast<uint64_t>(0) && opaque) {
+            vst4_u8(as_bytes(dst), color);
+            continue;
+        }
+
+        const uint8x8x4_t src = scale_pixels(color, vld1_u8(coverage));
+        vst4_u8(as_bytes(dst), source_over(src, vld4_u8(as_bytes(dst))));
+    }
+
+    gfx::detail::scalar_kernels().blend_solid_span_(dst, coverage, count, pixel);
+}
+
+void
+neon_blend_uniform_span(
+    uint32_t* dst,
+    size_t count,
+    uint32_t src
+    )
+{
+    uint8x8x4_t color;
+    color.val[0] = vdup_n_u8(static_cast<uint8_t>(src));
+    color.val[1] = vdup_n_u8(static_cast<uint8_t>(src >> 8));
+    color.val[2] = vdup_n_u8(static_cast<uint8_t>(src >> 16));
+    color.val[3] = vdup_n_u8(static_cast<uint8_t>(src >> 24));
+
+    for (; count >= 8; count -= 8, dst += 8)
+        vst4_u8(as_bytes(dst), source_over(color, vld4_u8(as_bytes(dst))));
+
+    gfx::detail::scalar_kernels().blend_uniform_span_(dst, count, src);
+}
+
+void
+neon_blend_span(
+    uint32_t* dst,
+    const uint32_t* src,
+    const uint8_t* coverage,
+    size_t count
+    )
+{
+    for (; count >= 8; count -= 8, dst += 8, src += 8, coverage += 8) {
+        const uint64_t cov = load_coverage(coverage);
+        if (!cov)
+            continue;
+
+        const uint8x8x4_t pixels = vld4_u8(as_bytes(src));
+        if (cov == ~static_cast<uint64_t>(0) &&
+            vget_lane_u64(vreinterpret_u64_u8(vmvn_u8(pixels.val[3])), 0) == 0) {
+            vst4_u8(as_bytes(dst), pixels);
+            continue;
+        }
+
+        const uint8x8x4_t scaled = scale_pixels(pixels, vld1_u8(coverage));
+        vst4_u8(as_bytes(dst), source_over(scaled, vld4_u8(as_bytes(dst))));
+    }
+
+    gfx::detail::scalar_kernels().blend_span_(dst, src, coverage, count);
+}
+
+const gfx::pixel_kernels C_NeonKernels = {
+    gfx::pixel_isa_neon,
+    "neon",
+    &neon_fill_span,
+    &neon_copy_span,
+    &neon_blend_solid_span,
+    &neon_blend_uniform_span,
+    &neon_blend_span
+};
+
+} // anonymous namespace
+
+const gfx::pixel_kernels&
+gfx::detail::neon_kernels() {
+    return C_NeonKernels;
+}
+
+#endif /* GFX_HAVE_NEON */
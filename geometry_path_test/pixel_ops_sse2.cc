@@ -0,0 +1,263 @@
+/*
+ * pixel_ops_sse2.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "pixel_kernels.h"
+
+#if defined(GFX_HAVE_SSE2)
+
+#include <cstring>
+
+#include <emmintrin.h>
+
+namespace {
+
+/*
+ * All the blends work on 4 pixels at a time, widened to 16 bits per
+ * channel. Coverage is expanded so that every byte of a pixel holds the
+ * coverage of that pixel, which lines it up with the channels.
+ */
+
+//
+// div255 on 16 bit lanes, exact for products of two 8 bit values.
+inline
+__m128i
+div255_epu16(
+    __m128i x
+    )
+{
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+//
+// pixels * factors / 255 per byte.
+inline
+__m128i
+scale_pixels(
+    __m128i pixels,
+    __m128i factors
+    )
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo = div255_epu16(_mm_mullo_epi16(
+        _mm_unpacklo_epi8(pixels, zero), _mm_unpacklo_epi8(factors, zero)));
+    const __m128i hi = div255_epu16(_mm_mullo_epi16(
+        _mm_unpackhi_epi8(pixels, zero), _mm_unpackhi_epi8(factors, zero)));
+    return _mm_packus_epi16(lo, hi);
+}
+
+//
+// The alpha of every pixel copied to all of its bytes.
+inline
+__m128i
+broadcast_alpha(
+    __m128i pixels
+    )
+{
+    __m128i alpha = _mm_srli_epi32(pixels, 24);
+    alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 8));
+    return _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+}
+
+inline
+__m128i
+source_over(
+    __m128i src,
+    __m128i dst
+    )
+{
+    const __m128i inv_alpha = _mm_xor_si128(broadcast_alpha(src), _mm_set1_epi32(-1));
+    return _mm_adds_epu8(src, scale_pixels(dst, inv_alpha));
+}
+
+inline
+uint32_t
+load_coverage(
+    const uint8_t* coverage
+    )
+{
+    uint32_t value;
+    std::memcpy(&value, coverage, sizeof(value));
+    return value;
+}
+
+inline
+__m128i
+expand_coverage(
+    uint32_t coverage
+    )
+{
+    __m128i cov = _mm_cvtsi32_si128(static_cast<int>(coverage));
+    cov = _mm_unpacklo_epi8(cov, cov);
+    return _mm_unpacklo_epi16(cov, cov);
+}
+
+inline
+bool
+all_opaque(
+    __m128i pixels
+    )
+{
+    const __m128i alpha_mask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+    return _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(pixels, alpha_mask), alpha_mask)) == 0xFFFF;
+}
+
+void
+sse2_fill_span(
+    uint32_t* dst,
+    size_t count,
+    uint32_t pixel
+    )
+{
+    //
+    // Align the destination, then store 16 pixels per iteration.
+    while (count && (reinterpret_cast<uintptr_t>(dst) & 15)) {
+        *dst++ = pixel;
+        --count;
+    }
+
+    const __m128i value = _mm_set1_epi32(static_cast<int>(pixel));
+    while (count >= 16) {
+        _mm_store_si128(reinterpret_cast<__m128i*>(dst), value);
+        _mm_store_si128(reinterpret_cast<__m128i*>(dst + 4), value);
+        _mm_store_si128(reinterpret_cast<__m128i*>(dst + 8), value);
+        _mm_store_si128(reinterpret_cast<__m128i*>(dst + 12), value);
+        dst += 16;
+        count -= 16;
+    }
+
+    while (count >= 4) {
+        _mm_store_si128(reinterpret_cast<__m128i*>(dst), value);
+        dst += 4;
+        count -= 4;
+    }
+
+    while (count--)
+        *dst++ = pixel;
+}
+
+void
+sse2_copy_span(
+    uint32_t* dst,
+    const uint32_t* src,
+    size_t count
+    )
+{
+    while (count && (reinterpret_cast<uintptr_t>(dst) & 15)) {
+        *dst++ = *src++;
+        --count;
+    }
+
+    while (count >= 16) {
+        const __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        const __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4));
+        const __m128i p2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+        const __m128i p3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 12));
+        _mm_store_si128(reinterpret_cast<__m128i*>(dst), p0);
+        _mm_store_si128(reinterpret_cast<__m128i*>(dst + 4), p1);
+        _mm_store_si128(reinterpret_cast<__m128i*>(dst + 8), p2);
+        _mm_store_si128(reinterpret_cast<__m128i*>(dst + 12), p3);
+        src += 16;
+        dst += 16;
+        count -= 16;
+    }
+
+    while (count--)
+        *dst++ = *src++;
+}
+
+void
+sse2_blend_solid_span(
+    uint32_t* dst,
+    const uint8_t* coverage,
+    size_t count,
+    uint32_t pixel
+    )
+{
+    const __m128i color = _mm_set1_epi32(static_cast<int>(pixel));
+    const bool opaque = (pixel >> 24) == 0xFF;
+
+    for (; count >= 4; count -= 4, dst += 4, coverage += 4) {
+        const uint32_t cov = load_coverage(coverage);
+        if (!cov)
+            continue;
+
+        __m128i* out = reinterpret_cast<__m128i*>(dst);
+        if (cov == 0xFFFFFFFF && opaque) {
+            _mm_storeu_si128(out, color);
+            continue;
+        }
+
+        const __m128i src = scale_pixels(color, expand_coverage(cov));
+        _mm_storeu_si128(out, source_over(src, _mm_loadu_si128(out)));
+    }
+
+    gfx::detail::scalar_kernels().blend_solid_span_(dst, coverage, count, pixel);
+}
+
+void
+sse2_blend_uniform_span(
+    uint32_t* dst,
+    size_t count,
+    uint32_t src
+    )
+{
+    const __m128i color = _mm_set1_epi32(static_cast<int>(src));
+
+    for (; count >= 4; count -= 4, dst += 4) {
+        __m128i* out = reinterpret_cast<__m128i*>(dst);
+        _mm_storeu_si128(out, source_over(color, _mm_loadu_si128(out)));
+    }
+
+    gfx::detail::scalar_kernels().blend_uniform_span_(dst, count, src);
+}
+
+void
+sse2_blend_span(
+    uint32_t* dst,
+    const uint32_t* src,
+    const uint8_t* coverage,
+    size_t count
+    )
+{
+    for (; count >= 4; count -= 4, dst += 4, src += 4, coverage += 4) {
+        const uint32_t cov = load_coverage(coverage);
+        if (!cov)
+            continue;
+
+        __m128i* out = reinterpret_cast<__m128i*>(dst);
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        if (cov == 0xFFFFFFFF && all_opaque(pixels)) {
+            _mm_storeu_si128(out, pixels);
+            continue;
+        }
+
+        const __m128i scaled = scale_pixels(pixels, expand_coverage(cov));
+        _mm_storeu_si128(out, source_over(scaled, _mm_loadu_si128(out)));
+    }
+
+    gfx::detail::scalar_kernels().blend_span_(dst, src, coverage, count);
+}
+
+const gfx::pixel_kernels C_Sse2Kernels = {
+    gfx::pixel_isa_sse2,
+    "sse2",
+    &sse2_fill_span,
+    &sse2_copy_span,
+    &sse2_blend_solid_span,
+    &sse2_blend_uniform_span,
+    &sse2_blend_span
+};
+
+} // anonymous namespace
+
+const gfx::pixel_kernels&
+gfx::detail::sse2_kernels() {
+    return C_Sse2Kernels;
+}
+
+#endif /* GFX_HAVE_SSE2 */
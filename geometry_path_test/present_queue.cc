@@ -0,0 +1,191 @@
+/*
+ * present_queue.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "present_queue.h"
+#include "trace.h"
+
+#include <cstring>
+
+gfx::headless_presenter::headless_presenter(
+    int width,
+    int height,
+    uint64_t refresh_interval_ns
+    )
+    : pixels_(static_cast<size_t>(width) * height),
+      front_(&pixels_[0], width, height, width),
+      refresh_interval_(refresh_interval_ns),
+      next_refresh_(std::chrono::steady_clock::now())
+{
+    assert(width > 0 && height > 0);
+}
+
+void
+gfx::headless_presenter::present_frame(
+    const present_buffer& buffer
+    )
+{
+    assert(buffer.surface_.width_ == front_.width_);
+    assert(buffer.surface_.height_ == front_.height_);
+
+    if (refresh_interval_.count()) {
+        //
+        // Waits for the next refresh; refreshes missed while idle are
+        // skipped, not caught up with.
+        std::this_thread::sleep_until(next_refresh_);
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        while (next_refresh_ <= now)
+            next_refresh_ += refresh_interval_;
+    }
+
+    for (int y = 0; y < front_.height_; ++y) {
+        std::memcpy(front_.row(y), buffer.surface_.row(y),
+                    static_cast<size_t>(front_.width_) * sizeof(uint32_t));
+    }
+
+    presented_ids_.push_back(buffer.frame_id_);
+}
+
+gfx::present_queue::present_queue(
+    int width,
+    int height,
+    present_policy policy,
+    frame_presenter* presenter
+    )
+    : policy_(policy),
+      presenter_(presenter),
+      buffers_(C_BufferCount),
+      next_frame_id_(0),
+      presenting_(false),
+      stop_(false)
+{
+    assert(width > 0 && height > 0);
+    assert(presenter_);
+
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+        present_buffer& buffer = buffers_[i];
+        buffer.pixels_.resize(static_cast<size_t>(width) * height);
+        buffer.surface_ = pixel_surface(&buffer.pixels_[0], width, height, width);
+        buffer.frame_id_ = 0;
+        free_buffers_.push_back(&buffer);
+    }
+
+    presenter_thread_ = std::thread(&present_queue::presenter_thread_proc, this);
+}
+
+gfx::present_queue::~present_queue() {
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        stop_ = true;
+    }
+    buffer_ready_.notify_one();
+    presenter_thread_.join();
+}
+
+gfx::present_buffer*
+gfx::present_queue::acquire() {
+    std::unique_lock<std::mutex> guard(lock_);
+
+    if (free_buffers_.empty()) {
+        //
+        // With present_latest one buffer at most waits and one is being
+        // presented, so this only happens when a frame is acquired twice.
+        assert(policy_ == present_fifo);
+        ++stats_.render_waits_;
+        buffer_freed_.wait(guard, [this]() { return !free_buffers_.empty(); });
+    }
+
+    present_buffer* buffer = free_buffers_.back();
+    free_buffers_.pop_back();
+    buffer->frame_id_ = next_frame_id_++;
+    buffer->acquired_ = std::chrono::steady_clock::now();
+    return buffer;
+}
+
+void
+gfx::present_queue::submit(
+    present_buffer* buffer
+    )
+{
+    assert(buffer);
+    buffer->submitted_ = std::chrono::steady_clock::now();
+
+    bool dropped = false;
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (policy_ == present_latest) {
+            while (!ready_buffers_.empty()) {
+                free_buffers_.push_back(ready_buffers_.front());
+                ready_buffers_.pop_front();
+                ++stats_.dropped_;
+                dropped = true;
+            }
+        }
+
+        ready_buffers_.push_back(buffer);
+        ++stats_.submitted_;
+    }
+
+    buffer_ready_.notify_one();
+    if (dropped)
+        buffer_freed_.notify_all();
+}
+
+void
+gfx::present_queue::flush() {
+    std::unique_lock<std::mutex> guard(lock_);
+    buffer_freed_.wait(guard, [this]() {
+        return ready_buffers_.empty() && !presenting_;
+    });
+}
+
+gfx::present_statistics
+gfx::present_queue::statistics() const {
+    std::lock_guard<std::mutex> guard(lock_);
+    return stats_;
+}
+
+void
+gfx::present_queue::presenter_thread_proc() {
+    GFX_TRACE_THREAD_NAME("presenter");
+
+    for (;;) {
+        present_buffer* buffer = nullptr;
+        {
+            std::unique_lock<std::mutex> guard(lock_);
+            buffer_ready_.wait(guard, [this]() {
+                return stop_ || !ready_buffers_.empty();
+            });
+
+            if (ready_buffers_.empty())
+                break;
+
+            buffer = ready_buffers_.front();
+            ready_buffers_.pop_front();
+            presenting_ = true;
+        }
+
+        {
+            GFX_TRACE_ZONE("present");
+            presenter_->present_frame(*buffer);
+        }
+
+        const uint64_t latency_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - buffer->acquired_).count());
+
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            ++stats_.presented_;
+            stats_.last_presented_id_ = buffer->frame_id_;
+            stats_.latency_total_ns_ += latency_ns;
+            stats_.latency_max_ns_ = std::max(stats_.latency_max_ns_, latency_ns);
+            presenting_ = false;
+            free_buffers_.push_back(buffer);
+        }
+        buffer_freed_.notify_all();
+    }
+}
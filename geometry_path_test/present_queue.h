@@ -0,0 +1,174 @@
+/*
+ * present_queue.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_PRESENT_QUEUE_H_
+#define GFX_PRESENT_QUEUE_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "software_render_target.h"
+
+namespace gfx {
+
+enum present_policy {
+    //
+    // Every frame is presented, in order. The render thread waits when the
+    // presenter falls two frames behind.
+    present_fifo,
+    //
+    // Only the newest finished frame is presented, the one it replaces is
+    // dropped. The render thread never waits.
+    present_latest
+};
+
+struct present_buffer {
+    std::vector<uint32_t>                   pixels_;
+    pixel_surface                           surface_;
+    uint64_t                                frame_id_;
+    //
+    // When the render thread got the buffer and when it handed it back.
+    std::chrono::steady_clock::time_point   acquired_;
+    std::chrono::steady_clock::time_point   submitted_;
+};
+
+/*
+ * Puts frames on screen (or copies them out). Called on the presenter
+ * thread, returns once the buffer is no longer needed.
+ */
+class frame_presenter {
+public :
+    virtual ~frame_presenter() {}
+
+    virtual void present_frame(const present_buffer& buffer) = 0;
+};
+
+/*
+ * Stand-in for a swap chain : copies every frame into its own front
+ * buffer, at most once per refresh interval (0 for no wait), and records
+ * the ids of the frames presented.
+ */
+class headless_presenter : public frame_presenter {
+public :
+    headless_presenter(int width, int height, uint64_t refresh_interval_ns);
+
+    void present_frame(const present_buffer& buffer);
+
+    /*
+     * Only valid while no frame is being presented, e.g. after
+     * present_queue::flush().
+     */
+    const pixel_surface& front() const {
+        return front_;
+    }
+
+    const std::vector<uint64_t>& presented_ids() const {
+        return presented_ids_;
+    }
+
+private :
+    std::vector<uint32_t>                   pixels_;
+    pixel_surface                           front_;
+    std::chrono::nanoseconds                refresh_interval_;
+    std::chrono::steady_clock::time_point   next_refresh_;
+    std::vector<uint64_t>                   presented_ids_;
+};
+
+struct present_statistics {
+    uint64_t    submitted_;
+    uint64_t    presented_;
+    //
+    // Frames replaced by a newer one before being presented (present_latest).
+    uint64_t    dropped_;
+    //
+    // Times acquire() had to wait for the presenter to free a buffer.
+    uint64_t    render_waits_;
+    uint64_t    last_presented_id_;
+    //
+    // From acquire() to the end of present_frame(), over presented frames.
+    uint64_t    latency_total_ns_;
+    uint64_t    latency_max_ns_;
+
+    present_statistics()
+        : submitted_(0), presented_(0), dropped_(0), render_waits_(0),
+          last_presented_id_(0), latency_total_ns_(0), latency_max_ns_(0) {}
+
+    double average_latency_ns() const {
+        return presented_ ? static_cast<double>(latency_total_ns_) / presented_ : 0.0;
+    }
+};
+
+/*
+ * Rotates three framebuffers between the render thread and a presenter
+ * thread, so the render thread does not stall while a frame is presented :
+ * one is being rendered, one waits, one is being presented.
+ *
+ * Like frame_capture, frames are rendered straight into the buffers (bind
+ * the buffer's surface to a software_render_target) : acquire() a buffer,
+ * render into it, submit() it. Buffers get increasing frame ids when
+ * acquired.
+ */
+class present_queue {
+public :
+    static const size_t C_BufferCount = 3;
+
+    present_queue(int width, int height, present_policy policy, frame_presenter* presenter);
+
+    /*
+     * Presents the frames already submitted, then stops the presenter
+     * thread.
+     */
+    ~present_queue();
+
+    present_buffer* acquire();
+
+    /*
+     * Queues a buffer returned by acquire() for presentation. The render
+     * thread must not touch it afterwards.
+     */
+    void submit(present_buffer* buffer);
+
+    /*
+     * Waits until every submitted frame has been presented (or dropped).
+     */
+    void flush();
+
+    present_policy policy() const {
+        return policy_;
+    }
+
+    present_statistics statistics() const;
+
+private :
+    present_queue(const present_queue&);
+    present_queue& operator=(const present_queue&);
+
+    void presenter_thread_proc();
+
+    present_policy                  policy_;
+    frame_presenter*                presenter_;
+    std::vector<present_buffer>     buffers_;
+    std::vector<present_buffer*>    free_buffers_;
+    std::deque<present_buffer*>     ready_buffers_;
+    mutable std::mutex              lock_;
+    std::condition_variable         buffer_freed_;
+    std::condition_variable         buffer_ready_;
+    present_statistics              stats_;
+    uint64_t                        next_frame_id_;
+    bool                            presenting_;
+    bool                            stop_;
+    std::thread                     presenter_thread_;
+};
+
+} // ns gfx
+
+#endif /* GFX_PRESENT_QUEUE_H_ */
@@ -0,0 +1,193 @@
+/*
+ * quality_controller.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "quality_controller.h"
+
+namespace {
+
+//
+// Weight of the newest frame in the smoothed frame time.
+const double C_Smoothing = 0.2;
+
+const double C_ImproveRatio = 0.7;
+
+//
+// Load lighter than this fraction of the one a step up failed under.
+const double C_LighterLoadRatio = 0.8;
+
+const int C_MaxImproveFrames = 16 * gfx::quality_controller::C_ImproveFrames;
+
+//
+// A step up that held this long resets the wait to C_ImproveFrames.
+const int C_ImproveHeldFrames = 4 * gfx::quality_controller::C_ImproveFrames;
+
+} // anonymous namespace
+
+gfx::quality_controller::quality_controller(
+    uint64_t budget_ns
+    )
+    : budget_ns_(budget_ns),
+      level_(0),
+      smoothed_ns_(0.0),
+      over_count_(0),
+      under_count_(0),
+      settle_count_(0),
+      improve_frames_(C_ImproveFrames),
+      since_improve_(-1),
+      improve_from_ns_(0.0),
+      miss_window_(C_MissWindow, 0),
+      miss_window_pos_(0),
+      miss_count_(0)
+{
+    assert(budget_ns_ > 0);
+
+    std::vector<quality_settings> levels;
+    levels.push_back(quality_settings(8, 0.1f, 0.0f, 1));
+    levels.push_back(quality_settings(4, 0.25f, 0.0f, 1));
+    levels.push_back(quality_settings(4, 0.5f, 1.0f, 2));
+    levels.push_back(quality_settings(2, 1.0f, 2.0f, 4));
+    levels.push_back(quality_settings(1, 2.0f, 4.0f, 8));
+    set_levels(levels);
+}
+
+void
+gfx::quality_controller::set_levels(
+    const std::vector<quality_settings>& levels
+    )
+{
+    assert(!levels.empty());
+    levels_ = levels;
+    level_ = std::min(level_, levels_.size() - 1);
+}
+
+void
+gfx::quality_controller::set_budget(
+    uint64_t budget_ns
+    )
+{
+    assert(budget_ns > 0);
+    budget_ns_ = budget_ns;
+    over_count_ = under_count_ = 0;
+}
+
+void
+gfx::quality_controller::set_level(
+    size_t level
+    )
+{
+    assert(level < levels_.size());
+    level_ = level;
+    over_count_ = under_count_ = 0;
+    settle_count_ = C_SettleFrames;
+    since_improve_ = -1;
+}
+
+void
+gfx::quality_controller::change_level(
+    size_t level
+    )
+{
+    level_ = level;
+    over_count_ = under_count_ = 0;
+    settle_count_ = C_SettleFrames;
+    ++stats_.level_changes_;
+}
+
+void
+gfx::quality_controller::step_down() {
+    assert(level_ + 1 < levels_.size());
+
+    //
+    // The last step up did not hold : wait longer before the next.
+    if (since_improve_ >= 0 && since_improve_ < C_ImproveHeldFrames)
+        improve_frames_ = std::min(improve_frames_ * 2, C_MaxImproveFrames);
+
+    since_improve_ = -1;
+    change_level(level_ + 1);
+}
+
+bool
+gfx::quality_controller::add_frame(
+    uint64_t frame_ns
+    )
+{
+    const bool missed = frame_ns > budget_ns_;
+    miss_count_ += static_cast<int>(missed) - miss_window_[miss_window_pos_];
+    miss_window_[miss_window_pos_] = missed;
+    miss_window_pos_ = (miss_window_pos_ + 1) % miss_window_.size();
+
+    smoothed_ns_ = stats_.frames_ ?
+        smoothed_ns_ + C_Smoothing * (static_cast<double>(frame_ns) - smoothed_ns_) :
+        static_cast<double>(frame_ns);
+    ++stats_.frames_;
+    stats_.budget_misses_ += missed;
+
+    if (since_improve_ >= 0 && since_improve_ < C_ImproveHeldFrames &&
+        ++since_improve_ == C_ImproveHeldFrames)
+        improve_frames_ = C_ImproveFrames;
+
+    if (settle_count_) {
+        --settle_count_;
+
+        //
+        // Right after a step up, frames over budget in a row are enough to
+        // go back : the smoothed time would only show it after a while.
+        if (since_improve_ < 0)
+            return false;
+
+        over_count_ = missed ? over_count_ + 1 : 0;
+        if (over_count_ < C_DegradeFrames)
+            return false;
+
+        step_down();
+        return true;
+    }
+
+    const double budget = static_cast<double>(budget_ns_);
+
+    if (smoothed_ns_ > budget) {
+        under_count_ = 0;
+        if (++over_count_ < C_DegradeFrames || level_ + 1 == levels_.size())
+            return false;
+
+        step_down();
+        return true;
+    }
+
+    over_count_ = 0;
+    if (smoothed_ns_ >= budget * C_ImproveRatio) {
+        under_count_ = 0;
+        return false;
+    }
+
+    if (improve_frames_ > C_ImproveFrames && smoothed_ns_ < improve_from_ns_ * C_LighterLoadRatio)
+        improve_frames_ = C_ImproveFrames;
+
+    if (++under_count_ < improve_frames_ || level_ == 0)
+        return false;
+
+    since_improve_ = 0;
+    improve_from_ns_ = smoothed_ns_;
+    change_level(level_ - 1);
+    return true;
+}
+
+void
+gfx::quality_controller::apply(
+    software_render_target* target
+    ) const
+{
+    assert(target);
+    target->set_sample_count(settings().sample_count_);
+    target->set_flattening_tolerance(settings().flattening_tolerance_);
+}
+
+float
+gfx::quality_controller::budget_miss_rate() const {
+    const size_t frames = std::min<uint64_t>(stats_.frames_, miss_window_.size());
+    return frames ? static_cast<float>(miss_count_) / static_cast<float>(frames) : 0.0f;
+}
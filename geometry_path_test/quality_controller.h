@@ -0,0 +1,180 @@
+/*
+ * quality_controller.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_QUALITY_CONTROLLER_H_
+#define GFX_QUALITY_CONTROLLER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "software_render_target.h"
+
+namespace gfx {
+
+/*
+ * The knobs a quality level sets.
+ */
+struct quality_settings {
+    //
+    // Anti-aliasing scanlines per pixel row (software backend).
+    int     sample_count_;
+    //
+    // Curve flattening tolerance, in pixels.
+    float   flattening_tolerance_;
+    //
+    // Objects smaller than this on screen (largest side, in pixels) are not
+    // drawn; 0 draws everything.
+    float   cull_size_;
+    //
+    // Distant objects are updated once every this many frames.
+    int     distant_update_interval_;
+
+    quality_settings()
+        : sample_count_(4), flattening_tolerance_(0.25f), cull_size_(0.0f),
+          distant_update_interval_(1) {}
+
+    quality_settings(int samples, float tolerance, float cull_size, int update_interval)
+        : sample_count_(samples), flattening_tolerance_(tolerance), cull_size_(cull_size),
+          distant_update_interval_(update_interval) {}
+
+    bool should_draw(float screen_size) const {
+        return screen_size >= cull_size_;
+    }
+
+    /*
+     * Whether a distant object is updated this frame. Objects are spread
+     * over the interval, so the work is the same every frame.
+     */
+    bool distant_update_due(uint64_t frame, size_t object) const {
+        return (frame + object) % static_cast<uint64_t>(distant_update_interval_) == 0;
+    }
+};
+
+struct quality_statistics {
+    uint64_t    frames_;
+    uint64_t    budget_misses_;
+    uint64_t    level_changes_;
+
+    quality_statistics() : frames_(0), budget_misses_(0), level_changes_(0) {}
+};
+
+/*
+ * Holds a frame time budget by moving between quality levels, from 0 (the
+ * best) to level_count() - 1 (the cheapest), instead of dropping frames.
+ *
+ * Frame times are smoothed; the controller steps down a level when the
+ * smoothed time has been over budget for a few frames, and steps back up
+ * only after a long run well under budget. After any change it waits for
+ * the new level to show in the measurements, except that a step up is
+ * undone by a few frames over budget in a row. When stepping up is followed
+ * by a quick step down (the better level does not fit), the wait before
+ * the next try doubles, so a load sitting between two levels does not make
+ * the quality flicker. The wait is back to normal once a step up holds or
+ * the load gets clearly lighter.
+ */
+class quality_controller {
+public :
+    //
+    // Frames over budget before stepping down.
+    static const int C_DegradeFrames = 4;
+    //
+    // Frames well under budget (70 % of it) before stepping up; doubles,
+    // up to 16 times, every time a step up does not hold.
+    static const int C_ImproveFrames = 60;
+    //
+    // Frames ignored after a change, while the smoothed time settles.
+    static const int C_SettleFrames = 8;
+    //
+    // Frames the miss rate is measured over.
+    static const int C_MissWindow = 120;
+
+    explicit quality_controller(uint64_t budget_ns);
+
+    /*
+     * The levels, best first. The default ones go from 8 samples and a
+     * 0.1 pixel tolerance down to 1 sample, 2 pixels, culling under 4
+     * pixels and distant objects updated every 8 frames.
+     */
+    void set_levels(const std::vector<quality_settings>& levels);
+
+    size_t level_count() const {
+        return levels_.size();
+    }
+
+    void set_budget(uint64_t budget_ns);
+
+    uint64_t budget() const {
+        return budget_ns_;
+    }
+
+    /*
+     * Records the time taken by a frame, returns true if the level changed
+     * (the new settings apply to the next frame).
+     */
+    bool add_frame(uint64_t frame_ns);
+
+    size_t level() const {
+        return level_;
+    }
+
+    void set_level(size_t level);
+
+    const quality_settings& settings() const {
+        return levels_[level_];
+    }
+
+    /*
+     * Sets the knobs of the software backend.
+     */
+    void apply(software_render_target* target) const;
+
+    /*
+     * Fraction of the last C_MissWindow frames over budget.
+     */
+    float budget_miss_rate() const;
+
+    double smoothed_frame_time() const {
+        return smoothed_ns_;
+    }
+
+    const quality_statistics& statistics() const {
+        return stats_;
+    }
+
+private :
+    void change_level(size_t level);
+
+    void step_down();
+
+    std::vector<quality_settings>   levels_;
+    uint64_t                        budget_ns_;
+    size_t                          level_;
+    double                          smoothed_ns_;
+    int                             over_count_;
+    int                             under_count_;
+    int                             settle_count_;
+    //
+    // Frames to wait under budget before the next step up, doubled when
+    // a step up does not hold.
+    int                             improve_frames_;
+    //
+    // Frames since the last step up, -1 when the last change was down.
+    int                             since_improve_;
+    //
+    // Smoothed frame time before the last step up : once the load is
+    // clearly lighter than that, the longer wait no longer applies.
+    double                          improve_from_ns_;
+    std::vector<uint8_t>            miss_window_;
+    size_t                          miss_window_pos_;
+    int                             miss_count_;
+    quality_statistics              stats_;
+};
+
+} // ns gfx
+
+#endif /* GFX_QUALITY_CONTROLLER_H_ */
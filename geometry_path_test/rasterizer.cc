@@ -0,0 +1,253 @@
+/*
+ * rasterizer.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "rasterizer.h"
+
+#include <cmath>
+
+const int gfx::scanline_rasterizer::Max_Sample_Count;
+
+gfx::scanline_rasterizer::scanline_rasterizer()
+    : clip_width_(0), clip_height_(0), sample_count_(4),
+      touched_min_(0), touched_max_(-1) {}
+
+void
+gfx::scanline_rasterizer::set_clip(
+    int width,
+    int height
+    )
+{
+    assert(width >= 0 && height >= 0);
+    clip_width_ = width;
+    clip_height_ = height;
+    area_.assign(width + 1, 0.0f);
+    cover_delta_.assign(width + 1, 0.0f);
+    coverage_.resize(width + 1);
+    touched_min_ = clip_width_;
+    touched_max_ = -1;
+}
+
+void
+gfx::scanline_rasterizer::set_sample_count(
+    int samples
+    )
+{
+    sample_count_ = clamp(samples, 1, Max_Sample_Count);
+}
+
+void
+gfx::scanline_rasterizer::add_edge(
+    const vector2& p0,
+    const vector2& p1
+    )
+{
+    if (p0.y_ == p1.y_)
+        return;
+
+    edge e;
+    if (p0.y_ < p1.y_) {
+        e.x_top_ = p0.x_;
+        e.y_top_ = p0.y_;
+        e.y_bottom_ = p1.y_;
+        e.winding_ = 1;
+    } else {
+        e.x_top_ = p1.x_;
+        e.y_top_ = p1.y_;
+        e.y_bottom_ = p0.y_;
+        e.winding_ = -1;
+    }
+    e.dxdy_ = (p1.x_ - p0.x_) / (p1.y_ - p0.y_);
+    edges_.push_back(e);
+}
+
+void
+gfx::scanline_rasterizer::add_polygon(
+    const vector2* points,
+    size_t count
+    )
+{
+    if (count < 3)
+        return;
+
+    for (size_t i = 0; i + 1 < count; ++i)
+        add_edge(points[i], points[i + 1]);
+    add_edge(points[count - 1], points[0]);
+}
+
+void
+gfx::scanline_rasterizer::add_path(
+    const flattened_path& path
+    )
+{
+    for (size_t fig = 0; fig < path.figure_count(); ++fig) {
+        const size_t first = path.figure_begin(fig);
+        add_polygon(&path.points_[first], path.figure_ends_[fig] - first);
+    }
+}
+
+void
+gfx::scanline_rasterizer::accumulate_span(
+    float x0,
+    float x1,
+    float weight
+    )
+{
+    x0 = std::max(x0, 0.0f);
+    x1 = std::min(x1, static_cast<float>(clip_width_));
+    if (!(x1 > x0))
+        return;
+
+    const int ix0 = static_cast<int>(x0);
+    const int ix1 = static_cast<int>(x1);
+
+    if (ix0 == ix1) {
+        area_[ix0] += (x1 - x0) * weight;
+    } else {
+        //
+        // Partial first pixel, full pixels as a run in the cover deltas,
+        // partial last pixel.
+        area_[ix0] += (static_cast<float>(ix0 + 1) - x0) * weight;
+        cover_delta_[ix0 + 1] += weight;
+        cover_delta_[ix1] -= weight;
+        area_[ix1] += (x1 - static_cast<float>(ix1)) * weight;
+    }
+
+    touched_min_ = std::min(touched_min_, ix0);
+    touched_max_ = std::max(touched_max_, ix1);
+}
+
+size_t
+gfx::scanline_rasterizer::emit_row(
+    int y,
+    coverage_sink* sink
+    )
+{
+    if (touched_max_ < touched_min_)
+        return 0;
+
+    //
+    // The last touched index can be clip_width_ (a span ending exactly on
+    // the right edge), it carries no coverage.
+    const int first = touched_min_;
+    const int last = std::min(touched_max_, clip_width_ - 1);
+
+    float cover = 0.0f;
+    size_t covered = 0;
+    int run_start = -1;
+
+    for (int x = first; x <= last; ++x) {
+        cover += cover_delta_[x];
+        const float value = std::min(std::fabs(cover + area_[x]), 1.0f);
+        const uint8_t cov = static_cast<uint8_t>(value * 255.0f + 0.5f);
+        coverage_[x] = cov;
+        cover_delta_[x] = area_[x] = 0.0f;
+
+        if (cov) {
+            ++covered;
+            if (run_start < 0)
+                run_start = x;
+        } else if (run_start >= 0) {
+            sink->coverage_span(y, run_start, x - run_start, &coverage_[run_start]);
+            run_start = -1;
+        }
+    }
+
+    if (run_start >= 0)
+        sink->coverage_span(y, run_start, last + 1 - run_start, &coverage_[run_start]);
+
+    for (int x = last + 1; x <= touched_max_; ++x)
+        cover_delta_[x] = area_[x] = 0.0f;
+
+    touched_min_ = clip_width_;
+    touched_max_ = -1;
+    return covered;
+}
+
+size_t
+gfx::scanline_rasterizer::rasterize(
+    fill_mode mode,
+    coverage_sink* sink
+    )
+{
+    assert(sink);
+    if (edges_.empty() || !clip_width_ || !clip_height_)
+        return 0;
+
+    std::sort(edges_.begin(), edges_.end());
+
+    float y_max = edges_[0].y_bottom_;
+    for (size_t i = 1; i < edges_.size(); ++i)
+        y_max = std::max(y_max, edges_[i].y_bottom_);
+
+    const int row_first = std::max(0, static_cast<int>(std::floor(edges_[0].y_top_)));
+    const int row_last = std::min(clip_height_, static_cast<int>(std::ceil(y_max)));
+
+    const float weight = 1.0f / static_cast<float>(sample_count_);
+    size_t next_edge = 0;
+    size_t covered = 0;
+    active_edges_.clear();
+
+    for (int y = row_first; y < row_last; ++y) {
+        const float row_bottom = static_cast<float>(y + 1);
+
+        while (next_edge < edges_.size() && edges_[next_edge].y_top_ < row_bottom)
+            active_edges_.push_back(next_edge++);
+
+        size_t kept = 0;
+        for (size_t i = 0; i < active_edges_.size(); ++i) {
+            if (edges_[active_edges_[i]].y_bottom_ > static_cast<float>(y))
+                active_edges_[kept++] = active_edges_[i];
+        }
+        active_edges_.resize(kept);
+
+        if (active_edges_.empty())
+            continue;
+
+        for (int s = 0; s < sample_count_; ++s) {
+            const float sample_y = static_cast<float>(y) +
+                (static_cast<float>(s) + 0.5f) * weight;
+
+            crossings_.clear();
+            for (size_t i = 0; i < active_edges_.size(); ++i) {
+                const edge& e = edges_[active_edges_[i]];
+                if (sample_y < e.y_top_ || sample_y >= e.y_bottom_)
+                    continue;
+
+                crossing c;
+                c.x_ = e.x_top_ + (sample_y - e.y_top_) * e.dxdy_;
+                c.winding_ = e.winding_;
+                crossings_.push_back(c);
+            }
+
+            if (crossings_.size() < 2)
+                continue;
+
+            std::sort(crossings_.begin(), crossings_.end());
+
+            int winding = 0;
+            float span_start = 0.0f;
+            for (size_t i = 0; i < crossings_.size(); ++i) {
+                const int prev_winding = winding;
+                winding += crossings_[i].winding_;
+
+                const bool was_inside = mode == fill_mode_alternate ?
+                    (prev_winding & 1) != 0 : prev_winding != 0;
+                const bool is_inside = mode == fill_mode_alternate ?
+                    (winding & 1) != 0 : winding != 0;
+
+                if (!was_inside && is_inside)
+                    span_start = crossings_[i].x_;
+                else if (was_inside && !is_inside)
+                    accumulate_span(span_start, crossings_[i].x_, weight);
+            }
+        }
+
+        covered += emit_row(y, sink);
+    }
+
+    return covered;
+}
@@ -0,0 +1,117 @@
+/*
+ * rasterizer.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_RASTERIZER_H_
+#define GFX_RASTERIZER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "path_geometry.h"
+#include "vector2.h"
+
+namespace gfx {
+
+/*
+ * Receives the output of the rasterizer, one row at a time.
+ */
+class coverage_sink {
+public :
+    virtual ~coverage_sink() {}
+
+    /*
+     * Coverage (0 - 255) of the pixels [x, x + count) on row y.
+     */
+    virtual void coverage_span(int y, int x, int count, const uint8_t* coverage) = 0;
+};
+
+/*
+ * Anti-aliased scanline polygon rasterizer. Every pixel row is sampled by
+ * sample_count() horizontal scanlines; along a scanline, coverage is exact
+ * (fractional at the span ends). Spans are accumulated as area plus cover
+ * deltas, so a long span costs the same as a short one.
+ */
+class scanline_rasterizer {
+public :
+    static const int Max_Sample_Count = 16;
+
+    scanline_rasterizer();
+
+    void set_clip(int width, int height);
+
+    void set_sample_count(int samples);
+
+    int sample_count() const {
+        return sample_count_;
+    }
+
+    void reset() {
+        edges_.clear();
+    }
+
+    /*
+     * Adds a closed polygon, in device coordinates.
+     */
+    void add_polygon(const vector2* points, size_t count);
+
+    void add_path(const flattened_path& path);
+
+    size_t edge_count() const {
+        return edges_.size();
+    }
+
+    /*
+     * Rasterizes everything added since the last reset(). Returns the
+     * number of pixels with non zero coverage that were emitted.
+     */
+    size_t rasterize(fill_mode mode, coverage_sink* sink);
+
+private :
+    struct edge {
+        float   x_top_;
+        float   y_top_;
+        float   y_bottom_;
+        float   dxdy_;
+        int     winding_;
+
+        bool operator<(const edge& rhs) const {
+            return y_top_ < rhs.y_top_;
+        }
+    };
+
+    struct crossing {
+        float   x_;
+        int     winding_;
+
+        bool operator<(const crossing& rhs) const {
+            return x_ < rhs.x_;
+        }
+    };
+
+    void add_edge(const vector2& p0, const vector2& p1);
+
+    void accumulate_span(float x0, float x1, float weight);
+
+    size_t emit_row(int y, coverage_sink* sink);
+
+    int                     clip_width_;
+    int                     clip_height_;
+    int                     sample_count_;
+    std::vector<edge>       edges_;
+    std::vector<size_t>     active_edges_;
+    std::vector<crossing>   crossings_;
+    std::vector<float>      area_;
+    std::vector<float>      cover_delta_;
+    std::vector<uint8_t>    coverage_;
+    int                     touched_min_;
+    int                     touched_max_;
+};
+
+} // ns gfx
+
+#endif /* GFX_RASTERIZER_H_ */
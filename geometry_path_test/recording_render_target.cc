@@ -0,0 +1,323 @@
+/*
+ * recording_render_target.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "recording_render_target.h"
+
+#include <cfloat>
+#include <cmath>
+
+namespace {
+
+//
+// Geometry bounds only need to be conservative, a coarse flattening is
+// enough (the tolerance is added to the bounds).
+const float C_BoundsTolerance = 1.0f;
+
+//
+// Antialiasing may touch the pixel next to an edge.
+const float C_AntialiasMargin = 1.0f;
+
+inline
+bool
+same_transform(
+    const gfx::matrix3X3& lhs,
+    const gfx::matrix3X3& rhs
+    )
+{
+    return lhs.a11_ == rhs.a11_ && lhs.a12_ == rhs.a12_ && lhs.a13_ == rhs.a13_ &&
+        lhs.a21_ == rhs.a21_ && lhs.a22_ == rhs.a22_ && lhs.a23_ == rhs.a23_ &&
+        lhs.a31_ == rhs.a31_ && lhs.a32_ == rhs.a32_ && lhs.a33_ == rhs.a33_;
+}
+
+} // anonymous namespace
+
+gfx::recording_render_target::recording_render_target(
+    render_target* device_target
+    )
+    : device_target_(device_target),
+      transform_(matrix3X3::identity),
+      drawing_(false)
+{
+    assert(device_target_);
+}
+
+void
+gfx::recording_render_target::begin_draw() {
+    assert(!drawing_);
+    drawing_ = true;
+    commands_.clear();
+    transform_ = matrix3X3::identity;
+}
+
+gfx::end_draw_result
+gfx::recording_render_target::end_draw() {
+    assert(drawing_);
+    drawing_ = false;
+    return end_draw_ok;
+}
+
+gfx::draw_command&
+gfx::recording_render_target::add_command(
+    draw_command_type type
+    )
+{
+    assert(drawing_);
+
+    commands_.push_back(draw_command());
+    draw_command& cmd = commands_.back();
+    cmd.type_ = type;
+    cmd.transform_ = transform_;
+    cmd.brush_ = nullptr;
+    cmd.stroke_width_ = 0.0f;
+    cmd.geometry_ = nullptr;
+    cmd.layer_ = nullptr;
+    cmd.device_bounds_ = rectangle(0.0f, 0.0f, static_cast<float>(width()),
+                                   static_cast<float>(height()));
+    return cmd;
+}
+
+gfx::rectangle
+gfx::recording_render_target::device_rectangle(
+    const vector2* points,
+    size_t count,
+    float margin
+    ) const
+{
+    rectangle bounds(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (size_t i = 0; i < count; ++i)
+        bounds.add_point(points[i]);
+
+    //
+    // Out to whole pixels, then clipped.
+    return rectangle(
+        std::max(std::floor(bounds.left_ - margin), 0.0f),
+        std::max(std::floor(bounds.top_ - margin), 0.0f),
+        std::min(std::ceil(bounds.right_ + margin), static_cast<float>(width())),
+        std::min(std::ceil(bounds.bottom_ + margin), static_cast<float>(height())));
+}
+
+void
+gfx::recording_render_target::clear(
+    const color& clear_color
+    )
+{
+    draw_command& cmd = add_command(draw_command_clear);
+    cmd.color_ = clear_color;
+}
+
+void
+gfx::recording_render_target::fill_rectangle(
+    const rectangle& rect,
+    const brush* fill_brush
+    )
+{
+    draw_command& cmd = add_command(draw_command_fill_rectangle);
+    cmd.brush_ = fill_brush;
+    cmd.rect_ = rect;
+
+    const vector2 corners[] = {
+        transform_ * vector2(rect.left_, rect.top_),
+        transform_ * vector2(rect.right_, rect.top_),
+        transform_ * vector2(rect.right_, rect.bottom_),
+        transform_ * vector2(rect.left_, rect.bottom_)
+    };
+    cmd.device_bounds_ = device_rectangle(corners, 4, C_AntialiasMargin);
+}
+
+void
+gfx::recording_render_target::draw_line(
+    const vector2& p0,
+    const vector2& p1,
+    const brush* stroke_brush,
+    float stroke_width
+    )
+{
+    draw_command& cmd = add_command(draw_command_draw_line);
+    cmd.brush_ = stroke_brush;
+    cmd.p0_ = p0;
+    cmd.p1_ = p1;
+    cmd.stroke_width_ = stroke_width;
+
+    //
+    // The stroke is within half the width of the segment, in any direction.
+    const float half_width = stroke_width * 0.5f;
+    const vector2 corners[] = {
+        transform_ * vector2(p0.x_ - half_width, p0.y_ - half_width),
+        transform_ * vector2(p0.x_ + half_width, p0.y_ + half_width),
+        transform_ * vector2(p0.x_ - half_width, p0.y_ + half_width),
+        transform_ * vector2(p0.x_ + half_width, p0.y_ - half_width),
+        transform_ * vector2(p1.x_ - half_width, p1.y_ - half_width),
+        transform_ * vector2(p1.x_ + half_width, p1.y_ + half_width),
+        transform_ * vector2(p1.x_ - half_width, p1.y_ + half_width),
+        transform_ * vector2(p1.x_ + half_width, p1.y_ - half_width)
+    };
+    cmd.device_bounds_ = device_rectangle(corners, 8, C_AntialiasMargin);
+}
+
+void
+gfx::recording_render_target::fill_geometry(
+    const path_geometry& geometry,
+    const brush* fill_brush
+    )
+{
+    draw_command& cmd = add_command(draw_command_fill_geometry);
+    cmd.brush_ = fill_brush;
+    cmd.geometry_ = &geometry;
+
+    geometry.flatten(transform_, C_BoundsTolerance, &flattened_);
+    if (flattened_.points_.empty()) {
+        cmd.device_bounds_ = rectangle(0.0f, 0.0f, 0.0f, 0.0f);
+        return;
+    }
+
+    cmd.device_bounds_ = device_rectangle(
+        &flattened_.points_[0], flattened_.points_.size(),
+        C_BoundsTolerance + C_AntialiasMargin);
+}
+
+void
+gfx::recording_render_target::fill_geometry_instances(
+    const path_geometry& geometry,
+    const matrix3X3* transforms,
+    const color* colors,
+    size_t count
+    )
+{
+    assert(transforms && colors);
+    if (!count)
+        return;
+
+    //
+    // Bounds of the geometry flattened finely enough for the most
+    // magnified copy, widened by the tolerance : each copy is inside its
+    // transformed corners.
+    float max_scale = 0.0f;
+    for (size_t i = 0; i < count; ++i)
+        max_scale = std::max(max_scale, transform_scale_factor(transform_ * transforms[i]));
+    const float local_tolerance =
+        max_scale > EPSILON ? C_BoundsTolerance / max_scale : C_BoundsTolerance;
+
+    geometry.flatten(matrix3X3::identity, local_tolerance, &flattened_);
+    const bool empty = flattened_.points_.empty();
+    rectangle local_bounds(0.0f, 0.0f, 0.0f, 0.0f);
+    if (!empty) {
+        local_bounds = flattened_.bounds();
+        local_bounds.left_ -= local_tolerance;
+        local_bounds.top_ -= local_tolerance;
+        local_bounds.right_ += local_tolerance;
+        local_bounds.bottom_ += local_tolerance;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        draw_command& cmd = add_command(draw_command_fill_geometry_instance);
+        cmd.transform_ = transform_ * transforms[i];
+        cmd.color_ = colors[i];
+        cmd.geometry_ = &geometry;
+
+        if (empty) {
+            cmd.device_bounds_ = rectangle(0.0f, 0.0f, 0.0f, 0.0f);
+            continue;
+        }
+
+        const vector2 corners[] = {
+            cmd.transform_ * vector2(local_bounds.left_, local_bounds.top_),
+            cmd.transform_ * vector2(local_bounds.right_, local_bounds.top_),
+            cmd.transform_ * vector2(local_bounds.right_, local_bounds.bottom_),
+            cmd.transform_ * vector2(local_bounds.left_, local_bounds.bottom_)
+        };
+        cmd.device_bounds_ = device_rectangle(corners, 4, C_AntialiasMargin);
+    }
+}
+
+void
+gfx::recording_render_target::draw_layer(
+    const bitmap_layer* layer
+    )
+{
+    //
+    // Layers are composited at the origin, their size is not known here :
+    // bounded by the whole target.
+    draw_command& cmd = add_command(draw_command_draw_layer);
+    cmd.layer_ = layer;
+}
+
+void
+gfx::recording_render_target::replay(
+    render_target* target
+    ) const
+{
+    assert(target);
+
+    bool transform_set = false;
+    matrix3X3 current(matrix3X3::identity);
+    std::vector<matrix3X3> instance_transforms;
+    std::vector<color> instance_colors;
+
+    for (size_t i = 0; i < commands_.size(); ++i) {
+        const draw_command& cmd = commands_[i];
+
+        if (cmd.type_ == draw_command_fill_geometry_instance) {
+            //
+            // The run of copies of the same geometry, under the identity
+            // (their transforms are complete).
+            instance_transforms.clear();
+            instance_colors.clear();
+            size_t end = i;
+            while (end < commands_.size() &&
+                   commands_[end].type_ == draw_command_fill_geometry_instance &&
+                   commands_[end].geometry_ == cmd.geometry_) {
+                instance_transforms.push_back(commands_[end].transform_);
+                instance_colors.push_back(commands_[end].color_);
+                ++end;
+            }
+
+            if (!transform_set || !same_transform(matrix3X3::identity, current)) {
+                target->set_transform(matrix3X3::identity);
+                current = matrix3X3::identity;
+                transform_set = true;
+            }
+
+            target->fill_geometry_instances(*cmd.geometry_, &instance_transforms[0],
+                                            &instance_colors[0], instance_transforms.size());
+            i = end - 1;
+            continue;
+        }
+
+        if (cmd.type_ != draw_command_clear && cmd.type_ != draw_command_draw_layer &&
+            (!transform_set || !same_transform(cmd.transform_, current))) {
+            target->set_transform(cmd.transform_);
+            current = cmd.transform_;
+            transform_set = true;
+        }
+
+        switch (cmd.type_) {
+        case draw_command_clear :
+            target->clear(cmd.color_);
+            break;
+
+        case draw_command_fill_rectangle :
+            target->fill_rectangle(cmd.rect_, cmd.brush_);
+            break;
+
+        case draw_command_draw_line :
+            target->draw_line(cmd.p0_, cmd.p1_, cmd.brush_, cmd.stroke_width_);
+            break;
+
+        case draw_command_fill_geometry :
+            target->fill_geometry(*cmd.geometry_, cmd.brush_);
+            break;
+
+        case draw_command_draw_layer :
+            target->draw_layer(cmd.layer_);
+            break;
+
+        default :
+            assert(false && "unknown draw command");
+            break;
+        }
+    }
+}
@@ -0,0 +1,141 @@
+/*
+ * recording_render_target.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_RECORDING_RENDER_TARGET_H_
+#define GFX_RECORDING_RENDER_TARGET_H_
+
+#include <vector>
+
+#include "render_target.h"
+
+namespace gfx {
+
+enum draw_command_type {
+    draw_command_clear,
+    draw_command_fill_rectangle,
+    draw_command_draw_line,
+    draw_command_fill_geometry,
+    //
+    // One copy from fill_geometry_instances(), painted with color_; the
+    // transform includes the copy's own.
+    draw_command_fill_geometry_instance,
+    draw_command_draw_layer
+};
+
+/*
+ * One recorded drawing call, with the transform that was current when it
+ * was made. Brushes, geometries and layers are referenced, not copied :
+ * they must stay alive and unchanged until the frame is replayed.
+ */
+struct draw_command {
+    draw_command_type       type_;
+    matrix3X3               transform_;
+    const brush*            brush_;
+    color                   color_;
+    rectangle               rect_;
+    vector2                 p0_;
+    vector2                 p1_;
+    float                   stroke_width_;
+    const path_geometry*    geometry_;
+    const bitmap_layer*     layer_;
+    //
+    // Conservative device space bounds of the pixels the command can
+    // touch, whole pixels, clipped to the target.
+    rectangle               device_bounds_;
+};
+
+/*
+ * Records a frame instead of drawing it, so passes like
+ * eliminate_overdraw() can look at the whole frame before it is replayed
+ * into the real target.
+ *
+ * Layers are created by (and belong to) the target the frame is replayed
+ * into.
+ */
+class recording_render_target : public render_target {
+public :
+    explicit recording_render_target(render_target* device_target);
+
+    std::vector<draw_command>& commands() {
+        return commands_;
+    }
+
+    const std::vector<draw_command>& commands() const {
+        return commands_;
+    }
+
+    /*
+     * Draws the recorded frame into target, between the caller's
+     * begin_draw() and end_draw().
+     */
+    void replay(render_target* target) const;
+
+    int width() const {
+        return device_target_->width();
+    }
+
+    int height() const {
+        return device_target_->height();
+    }
+
+    /*
+     * Starts a new recording, the previous frame is discarded.
+     */
+    void begin_draw();
+
+    end_draw_result end_draw();
+
+    void clear(const color& clear_color);
+
+    void set_transform(const matrix3X3& xform) {
+        transform_ = xform;
+    }
+
+    const matrix3X3& get_transform() const {
+        return transform_;
+    }
+
+    void fill_rectangle(const rectangle& rect, const brush* fill_brush);
+
+    void draw_line(
+        const vector2& p0, const vector2& p1, const brush* stroke_brush,
+        float stroke_width = 1.0f);
+
+    void fill_geometry(const path_geometry& geometry, const brush* fill_brush);
+
+    /*
+     * Records a command per copy, consecutive copies of a geometry are
+     * replayed as one batch.
+     */
+    void fill_geometry_instances(
+        const path_geometry& geometry, const matrix3X3* transforms, const color* colors,
+        size_t count);
+
+    std::shared_ptr<bitmap_layer> create_layer(int width, int height) {
+        return device_target_->create_layer(width, height);
+    }
+
+    void draw_layer(const bitmap_layer* layer);
+
+private :
+    recording_render_target(const recording_render_target&);
+    recording_render_target& operator=(const recording_render_target&);
+
+    draw_command& add_command(draw_command_type type);
+
+    rectangle device_rectangle(const vector2* points, size_t count, float margin) const;
+
+    render_target*              device_target_;
+    matrix3X3                   transform_;
+    std::vector<draw_command>   commands_;
+    flattened_path              flattened_;
+    bool                        drawing_;
+};
+
+} // ns gfx
+
+#endif /* GFX_RECORDING_RENDER_TARGET_H_ */
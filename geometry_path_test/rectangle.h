@@ -0,0 +1,108 @@
+/*
+ * rectangle.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_RECTANGLE_H_
+#define GFX_RECTANGLE_H_
+
+#include <algorithm>
+
+#if defined(D2D_SUPPORT__)
+#include <d2d1.h>
+#endif
+
+#include "vector2.h"
+
+namespace gfx {
+
+/*
+ * Axis aligned rectangle, same layout as a D2D1_RECT_F.
+ */
+class rectangle {
+public :
+    float left_;
+    float top_;
+    float right_;
+    float bottom_;
+
+    rectangle() {}
+
+    rectangle(float left, float top, float right, float bottom)
+        : left_(left), top_(top), right_(right), bottom_(bottom) {}
+
+#if defined(D2D_SUPPORT__)
+    rectangle(const D2D1_RECT_F& d2r)
+        : left_(d2r.left), top_(d2r.top), right_(d2r.right), bottom_(d2r.bottom) {}
+
+    operator D2D1_RECT_F() const {
+        return D2D1::RectF(left_, top_, right_, bottom_);
+    }
+#endif
+
+    float width() const {
+        return right_ - left_;
+    }
+
+    float height() const {
+        return bottom_ - top_;
+    }
+
+    bool is_empty() const {
+        return !(right_ > left_ && bottom_ > top_);
+    }
+
+    vector2 center() const {
+        return vector2((left_ + right_) * 0.5f, (top_ + bottom_) * 0.5f);
+    }
+
+    rectangle& add_point(const vector2& pt) {
+        left_ = std::min(left_, pt.x_);
+        top_ = std::min(top_, pt.y_);
+        right_ = std::max(right_, pt.x_);
+        bottom_ = std::max(bottom_, pt.y_);
+        return *this;
+    }
+};
+
+inline
+bool
+point_in_rectangle(
+    const vector2& pt,
+    const rectangle& rect
+    )
+{
+    return pt.x_ >= rect.left_ && pt.x_ <= rect.right_ &&
+        pt.y_ >= rect.top_ && pt.y_ <= rect.bottom_;
+}
+
+/*
+ * True if inner lies entirely inside outer.
+ */
+inline
+bool
+rectangle_contains(
+    const rectangle& outer,
+    const rectangle& inner
+    )
+{
+    return inner.left_ >= outer.left_ && inner.right_ <= outer.right_ &&
+        inner.top_ >= outer.top_ && inner.bottom_ <= outer.bottom_;
+}
+
+inline
+bool
+rectangles_intersect(
+    const rectangle& lhs,
+    const rectangle& rhs
+    )
+{
+    return lhs.left_ < rhs.right_ && rhs.left_ < lhs.right_ &&
+        lhs.top_ < rhs.bottom_ && rhs.top_ < lhs.bottom_;
+}
+
+} // ns gfx
+
+#endif /* GFX_RECTANGLE_H_ */
@@ -0,0 +1,111 @@
+/*
+ * render_target.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_RENDER_TARGET_H_
+#define GFX_RENDER_TARGET_H_
+
+#include <memory>
+
+#include "brush.h"
+#include "color.h"
+#include "matrix3x3.h"
+#include "path_geometry.h"
+#include "rectangle.h"
+#include "vector2.h"
+
+namespace gfx {
+
+enum end_draw_result {
+    end_draw_ok,
+    //
+    // The device was lost (D2DERR_RECREATE_TARGET), the target and every
+    // resource created from it must be recreated.
+    end_draw_recreate_target,
+    end_draw_failed
+};
+
+class render_target;
+
+/*
+ * Offscreen bitmap created by a render target (an ID2D1BitmapRenderTarget
+ * on Direct2D). It is drawn into through its own render target and then
+ * composited into the target that created it with draw_layer().
+ */
+class bitmap_layer {
+public :
+    virtual ~bitmap_layer() {}
+
+    virtual render_target* target() = 0;
+};
+
+/*
+ * The subset of ID2D1RenderTarget used by the demos. Drawing calls must be
+ * made between begin_draw() and end_draw(); coordinates go through the
+ * current transform, like in Direct2D.
+ */
+class render_target {
+public :
+    virtual ~render_target() {}
+
+    virtual int width() const = 0;
+
+    virtual int height() const = 0;
+
+    virtual void begin_draw() = 0;
+
+    virtual end_draw_result end_draw() = 0;
+
+    virtual void clear(const color& clear_color) = 0;
+
+    virtual void set_transform(const matrix3X3& xform) = 0;
+
+    virtual const matrix3X3& get_transform() const = 0;
+
+    virtual void fill_rectangle(const rectangle& rect, const brush* fill_brush) = 0;
+
+    virtual void draw_line(
+        const vector2& p0, const vector2& p1, const brush* stroke_brush,
+        float stroke_width = 1.0f) = 0;
+
+    virtual void fill_geometry(const path_geometry& geometry, const brush* fill_brush) = 0;
+
+    /*
+     * Fills count copies of geometry, copy i transformed by transforms[i]
+     * (then by the current transform) and painted with colors[i]. Does
+     * what count fill_geometry() calls with solid colour brushes would;
+     * backends that can draw the copies as a batch override it.
+     */
+    virtual void fill_geometry_instances(
+        const path_geometry& geometry, const matrix3X3* transforms, const color* colors,
+        size_t count) {
+        const matrix3X3 xform(get_transform());
+        solid_color_brush instance_brush;
+        for (size_t i = 0; i < count; ++i) {
+            set_transform(xform * transforms[i]);
+            instance_brush.set_color(colors[i]);
+            fill_geometry(geometry, &instance_brush);
+        }
+        set_transform(xform);
+    }
+
+    /*
+     * Creates a layer with the same pixel format as this target, or
+     * returns nullptr. Like every device resource, the layer has to be
+     * recreated together with the target.
+     */
+    virtual std::shared_ptr<bitmap_layer> create_layer(int width, int height) = 0;
+
+    /*
+     * Source over composite of a layer created by this target, at the
+     * device origin (the current transform is ignored).
+     */
+    virtual void draw_layer(const bitmap_layer* layer) = 0;
+};
+
+} // ns gfx
+
+#endif /* GFX_RENDER_TARGET_H_ */
@@ -0,0 +1,123 @@
+/*
+ * simulation.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "simulation.h"
+
+namespace {
+
+//
+// The kernels are plain loops over float arrays, the compiler vectorizes
+// them. No fused multiply-add contraction is relied on : the results must
+// not depend on the code path, for replays to match.
+
+void
+integrate_span(
+    float* position,
+    const float* velocity,
+    size_t count,
+    float dt
+    )
+{
+    for (size_t i = 0; i < count; ++i)
+        position[i] += velocity[i] * dt;
+}
+
+void
+clamp_span(
+    float* position,
+    const float* min_position,
+    const float* max_position,
+    size_t count
+    )
+{
+    for (size_t i = 0; i < count; ++i)
+        position[i] = std::min(std::max(position[i], min_position[i]), max_position[i]);
+}
+
+void
+lerp_span(
+    const float* previous,
+    const float* current,
+    size_t count,
+    float alpha,
+    float* result
+    )
+{
+    for (size_t i = 0; i < count; ++i)
+        result[i] = previous[i] + (current[i] - previous[i]) * alpha;
+}
+
+} // anonymous namespace
+
+size_t
+gfx::kinematic_bodies::add(
+    const vector2& position,
+    const vector2& velocity,
+    const rectangle& bounds
+    )
+{
+    x_.push_back(position.x_);
+    y_.push_back(position.y_);
+    vx_.push_back(velocity.x_);
+    vy_.push_back(velocity.y_);
+    prev_x_.push_back(position.x_);
+    prev_y_.push_back(position.y_);
+    min_x_.push_back(bounds.left_);
+    min_y_.push_back(bounds.top_);
+    max_x_.push_back(bounds.right_);
+    max_y_.push_back(bounds.bottom_);
+    return x_.size() - 1;
+}
+
+void
+gfx::kinematic_bodies::clear() {
+    x_.clear();
+    y_.clear();
+    vx_.clear();
+    vy_.clear();
+    prev_x_.clear();
+    prev_y_.clear();
+    min_x_.clear();
+    min_y_.clear();
+    max_x_.clear();
+    max_y_.clear();
+}
+
+void
+gfx::kinematic_bodies::step(
+    float dt
+    )
+{
+    const size_t n = count();
+    if (!n)
+        return;
+
+    prev_x_ = x_;
+    prev_y_ = y_;
+
+    integrate_span(&x_[0], &vx_[0], n, dt);
+    integrate_span(&y_[0], &vy_[0], n, dt);
+    clamp_span(&x_[0], &min_x_[0], &max_x_[0], n);
+    clamp_span(&y_[0], &min_y_[0], &max_y_[0], n);
+}
+
+void
+gfx::kinematic_bodies::interpolate(
+    float alpha,
+    float* x,
+    float* y
+    ) const
+{
+    assert(x && y);
+
+    const size_t n = count();
+    if (!n)
+        return;
+
+    lerp_span(&prev_x_[0], &x_[0], n, alpha, x);
+    lerp_span(&prev_y_[0], &y_[0], n, alpha, y);
+}
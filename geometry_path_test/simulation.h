@@ -0,0 +1,151 @@
+/*
+ * simulation.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_SIMULATION_H_
+#define GFX_SIMULATION_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "rectangle.h"
+#include "vector2.h"
+
+namespace gfx {
+
+/*
+ * Turns variable frame times into a whole number of fixed simulation
+ * steps. Time is kept in integer nanoseconds, so the number of steps run
+ * after a given total time does not depend on how that time was split
+ * into frames : the simulation is the same at any render rate, and a
+ * replay of the same inputs gives the same states.
+ *
+ * The time left over after the last step is the interpolation factor
+ * between the previous and the current state.
+ */
+class fixed_timestep {
+public :
+    //
+    // At most max_steps are run per frame; if a frame took longer than
+    // that, the extra time is dropped (the simulation slows down instead of
+    // falling further and further behind).
+    explicit fixed_timestep(uint64_t step_ns, int max_steps = 8)
+        : step_ns_(step_ns), max_steps_(max_steps), accumulator_ns_(0), steps_(0) {
+        assert(step_ns_ > 0 && max_steps_ > 0);
+    }
+
+    void reset() {
+        accumulator_ns_ = 0;
+        steps_ = 0;
+    }
+
+    /*
+     * Adds the time since the last frame, returns the number of steps to
+     * simulate for this frame.
+     */
+    int advance(uint64_t elapsed_ns) {
+        accumulator_ns_ += elapsed_ns;
+
+        uint64_t steps = accumulator_ns_ / step_ns_;
+        if (steps > static_cast<uint64_t>(max_steps_)) {
+            steps = max_steps_;
+            accumulator_ns_ = steps * step_ns_;
+        }
+
+        accumulator_ns_ -= steps * step_ns_;
+        steps_ += steps;
+        return static_cast<int>(steps);
+    }
+
+    float step_seconds() const {
+        return static_cast<float>(static_cast<double>(step_ns_) * 1.0e-9);
+    }
+
+    /*
+     * In [0, 1) : how far the render time is past the current state.
+     */
+    float interpolation_alpha() const {
+        return static_cast<float>(static_cast<double>(accumulator_ns_) / step_ns_);
+    }
+
+    uint64_t step_count() const {
+        return steps_;
+    }
+
+private :
+    uint64_t    step_ns_;
+    int         max_steps_;
+    uint64_t    accumulator_ns_;
+    uint64_t    steps_;
+};
+
+/*
+ * Bodies moving at constant velocity, each kept within its own bounds.
+ * The state is stored as one array per component, the integration and
+ * interpolation kernels run over whole arrays.
+ *
+ * The previous state is kept so rendering can interpolate between the
+ * last two steps.
+ */
+class kinematic_bodies {
+public :
+    size_t count() const {
+        return x_.size();
+    }
+
+    /*
+     * bounds limits the position of the body (not its extent), returns the
+     * index of the new body.
+     */
+    size_t add(const vector2& position, const vector2& velocity, const rectangle& bounds);
+
+    void clear();
+
+    void set_velocity(size_t body, const vector2& velocity) {
+        vx_[body] = velocity.x_;
+        vy_[body] = velocity.y_;
+    }
+
+    vector2 velocity(size_t body) const {
+        return vector2(vx_[body], vy_[body]);
+    }
+
+    vector2 position(size_t body) const {
+        return vector2(x_[body], y_[body]);
+    }
+
+    vector2 interpolated_position(size_t body, float alpha) const {
+        return vector2(prev_x_[body] + (x_[body] - prev_x_[body]) * alpha,
+                       prev_y_[body] + (y_[body] - prev_y_[body]) * alpha);
+    }
+
+    /*
+     * Advances every body by dt seconds.
+     */
+    void step(float dt);
+
+    /*
+     * Writes the positions of all bodies, alpha of the way between the
+     * previous and the current step, to x and y (count() elements each).
+     */
+    void interpolate(float alpha, float* x, float* y) const;
+
+private :
+    std::vector<float>  x_;
+    std::vector<float>  y_;
+    std::vector<float>  vx_;
+    std::vector<float>  vy_;
+    std::vector<float>  prev_x_;
+    std::vector<float>  prev_y_;
+    std::vector<float>  min_x_;
+    std::vector<float>  min_y_;
+    std::vector<float>  max_x_;
+    std::vector<float>  max_y_;
+};
+
+} // ns gfx
+
+#endif /* GFX_SIMULATION_H_ */
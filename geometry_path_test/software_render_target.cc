@@ -0,0 +1,754 @@
+/*
+ * software_render_target.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "software_render_target.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#include "pixel_ops.h"
+
+namespace {
+
+inline
+uint8_t
+to_coverage(
+    float value
+    )
+{
+    return static_cast<uint8_t>(gfx::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+gfx::rectangle
+bounding_rectangle(
+    const gfx::vector2* points,
+    size_t count
+    )
+{
+    gfx::rectangle bbox(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (size_t i = 0; i < count; ++i)
+        bbox.add_point(points[i]);
+    return bbox;
+}
+
+/*
+ * The pixels [*x0, *x1) of row y whose centres fall between the edges of
+ * a convex polygon, clipped to [0, width). False when there are none.
+ */
+bool
+convex_row_span(
+    const gfx::vector2* points,
+    size_t count,
+    int y,
+    int width,
+    int* x0,
+    int* x1
+    )
+{
+    const float cy = static_cast<float>(y) + 0.5f;
+    float x_min = FLT_MAX;
+    float x_max = -FLT_MAX;
+    for (size_t e = 0; e < count; ++e) {
+        const gfx::vector2& p0 = points[e];
+        const gfx::vector2& p1 = points[e + 1 < count ? e + 1 : 0];
+        if ((p0.y_ <= cy) == (p1.y_ <= cy))
+            continue;
+        const float x = p0.x_ + (cy - p0.y_) * (p1.x_ - p0.x_) / (p1.y_ - p0.y_);
+        x_min = std::min(x_min, x);
+        x_max = std::max(x_max, x);
+    }
+
+    *x0 = std::max(0, static_cast<int>(std::floor(x_min)));
+    *x1 = std::min(width, static_cast<int>(std::ceil(x_max)));
+    return *x0 < *x1;
+}
+
+} // anonymous namespace
+
+gfx::software_render_target::software_render_target(
+    int width,
+    int height
+    )
+    : storage_(static_cast<size_t>(width) * height),
+      transform_(matrix3X3::identity),
+      field_resolution_(0),
+      sprites_enabled_(false),
+      tolerance_(0.25f),
+      fill_pixel_(0),
+      shader_(nullptr),
+      drawing_(false)
+{
+    assert(width > 0 && height > 0);
+    bind_surface(pixel_surface(&storage_[0], width, height, width));
+}
+
+gfx::software_render_target::software_render_target(
+    const pixel_surface& surface
+    )
+    : transform_(matrix3X3::identity),
+      field_resolution_(0),
+      sprites_enabled_(false),
+      tolerance_(0.25f),
+      fill_pixel_(0),
+      shader_(nullptr),
+      drawing_(false)
+{
+    bind_surface(surface);
+}
+
+void
+gfx::software_render_target::bind_surface(
+    const pixel_surface& surface
+    )
+{
+    assert(!drawing_);
+    assert(surface.pixels_ && surface.stride_ >= surface.width_);
+
+    if (surface.width_ != surface_.width_ || surface.height_ != surface_.height_) {
+        rasterizer_.set_clip(surface.width_, surface.height_);
+        shaded_row_.resize(surface.width_);
+        coverage_row_.resize(surface.width_);
+    }
+    surface_ = surface;
+}
+
+void
+gfx::software_render_target::begin_draw() {
+    assert(!drawing_);
+    drawing_ = true;
+}
+
+gfx::end_draw_result
+gfx::software_render_target::end_draw() {
+    assert(drawing_);
+    drawing_ = false;
+    ++stats_.frames_;
+    return end_draw_ok;
+}
+
+void
+gfx::software_render_target::clear(
+    const color& clear_color
+    )
+{
+    assert(drawing_);
+    ++stats_.draw_calls_;
+
+    //
+    // Like ID2D1RenderTarget::Clear, replaces the pixels and ignores the
+    // transform.
+    const uint32_t pixel = pack_premultiplied_rgba8(clear_color);
+    for (int y = 0; y < surface_.height_; ++y)
+        fill_span(surface_.row(y), surface_.width_, pixel);
+
+    stats_.pixels_filled_ += static_cast<uint64_t>(surface_.width_) * surface_.height_;
+}
+
+void
+gfx::software_render_target::fill_rectangle(
+    const rectangle& rect,
+    const brush* fill_brush
+    )
+{
+    assert(drawing_);
+    ++stats_.draw_calls_;
+    set_fill_brush(fill_brush);
+
+    const vector2 corners[] = {
+        transform_ * vector2(rect.left_, rect.top_),
+        transform_ * vector2(rect.right_, rect.top_),
+        transform_ * vector2(rect.right_, rect.bottom_),
+        transform_ * vector2(rect.left_, rect.bottom_)
+    };
+
+    if (transform_is_axis_aligned())
+        fill_device_rectangle(bounding_rectangle(corners, 4));
+    else
+        fill_polygon(corners, 4, fill_mode_winding);
+}
+
+void
+gfx::software_render_target::draw_line(
+    const vector2& p0,
+    const vector2& p1,
+    const brush* stroke_brush,
+    float stroke_width
+    )
+{
+    assert(drawing_);
+    ++stats_.draw_calls_;
+
+    const vector2 direction(p1 - p0);
+    const float length = direction.magnitude();
+    if (is_zero(length))
+        return;
+
+    set_fill_brush(stroke_brush);
+
+    //
+    // Flat caps, the stroke is the rectangle around the segment.
+    const vector2 offset(ortho_from(direction / length) * (stroke_width * 0.5f));
+    const vector2 corners[] = {
+        transform_ * (p0 + offset),
+        transform_ * (p1 + offset),
+        transform_ * (p1 - offset),
+        transform_ * (p0 - offset)
+    };
+
+    if (transform_is_axis_aligned() &&
+        (direction.x_ == 0.0f || direction.y_ == 0.0f))
+        fill_device_rectangle(bounding_rectangle(corners, 4));
+    else
+        fill_polygon(corners, 4, fill_mode_winding);
+}
+
+void
+gfx::software_render_target::fill_geometry(
+    const path_geometry& geometry,
+    const brush* fill_brush
+    )
+{
+    assert(drawing_);
+    ++stats_.draw_calls_;
+    set_fill_brush(fill_brush);
+
+    if (field_resolution_) {
+        draw_distance_field(distance_fields_.find(geometry, field_resolution_), transform_);
+        return;
+    }
+
+    if (draw_from_atlas(geometry, transform_))
+        return;
+
+    lod_cache_.flatten(geometry, transform_, tolerance_, &flattened_);
+    rasterizer_.reset();
+    rasterizer_.add_path(flattened_);
+    rasterizer_.rasterize(flattened_.fill_mode_, this);
+}
+
+void
+gfx::software_render_target::fill_distance_field(
+    const distance_field& field,
+    const brush* fill_brush
+    )
+{
+    assert(drawing_);
+    ++stats_.draw_calls_;
+    set_fill_brush(fill_brush);
+    draw_distance_field(field, transform_);
+}
+
+void
+gfx::software_render_target::fill_geometry_instances(
+    const path_geometry& geometry,
+    const matrix3X3* transforms,
+    const color* colors,
+    size_t count
+    )
+{
+    assert(drawing_);
+    assert(transforms && colors);
+    ++stats_.draw_calls_;
+
+    instance_transforms_.resize(count);
+    float max_scale = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        instance_transforms_[i] = transform_ * transforms[i];
+        max_scale = std::max(max_scale, transform_scale_factor(instance_transforms_[i]));
+    }
+
+    const float local_tolerance = max_scale > EPSILON ? tolerance_ / max_scale : tolerance_;
+    const flattened_path& lod = lod_cache_.find_lod(geometry, local_tolerance);
+    if (lod.empty())
+        return;
+
+    const rectangle local_bounds(lod.bounds());
+    const vector2 local_corners[] = {
+        vector2(local_bounds.left_, local_bounds.top_),
+        vector2(local_bounds.right_, local_bounds.top_),
+        vector2(local_bounds.right_, local_bounds.bottom_),
+        vector2(local_bounds.left_, local_bounds.bottom_)
+    };
+    const float width = static_cast<float>(surface_.width_);
+    const float height = static_cast<float>(surface_.height_);
+
+    //
+    // Same as fill_geometry() : in distance field mode, every instance is
+    // drawn from the geometry's field.
+    const distance_field* field = field_resolution_ ?
+        &distance_fields_.find(geometry, field_resolution_) : nullptr;
+
+    shader_ = nullptr;
+    flattened_.fill_mode_ = lod.fill_mode_;
+    flattened_.figure_ends_ = lod.figure_ends_;
+    flattened_.points_.resize(lod.points_.size());
+
+    for (size_t i = 0; i < count; ++i) {
+        const matrix3X3& xform = instance_transforms_[i];
+        const vector2 corners[] = {
+            xform * local_corners[0], xform * local_corners[1],
+            xform * local_corners[2], xform * local_corners[3]
+        };
+        const rectangle device_bounds(bounding_rectangle(corners, 4));
+        if (device_bounds.right_ <= 0.0f || device_bounds.bottom_ <= 0.0f ||
+            device_bounds.left_ >= width || device_bounds.top_ >= height) {
+            ++stats_.instances_culled_;
+            continue;
+        }
+
+        fill_pixel_ = pack_premultiplied_rgba8(colors[i]);
+        if (field) {
+            draw_distance_field(*field, xform);
+            ++stats_.instances_drawn_;
+            continue;
+        }
+
+        if (draw_from_atlas(geometry, xform)) {
+            ++stats_.instances_drawn_;
+            continue;
+        }
+
+        for (size_t p = 0; p < lod.points_.size(); ++p)
+            flattened_.points_[p] = xform * lod.points_[p];
+
+        rasterizer_.reset();
+        rasterizer_.add_path(flattened_);
+        rasterizer_.rasterize(flattened_.fill_mode_, this);
+        ++stats_.instances_drawn_;
+    }
+}
+
+std::shared_ptr<gfx::bitmap_layer>
+gfx::software_render_target::create_layer(
+    int width,
+    int height
+    )
+{
+    if (width <= 0 || height <= 0)
+        return nullptr;
+
+    std::shared_ptr<software_bitmap_layer> layer(new software_bitmap_layer(width, height));
+    software_render_target* layer_target =
+        static_cast<software_render_target*>(layer->target());
+    layer_target->set_sample_count(sample_count());
+    layer_target->set_flattening_tolerance(tolerance_);
+    layer_target->lod_cache().set_budget(lod_cache_.budget());
+    return layer;
+}
+
+void
+gfx::software_render_target::draw_layer(
+    const bitmap_layer* layer
+    )
+{
+    assert(drawing_);
+    assert(layer);
+    ++stats_.draw_calls_;
+
+    const pixel_surface& source =
+        static_cast<const software_bitmap_layer*>(layer)->software_target().surface();
+    const int width = std::min(source.width_, surface_.width_);
+    const int height = std::min(source.height_, surface_.height_);
+    if (width <= 0 || height <= 0)
+        return;
+
+    //
+    // Full coverage : the blend kernels store opaque runs directly, so an
+    // opaque layer costs about as much as a copy.
+    std::memset(&coverage_row_[0], 0xFF, width);
+    for (int y = 0; y < height; ++y)
+        blend_span(surface_.row(y), source.row(y), &coverage_row_[0], width);
+
+    stats_.pixels_composited_ += static_cast<uint64_t>(width) * height;
+}
+
+void
+gfx::software_render_target::set_fill_brush(
+    const brush* fill_brush
+    )
+{
+    assert(fill_brush);
+    shader_ = nullptr;
+
+    switch (fill_brush->type()) {
+    case brush_type_solid_color :
+        fill_pixel_ = pack_premultiplied_rgba8(
+            static_cast<const solid_color_brush*>(fill_brush)->get_color());
+        break;
+
+    case brush_type_linear_gradient :
+    case brush_type_radial_gradient : {
+        const gradient_brush* gradient = static_cast<const gradient_brush*>(fill_brush);
+        device_to_brush_ = transform_ * gradient->get_transform();
+        if (device_to_brush_.is_invertible()) {
+            device_to_brush_.invert();
+            shader_ = gradient;
+        } else {
+            //
+            // Collapsed brush space, nothing to paint with.
+            fill_pixel_ = 0;
+        }
+        }
+        break;
+
+    default :
+        assert(false && "unsupported brush type");
+        break;
+    }
+}
+
+void
+gfx::software_render_target::coverage_span(
+    int y,
+    int x,
+    int count,
+    const uint8_t* coverage
+    )
+{
+    if (shader_) {
+        shader_->shade_span(device_to_brush_, x, y, count, &shaded_row_[0]);
+        blend_span(surface_.row(y) + x, &shaded_row_[0], coverage, count);
+    } else {
+        blend_solid_span(surface_.row(y) + x, coverage, count, fill_pixel_);
+    }
+    stats_.pixels_blended_ += count;
+}
+
+void
+gfx::software_render_target::fill_polygon(
+    const vector2* points,
+    size_t count,
+    fill_mode mode
+    )
+{
+    rasterizer_.reset();
+    rasterizer_.add_polygon(points, count);
+    rasterizer_.rasterize(mode, this);
+}
+
+void
+gfx::software_render_target::draw_distance_field(
+    const distance_field& field,
+    const matrix3X3& xform
+    )
+{
+    if (field.empty() || !xform.is_invertible())
+        return;
+
+    matrix3X3 device_to_local(xform);
+    device_to_local.invert();
+
+    //
+    // Local distances to device pixels, exact for scales and rotations.
+    // A transform that stretches some directions more than others turns
+    // them through the gradient instead, bounded by the smallest and
+    // largest stretch.
+    const float scale = transform_scale_factor(xform);
+    const float min_scale = transform_min_scale_factor(xform);
+    const bool similarity = scale - min_scale <= scale * 1.0e-3f;
+    const rectangle local(field.bounds());
+    const vector2 quad[] = {
+        xform * vector2(local.left_, local.top_),
+        xform * vector2(local.right_, local.top_),
+        xform * vector2(local.right_, local.bottom_),
+        xform * vector2(local.left_, local.bottom_)
+    };
+    const rectangle device(bounding_rectangle(quad, 4));
+    const int row_first = std::max(0, static_cast<int>(std::floor(device.top_)));
+    const int row_last = std::min(surface_.height_, static_cast<int>(std::ceil(device.bottom_)));
+
+    //
+    // Grid coordinates of a pixel centre, and their steps along a row.
+    const float inv_cell = 1.0f / field.cell_size();
+    const float step_x = device_to_local.a11_ * inv_cell;
+    const float step_y = device_to_local.a21_ * inv_cell;
+    const float row_step_x = device_to_local.a12_ * inv_cell;
+    const float row_step_y = device_to_local.a22_ * inv_cell;
+    const int grid_width = field.width();
+    const int grid_height = field.height();
+    const float max_gx = static_cast<float>(grid_width - 1);
+    const float max_gy = static_cast<float>(grid_height - 1);
+    const float* distances = field.distances();
+
+    for (int y = row_first; y < row_last; ++y) {
+        int ix0;
+        int ix1;
+        if (!convex_row_span(quad, 4, y, surface_.width_, &ix0, &ix1))
+            continue;
+
+        const float cy = static_cast<float>(y) + 0.5f;
+        const vector2 start(device_to_local * vector2(static_cast<float>(ix0) + 0.5f, cy));
+        float gx = (start.x_ - field.origin().x_) * inv_cell;
+        float gy = (start.y_ - field.origin().y_) * inv_cell;
+
+        //
+        // Runs of covered pixels go to coverage_span(). Far from the
+        // outline, the distance tells how many pixels ahead keep the same
+        // coverage : the interpolated field changes by at most sqrt(2) per
+        // cell, 1.5 pixels per pixel to be safe. The outline is at least
+        // the local distance times the smallest stretch away.
+        int run_start = -1;
+        int x = ix0;
+        while (x < ix1) {
+            uint8_t coverage = 0;
+            int same = 1;
+            if (gx >= 0.0f && gy >= 0.0f && gx <= max_gx && gy <= max_gy) {
+                const int x0 = std::min(static_cast<int>(gx), grid_width - 2);
+                const int y0 = std::min(static_cast<int>(gy), grid_height - 2);
+                const float fx = gx - static_cast<float>(x0);
+                const float fy = gy - static_cast<float>(y0);
+                const float* row0 = distances + static_cast<size_t>(y0) * grid_width + x0;
+                const float* row1 = row0 + grid_width;
+                const float top = row0[0] + (row0[1] - row0[0]) * fx;
+                const float bottom = row1[0] + (row1[1] - row1[0]) * fx;
+                const float local_distance = top + (bottom - top) * fy;
+                float distance = local_distance * scale;
+                if (!similarity) {
+                    //
+                    // Local distance per device pixel, along x and y.
+                    const float dx = (row0[1] - row0[0]) +
+                        ((row1[1] - row1[0]) - (row0[1] - row0[0])) * fy;
+                    const float dy = bottom - top;
+                    const float per_x = dx * step_x + dy * step_y;
+                    const float per_y = dx * row_step_x + dy * row_step_y;
+                    const float gradient = std::min(1.0f / min_scale, std::max(1.0f / scale,
+                        std::sqrt(per_x * per_x + per_y * per_y)));
+                    distance = local_distance / gradient;
+                }
+
+                coverage = to_coverage(0.5f - distance);
+                const float nearest = std::fabs(local_distance) * min_scale;
+                if (nearest > 2.0f) {
+                    same = std::min(ix1 - x, std::max(1, static_cast<int>(
+                        (nearest - 0.5f) * (1.0f / 1.5f))));
+                }
+            }
+
+            if (coverage) {
+                std::memset(&coverage_row_[x], coverage, same);
+                if (run_start < 0)
+                    run_start = x;
+            } else if (run_start >= 0) {
+                coverage_span(y, run_start, x - run_start, &coverage_row_[run_start]);
+                run_start = -1;
+            }
+
+            x += same;
+            gx += step_x * static_cast<float>(same);
+            gy += step_y * static_cast<float>(same);
+        }
+
+        if (run_start >= 0)
+            coverage_span(y, run_start, ix1 - run_start, &coverage_row_[run_start]);
+    }
+}
+
+bool
+gfx::software_render_target::draw_from_atlas(
+    const path_geometry& geometry,
+    const matrix3X3& xform
+    )
+{
+    if (!sprites_enabled_)
+        return false;
+
+    const atlas_sprite* sprite = sprite_atlas_.find(geometry, xform);
+    if (!sprite)
+        return false;
+
+    draw_sprite(*sprite, xform);
+    return true;
+}
+
+void
+gfx::software_render_target::draw_sprite(
+    const atlas_sprite& sprite,
+    const matrix3X3& xform
+    )
+{
+    //
+    // Device pixels to page pixels : back to local space, then into the
+    // sprite.
+    matrix3X3 device_to_local(xform);
+    if (!device_to_local.is_invertible())
+        return;
+    device_to_local.invert();
+    const matrix3X3 device_to_page(sprite.local_to_page_ * device_to_local);
+    matrix3X3 page_to_device(device_to_page);
+    page_to_device.invert();
+
+    //
+    // Only the pixels inside the octagon around the coverage sample
+    // anything : the slot's corners and border are skipped.
+    vector2 outline[atlas_sprite::C_OutlinePoints];
+    for (size_t i = 0; i < atlas_sprite::C_OutlinePoints; ++i)
+        outline[i] = page_to_device * sprite.outline_[i];
+    const rectangle device(bounding_rectangle(outline, atlas_sprite::C_OutlinePoints));
+    const int row_first = std::max(0, static_cast<int>(std::floor(device.top_)));
+    const int row_last = std::min(surface_.height_, static_cast<int>(std::ceil(device.bottom_)));
+
+    const uint8_t* page = sprite_atlas_.page_coverage(sprite.page_);
+    const int stride = sprite_atlas::C_PageSize;
+    //
+    // Page positions in 16.16 fixed point. Texel centres are at half
+    // pixels; sampling positions are clamped to the slot, whose border is
+    // empty.
+    const float C_One = 65536.0f;
+    const int32_t min_u = sprite.x_ << 16;
+    const int32_t min_v = sprite.y_ << 16;
+    const int32_t max_u = (sprite.x_ + sprite.width_ - 2) << 16;
+    const int32_t max_v = (sprite.y_ + sprite.height_ - 2) << 16;
+    const int32_t step_u = static_cast<int32_t>(device_to_page.a11_ * C_One);
+    const int32_t step_v = static_cast<int32_t>(device_to_page.a21_ * C_One);
+    const bool unrotated = step_u == (1 << 16) && step_v == 0;
+
+    for (int y = row_first; y < row_last; ++y) {
+        int ix0;
+        int ix1;
+        if (!convex_row_span(outline, atlas_sprite::C_OutlinePoints, y, surface_.width_,
+                             &ix0, &ix1))
+            continue;
+
+        const vector2 start(device_to_page *
+                            vector2(static_cast<float>(ix0) + 0.5f, static_cast<float>(y) + 0.5f));
+        int32_t u = static_cast<int32_t>((start.x_ - 0.5f) * C_One);
+        int32_t v = static_cast<int32_t>((start.y_ - 0.5f) * C_One);
+
+        //
+        // At the sprite's own scale and rotation, on whole pixels, every
+        // pixel samples a texel centre : the page row is the coverage.
+        // Only one texel is read, the whole slot can be.
+        const int count = ix1 - ix0;
+        const uint8_t* coverage = &coverage_row_[ix0];
+        if (unrotated && !(u & 0xFFFF) && !(v & 0xFFFF) && u >= min_u && v >= min_v &&
+            v <= max_v + (1 << 16) && u + ((count - 1) << 16) <= max_u + (1 << 16)) {
+            coverage = page + static_cast<size_t>(v >> 16) * stride + (u >> 16);
+        } else {
+            uint8_t* filtered = &coverage_row_[ix0];
+            for (int i = 0; i < count; ++i, u += step_u, v += step_v) {
+                const int32_t cu = clamp(u, min_u, max_u);
+                const int32_t cv = clamp(v, min_v, max_v);
+                const uint32_t wu = (cu >> 8) & 0xFF;
+                const uint32_t wv = (cv >> 8) & 0xFF;
+                const uint8_t* texel = page + static_cast<size_t>(cv >> 16) * stride + (cu >> 16);
+                const uint32_t top = texel[0] * (256 - wu) + texel[1] * wu;
+                const uint32_t bottom = texel[stride] * (256 - wu) + texel[stride + 1] * wu;
+                filtered[i] = static_cast<uint8_t>((top * (256 - wv) + bottom * wv) >> 16);
+            }
+        }
+
+        //
+        // The octagon reaches around the shape : only the covered part of
+        // the row goes to coverage_span(). Gaps inside it blend nothing.
+        int first = 0;
+        int last = count;
+        while (first < last && !coverage[first])
+            ++first;
+        while (last > first && !coverage[last - 1])
+            --last;
+        if (first < last)
+            coverage_span(y, ix0 + first, last - first, coverage + first);
+    }
+}
+
+void
+gfx::software_render_target::fill_device_rectangle(
+    const rectangle& rect
+    )
+{
+    const float x0 = std::max(rect.left_, 0.0f);
+    const float y0 = std::max(rect.top_, 0.0f);
+    const float x1 = std::min(rect.right_, static_cast<float>(surface_.width_));
+    const float y1 = std::min(rect.bottom_, static_cast<float>(surface_.height_));
+    if (!(x1 > x0) || !(y1 > y0))
+        return;
+
+    if (shader_) {
+        shade_device_rectangle(x0, y0, x1, y1);
+        return;
+    }
+
+    //
+    // [ix0, ix1) are the touched columns, [fx0, fx1) the fully covered ones.
+    const int ix0 = static_cast<int>(x0);
+    const int ix1 = static_cast<int>(std::ceil(x1));
+    const int fx0 = static_cast<int>(std::ceil(x0));
+    const int fx1 = static_cast<int>(x1);
+    const int iy0 = static_cast<int>(y0);
+    const int iy1 = static_cast<int>(std::ceil(y1));
+    const bool opaque = (fill_pixel_ >> 24) == 0xFF;
+
+    for (int y = iy0; y < iy1; ++y) {
+        const float cov_y = std::min(y1, static_cast<float>(y + 1)) -
+            std::max(y0, static_cast<float>(y));
+        uint32_t* row = surface_.row(y);
+
+        if (ix1 - ix0 == 1) {
+            blend_solid_span(row + ix0, to_coverage((x1 - x0) * cov_y), 1, fill_pixel_);
+            ++stats_.pixels_blended_;
+            continue;
+        }
+
+        if (fx0 > ix0) {
+            blend_solid_span(row + ix0, to_coverage((fx0 - x0) * cov_y), 1, fill_pixel_);
+            ++stats_.pixels_blended_;
+        }
+
+        if (fx1 > fx0) {
+            const uint8_t cov = to_coverage(cov_y);
+            blend_solid_span(row + fx0, cov, fx1 - fx0, fill_pixel_);
+            if (opaque && cov == 0xFF)
+                stats_.pixels_filled_ += fx1 - fx0;
+            else
+                stats_.pixels_blended_ += fx1 - fx0;
+        }
+
+        if (ix1 > fx1) {
+            blend_solid_span(row + fx1, to_coverage((x1 - fx1) * cov_y), 1, fill_pixel_);
+            ++stats_.pixels_blended_;
+        }
+    }
+}
+
+void
+gfx::software_render_target::shade_device_rectangle(
+    float x0,
+    float y0,
+    float x1,
+    float y1
+    )
+{
+    //
+    // Same coverage as the solid path, but every row is shaded, so the
+    // coverage is built for the whole row and goes through coverage_span.
+    const int ix0 = static_cast<int>(x0);
+    const int ix1 = static_cast<int>(std::ceil(x1));
+    const int fx0 = static_cast<int>(std::ceil(x0));
+    const int fx1 = static_cast<int>(x1);
+    const int iy0 = static_cast<int>(y0);
+    const int iy1 = static_cast<int>(std::ceil(y1));
+
+    for (int y = iy0; y < iy1; ++y) {
+        const float cov_y = std::min(y1, static_cast<float>(y + 1)) -
+            std::max(y0, static_cast<float>(y));
+        uint8_t* coverage = &coverage_row_[ix0];
+
+        if (ix1 - ix0 == 1) {
+            coverage[0] = to_coverage((x1 - x0) * cov_y);
+        } else {
+            if (fx1 > fx0)
+                std::memset(coverage + (fx0 - ix0), to_coverage(cov_y), fx1 - fx0);
+            if (fx0 > ix0)
+                coverage[0] = to_coverage((fx0 - x0) * cov_y);
+            if (ix1 > fx1)
+                coverage[ix1 - 1 - ix0] = to_coverage((x1 - fx1) * cov_y);
+        }
+
+        coverage_span(y, ix0, ix1 - ix0, coverage);
+    }
+}
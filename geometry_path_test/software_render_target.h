@@ -0,0 +1,313 @@
+/*
+ * software_render_target.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_SOFTWARE_RENDER_TARGET_H_
+#define GFX_SOFTWARE_RENDER_TARGET_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "distance_field.h"
+#include "geometry_lod_cache.h"
+#include "gradient_brush.h"
+#include "rasterizer.h"
+#include "render_target.h"
+#include "sprite_atlas.h"
+
+namespace gfx {
+
+/*
+ * Non owning view of a premultiplied RGBA8 pixel buffer. The stride is in
+ * pixels.
+ */
+struct pixel_surface {
+    uint32_t*   pixels_;
+    int         width_;
+    int         height_;
+    int         stride_;
+
+    pixel_surface() : pixels_(nullptr), width_(0), height_(0), stride_(0) {}
+
+    pixel_surface(uint32_t* pixels, int width, int height, int stride)
+        : pixels_(pixels), width_(width), height_(height), stride_(stride) {}
+
+    uint32_t* row(int y) const {
+        return pixels_ + static_cast<ptrdiff_t>(y) * stride_;
+    }
+};
+
+/*
+ * Counts the pixel work done by a software_render_target.
+ */
+struct fill_statistics {
+    uint64_t    frames_;
+    uint64_t    draw_calls_;
+    //
+    // Pixels stored without reading the destination (clears, opaque spans).
+    uint64_t    pixels_filled_;
+    //
+    // Pixels blended source over the destination.
+    uint64_t    pixels_blended_;
+    //
+    // Pixels of cached layers composited into the target.
+    uint64_t    pixels_composited_;
+    //
+    // Copies drawn by fill_geometry_instances() and those skipped because
+    // they were outside the target.
+    uint64_t    instances_drawn_;
+    uint64_t    instances_culled_;
+
+    fill_statistics() {
+        reset();
+    }
+
+    void reset() {
+        frames_ = draw_calls_ = pixels_filled_ = pixels_blended_ = pixels_composited_ = 0;
+        instances_drawn_ = instances_culled_ = 0;
+    }
+
+    uint64_t pixels_written() const {
+        return pixels_filled_ + pixels_blended_ + pixels_composited_;
+    }
+};
+
+/*
+ * Renders into memory, as premultiplied RGBA8 (the format the demos ask
+ * Direct2D for). Runs anywhere, no device needed.
+ *
+ * Clears and axis aligned rectangles (which includes horizontal and
+ * vertical lines under an axis aligned transform) go through SIMD span
+ * fills; everything else is flattened and goes through the scanline
+ * rasterizer. Geometries are flattened through a LOD cache, curves are
+ * only subdivided again when the scale changes noticeably. Gradient
+ * brushes are shaded one span at a time into a scratch row, then blended
+ * with the coverage.
+ *
+ * Optionally, geometries are drawn from signed distance fields instead of
+ * being rasterized, see set_distance_field_resolution(), and small shapes
+ * are drawn from a sprite atlas, see set_sprite_atlas_enabled().
+ */
+class software_render_target : public render_target, private coverage_sink {
+public :
+    /*
+     * Allocates and owns its pixels.
+     */
+    software_render_target(int width, int height);
+
+    /*
+     * Renders into memory owned by someone else.
+     */
+    explicit software_render_target(const pixel_surface& surface);
+
+    void bind_surface(const pixel_surface& surface);
+
+    const pixel_surface& surface() const {
+        return surface_;
+    }
+
+    void set_sample_count(int samples) {
+        rasterizer_.set_sample_count(samples);
+        sprite_atlas_.set_sample_count(samples);
+    }
+
+    int sample_count() const {
+        return rasterizer_.sample_count();
+    }
+
+    /*
+     * Maximum distance, in pixels, between a curve and its flattened
+     * approximation.
+     */
+    void set_flattening_tolerance(float tolerance) {
+        assert(tolerance > 0.0f);
+        tolerance_ = tolerance;
+        sprite_atlas_.set_flattening_tolerance(tolerance);
+    }
+
+    float flattening_tolerance() const {
+        return tolerance_;
+    }
+
+    /*
+     * With a resolution (cells along the longer side of a geometry),
+     * fill_geometry() builds a distance field per geometry once and draws
+     * from it at any scale : cheaper than rasterizing large shapes, but
+     * sharp corners round off at high magnification. 0 (the default)
+     * rasterizes the outline.
+     */
+    void set_distance_field_resolution(int resolution) {
+        assert(resolution >= 0);
+        field_resolution_ = resolution;
+    }
+
+    int distance_field_resolution() const {
+        return field_resolution_;
+    }
+
+    distance_field_cache& distance_fields() {
+        return distance_fields_;
+    }
+
+    /*
+     * When enabled, geometries that fit in sprite_atlas::max_sprite_size()
+     * pixels are rasterized once per quantized scale and rotation, then
+     * drawn from the filtered coverage. Off by default : the edges come
+     * out slightly softer than rasterized ones.
+     */
+    void set_sprite_atlas_enabled(bool enabled) {
+        sprites_enabled_ = enabled;
+    }
+
+    bool sprite_atlas_enabled() const {
+        return sprites_enabled_;
+    }
+
+    sprite_atlas& sprites() {
+        return sprite_atlas_;
+    }
+
+    /*
+     * Flattened geometries kept between draws, see geometry_lod_cache.
+     */
+    geometry_lod_cache& lod_cache() {
+        return lod_cache_;
+    }
+
+    const geometry_lod_cache& lod_cache() const {
+        return lod_cache_;
+    }
+
+    const fill_statistics& statistics() const {
+        return stats_;
+    }
+
+    void reset_statistics() {
+        stats_.reset();
+    }
+
+    int width() const {
+        return surface_.width_;
+    }
+
+    int height() const {
+        return surface_.height_;
+    }
+
+    void begin_draw();
+
+    end_draw_result end_draw();
+
+    void clear(const color& clear_color);
+
+    void set_transform(const matrix3X3& xform) {
+        transform_ = xform;
+    }
+
+    const matrix3X3& get_transform() const {
+        return transform_;
+    }
+
+    void fill_rectangle(const rectangle& rect, const brush* fill_brush);
+
+    void draw_line(
+        const vector2& p0, const vector2& p1, const brush* stroke_brush,
+        float stroke_width = 1.0f);
+
+    void fill_geometry(const path_geometry& geometry, const brush* fill_brush);
+
+    /*
+     * Fills the shape of a distance field (in the current transform), the
+     * coverage of a pixel is its distance to the outline, from half a
+     * pixel outside to half a pixel inside.
+     */
+    void fill_distance_field(const distance_field& field, const brush* fill_brush);
+
+    /*
+     * One LOD lookup for the batch, at the tolerance the most magnified
+     * copy needs; copies entirely outside the target are skipped.
+     */
+    void fill_geometry_instances(
+        const path_geometry& geometry, const matrix3X3* transforms, const color* colors,
+        size_t count);
+
+    std::shared_ptr<bitmap_layer> create_layer(int width, int height);
+
+    void draw_layer(const bitmap_layer* layer);
+
+private :
+    software_render_target(const software_render_target&);
+    software_render_target& operator=(const software_render_target&);
+
+    void coverage_span(int y, int x, int count, const uint8_t* coverage);
+
+    void set_fill_brush(const brush* fill_brush);
+
+    void fill_device_rectangle(const rectangle& rect);
+
+    void shade_device_rectangle(float x0, float y0, float x1, float y1);
+
+    void fill_polygon(const vector2* points, size_t count, fill_mode mode);
+
+    void draw_distance_field(const distance_field& field, const matrix3X3& xform);
+
+    //
+    // Draws the current fill through the atlas, false if the shape is not
+    // in it (too large).
+    bool draw_from_atlas(const path_geometry& geometry, const matrix3X3& xform);
+
+    void draw_sprite(const atlas_sprite& sprite, const matrix3X3& xform);
+
+    bool transform_is_axis_aligned() const {
+        return transform_.a12_ == 0.0f && transform_.a21_ == 0.0f;
+    }
+
+    std::vector<uint32_t>   storage_;
+    pixel_surface           surface_;
+    matrix3X3               transform_;
+    scanline_rasterizer     rasterizer_;
+    flattened_path          flattened_;
+    std::vector<matrix3X3>  instance_transforms_;
+    geometry_lod_cache      lod_cache_;
+    distance_field_cache    distance_fields_;
+    int                     field_resolution_;
+    sprite_atlas            sprite_atlas_;
+    bool                    sprites_enabled_;
+    float                   tolerance_;
+    uint32_t                fill_pixel_;
+    //
+    // Set when filling with a gradient, null for solid colours.
+    const gradient_brush*   shader_;
+    matrix3X3               device_to_brush_;
+    std::vector<uint32_t>   shaded_row_;
+    std::vector<uint8_t>    coverage_row_;
+    fill_statistics         stats_;
+    bool                    drawing_;
+};
+
+/*
+ * Layers of the software backend are software targets with their own
+ * pixels.
+ */
+class software_bitmap_layer : public bitmap_layer {
+public :
+    software_bitmap_layer(int width, int height) : target_(width, height) {}
+
+    render_target* target() {
+        return &target_;
+    }
+
+    const software_render_target& software_target() const {
+        return target_;
+    }
+
+private :
+    software_render_target  target_;
+};
+
+} // ns gfx
+
+#endif /* GFX_SOFTWARE_RENDER_TARGET_H_ */
@@ -0,0 +1,310 @@
+/*
+ * sprite_atlas.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "sprite_atlas.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const int C_ScaleStepsPerOctave = 4;
+const int C_RotationSteps = 64;
+
+//
+// Empty pixels around the shape : antialiasing and the bilinear
+// filter both reach a pixel out.
+const int C_SpriteBorder = 2;
+
+//
+// Shapes found too large for the atlas are remembered, so they are not
+// measured again every draw. The set is dropped when it fills up : keys
+// of geometries long gone would otherwise pile up.
+const size_t C_MaxRejectedKeys = 1024;
+
+/*
+ * The octagon bounding points along the axes and diagonals, grown by
+ * reach along the axes.
+ */
+void
+bounding_octagon(
+    const std::vector<gfx::vector2>& points,
+    float reach,
+    gfx::vector2* octagon
+    )
+{
+    float min_x = FLT_MAX;
+    float max_x = -FLT_MAX;
+    float min_y = FLT_MAX;
+    float max_y = -FLT_MAX;
+    float min_sum = FLT_MAX;
+    float max_sum = -FLT_MAX;
+    float min_diff = FLT_MAX;
+    float max_diff = -FLT_MAX;
+    for (size_t i = 0; i < points.size(); ++i) {
+        const gfx::vector2& p = points[i];
+        min_x = std::min(min_x, p.x_);
+        max_x = std::max(max_x, p.x_);
+        min_y = std::min(min_y, p.y_);
+        max_y = std::max(max_y, p.y_);
+        min_sum = std::min(min_sum, p.x_ + p.y_);
+        max_sum = std::max(max_sum, p.x_ + p.y_);
+        min_diff = std::min(min_diff, p.x_ - p.y_);
+        max_diff = std::max(max_diff, p.x_ - p.y_);
+    }
+
+    min_x -= reach;
+    max_x += reach;
+    min_y -= reach;
+    max_y += reach;
+    min_sum -= 2.0f * reach;
+    max_sum += 2.0f * reach;
+    min_diff -= 2.0f * reach;
+    max_diff += 2.0f * reach;
+
+    //
+    // Around the octagon, starting on the top edge.
+    octagon[0] = gfx::vector2(min_sum - min_y, min_y);
+    octagon[1] = gfx::vector2(max_diff + min_y, min_y);
+    octagon[2] = gfx::vector2(max_x, max_x - max_diff);
+    octagon[3] = gfx::vector2(max_x, max_sum - max_x);
+    octagon[4] = gfx::vector2(max_sum - max_y, max_y);
+    octagon[5] = gfx::vector2(min_diff + max_y, max_y);
+    octagon[6] = gfx::vector2(min_x, min_x - min_diff);
+    octagon[7] = gfx::vector2(min_x, min_sum - min_x);
+}
+
+} // anonymous namespace
+
+void
+gfx::sprite_atlas::page_sink::coverage_span(
+    int y,
+    int x,
+    int count,
+    const uint8_t* coverage
+    )
+{
+    std::memcpy(page_ + static_cast<size_t>(y) * C_PageSize + x, coverage, count);
+}
+
+gfx::sprite_atlas::sprite_atlas(
+    size_t budget_bytes
+    )
+    : budget_(budget_bytes),
+      tolerance_(0.25f),
+      use_counter_(0)
+{
+    rasterizer_.set_clip(C_PageSize, C_PageSize);
+}
+
+const gfx::atlas_sprite*
+gfx::sprite_atlas::find(
+    const path_geometry& geometry,
+    const matrix3X3& xform
+    )
+{
+    const float scale = transform_scale_factor(xform);
+    if (!(scale > EPSILON)) {
+        ++stats_.rejected_;
+        return nullptr;
+    }
+
+    const int scale_step = static_cast<int>(
+        std::ceil(std::log2(scale) * C_ScaleStepsPerOctave - 1.0e-3f));
+    const float angle = rads2degs(std::atan2(xform.a21_, xform.a11_));
+    int rotation_step = static_cast<int>(
+        std::floor(angle * (C_RotationSteps / 360.0f) + 0.5f)) % C_RotationSteps;
+    if (rotation_step < 0)
+        rotation_step += C_RotationSteps;
+
+    const sprite_key key = { &geometry, geometry.revision(), scale_step, rotation_step };
+    if (rejected_keys_.count(key)) {
+        ++stats_.rejected_;
+        return nullptr;
+    }
+
+    sprite_map::iterator found = index_.find(key);
+    if (found != index_.end()) {
+        ++stats_.hits_;
+        pages_[found->second.page_].last_used_ = ++use_counter_;
+        return &found->second;
+    }
+
+    //
+    // The shape at the quantized scale and rotation, then moved into its
+    // slot.
+    const float sprite_scale = std::exp2(static_cast<float>(scale_step) / C_ScaleStepsPerOctave);
+    const matrix3X3 quantized =
+        matrix3X3::rotation(static_cast<float>(rotation_step) * (360.0f / C_RotationSteps)) *
+        matrix3X3::scale(sprite_scale, sprite_scale);
+    geometry.flatten(quantized, tolerance_, &flattened_);
+
+    if (flattened_.empty())
+        return reject(key);
+
+    const rectangle bounds(flattened_.bounds());
+    const float left = std::floor(bounds.left_) - C_SpriteBorder;
+    const float top = std::floor(bounds.top_) - C_SpriteBorder;
+    const int width = static_cast<int>(std::ceil(bounds.right_) - left) + C_SpriteBorder;
+    const int height = static_cast<int>(std::ceil(bounds.bottom_) - top) + C_SpriteBorder;
+    atlas_sprite sprite;
+    if (width > max_sprite_size() || height > max_sprite_size() ||
+        !allocate(width, height, &sprite))
+        return reject(key);
+
+    ++stats_.misses_;
+    const vector2 offset(static_cast<float>(sprite.x_) - left, static_cast<float>(sprite.y_) - top);
+    sprite.local_to_page_ = matrix3X3::translation(offset) * quantized;
+    for (size_t i = 0; i < flattened_.points_.size(); ++i)
+        flattened_.points_[i] += offset;
+
+    //
+    // Texels touching the shape get coverage, and the filter reads the
+    // texels within a pixel of the position it samples.
+    bounding_octagon(flattened_.points_, 1.5f, sprite.outline_);
+
+    atlas_page& page = pages_[sprite.page_];
+    sink_.page_ = &page.coverage_[0];
+    rasterizer_.reset();
+    rasterizer_.add_path(flattened_);
+    rasterizer_.rasterize(flattened_.fill_mode_, &sink_);
+
+    page.last_used_ = ++use_counter_;
+    page.sprites_.push_back(key);
+    std::pair<sprite_map::iterator, bool> inserted = index_.insert(std::make_pair(key, sprite));
+    return &inserted.first->second;
+}
+
+const gfx::atlas_sprite*
+gfx::sprite_atlas::reject(
+    const sprite_key& key
+    )
+{
+    if (rejected_keys_.size() >= C_MaxRejectedKeys)
+        rejected_keys_.clear();
+
+    rejected_keys_.insert(key);
+    ++stats_.rejected_;
+    return nullptr;
+}
+
+bool
+gfx::sprite_atlas::allocate(
+    int width,
+    int height,
+    atlas_sprite* sprite
+    )
+{
+    for (size_t page = 0; page < pages_.size(); ++page) {
+        if (allocate_in_page(page, width, height, sprite))
+            return true;
+    }
+
+    if (pages_.size() < max_pages()) {
+        pages_.push_back(atlas_page());
+        atlas_page& page = pages_.back();
+        page.coverage_.assign(static_cast<size_t>(C_PageSize) * C_PageSize, 0);
+        page.used_height_ = 0;
+        page.last_used_ = 0;
+        return allocate_in_page(pages_.size() - 1, width, height, sprite);
+    }
+
+    size_t oldest = 0;
+    for (size_t page = 1; page < pages_.size(); ++page) {
+        if (pages_[page].last_used_ < pages_[oldest].last_used_)
+            oldest = page;
+    }
+
+    evict_page(oldest);
+    return allocate_in_page(oldest, width, height, sprite);
+}
+
+bool
+gfx::sprite_atlas::allocate_in_page(
+    size_t page_index,
+    int width,
+    int height,
+    atlas_sprite* sprite
+    )
+{
+    atlas_page& page = pages_[page_index];
+
+    //
+    // The lowest shelf the sprite fits on, unless it wastes more than
+    // half the sprite's height.
+    atlas_shelf* best = nullptr;
+    for (size_t i = 0; i < page.shelves_.size(); ++i) {
+        atlas_shelf& shelf = page.shelves_[i];
+        if (shelf.height_ >= height && shelf.height_ <= height + height / 2 + 4 &&
+            shelf.used_width_ + width <= C_PageSize &&
+            (!best || shelf.height_ < best->height_))
+            best = &shelf;
+    }
+
+    if (!best) {
+        const int shelf_height = (height + 3) & ~3;
+        if (page.used_height_ + shelf_height > C_PageSize)
+            return false;
+
+        atlas_shelf shelf = { page.used_height_, shelf_height, 0 };
+        page.shelves_.push_back(shelf);
+        page.used_height_ += shelf_height;
+        best = &page.shelves_.back();
+    }
+
+    sprite->page_ = page_index;
+    sprite->x_ = best->used_width_;
+    sprite->y_ = best->y_;
+    sprite->width_ = width;
+    sprite->height_ = height;
+    best->used_width_ += width;
+    return true;
+}
+
+void
+gfx::sprite_atlas::evict_page(
+    size_t page_index
+    )
+{
+    atlas_page& page = pages_[page_index];
+    for (size_t i = 0; i < page.sprites_.size(); ++i)
+        index_.erase(page.sprites_[i]);
+
+    ++stats_.pages_evicted_;
+    stats_.sprites_evicted_ += page.sprites_.size();
+    page.sprites_.clear();
+    page.shelves_.clear();
+    page.used_height_ = 0;
+    std::fill(page.coverage_.begin(), page.coverage_.end(), 0);
+}
+
+size_t
+gfx::sprite_atlas::max_pages() const {
+    return std::max<size_t>(1, budget_ / (static_cast<size_t>(C_PageSize) * C_PageSize));
+}
+
+void
+gfx::sprite_atlas::set_budget(
+    size_t budget_bytes
+    )
+{
+    budget_ = budget_bytes;
+    if (pages_.size() <= max_pages())
+        return;
+
+    for (size_t page = max_pages(); page < pages_.size(); ++page)
+        evict_page(page);
+    pages_.resize(max_pages());
+}
+
+void
+gfx::sprite_atlas::clear() {
+    pages_.clear();
+    index_.clear();
+    rejected_keys_.clear();
+}
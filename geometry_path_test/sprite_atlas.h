@@ -0,0 +1,250 @@
+/*
+ * sprite_atlas.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_SPRITE_ATLAS_H_
+#define GFX_SPRITE_ATLAS_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "matrix3x3.h"
+#include "path_geometry.h"
+#include "rasterizer.h"
+
+namespace gfx {
+
+/*
+ * The coverage of a geometry, rasterized into an atlas page.
+ * local_to_page_ maps the geometry's own space to page pixels : drawing
+ * maps every device pixel back through it and filters the page
+ * bilinearly.
+ */
+struct atlas_sprite {
+    static const size_t C_OutlinePoints = 8;
+
+    size_t      page_;
+    //
+    // The slot in the page, with an empty border of two pixels.
+    int         x_;
+    int         y_;
+    int         width_;
+    int         height_;
+    matrix3X3   local_to_page_;
+    //
+    // A convex octagon, in page pixels, holding every position at which
+    // the bilinear filter reads a covered texel.
+    vector2     outline_[C_OutlinePoints];
+};
+
+struct sprite_atlas_statistics {
+    uint64_t    hits_;
+    uint64_t    misses_;
+    //
+    // Lookups for sprites larger than the atlas takes, drawn directly.
+    uint64_t    rejected_;
+    //
+    // Pages reclaimed for new sprites, and the sprites they held.
+    uint64_t    pages_evicted_;
+    uint64_t    sprites_evicted_;
+
+    sprite_atlas_statistics() {
+        reset();
+    }
+
+    void reset() {
+        hits_ = misses_ = rejected_ = pages_evicted_ = sprites_evicted_ = 0;
+    }
+
+    double hit_rate() const {
+        const uint64_t lookups = hits_ + misses_;
+        return lookups ? static_cast<double>(hits_) / lookups : 0.0;
+    }
+};
+
+/*
+ * Pre-rasterized coverage of small shapes, so repeated draws become
+ * filtered blits. A sprite is made per geometry, quantized scale (4 steps
+ * per octave, rounded up so sprites are only ever shrunk) and rotation (64
+ * steps); the rest of the transform, translation included, is left to the
+ * bilinear filter. Sprites hold coverage, not colour : one serves every
+ * brush the shape is filled with.
+ *
+ * Filtering costs the same for every pixel of a sprite, while the
+ * rasterizer's cost grows with the outline and the sample count. Sprites
+ * are only made up to max_sprite_size(), about where the two break even;
+ * larger shapes are left to the rasterizer.
+ *
+ * Sprites are packed into square pages by a shelf packer. Pages are
+ * bounded by a memory budget; when no page has room, the least recently
+ * used page is cleared and reused, with all its sprites.
+ */
+class sprite_atlas {
+public :
+    static const int C_PageSize = 512;
+    static const int C_MaxSpriteSize = 128;
+    //
+    // Measured on the fighter swarm : at 4 samples per pixel sprites win
+    // up to about 40 pixels, at 8 up to the largest ones.
+    static const int C_BreakEvenPixelsPerSample = 10;
+    static const size_t C_DefaultBudget = 4 * C_PageSize * C_PageSize;
+
+    explicit sprite_atlas(size_t budget_bytes = C_DefaultBudget);
+
+    /*
+     * The sprite of geometry under xform, rasterized if missing. Returns
+     * nullptr when the shape is larger than max_sprite_size(). Valid until
+     * the next call to find().
+     */
+    const atlas_sprite* find(const path_geometry& geometry, const matrix3X3& xform);
+
+    /*
+     * Coverage of a page, C_PageSize bytes per row.
+     */
+    const uint8_t* page_coverage(size_t page) const {
+        return &pages_[page].coverage_[0];
+    }
+
+    /*
+     * Largest sprite side, in pixels, at the current sample count.
+     */
+    int max_sprite_size() const {
+        return std::min(C_MaxSpriteSize,
+                        C_BreakEvenPixelsPerSample * rasterizer_.sample_count());
+    }
+
+    size_t page_count() const {
+        return pages_.size();
+    }
+
+    /*
+     * Sprites held by the pages. Shapes found too large are not counted.
+     */
+    size_t sprite_count() const {
+        return index_.size();
+    }
+
+    /*
+     * Changing the quality settings drops the sprites made with the old
+     * ones.
+     */
+    void set_sample_count(int samples) {
+        if (samples == rasterizer_.sample_count())
+            return;
+        rasterizer_.set_sample_count(samples);
+        clear();
+    }
+
+    /*
+     * Maximum distance, in sprite pixels, between a curve and its
+     * flattened approximation.
+     */
+    void set_flattening_tolerance(float tolerance) {
+        assert(tolerance > 0.0f);
+        if (tolerance == tolerance_)
+            return;
+        tolerance_ = tolerance;
+        clear();
+    }
+
+    void set_budget(size_t budget_bytes);
+
+    size_t budget() const {
+        return budget_;
+    }
+
+    size_t memory_used() const {
+        return pages_.size() * C_PageSize * C_PageSize;
+    }
+
+    void clear();
+
+    const sprite_atlas_statistics& statistics() const {
+        return stats_;
+    }
+
+    void reset_statistics() {
+        stats_.reset();
+    }
+
+private :
+    struct sprite_key {
+        const path_geometry*    geometry_;
+        uint32_t                revision_;
+        int                     scale_step_;
+        int                     rotation_step_;
+
+        bool operator==(const sprite_key& rhs) const {
+            return geometry_ == rhs.geometry_ && revision_ == rhs.revision_ &&
+                scale_step_ == rhs.scale_step_ && rotation_step_ == rhs.rotation_step_;
+        }
+    };
+
+    struct sprite_key_hash {
+        size_t operator()(const sprite_key& key) const {
+            size_t h = std::hash<const void*>()(key.geometry_);
+            h ^= (static_cast<size_t>(key.revision_) << 16) ^
+                (static_cast<size_t>(key.scale_step_ & 0xFF) << 8) ^
+                static_cast<size_t>(key.rotation_step_);
+            return h;
+        }
+    };
+
+    struct atlas_shelf {
+        int y_;
+        int height_;
+        int used_width_;
+    };
+
+    struct atlas_page {
+        std::vector<uint8_t>    coverage_;
+        std::vector<atlas_shelf> shelves_;
+        int                     used_height_;
+        uint64_t                last_used_;
+        std::vector<sprite_key> sprites_;
+    };
+
+    class page_sink : public coverage_sink {
+    public :
+        page_sink() : page_(nullptr) {}
+
+        void coverage_span(int y, int x, int count, const uint8_t* coverage);
+
+        uint8_t*    page_;
+    };
+
+    typedef std::unordered_map<sprite_key, atlas_sprite, sprite_key_hash> sprite_map;
+    typedef std::unordered_set<sprite_key, sprite_key_hash> sprite_key_set;
+
+    const atlas_sprite* reject(const sprite_key& key);
+
+    bool allocate(int width, int height, atlas_sprite* sprite);
+
+    bool allocate_in_page(size_t page, int width, int height, atlas_sprite* sprite);
+
+    void evict_page(size_t page);
+
+    size_t max_pages() const;
+
+    size_t                      budget_;
+    float                       tolerance_;
+    uint64_t                    use_counter_;
+    std::vector<atlas_page>     pages_;
+    sprite_map                  index_;
+    sprite_key_set              rejected_keys_;
+    scanline_rasterizer         rasterizer_;
+    page_sink                   sink_;
+    flattened_path              flattened_;
+    sprite_atlas_statistics     stats_;
+};
+
+} // ns gfx
+
+#endif /* GFX_SPRITE_ATLAS_H_ */
@@ -0,0 +1,481 @@
+/*
+ * svg_path_parser.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "svg_path_parser.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+inline
+bool
+is_digit(
+    char c
+    )
+{
+    return static_cast<unsigned>(c - '0') < 10u;
+}
+
+inline
+bool
+is_whitespace(
+    char c
+    )
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+inline
+bool
+is_number_start(
+    char c
+    )
+{
+    return is_digit(c) || c == '-' || c == '+' || c == '.';
+}
+
+inline
+bool
+is_path_command(
+    char c
+    )
+{
+    return c && std::strchr("MmZzLlHhVvCcSsQqTtAa", c) != nullptr;
+}
+
+//
+// Powers of ten that are exactly representable as a double.
+const double C_ExactPowersOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21,
+    1e22
+};
+
+const int C_MaxExactPowerOfTen = 22;
+
+//
+// Maximum number of significant digits accumulated into the mantissa.
+// Nineteen decimal digits always fit in 64 bits, further digits are way
+// beyond float precision anyway.
+const int C_MaxMantissaDigits = 19;
+
+double
+scale_by_power_of_ten(
+    double value,
+    int exponent
+    )
+{
+    if (exponent >= 0) {
+        if (exponent <= C_MaxExactPowerOfTen)
+            return value * C_ExactPowersOfTen[exponent];
+        return value * std::pow(10.0, exponent);
+    }
+
+    if (-exponent <= C_MaxExactPowerOfTen)
+        return value / C_ExactPowersOfTen[-exponent];
+    return value * std::pow(10.0, exponent);
+}
+
+} // anonymous namespace
+
+const char*
+gfx::parse_svg_number(
+    const char* first,
+    const char* last,
+    float* value
+    )
+{
+    const char* p = first;
+    bool negative = false;
+
+    if (p != last && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    unsigned long long mantissa = 0;
+    int significant_digits = 0;
+    int exponent = 0;
+    bool has_digits = false;
+
+    //
+    // Integer part.
+    while (p != last && is_digit(*p)) {
+        has_digits = true;
+        if (significant_digits < C_MaxMantissaDigits) {
+            mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+            if (mantissa)
+                ++significant_digits;
+        } else {
+            ++exponent;
+        }
+        ++p;
+    }
+
+    //
+    // Fractional part.
+    if (p != last && *p == '.' && (p + 1) != last && is_digit(p[1])) {
+        ++p;
+        while (p != last && is_digit(*p)) {
+            has_digits = true;
+            if (significant_digits < C_MaxMantissaDigits) {
+                mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                if (mantissa)
+                    ++significant_digits;
+                --exponent;
+            }
+            ++p;
+        }
+    } else if (p != last && *p == '.' && has_digits) {
+        //
+        // "5." is a valid number.
+        ++p;
+    }
+
+    if (!has_digits)
+        return nullptr;
+
+    //
+    // Exponent, only consumed if it is well formed, so that "1e" parses
+    // as 1 followed by garbage.
+    if (p != last && (*p == 'e' || *p == 'E')) {
+        const char* e = p + 1;
+        bool negative_exponent = false;
+        if (e != last && (*e == '-' || *e == '+')) {
+            negative_exponent = (*e == '-');
+            ++e;
+        }
+
+        if (e != last && is_digit(*e)) {
+            int exp_value = 0;
+            while (e != last && is_digit(*e)) {
+                if (exp_value < 10000)
+                    exp_value = exp_value * 10 + (*e - '0');
+                ++e;
+            }
+            exponent += negative_exponent ? -exp_value : exp_value;
+            p = e;
+        }
+    }
+
+    double result = scale_by_power_of_ten(static_cast<double>(mantissa), exponent);
+    *value = static_cast<float>(negative ? -result : result);
+    return p;
+}
+
+void
+gfx::svg_path_parser::reset() {
+    first_ = cursor_ = last_ = nullptr;
+    error_offset_ = 0;
+    command_count_ = 0;
+    current_point_ = figure_start_ = last_control_point_ = vector2(0.0f, 0.0f);
+    last_curve_ = last_curve_none;
+    figure_open_ = false;
+}
+
+bool
+gfx::svg_path_parser::parse(
+    const char* path_data
+    )
+{
+    assert(path_data);
+    return parse(path_data, path_data + std::strlen(path_data));
+}
+
+bool
+gfx::svg_path_parser::parse(
+    const char* first,
+    const char* last
+    )
+{
+    reset();
+    first_ = cursor_ = first;
+    last_ = last;
+
+    char command = 0;
+    bool succeeded = true;
+
+    for (;;) {
+        skip_whitespace();
+        if (cursor_ == last_)
+            break;
+
+        const char c = *cursor_;
+        if (!is_number_start(c)) {
+            //
+            // Explicit command.
+            if (!is_path_command(c)) {
+                succeeded = false;
+                break;
+            }
+
+            //
+            // The path data must start with a moveto.
+            if (!command_count_ && c != 'M' && c != 'm') {
+                succeeded = false;
+                break;
+            }
+
+            ++cursor_;
+            command = c;
+            skip_whitespace();
+        } else if (!command || command == 'Z' || command == 'z') {
+            //
+            // Coordinates without a command, or after a closepath.
+            succeeded = false;
+            break;
+        }
+
+        if (!parse_command(command)) {
+            succeeded = false;
+            break;
+        }
+
+        ++command_count_;
+        skip_comma_whitespace();
+
+        //
+        // Coordinate pairs following a moveto are implicit linetos.
+        if (command == 'M')
+            command = 'L';
+        else if (command == 'm')
+            command = 'l';
+    }
+
+    if (figure_open_) {
+        sink_->end_figure(figure_end_open);
+        figure_open_ = false;
+    }
+
+    error_offset_ = succeeded ? 0 : static_cast<size_t>(cursor_ - first_);
+    return succeeded;
+}
+
+bool
+gfx::svg_path_parser::parse_command(
+    char cmd
+    )
+{
+    const bool relative = (cmd >= 'a' && cmd <= 'z');
+    last_curve curve = last_curve_none;
+
+    switch (cmd) {
+    case 'M' : case 'm' : {
+        vector2 pt;
+        if (!read_point(relative, &pt))
+            return false;
+
+        if (figure_open_)
+            sink_->end_figure(figure_end_open);
+
+        sink_->begin_figure(pt, figure_begin_filled);
+        figure_open_ = true;
+        current_point_ = figure_start_ = pt;
+    }
+        break;
+
+    case 'Z' : case 'z' :
+        if (figure_open_) {
+            sink_->end_figure(figure_end_closed);
+            figure_open_ = false;
+        }
+        current_point_ = figure_start_;
+        break;
+
+    case 'L' : case 'l' : {
+        vector2 pt;
+        if (!read_point(relative, &pt))
+            return false;
+
+        ensure_figure_open();
+        sink_->add_line(pt);
+        current_point_ = pt;
+    }
+        break;
+
+    case 'H' : case 'h' : {
+        float x;
+        if (!read_number(&x))
+            return false;
+
+        ensure_figure_open();
+        current_point_.x_ = relative ? current_point_.x_ + x : x;
+        sink_->add_line(current_point_);
+    }
+        break;
+
+    case 'V' : case 'v' : {
+        float y;
+        if (!read_number(&y))
+            return false;
+
+        ensure_figure_open();
+        current_point_.y_ = relative ? current_point_.y_ + y : y;
+        sink_->add_line(current_point_);
+    }
+        break;
+
+    case 'C' : case 'c' : case 'S' : case 's' : {
+        bezier_segment bezier;
+        if (cmd == 'C' || cmd == 'c') {
+            if (!read_point(relative, &bezier.point1_))
+                return false;
+        } else {
+            //
+            // First control point is the reflection of the previous
+            // curve's second control point, if the previous segment was
+            // a cubic.
+            bezier.point1_ = last_curve_ == last_curve_cubic ?
+                2.0f * current_point_ - last_control_point_ : current_point_;
+        }
+
+        if (!read_point(relative, &bezier.point2_) ||
+            !read_point(relative, &bezier.point3_))
+            return false;
+
+        ensure_figure_open();
+        sink_->add_bezier(bezier);
+        last_control_point_ = bezier.point2_;
+        current_point_ = bezier.point3_;
+        curve = last_curve_cubic;
+    }
+        break;
+
+    case 'Q' : case 'q' : case 'T' : case 't' : {
+        quadratic_bezier_segment bezier;
+        if (cmd == 'Q' || cmd == 'q') {
+            if (!read_point(relative, &bezier.point1_))
+                return false;
+        } else {
+            bezier.point1_ = last_curve_ == last_curve_quadratic ?
+                2.0f * current_point_ - last_control_point_ : current_point_;
+        }
+
+        if (!read_point(relative, &bezier.point2_))
+            return false;
+
+        ensure_figure_open();
+        sink_->add_quadratic_bezier(bezier);
+        last_control_point_ = bezier.point1_;
+        current_point_ = bezier.point2_;
+        curve = last_curve_quadratic;
+    }
+        break;
+
+    case 'A' : case 'a' : {
+        float rx, ry, rotation;
+        bool large_arc, sweep;
+        vector2 pt;
+
+        if (!read_number(&rx) || !read_number(&ry) ||
+            !read_number(&rotation) || !read_flag(&large_arc) ||
+            !read_flag(&sweep) || !read_point(relative, &pt))
+            return false;
+
+        ensure_figure_open();
+
+        //
+        // Out of range parameters, as per the SVG implementation notes :
+        // identical endpoints omit the arc, a zero radius makes it a line.
+        if (pt.x_ == current_point_.x_ && pt.y_ == current_point_.y_)
+            break;
+
+        if (rx == 0.0f || ry == 0.0f) {
+            sink_->add_line(pt);
+        } else {
+            sink_->add_arc(arc_segment(
+                pt, vector2(std::fabs(rx), std::fabs(ry)), rotation,
+                sweep ? sweep_direction_clockwise :
+                        sweep_direction_counter_clockwise,
+                large_arc ? arc_size_large : arc_size_small));
+        }
+        current_point_ = pt;
+    }
+        break;
+
+    default :
+        assert(false && "unhandled path command");
+        return false;
+        break;
+    }
+
+    last_curve_ = curve;
+    return true;
+}
+
+bool
+gfx::svg_path_parser::read_number(
+    float* value
+    )
+{
+    const char* next = parse_svg_number(cursor_, last_, value);
+    if (!next)
+        return false;
+
+    cursor_ = next;
+    skip_comma_whitespace();
+    return true;
+}
+
+bool
+gfx::svg_path_parser::read_flag(
+    bool* flag
+    )
+{
+    //
+    // Flags are a single character and need no separator, "11" is two
+    // flags.
+    if (cursor_ == last_ || (*cursor_ != '0' && *cursor_ != '1'))
+        return false;
+
+    *flag = (*cursor_ == '1');
+    ++cursor_;
+    skip_comma_whitespace();
+    return true;
+}
+
+bool
+gfx::svg_path_parser::read_point(
+    bool relative,
+    vector2* pt
+    )
+{
+    if (!read_number(&pt->x_) || !read_number(&pt->y_))
+        return false;
+
+    if (relative)
+        *pt += current_point_;
+    return true;
+}
+
+void
+gfx::svg_path_parser::skip_whitespace() {
+    while (cursor_ != last_ && is_whitespace(*cursor_))
+        ++cursor_;
+}
+
+void
+gfx::svg_path_parser::skip_comma_whitespace() {
+    skip_whitespace();
+    if (cursor_ != last_ && *cursor_ == ',') {
+        ++cursor_;
+        skip_whitespace();
+    }
+}
+
+void
+gfx::svg_path_parser::ensure_figure_open() {
+    //
+    // A drawing command right after a closepath starts a new figure at the
+    // start point of the one that was closed.
+    if (!figure_open_) {
+        sink_->begin_figure(current_point_, figure_begin_filled);
+        figure_open_ = true;
+        figure_start_ = current_point_;
+    }
+}
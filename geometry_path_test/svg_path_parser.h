@@ -0,0 +1,104 @@
+/*
+ * svg_path_parser.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_SVG_PATH_PARSER_H_
+#define GFX_SVG_PATH_PARSER_H_
+
+#include <cassert>
+#include <cstddef>
+#include "path_sink.h"
+#include "vector2.h"
+
+namespace gfx {
+
+/*
+ * Parses SVG path data (the 'd' attribute) and emits the segments into a
+ * path_sink as it goes. Supports the whole grammar : absolute and relative
+ * forms of M, L, H, V, C, S, Q, T, A and Z, implicit command repetition and
+ * the compact number/flag syntax ("M1-2.5.5.5", "a1 1 0 013 4").
+ *
+ * The parser makes a single pass over the input and never allocates, so it
+ * can be pointed at a memory mapped file of any size. Figures are ended on
+ * the sink, but close() is left to the caller.
+ *
+ * On malformed input, parsing stops at the first error (the segments before
+ * it have already been emitted, as the SVG spec prescribes), parse()
+ * returns false and error_offset() reports where the error is.
+ */
+class svg_path_parser {
+public :
+    explicit svg_path_parser(path_sink* sink) : sink_(sink) {
+        assert(sink_);
+        reset();
+    }
+
+    bool parse(const char* first, const char* last);
+
+    bool parse(const char* path_data);
+
+    size_t error_offset() const {
+        return error_offset_;
+    }
+
+    /*
+     * Number of path commands (explicit or implicit) processed by the
+     * last call to parse().
+     */
+    size_t command_count() const {
+        return command_count_;
+    }
+
+private :
+    enum last_curve {
+        last_curve_none,
+        last_curve_cubic,
+        last_curve_quadratic
+    };
+
+    void reset();
+
+    bool parse_command(char cmd);
+
+    bool read_number(float* value);
+
+    bool read_flag(bool* flag);
+
+    bool read_point(bool relative, vector2* pt);
+
+    void skip_whitespace();
+
+    void skip_comma_whitespace();
+
+    void ensure_figure_open();
+
+    path_sink*  sink_;
+    const char* first_;
+    const char* cursor_;
+    const char* last_;
+    size_t      error_offset_;
+    size_t      command_count_;
+    vector2     current_point_;
+    vector2     figure_start_;
+    vector2     last_control_point_;
+    last_curve  last_curve_;
+    bool        figure_open_;
+};
+
+/*
+ * Parses a number in the SVG/CSS syntax from [first, last). Returns a
+ * pointer one past the number or nullptr if there is no number at first.
+ */
+const char*
+parse_svg_number(
+    const char* first,
+    const char* last,
+    float* value
+    );
+
+} // ns gfx
+
+#endif /* GFX_SVG_PATH_PARSER_H_ */
@@ -0,0 +1,104 @@
+/*
+ * thread_pool.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "thread_pool.h"
+#include "trace.h"
+
+gfx::thread_pool::thread_pool(
+    size_t worker_count
+    )
+    : task_(nullptr),
+      count_(0),
+      next_(0),
+      completed_(0),
+      stop_(false)
+{
+    workers_.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i)
+        workers_.push_back(std::thread(&thread_pool::worker_thread_proc, this));
+}
+
+gfx::thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        stop_ = true;
+    }
+    work_ready_.notify_all();
+
+    for (size_t i = 0; i < workers_.size(); ++i)
+        workers_[i].join();
+}
+
+size_t
+gfx::thread_pool::default_worker_count() {
+    //
+    // hardware_concurrency() is 0 when unknown.
+    const unsigned threads = std::thread::hardware_concurrency();
+    return threads > 1 ? threads - 1 : 0;
+}
+
+void
+gfx::thread_pool::run(
+    size_t count,
+    const std::function<void(size_t)>& task
+    )
+{
+    if (!count)
+        return;
+
+    std::unique_lock<std::mutex> guard(lock_);
+    assert(!task_ && "thread_pool::run() is not reentrant");
+
+    task_ = &task;
+    count_ = count;
+    next_ = 0;
+    completed_ = 0;
+    work_ready_.notify_all();
+
+    //
+    // The caller takes tasks too, a pool without workers runs everything
+    // here.
+    while (next_ < count_) {
+        const size_t index = next_++;
+        guard.unlock();
+        task(index);
+        guard.lock();
+        ++completed_;
+    }
+
+    work_done_.wait(guard, [this]() { return completed_ == count_; });
+
+    //
+    // Late workers find nothing left to take.
+    task_ = nullptr;
+    count_ = 0;
+    next_ = 0;
+}
+
+void
+gfx::thread_pool::worker_thread_proc() {
+    GFX_TRACE_THREAD_NAME("pool worker");
+    std::unique_lock<std::mutex> guard(lock_);
+
+    for (;;) {
+        work_ready_.wait(guard, [this]() { return stop_ || next_ < count_; });
+        if (stop_)
+            return;
+
+        const size_t index = next_++;
+        const std::function<void(size_t)>* task = task_;
+        guard.unlock();
+        {
+            GFX_TRACE_ZONE("pool task");
+            (*task)(index);
+        }
+        guard.lock();
+
+        if (++completed_ == count_)
+            work_done_.notify_one();
+    }
+}
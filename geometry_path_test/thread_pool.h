@@ -0,0 +1,65 @@
+/*
+ * thread_pool.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_THREAD_POOL_H_
+#define GFX_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gfx {
+
+/*
+ * Fixed set of worker threads running batches of tasks : run() calls
+ * task(0) .. task(count - 1), spread over the workers and the calling
+ * thread, and returns when all of them are done. Batches do not overlap,
+ * run() is meant to be called from a single thread.
+ */
+class thread_pool {
+public :
+    /*
+     * worker_count extra threads; the default is one less than the
+     * hardware threads, the caller being the last one.
+     */
+    explicit thread_pool(size_t worker_count = default_worker_count());
+
+    ~thread_pool();
+
+    static size_t default_worker_count();
+
+    size_t worker_count() const {
+        return workers_.size();
+    }
+
+    void run(size_t count, const std::function<void(size_t)>& task);
+
+private :
+    thread_pool(const thread_pool&);
+    thread_pool& operator=(const thread_pool&);
+
+    void worker_thread_proc();
+
+    std::mutex                              lock_;
+    std::condition_variable                 work_ready_;
+    std::condition_variable                 work_done_;
+    //
+    // The batch being run, indices are handed out under the lock.
+    const std::function<void(size_t)>*      task_;
+    size_t                                  count_;
+    size_t                                  next_;
+    size_t                                  completed_;
+    bool                                    stop_;
+    std::vector<std::thread>                workers_;
+};
+
+} // ns gfx
+
+#endif /* GFX_THREAD_POOL_H_ */
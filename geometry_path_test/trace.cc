@@ -0,0 +1,261 @@
+/*
+ * trace.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "trace.h"
+
+#include <chrono>
+#include <map>
+#include <mutex>
+
+thread_local gfx::trace_buffer* gfx::t_trace_buffer = nullptr;
+
+namespace {
+
+/*
+ * A registered buffer. Those of exited threads are kept until the next
+ * trace_clear(), so their zones still get written.
+ */
+struct registered_buffer {
+    std::unique_ptr<gfx::trace_buffer>  buffer_;
+    bool                                exited_;
+};
+
+/*
+ * The buffers not yet cleared, with the names of their threads.
+ */
+struct trace_registry {
+    std::mutex                          lock_;
+    std::vector<registered_buffer>      buffers_;
+    std::map<uint32_t, std::string>     thread_names_;
+    std::string                         exit_path_;
+    uint32_t                            next_thread_id_;
+
+    trace_registry() : next_thread_id_(1) {}
+
+    ~trace_registry();
+
+    bool write_chrome_json(const std::string& path);
+};
+
+trace_registry&
+registry() {
+    static trace_registry instance;
+    return instance;
+}
+
+/*
+ * Marks the thread's buffer as exited when the thread ends.
+ */
+struct thread_exit_marker {
+    ~thread_exit_marker();
+};
+
+thread_local thread_exit_marker t_exit_marker;
+
+thread_exit_marker::~thread_exit_marker() {
+    if (!gfx::t_trace_buffer)
+        return;
+
+    trace_registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.lock_);
+    for (size_t b = 0; b < r.buffers_.size(); ++b) {
+        if (r.buffers_[b].buffer_.get() == gfx::t_trace_buffer)
+            r.buffers_[b].exited_ = true;
+    }
+}
+
+void
+write_json_string(
+    FILE* fp,
+    const char* text
+    )
+{
+    std::fputc('"', fp);
+    for (; *text; ++text) {
+        const unsigned char c = static_cast<unsigned char>(*text);
+        if (c == '"' || c == '\\')
+            std::fprintf(fp, "\\%c", c);
+        else if (c < 0x20)
+            std::fprintf(fp, "\\u%04x", c);
+        else
+            std::fputc(c, fp);
+    }
+    std::fputc('"', fp);
+}
+
+trace_registry::~trace_registry() {
+    if (!exit_path_.empty())
+        write_chrome_json(exit_path_);
+}
+
+bool
+trace_registry::write_chrome_json(
+    const std::string& path
+    )
+{
+    FILE* fp = std::fopen(path.c_str(), "w");
+    if (!fp)
+        return false;
+
+    std::lock_guard<std::mutex> lock(lock_);
+
+    //
+    // Times are made relative to the earliest zone, in microseconds.
+    std::vector<std::vector<gfx::trace_event> > events(buffers_.size());
+    uint64_t origin_ns = UINT64_MAX;
+    for (size_t b = 0; b < buffers_.size(); ++b) {
+        buffers_[b].buffer_->snapshot(&events[b]);
+        for (size_t i = 0; i < events[b].size(); ++i)
+            origin_ns = std::min(origin_ns, events[b][i].begin_ns_);
+    }
+
+    std::fprintf(fp, "{\"traceEvents\":[\n");
+    bool first = true;
+    for (std::map<uint32_t, std::string>::const_iterator it = thread_names_.begin();
+         it != thread_names_.end(); ++it) {
+        std::fprintf(fp, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                     "\"args\":{\"name\":", first ? "" : ",\n", it->first);
+        write_json_string(fp, it->second.c_str());
+        std::fprintf(fp, "}}");
+        first = false;
+    }
+
+    for (size_t b = 0; b < buffers_.size(); ++b) {
+        const uint32_t tid = buffers_[b].buffer_->thread_id();
+        for (size_t i = 0; i < events[b].size(); ++i) {
+            const gfx::trace_event& event = events[b][i];
+            std::fprintf(fp, "%s{\"name\":", first ? "" : ",\n");
+            write_json_string(fp, event.name_);
+            std::fprintf(fp, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", tid,
+                         static_cast<double>(event.begin_ns_ - origin_ns) * 1.0e-3,
+                         static_cast<double>(event.end_ns_ - event.begin_ns_) * 1.0e-3);
+            first = false;
+        }
+    }
+
+    const bool written = std::fprintf(fp, "\n],\"displayTimeUnit\":\"ns\"}\n") > 0 &&
+        !std::ferror(fp);
+    return (std::fclose(fp) == 0) && written;
+}
+
+} // anonymous namespace
+
+gfx::trace_buffer::trace_buffer(
+    uint32_t thread_id
+    )
+    : slots_(C_Capacity),
+      started_(0),
+      head_(0),
+      thread_id_(thread_id)
+{
+}
+
+void
+gfx::trace_buffer::snapshot(
+    std::vector<trace_event>* events
+    ) const
+{
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    const uint64_t first = head > C_Capacity ? head - C_Capacity : 0;
+    const size_t start = events->size();
+
+    for (uint64_t i = first; i < head; ++i) {
+        const slot& s = slots_[i & (C_Capacity - 1)];
+        trace_event event;
+        event.name_ = s.name_.load(std::memory_order_relaxed);
+        event.begin_ns_ = s.begin_ns_.load(std::memory_order_relaxed);
+        event.end_ns_ = s.end_ns_.load(std::memory_order_relaxed);
+        events->push_back(event);
+    }
+
+    //
+    // Slots the writer started reusing while they were copied are
+    // dropped.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t started = started_.load(std::memory_order_relaxed);
+    if (started > first + C_Capacity) {
+        const size_t overwritten = static_cast<size_t>(
+            std::min(started - C_Capacity - first, head - first));
+        events->erase(events->begin() + start, events->begin() + start + overwritten);
+    }
+}
+
+uint64_t
+gfx::trace_now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+gfx::trace_buffer*
+gfx::trace_register_thread() {
+    //
+    // Odr-used here, so it is constructed, and destroyed at thread exit,
+    // in the threads that trace.
+    (void) &t_exit_marker;
+
+    trace_registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.lock_);
+    registered_buffer entry;
+    entry.buffer_.reset(new trace_buffer(r.next_thread_id_++));
+    entry.exited_ = false;
+    r.buffers_.push_back(std::move(entry));
+    t_trace_buffer = r.buffers_.back().buffer_.get();
+    return t_trace_buffer;
+}
+
+void
+gfx::trace_set_thread_name(
+    const char* name
+    )
+{
+    const uint32_t tid = trace_thread_buffer()->thread_id();
+    trace_registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.lock_);
+    r.thread_names_[tid] = name;
+}
+
+bool
+gfx::trace_write_chrome_json(
+    const std::string& path
+    )
+{
+    return registry().write_chrome_json(path);
+}
+
+void
+gfx::trace_write_at_exit(
+    const std::string& path
+    )
+{
+    trace_registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.lock_);
+    r.exit_path_ = path;
+}
+
+size_t
+gfx::trace_buffer_count() {
+    trace_registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.lock_);
+    return r.buffers_.size();
+}
+
+void
+gfx::trace_clear() {
+    trace_registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.lock_);
+    size_t kept = 0;
+    for (size_t b = 0; b < r.buffers_.size(); ++b) {
+        if (r.buffers_[b].exited_) {
+            r.thread_names_.erase(r.buffers_[b].buffer_->thread_id());
+            continue;
+        }
+
+        r.buffers_[b].buffer_->clear();
+        r.buffers_[kept++] = std::move(r.buffers_[b]);
+    }
+    r.buffers_.resize(kept);
+}
@@ -0,0 +1,192 @@
+/*
+ * trace.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_TRACE_H_
+#define GFX_TRACE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * Scoped trace zones :
+ *
+ *  void render_frame() {
+ *      GFX_TRACE_ZONE("render frame");
+ *      ...
+ *  }
+ *
+ * Each thread records its zones into its own ring buffer, without locks;
+ * the buffers are written out as Chrome trace-event JSON (chrome://tracing,
+ * ui.perfetto.dev) by trace_write_chrome_json(), or at exit once
+ * trace_write_at_exit() has been called.
+ *
+ * The macros compile to nothing unless GFX_TRACE is defined, as it is in
+ * the Trace configuration of the projects (-DGFX_TRACE elsewhere). The
+ * rest of the interface is always there, so the writing can stay
+ * unconditional.
+ */
+#if defined(GFX_TRACE)
+
+#define GFX_TRACE_CONCAT_(a, b)     a##b
+#define GFX_TRACE_CONCAT(a, b)      GFX_TRACE_CONCAT_(a, b)
+
+//
+// name must be a string literal (or live as long as the program).
+#define GFX_TRACE_ZONE(name)        \
+    ::gfx::trace_zone GFX_TRACE_CONCAT(trace_zone_, __LINE__)(name)
+
+#define GFX_TRACE_THREAD_NAME(name) ::gfx::trace_set_thread_name(name)
+
+#else
+
+#define GFX_TRACE_ZONE(name)        ((void) 0)
+#define GFX_TRACE_THREAD_NAME(name) ((void) 0)
+
+#endif
+
+namespace gfx {
+
+struct trace_event {
+    const char* name_;
+    uint64_t    begin_ns_;
+    uint64_t    end_ns_;
+};
+
+/*
+ * The zones of one thread. Written by that thread only; snapshot() may be
+ * called from any thread at any time and returns the events that were
+ * not overwritten while it copied them.
+ */
+class trace_buffer {
+public :
+    static const size_t C_Capacity = 1 << 16;
+
+    explicit trace_buffer(uint32_t thread_id);
+
+    void record(const char* name, uint64_t begin_ns, uint64_t end_ns) {
+        //
+        // A sequence lock : started_ moves first, so a reader copying the
+        // slot can tell it was overwritten meanwhile. The fences cost
+        // nothing on x86.
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        started_.store(head + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot& s = slots_[head & (C_Capacity - 1)];
+        s.name_.store(name, std::memory_order_relaxed);
+        s.begin_ns_.store(begin_ns, std::memory_order_relaxed);
+        s.end_ns_.store(end_ns, std::memory_order_relaxed);
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    /*
+     * Appends the events still in the buffer, oldest first.
+     */
+    void snapshot(std::vector<trace_event>* events) const;
+
+    uint32_t thread_id() const {
+        return thread_id_;
+    }
+
+    /*
+     * Events recorded since the start, including those overwritten.
+     */
+    uint64_t recorded() const {
+        return head_.load(std::memory_order_acquire);
+    }
+
+    /*
+     * The owning thread must not be recording.
+     */
+    void clear() {
+        started_.store(0, std::memory_order_relaxed);
+        head_.store(0, std::memory_order_release);
+    }
+
+private :
+    struct slot {
+        std::atomic<const char*>    name_;
+        std::atomic<uint64_t>       begin_ns_;
+        std::atomic<uint64_t>       end_ns_;
+    };
+
+    trace_buffer(const trace_buffer&);
+    trace_buffer& operator=(const trace_buffer&);
+
+    std::vector<slot>       slots_;
+    //
+    // Events begun and events complete.
+    std::atomic<uint64_t>   started_;
+    std::atomic<uint64_t>   head_;
+    uint32_t                thread_id_;
+};
+
+uint64_t trace_now_ns();
+
+/*
+ * The calling thread's buffer, created on first use. Buffers outlive
+ * their threads, until the next trace_clear() frees them.
+ */
+trace_buffer* trace_register_thread();
+
+extern thread_local trace_buffer* t_trace_buffer;
+
+inline
+trace_buffer*
+trace_thread_buffer() {
+    return t_trace_buffer ? t_trace_buffer : trace_register_thread();
+}
+
+/*
+ * Shown instead of the thread id in the trace viewers.
+ */
+void trace_set_thread_name(const char* name);
+
+/*
+ * Writes every thread's zones as Chrome trace-event JSON. Returns false
+ * when the file cannot be written.
+ */
+bool trace_write_chrome_json(const std::string& path);
+
+/*
+ * Writes the trace to path when the program exits.
+ */
+void trace_write_at_exit(const std::string& path);
+
+/*
+ * Buffers held, those of exited threads included.
+ */
+size_t trace_buffer_count();
+
+/*
+ * Drops the recorded zones, and frees the buffers of the threads that
+ * exited. No thread may be recording.
+ */
+void trace_clear();
+
+class trace_zone {
+public :
+    explicit trace_zone(const char* name)
+        : name_(name), begin_ns_(trace_now_ns()) {}
+
+    ~trace_zone() {
+        trace_thread_buffer()->record(name_, begin_ns_, trace_now_ns());
+    }
+
+private :
+    trace_zone(const trace_zone&);
+    trace_zone& operator=(const trace_zone&);
+
+    const char* name_;
+    uint64_t    begin_ns_;
+};
+
+} // ns gfx
+
+#endif /* GFX_TRACE_H_ */
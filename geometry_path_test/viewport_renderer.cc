@@ -0,0 +1,71 @@
+/*
+ * viewport_renderer.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+#include "pch_hdr.h"
+#include "viewport_renderer.h"
+
+gfx::viewport_renderer::viewport_renderer(
+    thread_pool* pool
+    )
+    : pool_(pool), parallel_submit_(true)
+{
+    assert(pool_);
+}
+
+size_t
+gfx::viewport_renderer::add_viewport(
+    render_target* target,
+    const matrix3X3& camera
+    )
+{
+    assert(target);
+
+    viewport view;
+    view.target_ = target;
+    view.camera_ = camera;
+    view.commands_.reset(new recording_render_target(target));
+    view.result_ = end_draw_ok;
+    viewports_.push_back(view);
+    return viewports_.size() - 1;
+}
+
+void
+gfx::viewport_renderer::submit(
+    viewport* view
+    )
+{
+    view->target_->begin_draw();
+    view->commands_->replay(view->target_);
+    view->result_ = view->target_->end_draw();
+}
+
+bool
+gfx::viewport_renderer::render(
+    const draw_function& draw
+    )
+{
+    const std::function<void(size_t)> render_viewport = [&](size_t index) {
+        viewport& view = viewports_[index];
+        recording_render_target* commands = view.commands_.get();
+
+        commands->begin_draw();
+        draw(commands, view.camera_, index);
+        commands->end_draw();
+        submit(&view);
+    };
+
+    if (parallel_submit_) {
+        pool_->run(viewports_.size(), render_viewport);
+    } else {
+        for (size_t i = 0; i < viewports_.size(); ++i)
+            render_viewport(i);
+    }
+
+    bool succeeded = true;
+    for (size_t i = 0; i < viewports_.size(); ++i)
+        succeeded = succeeded && viewports_[i].result_ == end_draw_ok;
+    return succeeded;
+}
@@ -0,0 +1,98 @@
+/*
+ * viewport_renderer.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: adi.hodos
+ */
+
+#ifndef GFX_VIEWPORT_RENDERER_H_
+#define GFX_VIEWPORT_RENDERER_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "matrix3x3.h"
+#include "recording_render_target.h"
+#include "render_target.h"
+#include "thread_pool.h"
+
+namespace gfx {
+
+/*
+ * Renders the same scene into several targets (windows, offscreen
+ * views), each with its own camera, in parallel on a thread_pool.
+ *
+ * Every viewport records its frame into its own command buffer (a
+ * recording_render_target) on a worker; the draw function is called
+ * concurrently for different viewports, so the scene data it reads must
+ * not change during render(). The frames are then replayed into the
+ * targets on the workers too.
+ *
+ * Targets that must only be used from one thread (a single threaded
+ * Direct2D factory) turn parallel submit off : every viewport is then
+ * recorded and replayed on the calling thread, one after the other,
+ * since content drawn into layers while recording (cached_layer) goes
+ * straight to the device.
+ */
+class viewport_renderer {
+public :
+    typedef std::function<void(render_target* target, const matrix3X3& camera,
+                               size_t viewport)> draw_function;
+
+    explicit viewport_renderer(thread_pool* pool);
+
+    size_t add_viewport(render_target* target, const matrix3X3& camera = matrix3X3::identity);
+
+    void set_camera(size_t viewport, const matrix3X3& camera) {
+        viewports_[viewport].camera_ = camera;
+    }
+
+    const matrix3X3& camera(size_t viewport) const {
+        return viewports_[viewport].camera_;
+    }
+
+    size_t viewport_count() const {
+        return viewports_.size();
+    }
+
+    void set_parallel_submit(bool enabled) {
+        parallel_submit_ = enabled;
+    }
+
+    /*
+     * Records and draws one frame in every viewport. Returns false if any
+     * target failed its end_draw(), see result().
+     */
+    bool render(const draw_function& draw);
+
+    end_draw_result result(size_t viewport) const {
+        return viewports_[viewport].result_;
+    }
+
+    /*
+     * The last frame recorded for a viewport.
+     */
+    const recording_render_target& commands(size_t viewport) const {
+        return *viewports_[viewport].commands_;
+    }
+
+private :
+    struct viewport {
+        render_target*                              target_;
+        matrix3X3                                   camera_;
+        std::shared_ptr<recording_render_target>    commands_;
+        end_draw_result                             result_;
+    };
+
+    void submit(viewport* view);
+
+    thread_pool*            pool_;
+    std::vector<viewport>   viewports_;
+    bool                    parallel_submit_;
+};
+
+} // ns gfx
+
+#endif /* GFX_VIEWPORT_RENDERER_H_ */